@@ -0,0 +1,2401 @@
+// mfgfix-bench: cost of one frame of face updates for a crowd
+//   idle faces with and without the idle fast path, a script writing one now and then, every configuration runs twice
+//   in lockstep, once in full as reference, and has to produce identical faces
+//   face inputs resolved once into the update context against looking them up where the update steps need them,
+//   both have to update the faces the same
+//   the fixed width merge kernels against the merge lambdas RegularUpdate had, both have to merge the same values
+//   faces spread over distance with and without level of detail, every face has to be handed
+//   exactly the time that passed, skipped frames included
+//   the frame budget scheduler under a simulated load, dialogue faces have to run every frame
+//   and no face may wait longer than FrameBudget::kMaxWait frames
+//   a preset sent to a crowd with one call per actor and with one broadcast, both have to set the same values
+//   script threads flooding the command queue while update threads drain it, the faces have to end up exactly
+//   as if every command had been applied one by one
+//   named presets parsed from JSON and loaded from their binary cache, both have to give the presets that were written
+//   keyframed sequences stepped like the face updates do, looping, expiring and chaining have to give the values
+//   worked out from the keys by hand
+//   planned transitions against the stepper, every channel of a plan has to arrive in the same frame, on its target,
+//   without moving away from it on the way
+//   face snapshots published while reader threads copy them out, no read may mix two publishes or go back in time
+//   face layers read back in the Papyrus preset layout, every channel in its place and applying it sets the same values
+//   transition speeds read by update threads while others set and unload them, against a locked map, no read may be torn
+//   blink and eye offset delays drawn with std::rand and pow against the generator and power curves, both have to draw
+//   the same distribution
+
+#include "core/Blend.h"
+#include "core/Broadcast.h"
+#include "core/Budget.h"
+#include "core/Commands.h"
+#include "core/FaceUpdate.h"
+#include "core/Lod.h"
+#include "core/Presets.h"
+#include "core/Random.h"
+#include "core/Scratch.h"
+#include "core/Sequence.h"
+#include "core/Snapshot.h"
+#include "core/SpeedTable.h"
+#include "core/Transition.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    constexpr std::array<std::uint32_t, static_cast<std::size_t>(Layer::Total)> kCounts{
+        Expression::Total, Expression::Total, Expression::Total,
+        Modifier::Total, Modifier::Total, Modifier::Total,
+        Phoneme::Total, Phoneme::Total, Phoneme::Total,
+        8, 8, 8
+    };
+
+    // a face owning its layers, the engine steps are no-ops like for a face without dialogue or transition
+    class BenchFace
+    {
+    public:
+        std::span<float> Values(Layer a_layer)
+        {
+            auto i = static_cast<std::size_t>(a_layer);
+            return { _values[i].data(), kCounts[i] };
+        }
+
+        bool IsZero(Layer a_layer)
+        {
+            auto values = Values(a_layer);
+            return std::all_of(values.begin(), values.end(), [](float a_value) { return a_value == 0.0f; });
+        }
+
+        void Reset(Layer a_layer)
+        {
+            auto values = Values(a_layer);
+            std::fill(values.begin(), values.end(), 0.0f);
+        }
+
+        void Copy(Layer a_src, Layer a_dst)
+        {
+            auto src = Values(a_src);
+            std::copy(src.begin(), src.end(), Values(a_dst).begin());
+        }
+
+        bool TransitionUpdate(float) { return false; }
+        void DialogueModifiersUpdate(float) {}
+        void DialoguePhonemesUpdate(float) {}
+
+        EyesTimers EyesTimersUpdate(const FaceUpdateContext& a_context)
+        {
+            return MfgFix::Core::EyesTimersUpdate(_eyes, a_context, _hold);
+        }
+
+        EyesState GetEyesState() const { return _eyes; }
+        void SetEyesState(const EyesState& a_eyes) { _eyes = a_eyes; }
+
+        float& BlinkValue() { return _blinkValue; }
+        bool Hold() const { return _hold; }
+        bool Dialogue() const { return false; }
+
+        void SetHold(bool a_hold) { _hold = a_hold; }
+
+        // bitwise, the fast path has to leave exactly what the full update leaves
+        bool operator==(const BenchFace& a_other) const
+        {
+            return std::memcmp(&_values, &a_other._values, sizeof(_values)) == 0 &&
+                   std::memcmp(&_eyes, &a_other._eyes, sizeof(EyesState)) == 0 &&
+                   std::memcmp(&_blinkValue, &a_other._blinkValue, sizeof(float)) == 0 &&
+                   _hold == a_other._hold;
+        }
+
+    private:
+        std::array<std::array<float, IdleFace::kMaxChannels>, static_cast<std::size_t>(Layer::Total)> _values{};
+        EyesState _eyes;
+        float _blinkValue{ 0.0f };
+        bool _hold{ false };
+    };
+
+    struct Crowd
+    {
+        std::vector<BenchFace> faces;
+        std::vector<Rng> rngs;
+        std::vector<IdleFace> idle;  // the plugin leases it with the rest of the face's record, which the full update needs too
+    };
+
+    struct Result
+    {
+        double fullNs{ 0.0 };
+        double idleNs{ 0.0 };
+        bool identical{ true };
+    };
+
+    std::array<EyesOffsetParams, Expression::Total> eyesOffset;
+
+    // an npc standing around with a mood and a scripted squint, or a corpse
+    BenchFace MakeFace(std::size_t a_index, bool a_dead)
+    {
+        BenchFace face;
+
+        face.Values(Layer::Expression2)[Expression::MoodHappy + a_index % 4] = 0.5f;
+        face.Values(Layer::Modifier2)[Modifier::SquintLeft] = 0.25f;
+        face.Values(Layer::Custom2)[a_index % 8] = 0.1f;
+
+        if (a_dead) {
+            face.SetHold(true);
+            auto eyes = face.GetEyesState();
+            eyes.blinkStage = BlinkStage::BlinkDownAndWait1;
+            face.SetEyesState(eyes);
+        }
+
+        return face;
+    }
+
+    FaceUpdateContext MakeContext(bool a_smooth)
+    {
+        FaceUpdateContext context;
+
+        context.timeDelta = 1.0f / 60.0f;
+        context.speed = a_smooth ? 0.75f : 0.0f;
+        context.animationStep = a_smooth ? context.timeDelta / context.speed : 0.0f;
+        context.blink = { 0.04f, 0.14f, 0.5f, 8.0f };
+        context.track = MakeTrackParams(30.0f, 15.0f, 3.0f, context.timeDelta);
+        context.phonemeThreshold = PhonemeThreshold(50.0f);
+        context.eyesOffset = eyesOffset;
+
+        return context;
+    }
+
+    void Frame(Crowd& a_crowd, bool a_smooth, bool a_idle)
+    {
+        for (std::size_t i = 0; i < a_crowd.faces.size(); ++i) {
+            auto context = MakeContext(a_smooth);
+            context.rng = &a_crowd.rngs[i];
+
+            context.idle = a_idle ? &a_crowd.idle[i] : nullptr;
+
+            if (a_smooth) {
+                SmoothUpdate(a_crowd.faces[i], context);
+            } else {
+                RegularUpdate(a_crowd.faces[i], context);
+            }
+        }
+    }
+
+    Result Run(std::size_t a_faces, bool a_dead, bool a_smooth, std::uint32_t a_frames)
+    {
+        Crowd full;
+        Crowd idle;
+
+        for (std::size_t i = 0; i < a_faces; ++i) {
+            full.faces.push_back(MakeFace(i, a_dead));
+            full.rngs.emplace_back(Rng::kDefaultSeed, i);
+        }
+
+        idle.faces = full.faces;
+        idle.rngs = full.rngs;
+        idle.idle = std::vector<IdleFace>(a_faces);
+
+        // settle the expressions first, at 60 fps a smooth transition takes about 45 frames
+        for (int i = 0; i < 120; ++i) {
+            Frame(full, a_smooth, false);
+            Frame(idle, a_smooth, true);
+        }
+
+        Result result;
+
+        for (std::uint32_t frame = 0; frame < a_frames; ++frame) {
+            // now and then a script squints one of them harder or lets go
+            if (frame % 250 == 0) {
+                auto i = frame / 250 % a_faces;
+                auto squint = frame / 250 % 2 ? 0.5f : 0.25f;
+
+                full.faces[i].Values(Layer::Modifier2)[Modifier::SquintLeft] = squint;
+                idle.faces[i].Values(Layer::Modifier2)[Modifier::SquintLeft] = squint;
+                idle.idle[i].Written();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            Frame(full, a_smooth, false);
+            auto middle = std::chrono::steady_clock::now();
+            Frame(idle, a_smooth, true);
+            auto end = std::chrono::steady_clock::now();
+
+            result.fullNs += std::chrono::duration<double, std::nano>(middle - start).count();
+            result.idleNs += std::chrono::duration<double, std::nano>(end - middle).count();
+
+            result.identical = result.identical && full.faces == idle.faces;
+        }
+
+        result.fullNs /= a_frames;
+        result.idleNs /= a_frames;
+
+        return result;
+    }
+
+    struct ContextResult
+    {
+        double perCallNs{ 0.0 };  // per face, inputs looked up where the update steps needed them
+        double contextNs{ 0.0 };  // per face, inputs resolved once into the update context
+        bool identical{ true };
+    };
+
+    // settings as the hook read them before the update context, and the two maps the speed took
+    struct PerCallInputs
+    {
+        float trackEyeXY{ 30.0f };
+        float trackEyeZ{ 15.0f };
+        float trackSpeed{ 3.0f };
+        float phonemeThreshold{ 50.0f };
+        BlinkParams blink{ 0.04f, 0.14f, 0.5f, 8.0f };
+        std::unordered_map<std::uintptr_t, std::uint32_t> owners;
+        std::unordered_map<std::uint32_t, float> speeds;
+
+        float GetSpeed(std::uintptr_t a_face) const
+        {
+            if (auto owner = owners.find(a_face); owner != owners.end()) {
+                if (auto speed = speeds.find(owner->second); speed != speeds.end()) {
+                    return speed->second;
+                }
+            }
+            return 0.0f;
+        }
+    };
+
+    // what the update context resolves from, converted once when the settings load
+    struct ResolvedInputs
+    {
+        BlinkParams blink{ 0.04f, 0.14f, 0.5f, 8.0f };
+        TrackParams track{ MakeTrackParams(30.0f, 15.0f, 3.0f, 1.0f) };
+        float phonemeThreshold{ PhonemeThreshold(50.0f) };
+        SpeedTable speeds;
+    };
+
+    // every other face with a transition speed, the rest regular; both ways have to leave the same faces
+    ContextResult RunContext(std::size_t a_faces, std::uint32_t a_frames)
+    {
+        constexpr float kTimeDelta = 1.0f / 60.0f;
+
+        auto faceKey = [](std::size_t a_face) { return (a_face + 1) * 0x230; };
+
+        PerCallInputs perCall;
+        auto resolved = std::make_unique<ResolvedInputs>();
+        Crowd before;
+        Crowd after;
+
+        for (std::size_t i = 0; i < a_faces; ++i) {
+            before.faces.push_back(MakeFace(i, false));
+            before.rngs.emplace_back(Rng::kDefaultSeed, i);
+
+            if (i % 2) {
+                perCall.owners[faceKey(i)] = static_cast<std::uint32_t>(i);
+                perCall.speeds[static_cast<std::uint32_t>(i)] = 0.75f;
+                resolved->speeds.Set(faceKey(i), static_cast<std::uint32_t>(i), 0.75f);
+            }
+        }
+
+        after.faces = before.faces;
+        after.rngs = before.rngs;
+
+        ContextResult result;
+
+        for (std::uint32_t frame = 0; frame < a_frames; ++frame) {
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < a_faces; ++i) {
+                FaceUpdateContext context;
+                context.timeDelta = kTimeDelta;
+                context.rng = &before.rngs[i];
+                context.eyesOffset = eyesOffset;
+
+                // the hook looked the speed up to pick the update, SmoothUpdate again for its step;
+                // the track limits went through deg2rad in the eyes helpers, the threshold was clamped in the merge
+                if (perCall.GetSpeed(faceKey(i)) > 0.0f) {
+                    context.speed = perCall.GetSpeed(faceKey(i));
+                    context.animationStep = kTimeDelta / context.speed;
+                }
+                context.blink = perCall.blink;
+                context.track = MakeTrackParams(perCall.trackEyeXY, perCall.trackEyeZ, perCall.trackSpeed, kTimeDelta);
+                context.phonemeThreshold = PhonemeThreshold(perCall.phonemeThreshold);
+
+                if (context.speed > 0.0f) {
+                    SmoothUpdate(before.faces[i], context);
+                } else {
+                    RegularUpdate(before.faces[i], context);
+                }
+            }
+            auto middle = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < a_faces; ++i) {
+                FaceUpdateContext context;
+                context.timeDelta = kTimeDelta;
+                context.rng = &after.rngs[i];
+                context.eyesOffset = eyesOffset;
+                context.speed = resolved->speeds.Get(faceKey(i), 0.0f);
+                context.animationStep = context.speed > 0.0f ? kTimeDelta / context.speed : 0.0f;
+                context.blink = resolved->blink;
+                context.track = resolved->track;
+                context.track.deltaMax *= kTimeDelta;
+                context.phonemeThreshold = resolved->phonemeThreshold;
+
+                if (context.speed > 0.0f) {
+                    SmoothUpdate(after.faces[i], context);
+                } else {
+                    RegularUpdate(after.faces[i], context);
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            result.perCallNs += std::chrono::duration<double, std::nano>(middle - start).count();
+            result.contextNs += std::chrono::duration<double, std::nano>(end - middle).count();
+
+            result.identical = result.identical && before.faces == after.faces;
+        }
+
+        result.perCallNs /= static_cast<double>(a_frames) * static_cast<double>(a_faces);
+        result.contextNs /= static_cast<double>(a_frames) * static_cast<double>(a_faces);
+
+        return result;
+    }
+
+    // the merge lambdas RegularUpdate had before the fixed width kernels, a runtime count and a branch per channel
+    void LambdaMergeNonZero(std::span<const float> a_src, std::span<float> a_dst)
+    {
+        auto count = std::min(a_src.size(), a_dst.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            if (a_src[i] != 0.0f) {
+                a_dst[i] = a_src[i];
+            }
+        }
+    }
+
+    void LambdaMergeModifiers(std::span<const float> a_src, std::span<float> a_dst)
+    {
+        LambdaMergeNonZero(a_src, a_dst);
+        if (a_src[Modifier::LookDown] != 0.0f || a_src[Modifier::LookLeft] != 0.0f || a_src[Modifier::LookRight] != 0.0f || a_src[Modifier::LookUp] != 0.0f) {
+            a_dst[Modifier::LookDown] = a_src[Modifier::LookDown];
+            a_dst[Modifier::LookLeft] = a_src[Modifier::LookLeft];
+            a_dst[Modifier::LookRight] = a_src[Modifier::LookRight];
+            a_dst[Modifier::LookUp] = a_src[Modifier::LookUp];
+        }
+    }
+
+    struct MergeResult
+    {
+        double lambdaNs{ 0.0 };  // per face
+        double kernelNs{ 0.0 };
+        bool identical{ true };
+    };
+
+    // layers 1 and 2 of a_faces faces merged into a reset layer 3 like RegularUpdate does, about a third of the channels set
+    MergeResult RunMerge(std::size_t a_faces, std::size_t a_width, bool a_modifiers, std::uint32_t a_frames)
+    {
+        Rng rng{ Rng::kDefaultSeed };
+        std::vector<float> layer1(a_faces * a_width);
+        std::vector<float> layer2(a_faces * a_width);
+        std::vector<float> lambda(a_faces * a_width);
+        std::vector<float> kernel(a_faces * a_width);
+
+        for (auto* layer : { &layer1, &layer2 }) {
+            for (auto& value : *layer) {
+                value = rng.Next() % 3 == 0 ? rng.Uniform() : 0.0f;
+            }
+        }
+
+        auto merge = [&](std::vector<float>& a_dst, auto a_merge) {
+            for (std::size_t face = 0; face < a_faces; ++face) {
+                auto offset = face * a_width;
+                std::span<float> dst{ a_dst.data() + offset, a_width };
+
+                std::fill(dst.begin(), dst.end(), 0.0f);
+                a_merge(std::span<const float>{ layer1.data() + offset, a_width }, dst);
+                a_merge(std::span<const float>{ layer2.data() + offset, a_width }, dst);
+            }
+        };
+
+        MergeResult result;
+
+        for (std::uint32_t frame = 0; frame < a_frames; ++frame) {
+            auto start = std::chrono::steady_clock::now();
+            if (a_modifiers) {
+                merge(lambda, LambdaMergeModifiers);
+            } else {
+                merge(lambda, LambdaMergeNonZero);
+            }
+            auto middle = std::chrono::steady_clock::now();
+            if (a_modifiers) {
+                merge(kernel, [](std::span<const float> a_src, std::span<float> a_dst) { MergeModifiers(a_src, a_dst); });
+            } else {
+                merge(kernel, [](std::span<const float> a_src, std::span<float> a_dst) { MergeNonZero(a_src, a_dst); });
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            result.lambdaNs += std::chrono::duration<double, std::nano>(middle - start).count();
+            result.kernelNs += std::chrono::duration<double, std::nano>(end - middle).count();
+
+            result.identical = result.identical && std::memcmp(lambda.data(), kernel.data(), lambda.size() * sizeof(float)) == 0;
+
+            // a script changes a channel now and then
+            auto& changed = layer2[rng.Next() % layer2.size()];
+            changed = changed != 0.0f ? 0.0f : rng.Uniform();
+        }
+
+        result.lambdaNs /= static_cast<double>(a_frames) * a_faces;
+        result.kernelNs /= static_cast<double>(a_frames) * a_faces;
+
+        return result;
+    }
+
+    // the ini defaults
+    LodPolicy MakeLodPolicy()
+    {
+        std::array<LodBand, 3> bands{ {
+            { 1000.0f, 0.08f, 2, LodPart::All },
+            { 2500.0f, 0.04f, 4, LodPart::Blink | LodPart::Smoothing },
+            { 4200.0f, 0.02f, 8, LodPart::Blink },
+        } };
+
+        return LodPolicy(bands, 0.5f);
+    }
+
+    struct LodResult
+    {
+        double ns{ 0.0 };
+        double updates{ 0.0 };  // per frame
+        std::array<std::size_t, LodPolicy::kMaxBands> bands{};  // faces per band at the end
+        bool timeKept{ true };
+    };
+
+    // a_faces walk back and forth between 2 m and 85 m from the camera, a 70 degree view
+    LodResult RunLod(std::size_t a_faces, const LodPolicy& a_policy, std::uint32_t a_frames)
+    {
+        constexpr float kTimeDelta = 1.0f / 60.0f;
+        constexpr float kNear = 150.0f;
+        constexpr float kFar = 6000.0f;
+        constexpr float kWalk = 100.0f;  // units per second
+        constexpr float kFov = 70.0f * 3.14159265f / 180.0f;
+
+        Crowd crowd;
+        LodFaces lodFaces;
+        std::vector<float> distance;
+        std::vector<double> handed(a_faces, 0.0);
+
+        for (std::size_t i = 0; i < a_faces; ++i) {
+            crowd.faces.push_back(MakeFace(i, false));
+            crowd.rngs.emplace_back(Rng::kDefaultSeed, i);
+            distance.push_back(kNear + (kFar - kNear) * static_cast<float>(i) / static_cast<float>(a_faces));
+        }
+
+        LodResult result;
+        std::uint64_t updates = 0;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::uint32_t frame = 0; frame < a_frames; ++frame) {
+            for (std::size_t i = 0; i < a_faces; ++i) {
+                auto walk = (i % 2 ? kWalk : -kWalk) * kTimeDelta;
+                distance[i] = std::clamp(distance[i] + walk * ((frame / 1200) % 2 ? -1.0f : 1.0f), kNear, kFar);
+
+                auto lease = lodFaces.Acquire(i + 1);
+                auto timeDelta = a_policy.Step(*lease.get(), i + 1, kTimeDelta, [&] {
+                    return LodView{ distance[i], ScreenSize(12.0f, distance[i], kFov) };
+                });
+
+                if (!timeDelta) {
+                    continue;
+                }
+
+                auto parts = a_policy[lease->band].parts;
+                auto context = MakeContext(parts & LodPart::Smoothing);
+                context.timeDelta = *timeDelta;
+                context.animationStep = context.speed > 0.0f ? *timeDelta / context.speed : 0.0f;
+                context.track = MakeTrackParams(30.0f, 15.0f, 3.0f, *timeDelta);
+                context.rng = &crowd.rngs[i];
+                context.lodParts = parts;
+
+                if (context.speed > 0.0f) {
+                    SmoothUpdate(crowd.faces[i], context);
+                } else {
+                    RegularUpdate(crowd.faces[i], context);
+                }
+
+                handed[i] += *timeDelta;
+                ++updates;
+            }
+        }
+
+        auto end = std::chrono::steady_clock::now();
+
+        result.ns = std::chrono::duration<double, std::nano>(end - start).count() / a_frames;
+        result.updates = static_cast<double>(updates) / a_frames;
+
+        for (std::size_t i = 0; i < a_faces; ++i) {
+            auto lease = lodFaces.Acquire(i + 1);
+            auto elapsed = static_cast<double>(a_frames) * kTimeDelta;
+
+            // whatever wasn't handed out yet is still pending
+            result.timeKept = result.timeKept && std::abs(handed[i] + lease->pending - elapsed) < 1e-3 * elapsed;
+            ++result.bands[lease->band];
+        }
+
+        return result;
+    }
+
+    struct BudgetResult
+    {
+        double spent{ 0.0 };  // per frame
+        double overruns{ 0.0 };  // % of frames
+        double updates{ 0.0 };   // per frame
+        std::uint64_t minRuns{ 0 };
+        std::uint64_t maxRuns{ 0 };
+        std::uint64_t maxWait{ 0 };
+        bool priorityRan{ true };
+        bool timeKept{ true };
+    };
+
+    // a_faces with a random cost of 5 to 15 us each, the first 2 in dialogue and 3 times as expensive,
+    // every 100th frame everything costs twice as much; the cost is simulated, nothing runs
+    BudgetResult RunBudget(std::size_t a_faces, std::uint64_t a_budget, std::uint32_t a_frames)
+    {
+        constexpr float kTimeDelta = 1.0f / 60.0f;
+        constexpr std::size_t kDialogue = 2;
+
+        FrameBudget budget;
+        budget.SetBudget(a_budget);
+
+        std::vector<BudgetState> states(a_faces);
+        std::vector<std::uint64_t> runs(a_faces, 0);
+        std::vector<std::uint64_t> lastRun(a_faces, 0);
+        std::vector<double> handed(a_faces, 0.0);
+        Rng rng(Rng::kDefaultSeed);
+
+        BudgetResult result;
+        std::uint64_t spent = 0;
+        std::uint64_t overruns = 0;
+        std::uint64_t updates = 0;
+
+        for (std::uint32_t frame = 1; frame <= a_frames; ++frame) {
+            std::uint64_t frameSpent = 0;
+
+            for (std::size_t i = 0; i < a_faces; ++i) {
+                auto priority = i < kDialogue;
+                auto ticket = budget.Admit(states[i], kTimeDelta, priority);
+
+                if (!ticket.run) {
+                    result.priorityRan = result.priorityRan && !priority;
+                    continue;
+                }
+
+                auto cost = static_cast<std::uint64_t>(Random(rng, 5000.0f, 15000.0f)) * (priority ? 3 : 1) * (frame % 100 ? 1 : 2);
+                budget.Spent(ticket, cost);
+
+                frameSpent += cost;
+                handed[i] += ticket.timeDelta;
+                result.maxWait = std::max<std::uint64_t>(result.maxWait, frame - lastRun[i]);
+                lastRun[i] = frame;
+                ++runs[i];
+                ++updates;
+            }
+
+            spent += frameSpent;
+            overruns += a_budget && frameSpent > a_budget ? 1 : 0;
+        }
+
+        result.spent = static_cast<double>(spent) / a_frames;
+        result.overruns = 100.0 * static_cast<double>(overruns) / a_frames;
+        result.updates = static_cast<double>(updates) / a_frames;
+        result.minRuns = *std::min_element(runs.begin() + kDialogue, runs.end());
+        result.maxRuns = *std::max_element(runs.begin() + kDialogue, runs.end());
+
+        for (std::size_t i = 0; i < a_faces; ++i) {
+            auto elapsed = static_cast<double>(a_frames) * kTimeDelta;
+            result.timeKept = result.timeKept && std::abs(handed[i] + states[i].pending - elapsed) < 1e-3 * elapsed;
+        }
+
+        return result;
+    }
+
+    struct BroadcastResult
+    {
+        double singleNs{ 0.0 };  // per actor
+        double broadcastNs{ 0.0 };
+        bool identical{ true };
+    };
+
+    // the marshalling of both ways through a task queue like SKSE's, every actor listed twice and a null
+    // in between for the broadcast; applying a preset writes its values to the actor, nothing else
+    BroadcastResult RunBroadcast(std::size_t a_actors, std::uint32_t a_calls)
+    {
+        struct Actor
+        {
+            ExpressionPreset face;
+            float speed{ 0.0f };
+        };
+
+        constexpr float kSpeed = 0.75f;
+
+        std::vector<float> values(kPresetSize);
+        Rng rng(Rng::kDefaultSeed);
+        for (auto& value : values) {
+            value = Random(rng, 0.0f, 1.0f);
+        }
+        values[30] = 2.0f;
+
+        std::vector<Actor> single(a_actors);
+        std::vector<Actor> broadcast(a_actors);
+        std::vector<Actor*> listed;
+
+        for (auto& actor : broadcast) {
+            listed.push_back(&actor);
+            listed.push_back(nullptr);
+        }
+        for (auto& actor : broadcast) {
+            listed.push_back(&actor);
+        }
+
+        std::vector<std::function<void()>> tasks;
+
+        auto apply = [](Actor* a_actor, const ExpressionPreset& a_preset, float a_speed) {
+            a_actor->face = a_preset;
+            a_actor->speed = a_speed;
+        };
+
+        auto drain = [&]() {
+            for (auto& task : tasks) {
+                task();
+            }
+            tasks.clear();
+        };
+
+        BroadcastResult result;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::uint32_t call = 0; call < a_calls; ++call) {
+            for (auto& actor : single) {
+                // what a Papyrus array arrives as, copied once per call
+                std::vector<float> arrived(values);
+                auto preset = MakePreset(arrived, false, {});
+                tasks.emplace_back([actorPtr = &actor, preset = *preset, &apply]() { apply(actorPtr, preset, kSpeed); });
+            }
+            drain();
+        }
+
+        auto middle = std::chrono::steady_clock::now();
+
+        for (std::uint32_t call = 0; call < a_calls; ++call) {
+            std::vector<float> arrived(values);
+            std::vector<Actor*> actors(listed);
+            auto preset = MakePreset(arrived, false, {});
+            tasks.emplace_back([actors = UniqueTargets(std::span<Actor* const>(actors)), preset = *preset, &apply]() {
+                for (auto actor : actors) {
+                    apply(actor, preset, kSpeed);
+                }
+            });
+            drain();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+
+        auto perActor = static_cast<double>(a_calls) * static_cast<double>(a_actors);
+        result.singleNs = std::chrono::duration<double, std::nano>(middle - start).count() / perActor;
+        result.broadcastNs = std::chrono::duration<double, std::nano>(end - middle).count() / perActor;
+
+        for (std::size_t i = 0; i < a_actors; ++i) {
+            auto& lhs = single[i];
+            auto& rhs = broadcast[i];
+            result.identical = result.identical && lhs.speed == rhs.speed && lhs.face.expression == rhs.face.expression &&
+                               lhs.face.expressionValue == rhs.face.expressionValue && lhs.face.phonemes == rhs.face.phonemes &&
+                               lhs.face.modifiers == rhs.face.modifiers;
+        }
+
+        return result;
+    }
+
+    // what the commands set on a face; a reset clears everything, like the engine reset of the script layers
+    struct CommandFace
+    {
+        std::array<std::int32_t, Phoneme::Total> phonemes{};
+        std::array<std::int32_t, kPresetModifiers> modifiers{};
+        std::uint32_t expression{ 0 };
+        std::int32_t expressionValue{ 0 };
+        float speed{ 0.0f };
+        std::uint32_t resets{ 0 };
+
+        void Reset()
+        {
+            phonemes.fill(0);
+            modifiers.fill(0);
+            expression = 0;
+            expressionValue = 0;
+            ++resets;
+        }
+
+        void Apply(const FaceCommand& a_command, const ExpressionPreset* a_preset)
+        {
+            auto clamp = [](std::int32_t a_value) { return std::clamp(a_value, 0, 200); };
+
+            speed = a_command.speed;
+
+            switch (a_command.kind) {
+            case CommandKind::Phoneme:
+                phonemes[a_command.id] = clamp(a_command.value);
+                break;
+            case CommandKind::Modifier:
+                modifiers[a_command.id] = clamp(a_command.value);
+                break;
+            case CommandKind::Expression:
+                expression = a_command.id;
+                expressionValue = clamp(a_command.value);
+                break;
+            case CommandKind::ClearPhonemes:
+                phonemes.fill(0);
+                break;
+            case CommandKind::ClearModifiers:
+                modifiers.fill(0);
+                break;
+            case CommandKind::ResetOverride:
+            case CommandKind::ResetAll:
+                Reset();
+                break;
+            case CommandKind::Preset:
+                expression = a_preset->expression;
+                expressionValue = clamp(a_preset->expressionValue);
+                if (a_preset->setPhonemes) {
+                    std::transform(a_preset->phonemes.begin(), a_preset->phonemes.end(), phonemes.begin(), clamp);
+                }
+                std::transform(a_preset->modifiers.begin(), a_preset->modifiers.end(), modifiers.begin(), clamp);
+                break;
+            }
+        }
+
+        // returns the writes skipped because the face already had the value
+        std::uint64_t Apply(const PendingFace& a_pending)
+        {
+            std::uint64_t dropped = 0;
+
+            speed = a_pending.speed;
+
+            if (a_pending.reset != FaceReset::None) {
+                Reset();
+            }
+
+            if (a_pending.setExpression) {
+                expression = a_pending.expression;
+                expressionValue = a_pending.expressionValue;
+            }
+
+            for (std::size_t i = 0; i < phonemes.size(); ++i) {
+                if (a_pending.phonemeMask >> i & 1) {
+                    dropped += phonemes[i] == a_pending.phonemes[i] ? 1 : 0;
+                    phonemes[i] = a_pending.phonemes[i];
+                }
+            }
+
+            for (std::size_t i = 0; i < modifiers.size(); ++i) {
+                if (a_pending.modifierMask >> i & 1) {
+                    dropped += modifiers[i] == a_pending.modifiers[i] ? 1 : 0;
+                    modifiers[i] = a_pending.modifiers[i];
+                }
+            }
+
+            return dropped;
+        }
+
+        // resets are compared by whether one happened at all, several coalesce into one
+        bool operator==(const CommandFace& a_other) const
+        {
+            return phonemes == a_other.phonemes && modifiers == a_other.modifiers && expression == a_other.expression &&
+                   expressionValue == a_other.expressionValue && speed == a_other.speed && (resets > 0) == (a_other.resets > 0);
+        }
+    };
+
+    struct CommandResult
+    {
+        double queueNs{ 0.0 };    // per command, sent and applied
+        double taskNs{ 0.0 };     // the same with a heap allocated task each, like AddUITask
+        double coalesced{ 0.0 };  // % of the commands merged into one pending for the same face
+        double dropped{ 0.0 };    // % of the writes applied
+        std::uint64_t overflows{ 0 };
+        bool identical{ true };
+    };
+
+    // a_senders threads send a_commands each to their own faces, a_updaters threads update all faces every frame,
+    // a face only on one thread at a time like the game does; 1 in 16 commands is a preset, 1 in 64 a reset
+    CommandResult RunCommands(std::size_t a_faces, std::size_t a_senders, std::size_t a_updaters, std::uint32_t a_commands)
+    {
+        CommandQueue queue;
+        CommandResult result;
+
+        std::vector<CommandFace> reference(a_faces);
+        std::vector<CommandFace> faces(a_faces);
+        std::vector<std::mutex> faceLocks(a_faces);
+
+        auto faceKey = [](std::size_t a_face) { return (a_face + 1) * 0x1F0; };
+
+        ExpressionPreset preset;
+        for (std::size_t i = 0; i < preset.phonemes.size(); ++i) {
+            preset.phonemes[i] = static_cast<std::int32_t>(i * 7);
+        }
+        for (std::size_t i = 0; i < preset.modifiers.size(); ++i) {
+            preset.modifiers[i] = static_cast<std::int32_t>(i * 11);
+        }
+        preset.expression = 2;
+        preset.expressionValue = 80;
+
+        // the same command stream per sender, generated up front so only the queue is timed
+        auto makeCommands = [&](std::size_t a_sender) {
+            std::vector<FaceCommand> commands;
+            commands.reserve(a_commands);
+            Rng rng(Rng::kDefaultSeed, a_sender);
+
+            for (std::uint32_t i = 0; i < a_commands; ++i) {
+                FaceCommand command;
+                auto face = a_sender + a_senders * (rng.Next() % ((a_faces + a_senders - 1 - a_sender) / a_senders));
+                auto roll = rng.Next() % 64;
+
+                command.face = faceKey(face);
+                command.owner = static_cast<std::uint32_t>(face);
+                command.speed = roll % 2 ? 0.75f : 0.0f;
+                command.kind = roll == 0 ? CommandKind::ResetAll : roll < 4 ? CommandKind::Preset : static_cast<CommandKind>(rng.Next() % 3);
+                command.id = static_cast<std::uint8_t>(command.kind == CommandKind::Phoneme ? rng.Next() % Phoneme::Total :
+                                                       command.kind == CommandKind::Modifier ? rng.Next() % kPresetModifiers :
+                                                                                               rng.Next() % Expression::Total);
+                command.value = static_cast<std::int32_t>(rng.Next() % 4) * 50;
+                commands.push_back(command);
+            }
+
+            return commands;
+        };
+
+        std::vector<std::vector<FaceCommand>> streams;
+        for (std::size_t sender = 0; sender < a_senders; ++sender) {
+            streams.push_back(makeCommands(sender));
+
+            for (auto& command : streams.back()) {
+                reference[command.owner].Apply(command, &preset);
+            }
+        }
+
+        std::atomic<std::size_t> sending{ a_senders };
+        std::atomic<std::uint64_t> dropped{ 0 };
+        std::atomic<std::uint64_t> applied{ 0 };
+
+        auto update = [&](std::size_t a_updater) {
+            PendingFace pending;
+            std::uint64_t threadDropped = 0;
+            std::uint64_t threadApplied = 0;
+            auto last = false;
+
+            while (!last) {
+                // one more round once all senders are done, whatever was still in the ring is drained there
+                last = sending.load(std::memory_order_acquire) == 0 && queue.Empty();
+
+                for (std::size_t face = a_updater; face < a_faces; face += a_updaters) {
+                    std::lock_guard locker(faceLocks[face]);
+
+                    if (queue.Take(faceKey(face), pending)) {
+                        threadDropped += faces[face].Apply(pending);
+                        threadApplied += std::popcount(pending.phonemeMask) + std::popcount(pending.modifierMask);
+                    }
+                }
+            }
+
+            dropped += threadDropped;
+            applied += threadApplied;
+        };
+
+        std::vector<std::thread> threads;
+        for (std::size_t updater = 0; updater < a_updaters; ++updater) {
+            threads.emplace_back(update, updater);
+        }
+
+        std::vector<std::thread> senders;
+        for (std::size_t sender = 0; sender < a_senders; ++sender) {
+            senders.emplace_back([&, sender]() {
+                for (auto command : streams[sender]) {
+                    if (command.kind == CommandKind::Preset) {
+                        queue.PushPreset(preset, { &command, 1 });
+                    } else {
+                        queue.Push(command);
+                    }
+                }
+
+                sending.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        for (auto& sender : senders) {
+            sender.join();
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // everything left after the last round, an update that came too early can leave a face for the next frame
+        PendingFace pending;
+        for (std::size_t face = 0; face < a_faces; ++face) {
+            while (queue.Take(faceKey(face), pending)) {
+                faces[face].Apply(pending);
+            }
+        }
+
+        auto total = static_cast<double>(a_commands) * static_cast<double>(a_senders);
+        auto counters = queue.GetCounters();
+
+        result.coalesced = 100.0 * static_cast<double>(counters.coalesced) / total;
+        result.dropped = 100.0 * static_cast<double>(dropped.load()) / std::max<double>(1.0, static_cast<double>(applied.load()));
+        result.overflows = counters.overflows;
+        result.identical = faces == reference && counters.pending == 0;
+
+        // cost per command of a script burst within one frame, sending and applying on one thread: through the queue,
+        // and as the task per command it replaces, a heap allocated closure into a locked queue
+        constexpr std::size_t kFrames = 200;
+
+        auto burst = std::min<std::size_t>(a_faces * 8, CommandQueue::kCapacity);
+        auto& stream = streams.front();
+        std::vector<CommandFace> taskFaces(a_faces);
+        std::mutex taskLock;
+        std::vector<std::function<void()>> tasks;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::size_t frame = 0, next = 0; frame < kFrames; ++frame) {
+            for (std::size_t i = 0; i < burst; ++i, next = (next + 1) % stream.size()) {
+                auto command = stream[next];
+                if (command.kind == CommandKind::Preset) {
+                    queue.PushPreset(preset, { &command, 1 });
+                } else {
+                    queue.Push(command);
+                }
+            }
+
+            for (std::size_t face = 0; face < a_faces; ++face) {
+                if (queue.Take(faceKey(face), pending)) {
+                    faces[face].Apply(pending);
+                }
+            }
+        }
+
+        auto middle = std::chrono::steady_clock::now();
+
+        for (std::size_t frame = 0, next = 0; frame < kFrames; ++frame) {
+            for (std::size_t i = 0; i < burst; ++i, next = (next + 1) % stream.size()) {
+                std::lock_guard locker(taskLock);
+                tasks.emplace_back([&taskFaces, command = stream[next], preset]() { taskFaces[command.owner].Apply(command, &preset); });
+            }
+
+            std::vector<std::function<void()>> run;
+            {
+                std::lock_guard locker(taskLock);
+                run.swap(tasks);
+            }
+            for (auto& task : run) {
+                task();
+            }
+        }
+
+        auto end = std::chrono::steady_clock::now();
+
+        result.queueNs = std::chrono::duration<double, std::nano>(middle - start).count() / static_cast<double>(kFrames * burst);
+        result.taskNs = std::chrono::duration<double, std::nano>(end - middle).count() / static_cast<double>(kFrames * burst);
+
+        return result;
+    }
+
+    struct PresetResult
+    {
+        double parseNs{ 0.0 };  // per preset, files read, parsed and compiled
+        double cacheNs{ 0.0 };  // per preset, loaded from the cache
+        double lookupNs{ 0.0 };
+        bool identical{ true };
+    };
+
+    // a_presets presets in two files, values in steps of 0.01 like Papyrus scripts use; names need escapes, one
+    // is repeated in the second file in other case, and members that aren't presets have to be skipped
+    PresetResult RunPresets(std::size_t a_presets, std::uint32_t a_lookups)
+    {
+        PresetResult result;
+
+        auto directory = std::filesystem::temp_directory_path() / "mfgfix-bench-presets";
+        auto cache = directory.parent_path() / "mfgfix-bench-presets.bin";
+
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+        std::filesystem::remove(cache, error);
+        std::filesystem::create_directories(directory, error);
+
+        Rng rng(Rng::kDefaultSeed);
+
+        std::vector<std::string> names;
+        std::vector<std::array<float, kPresetSize>> values(a_presets);
+        std::string files[2] = { "\xEF\xBB\xBF{\n", "{ \"comment\": \"not a preset\", \"short\": [ 1, 2 ],\n  \"nested\": { \"a\": [ true, null ] }" };
+
+        for (std::size_t i = 0; i < a_presets; ++i) {
+            char name[64];
+            std::snprintf(name, sizeof(name), i % 7 == 0 ? "preset \\\"%zu\\\" \\u00e9" : "preset_%zu", i);
+            names.push_back(i % 7 == 0 ? "preset \"" + std::to_string(i) + "\" \xC3\xA9" : name);
+
+            for (auto& value : values[i]) {
+                value = std::round(Random(rng, 0.0f, 1.0f) * 100.0f) / 100.0f;
+            }
+            values[i][30] = static_cast<float>(i % Expression::Total);
+
+            // the last one is written twice, the second file's version wins
+            auto& text = files[i + 1 == a_presets ? 1 : 0];
+            if (text.size() > 8) {
+                text += ",\n";
+            }
+
+            text += "  \"";
+            text += name;
+            text += "\": [";
+            for (std::size_t j = 0; j < kPresetSize; ++j) {
+                char number[32];
+                std::snprintf(number, sizeof(number), j ? ", %g" : "%g", static_cast<double>(values[i][j]));
+                text += number;
+            }
+            text += "]";
+        }
+
+        // the one repeated, different values and name case
+        auto last = values.back();
+        std::reverse(last.begin(), last.begin() + Phoneme::Total);
+        files[0] += ",\n  \"PRESET_";
+        files[0] += std::to_string(a_presets - 1);
+        files[0] += "\": [";
+        for (std::size_t j = 0; j < kPresetSize; ++j) {
+            char number[32];
+            std::snprintf(number, sizeof(number), j ? ", %g" : "%g", static_cast<double>(j == 30 ? values.back()[j] : last[j]));
+            files[0] += number;
+        }
+        files[0] += "]\n}\n";
+        files[1] += "\n}";
+
+        for (std::size_t i = 0; i < 2; ++i) {
+            std::ofstream(directory / (i ? "b.json" : "a.json"), std::ios::binary) << files[i];
+        }
+
+        auto check = [&](const PresetTable& a_table) {
+            if (a_table.Size() != a_presets) {
+                return false;
+            }
+            for (std::size_t i = 0; i < a_presets; ++i) {
+                auto preset = a_table.Find(names[i]);
+                if (!preset || *preset != Pack(values[i])) {
+                    return false;
+                }
+                // what the registry applies is what the float array gives
+                auto fromTable = MakePreset(Unpack(*preset), false, {});
+                auto fromArray = MakePreset(values[i], false, {});
+                if (fromTable->phonemes != fromArray->phonemes || fromTable->modifiers != fromArray->modifiers ||
+                    fromTable->expression != fromArray->expression || fromTable->expressionValue != fromArray->expressionValue) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+
+        PresetLoad compiled;
+        auto table = LoadPresets(directory, cache, compiled);
+
+        auto middle = std::chrono::steady_clock::now();
+
+        PresetLoad cached;
+        auto fromCache = LoadPresets(directory, cache, cached);
+
+        auto end = std::chrono::steady_clock::now();
+
+        result.parseNs = std::chrono::duration<double, std::nano>(middle - start).count() / static_cast<double>(a_presets);
+        result.cacheNs = std::chrono::duration<double, std::nano>(end - middle).count() / static_cast<double>(a_presets);
+
+        result.identical = !compiled.cached && compiled.skipped == 3 && compiled.errors.size() == 3 && cached.cached && check(table) && check(fromCache);
+
+        // written back and read again as the captures are
+        auto reparsed = ParsePresets(FormatPresets(table));
+        result.identical = result.identical && reparsed.error.empty() && check(PresetTable(std::move(reparsed.presets)));
+
+        // a source that changed makes the cache stale
+        std::filesystem::last_write_time(directory / "b.json", std::filesystem::last_write_time(directory / "b.json", error) + std::chrono::seconds(1), error);
+        PresetLoad stale;
+        LoadPresets(directory, cache, stale);
+        result.identical = result.identical && !stale.cached;
+
+        // lookups in other case, the way Papyrus strings come in
+        std::vector<std::string> lookups;
+        for (auto& name : names) {
+            lookups.push_back(name);
+            std::transform(name.begin(), name.end(), lookups.back().begin(), [](char a_char) { return a_char >= 'a' && a_char <= 'z' ? static_cast<char>(a_char - 32) : a_char; });
+        }
+
+        std::size_t found = 0;
+
+        start = std::chrono::steady_clock::now();
+
+        for (std::uint32_t i = 0; i < a_lookups; ++i) {
+            found += fromCache.Find(lookups[i % lookups.size()]) != nullptr;
+        }
+
+        end = std::chrono::steady_clock::now();
+
+        result.lookupNs = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(a_lookups);
+        result.identical = result.identical && found == a_lookups && !fromCache.Find("preset_");
+
+        std::filesystem::remove_all(directory, error);
+        std::filesystem::remove(cache, error);
+
+        return result;
+    }
+
+    struct SequenceResult
+    {
+        double stepNs{ 0.0 };   // per face and frame
+        double writes{ 0.0 };   // channels written per face and frame
+        bool identical{ true };
+    };
+
+    // a loop checked frame by frame against values worked out from its keys, time steps are exact in binary;
+    // then a_faces faces playing preset sequences for a_frames frames
+    SequenceResult RunSequences(std::size_t a_faces, std::uint32_t a_frames)
+    {
+        SequenceResult result;
+
+        constexpr float kStep = 1.0f / 64.0f;
+
+        // phoneme 0 up and down, modifier 3 set once, the expression rises on mood 2 then switches to 4
+        std::vector<SequenceKey> keys{
+            { 1.0f, SequenceChannel::Phoneme, 0, 100 },
+            { 0.0f, SequenceChannel::Phoneme, 0, 0 },
+            { 2.0f, SequenceChannel::Phoneme, 0, 0 },
+            { 0.5f, SequenceChannel::Modifier, 3, 50 },
+            { 0.0f, SequenceChannel::Expression, 2, 0 },
+            { 1.0f, SequenceChannel::Expression, 2, 100 },
+            { 1.5f, SequenceChannel::Expression, 4, 60 },
+            { 1.0f, SequenceChannel::Modifier, 20, 50 },  // out of range, dropped
+            { -1.0f, SequenceChannel::Phoneme, 1, 50 }    // before the start, dropped
+        };
+
+        auto loop = std::make_shared<const Sequence>(MakeSequence(keys, 0.0f, true, 5.0f, std::nullopt));
+        result.identical = loop->keys.size() == 7 && loop->tracks.size() == 3 && loop->duration == 2.0f;
+
+        SequencePlayer player(loop);
+
+        for (std::uint32_t frame = 1;; ++frame) {
+            PendingFace pending;
+            auto playing = player.Step(kStep, pending);
+
+            auto elapsed = frame * kStep;
+            if (elapsed >= 5.0f) {
+                result.identical = result.identical && !playing && pending.reset == FaceReset::All && !pending.phonemeMask && !pending.modifierMask;
+                break;
+            }
+
+            auto t = std::fmod(elapsed, 2.0f);
+            auto phoneme = static_cast<std::int32_t>(std::lround(t <= 1.0f ? 100.0f * t : 100.0f * (2.0f - t)));
+            auto modifier = elapsed >= 0.5f;
+            auto expression = t < 1.5f ? 2u : 4u;
+            auto expressionValue = t < 1.0f ? static_cast<std::int32_t>(std::lround(100.0f * t)) : (t < 1.5f ? 100 : 60);
+
+            result.identical = result.identical && playing && pending.phonemeMask == 1 && pending.phonemes[0] == phoneme &&
+                               pending.modifierMask == (modifier ? 1u << 3 : 0u) && (!modifier || pending.modifiers[3] == 50) &&
+                               pending.setExpression && pending.expression == expression && pending.expressionValue == expressionValue;
+        }
+
+        // once through, then the next preset on top of the last keys
+        ExpressionPreset next;
+        next.expression = 10;
+        next.expressionValue = 70;
+        next.phonemes.fill(30);
+
+        SequencePlayer once(std::make_shared<const Sequence>(MakeSequence(keys, 2.5f, false, 0.0f, next)));
+
+        for (std::uint32_t frame = 1;; ++frame) {
+            PendingFace pending;
+            if (!once.Step(kStep, pending)) {
+                result.identical = result.identical && frame * kStep >= 2.5f && pending.expression == 10 && pending.expressionValue == 70 &&
+                                   pending.phonemes[0] == 30 && pending.modifiers[3] == 0 && pending.modifierMask == (1u << kPresetModifiers) - 1;
+                break;
+            }
+            result.identical = result.identical && frame * kStep < 2.5f;
+        }
+
+        // a crowd playing four presets in a loop, stepped through the board like the update hook does
+        std::vector<SequenceKey> presetKeys;
+        Rng rng(Rng::kDefaultSeed);
+        for (std::size_t i = 0; i < 4; ++i) {
+            std::vector<float> values(kPresetSize);
+            for (auto& value : values) {
+                value = Random(rng, 0.0f, 1.0f);
+            }
+            values[30] = static_cast<float>(i * 3);
+            AppendPresetKeys(presetKeys, static_cast<float>(i) * 0.5f, *MakePreset(values, false, {}));
+        }
+
+        auto crowd = std::make_shared<const Sequence>(MakeSequence(presetKeys, 2.0f, true, 0.0f, std::nullopt));
+
+        SequenceBoard board;
+        for (std::size_t face = 0; face < a_faces; ++face) {
+            board.Start((face + 1) * 0x1F0, static_cast<std::uint32_t>(face), crowd, 0.0f);
+        }
+
+        std::uint64_t writes = 0;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::uint32_t frame = 0; frame < a_frames; ++frame) {
+            for (std::size_t face = 0; face < a_faces; ++face) {
+                PendingFace pending;
+                if (board.Step((face + 1) * 0x1F0, 1.0f / 60.0f, pending) == SequenceStep::None) {
+                    result.identical = false;
+                }
+                writes += std::popcount(pending.phonemeMask) + std::popcount(pending.modifierMask) + pending.setExpression;
+            }
+        }
+
+        auto end = std::chrono::steady_clock::now();
+
+        auto steps = static_cast<double>(a_frames) * static_cast<double>(a_faces);
+        result.stepNs = std::chrono::duration<double, std::nano>(end - start).count() / steps;
+        result.writes = static_cast<double>(writes) / steps;
+        result.identical = result.identical && board.Size() == a_faces && board.EraseOwner(0) == 1 && board.Size() == a_faces - 1;
+
+        return result;
+    }
+
+    struct TransitionResult
+    {
+        double stepperNs{ 0.0 };  // per face and frame, all four layers
+        double plannedNs{ 0.0 };
+        double linearNs{ 0.0 };  // planned with a linear curve
+        std::uint32_t stepperSpread{ 0 };  // frames between the first and the last channel reaching its target
+        std::uint32_t plannedSpread{ 0 };
+        bool identical{ true };
+    };
+
+    // a_count channels stepped by a_merge from random values to random targets, frames between the first and the last arriving
+    template <class Merge>
+    std::uint32_t ArrivalSpread(std::size_t a_count, Merge a_merge)
+    {
+        Rng rng(Rng::kDefaultSeed);
+        std::vector<float> dialogue(a_count), target(a_count), result(a_count);
+
+        for (std::size_t i = 0; i < a_count; ++i) {
+            result[i] = Random(rng, 0.0f, 1.0f);
+            target[i] = Random(rng, 0.0f, 1.0f);
+        }
+
+        std::vector<std::uint32_t> arrival(a_count, 0);
+
+        for (std::uint32_t frame = 1; frame < 1000 && std::ranges::find(arrival, 0u) != arrival.end(); ++frame) {
+            a_merge(dialogue, target, result);
+            for (std::size_t i = 0; i < a_count; ++i) {
+                arrival[i] = arrival[i] ? arrival[i] : (result[i] == target[i] ? frame : 0);
+            }
+        }
+
+        auto [first, last] = std::ranges::minmax(arrival);
+        return first ? last - first : ~0u;
+    }
+
+    // single layers checked frame by frame against the curve, time steps are exact in binary;
+    // then a_faces faces whose targets change every second, stepped and planned
+    TransitionResult RunTransitions(std::size_t a_faces, std::uint32_t a_frames)
+    {
+        TransitionResult result;
+
+        constexpr float kStep = 1.0f / 64.0f;
+        constexpr std::size_t kCount = Phoneme::Total;
+
+        // the tables follow their curves from 0 to 1 without going back
+        for (auto curve : { EaseCurve::Linear, EaseCurve::SmoothStep, EaseCurve::EaseIn, EaseCurve::EaseOut }) {
+            EaseTable ease(curve);
+            auto last = 0.0f;
+
+            for (std::uint32_t i = 0; i < 1024; ++i) {
+                auto t = static_cast<float>(i) / 1024.0f;
+                auto value = ease(t);
+                auto exact = curve == EaseCurve::SmoothStep ? t * t * (3.0f - 2.0f * t) :
+                             curve == EaseCurve::EaseIn     ? t * t :
+                             curve == EaseCurve::EaseOut    ? t * (2.0f - t) :
+                                                              t;
+
+                result.identical = result.identical && value >= last && std::fabs(value - exact) < 5e-4f;
+                last = value;
+            }
+
+            result.identical = result.identical && ease(0.0f) == 0.0f;
+        }
+
+        Rng rng(Rng::kDefaultSeed);
+
+        // the vector kernels against the scalar ones, every width a layer can have, targets unset on some lanes
+        for (std::size_t count = 0; count <= LayerTransition::kMaxChannels; ++count) {
+            std::array<float, LayerTransition::kMaxChannels> dialogue{}, target{}, from{}, delta{};
+            std::array<std::array<float, LayerTransition::kMaxChannels>, 3> out{};
+
+            for (std::size_t i = 0; i < count; ++i) {
+                dialogue[i] = Random(rng, 0.0f, 1.0f) < 0.5f ? 0.0f : Random(rng, -1.0f, 1.0f);
+                target[i] = Random(rng, 0.0f, 1.0f) < 0.5f ? 0.0f : Random(rng, -1.0f, 1.0f);
+                from[i] = Random(rng, -1.0f, 1.0f);
+                delta[i] = Random(rng, -1.0f, 1.0f);
+            }
+
+            auto scale = Random(rng, 0.0f, 1.0f);
+
+            auto scalar = Kernels::TransitionStepScalar(dialogue.data(), target.data(), from.data(), delta.data(), scale, out[0].data(), count);
+
+            for (std::size_t kernel = 1; kernel <= static_cast<std::size_t>(GetSupportedSimdLevel()); ++kernel) {
+                auto mask = (kernel == 1 ? Kernels::TransitionStepSSE41 : Kernels::TransitionStepAVX2)(dialogue.data(), target.data(), from.data(), delta.data(), scale, out[kernel].data(), count);
+
+                result.identical = result.identical && mask == scalar && std::memcmp(out[kernel].data(), out[0].data(), sizeof(out[0])) == 0;
+            }
+        }
+
+        // half a second is 32 frames, every channel is on the same fraction of its way until then
+        EaseTable smooth(EaseCurve::SmoothStep);
+
+        std::array<float, kCount> dialogue{}, target{}, result3{}, from{};
+        for (std::size_t i = 0; i < kCount; ++i) {
+            result3[i] = Random(rng, 0.0f, 1.0f);
+            target[i] = Random(rng, 0.0f, 1.0f);
+        }
+        target[3] = 0.0f;
+        dialogue[3] = 0.4f;  // follows dialogue until it stops, then planned back to 0
+
+        from = result3;
+        LayerTransition layer;
+        std::uint32_t written = 0;  // bumped with every change of the targets, like the writes to a face are counted
+
+        // a_frames of a plan that arrives after a_arrive, channel 3 follows dialogue
+        auto check = [&](std::uint32_t a_frames, std::uint32_t a_arrive) {
+            for (std::uint32_t frame = 1; frame <= a_frames; ++frame) {
+                auto before = result3;
+                layer.Merge(dialogue, target, result3, 0.5f, kStep, smooth, written);
+
+                auto progress = frame < a_arrive ? smooth(static_cast<float>(frame) / static_cast<float>(a_arrive)) : 1.0f;
+
+                for (std::size_t i = 0; i < kCount; ++i) {
+                    if (i == 3) {
+                        result.identical = result.identical && result3[i] == dialogue[i];
+                        continue;
+                    }
+
+                    auto delta = target[i] - from[i];
+                    auto toward = (target[i] - result3[i]) * delta >= 0.0f && (result3[i] - before[i]) * delta >= 0.0f;
+                    auto onCurve = frame >= a_arrive ? result3[i] == target[i] : std::fabs(result3[i] - from[i] - delta * progress) < 1e-5f;
+
+                    result.identical = result.identical && toward && onCurve;
+                }
+
+                result.identical = result.identical && layer.Moving() == (frame < a_arrive);
+            }
+        };
+
+        check(40, 32);
+
+        // new targets halfway through a plan, planned again from where the channels are
+        for (std::size_t i = 0; i < kCount; ++i) {
+            target[i] = i == 3 ? 0.0f : Random(rng, 0.0f, 1.0f);
+        }
+        from = result3;
+        ++written;
+        check(16, 32);
+
+        target[0] = 0.9f;
+        from = result3;
+        ++written;
+        check(16, 32);
+
+        // dialogue on channel 3 stops halfway, the layer is planned again from there
+        {
+            std::array<float, kCount> last = result3;
+            dialogue[3] = 0.0f;
+            layer.Merge(dialogue, target, result3, 0.5f, kStep, smooth, written);
+            result.identical = result.identical && layer.Moving() && result3[3] < 0.4f && result3[3] > 0.0f && result3[0] > last[0] && result3[0] < target[0];
+
+            for (std::uint32_t frame = 0; frame < 32; ++frame) {
+                layer.Merge(dialogue, target, result3, 0.5f, kStep, smooth, written);
+            }
+            result.identical = result.identical && !layer.Moving() && result3 == target;
+        }
+
+        // once there, dialogue coming and going and a target nobody said was written are stepped, the layer isn't planned
+        {
+            dialogue[3] = 0.4f;
+            layer.Merge(dialogue, target, result3, 0.5f, kStep, smooth, written);
+            result.identical = result.identical && !layer.Moving() && result3[3] == 0.4f;
+
+            dialogue[3] = 0.0f;
+            target[1] = target[1] < 0.5f ? 1.0f : 0.0f;
+            std::array<float, kCount> last = result3;
+            layer.Merge(dialogue, target, result3, 0.5f, kStep, smooth, written);
+            result.identical = result.identical && !layer.Moving() && result3[3] < 0.4f && result3[3] > 0.0f &&
+                               std::fabs(std::fabs(result3[1] - last[1]) - kStep / 0.5f) < 1e-6f;
+        }
+
+        // every channel arrives in the same frame when planned, the stepper gets the near ones there first
+        result.stepperSpread = ArrivalSpread(kCount, [](auto& a_dialogue, auto& a_target, auto& a_result) {
+            AnimMerge(a_dialogue, a_target, a_result, kStep / 0.75f);
+        });
+        result.plannedSpread = ArrivalSpread(kCount, [transition = LayerTransition{}, &smooth](auto& a_dialogue, auto& a_target, auto& a_result) mutable {
+            transition.Merge(a_dialogue, a_target, a_result, 0.75f, kStep, smooth, 0);
+        });
+
+        result.identical = result.identical && result.plannedSpread == 0;
+
+        // a crowd, every face is given new targets once a second and says so, the three ways timed over the same frames
+        constexpr std::array kLayers{ TransitionLayer::Expression, TransitionLayer::Modifier, TransitionLayer::Phoneme, TransitionLayer::Custom };
+        constexpr std::array<std::size_t, 4> kLayerCounts{ Expression::Total, Modifier::Total, Phoneme::Total, 8 };
+
+        struct CrowdFace
+        {
+            std::array<std::array<std::array<float, IdleFace::kMaxChannels>, 2>, 4> targets{};  // two sets it switches between
+            std::array<std::array<float, IdleFace::kMaxChannels>, 4> dialogue{};
+            std::array<std::array<float, IdleFace::kMaxChannels>, 4> values{};
+            FaceTransition transition;
+            std::size_t set{ 0 };
+        };
+
+        std::vector<CrowdFace> stepped(a_faces);
+        for (auto& face : stepped) {
+            for (auto& sets : face.targets) {
+                for (auto& set : sets) {
+                    for (auto& value : set) {
+                        value = Random(rng, 0.0f, 1.0f) < 0.5f ? 0.0f : Random(rng, 0.0f, 1.0f);
+                    }
+                }
+            }
+        }
+        auto planned = stepped;
+        auto linear = stepped;
+
+        auto params = MakeTransitionParams(0.6f, 1.0f, 1.0f, 1.0f);
+        auto linearParams = MakeTransitionParams(0.6f, 1.0f, 1.0f, 0.0f);
+
+        // a_params null for the stepper
+        auto frame = [&](std::vector<CrowdFace>& a_crowd, const TransitionParams* a_params, std::uint32_t a_frame) {
+            FaceUpdateContext context;
+            context.timeDelta = 1.0f / 60.0f;
+            context.speed = 0.75f;
+            context.animationStep = context.timeDelta / context.speed;
+            context.transitionParams = a_params;
+
+            for (std::size_t i = 0; i < a_crowd.size(); ++i) {
+                auto& face = a_crowd[i];
+                auto set = (a_frame + i) / 60 % 2;
+                context.transition = a_params ? &face.transition : nullptr;
+
+                if (set != face.set) {
+                    face.set = set;
+                    face.transition.Written();
+                }
+
+                for (std::size_t layer = 0; layer < kLayers.size(); ++layer) {
+                    SmoothMerge(context, kLayers[layer], { face.dialogue[layer].data(), kLayerCounts[layer] }, { face.targets[layer][set].data(), kLayerCounts[layer] },
+                        { face.values[layer].data(), kLayerCounts[layer] });
+                }
+            }
+        };
+
+        double stepperNs = 0.0;
+        double plannedNs = 0.0;
+        double linearNs = 0.0;
+
+        for (std::uint32_t i = 0; i < a_frames; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            frame(stepped, nullptr, i);
+            auto middle = std::chrono::steady_clock::now();
+            frame(planned, &params, i);
+            auto last = std::chrono::steady_clock::now();
+            frame(linear, &linearParams, i);
+            auto end = std::chrono::steady_clock::now();
+
+            stepperNs += std::chrono::duration<double, std::nano>(middle - start).count();
+            plannedNs += std::chrono::duration<double, std::nano>(last - middle).count();
+            linearNs += std::chrono::duration<double, std::nano>(end - last).count();
+        }
+
+        // all ways end up on the same targets once the last change had time to settle, the plans arrived by then
+        for (std::uint32_t i = 0; i < 120; ++i) {
+            frame(stepped, nullptr, a_frames);
+            frame(planned, &params, a_frames);
+            frame(linear, &linearParams, a_frames);
+        }
+
+        auto steps = static_cast<double>(a_frames) * static_cast<double>(a_faces);
+        result.stepperNs = stepperNs / steps;
+        result.plannedNs = plannedNs / steps;
+        result.linearNs = linearNs / steps;
+
+        for (std::size_t i = 0; i < a_faces; ++i) {
+            result.identical = result.identical && std::memcmp(&stepped[i].values, &planned[i].values, sizeof(stepped[i].values)) == 0 &&
+                               std::memcmp(&stepped[i].values, &linear[i].values, sizeof(stepped[i].values)) == 0 && !linear[i].transition.Moving();
+        }
+
+        return result;
+    }
+
+    struct SnapshotResult
+    {
+        double publishNs{ 0.0 };  // per publish, one thread
+        double idleNs{ 0.0 };     // per publish of what the face published last
+        double readNs{ 0.0 };     // per read, one thread
+        double lockedNs{ 0.0 };   // per read with a lock per face around a plain copy instead, like reading under the face lock
+        double retries{ 0.0 };    // per read under stress, reads started over because a publish was under way
+        bool identical{ true };
+    };
+
+    // the n-th publish of a face has every value n, the counts n mod 256 and dialogue set for odd n,
+    // so a read that mixes two publishes or goes back in time is caught
+    FaceSnapshot MakeStressSnapshot(std::uint32_t a_publish)
+    {
+        FaceSnapshot snapshot;
+        auto value = static_cast<float>(a_publish);
+
+        for (std::size_t layer = 0; layer < FaceSnapshot::kLayers; ++layer) {
+            snapshot.expressions[layer].fill(value);
+            snapshot.modifiers[layer].fill(value);
+            snapshot.phonemes[layer].fill(value);
+            snapshot.expressionCount[layer] = static_cast<std::uint8_t>(a_publish);
+            snapshot.modifierCount[layer] = static_cast<std::uint8_t>(a_publish);
+            snapshot.phonemeCount[layer] = static_cast<std::uint8_t>(a_publish);
+        }
+
+        snapshot.dialogue = a_publish & 1;
+
+        return snapshot;
+    }
+
+    bool IsStressSnapshot(const FaceSnapshot& a_snapshot, std::uint32_t a_publish)
+    {
+        auto expected = MakeStressSnapshot(a_publish);
+        return std::memcmp(&a_snapshot, &expected, sizeof(FaceSnapshot)) == 0;
+    }
+
+    // the board's bookkeeping, then a_writers threads publishing their faces over and over, face 0 every other time,
+    // while a_readers threads read a_reads snapshots each, every other one of face 0;
+    // timed on one thread, the stress numbers depend on how many cores there are to race on
+    SnapshotResult RunSnapshots(std::size_t a_faces, std::size_t a_writers, std::size_t a_readers, std::uint32_t a_reads)
+    {
+        SnapshotResult result;
+
+        auto faceKey = [](std::size_t a_face) { return (a_face + 1) * 0x230; };
+
+        // a face has no snapshot until it publishes and none after it's erased
+        {
+            SnapshotBoard board;
+            FaceSnapshot snapshot;
+            std::uint32_t version = 0;
+
+            result.identical = result.identical && !board.Read(faceKey(0), snapshot);
+
+            board.Publish(faceKey(0), MakeStressSnapshot(1));
+            board.Publish(faceKey(0), MakeStressSnapshot(2));
+            result.identical = result.identical && board.Read(faceKey(0), snapshot, &version) && version == 2 && IsStressSnapshot(snapshot, 2);
+
+            result.identical = result.identical && board.Erase(faceKey(0)) && !board.Read(faceKey(0), snapshot) && board.Size() == 0;
+
+            // faces that stop publishing are dropped once a shard is over its cap, the ones still publishing stay
+            for (std::size_t face = 0; face < SnapshotBoard::kShards * SnapshotBoard::kMaxPerShard * 4; ++face) {
+                board.Publish(faceKey(face), MakeStressSnapshot(1));
+                board.Publish(faceKey(0), MakeStressSnapshot(static_cast<std::uint32_t>(face + 1)));
+            }
+
+            result.identical = result.identical && board.Size() <= SnapshotBoard::kShards * (SnapshotBoard::kMaxPerShard + 1) && board.Read(faceKey(0), snapshot);
+        }
+
+        SnapshotBoard board;
+        std::atomic<std::size_t> reading{ a_readers };
+        std::atomic<bool> torn{ false };
+
+        std::vector<std::thread> threads;
+
+        // a writer per face like the face lock has it; stops short of 2^24, past it the values can't hold the count exactly
+        for (std::size_t writer = 0; writer < a_writers; ++writer) {
+            threads.emplace_back([&, writer]() {
+                std::vector<std::uint32_t> counts(a_faces, 0);
+                std::size_t next = writer;
+
+                for (std::uint64_t i = 0; reading.load(std::memory_order_acquire) && counts[0] < (1u << 23); ++i) {
+                    auto face = writer == 0 && i % 2 ? 0 : next;
+
+                    if (face == next) {
+                        next = next + a_writers < a_faces ? next + a_writers : writer;
+                    }
+
+                    board.Publish(faceKey(face), MakeStressSnapshot(++counts[face]));
+                }
+            });
+        }
+
+        // versions never go back and every read is one publish, whole
+        for (std::size_t reader = 0; reader < a_readers; ++reader) {
+            threads.emplace_back([&, reader]() {
+                std::vector<std::uint32_t> seen(a_faces, 0);
+                Rng rng(Rng::kDefaultSeed, reader);
+                FaceSnapshot snapshot;
+
+                for (std::uint32_t i = 0; i < a_reads; ++i) {
+                    auto face = i % 2 ? 0 : rng.Next() % a_faces;
+                    std::uint32_t version = 0;
+
+                    if (board.Read(faceKey(face), snapshot, &version)) {
+                        if (version < seen[face] || !IsStressSnapshot(snapshot, version)) {
+                            torn.store(true, std::memory_order_relaxed);
+                        }
+
+                        seen[face] = version;
+                    }
+                }
+
+                reading.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        result.retries = static_cast<double>(board.Retries()) / (static_cast<double>(a_reads) * static_cast<double>(a_readers));
+        result.identical = result.identical && !torn.load();
+
+        std::vector<FaceSnapshot> snapshots;
+        for (std::uint32_t i = 0; i < 64; ++i) {
+            snapshots.push_back(MakeStressSnapshot(i + 1));
+        }
+
+        SnapshotBoard timed;
+        std::vector<std::mutex> locks(a_faces);
+        std::vector<FaceSnapshot> copies(a_faces);
+        FaceSnapshot snapshot;
+        std::uint64_t sum = 0;
+
+        // 64 snapshots over a_faces faces, a face gets a different one every time
+        auto start = std::chrono::steady_clock::now();
+        for (std::uint32_t i = 0; i < a_reads; ++i) {
+            result.identical = result.identical && timed.Publish(faceKey(i % a_faces), snapshots[i % snapshots.size()]);
+        }
+        auto middle = std::chrono::steady_clock::now();
+
+        for (std::size_t face = 0; face < a_faces; ++face) {
+            timed.Publish(faceKey(face), snapshots[0]);
+        }
+
+        auto idle = std::chrono::steady_clock::now();
+        for (std::uint32_t i = 0; i < a_reads; ++i) {
+            result.identical = result.identical && !timed.Publish(faceKey(i % a_faces), snapshots[0]);
+        }
+        auto read = std::chrono::steady_clock::now();
+        for (std::uint32_t i = 0; i < a_reads; ++i) {
+            timed.Read(faceKey(i * 7 % a_faces), snapshot);
+            sum += snapshot.phonemeCount[0];
+        }
+        auto end = std::chrono::steady_clock::now();
+        for (std::uint32_t i = 0; i < a_reads; ++i) {
+            std::lock_guard locker(locks[i * 7 % a_faces]);
+            snapshot = copies[i * 7 % a_faces];
+            sum += snapshot.phonemeCount[0];
+        }
+        auto locked = std::chrono::steady_clock::now();
+
+        result.publishNs = std::chrono::duration<double, std::nano>(middle - start).count() / a_reads;
+        result.idleNs = std::chrono::duration<double, std::nano>(read - idle).count() / a_reads;
+        result.readNs = std::chrono::duration<double, std::nano>(end - read).count() / a_reads;
+        result.lockedNs = std::chrono::duration<double, std::nano>(locked - end).count() / a_reads;
+        result.identical = result.identical && sum > 0;
+
+        return result;
+    }
+
+    struct StateResult
+    {
+        double stateNs{ 0.0 };    // per face, one GetExpressionState: the snapshot read and the array built
+        double getterNs{ 0.0 };   // per face, the 32 snapshot reads of a GetPhonemeModifier loop
+        bool identical{ true };
+    };
+
+    // layers with a different value in every channel, in steps of 0.01 like the Papyrus arrays;
+    // every layer of a_faces faces read as one array and as 32 single reads
+    StateResult RunExpressionState(std::size_t a_faces, std::uint32_t a_calls)
+    {
+        StateResult result;
+
+        auto faceKey = [](std::size_t a_face) { return (a_face + 1) * 0x230; };
+        auto value = [](std::size_t a_layer, std::size_t a_channel, std::size_t a_face) {
+            return static_cast<float>((a_layer * 53 + a_channel * 7 + a_face * 3) % 201) / 100.0f;
+        };
+
+        auto makeSnapshot = [&](std::size_t a_face) {
+            FaceSnapshot snapshot;
+            std::array<float, 32> channels;
+
+            for (std::size_t layer = 0; layer < FaceSnapshot::kLayers; ++layer) {
+                for (std::size_t i = 0; i < channels.size(); ++i) {
+                    channels[i] = value(layer, i, a_face);
+                }
+
+                FaceSnapshot::Copy({ channels.data(), Phoneme::Total }, snapshot.phonemes[layer], snapshot.phonemeCount[layer]);
+                FaceSnapshot::Copy({ channels.data(), Modifier::Total }, snapshot.modifiers[layer], snapshot.modifierCount[layer]);
+                FaceSnapshot::Copy({ channels.data(), Expression::Total }, snapshot.expressions[layer], snapshot.expressionCount[layer]);
+            }
+
+            return snapshot;
+        };
+
+        // what a layer has to read back as, worked out from the channel values
+        auto expected = [&](std::size_t a_face, SnapshotLayer a_layer) {
+            std::array<float, kPresetSize> values{};
+            auto layer = static_cast<std::size_t>(a_layer) - 1;
+            auto moods = a_layer == SnapshotLayer::Output ? 2 : 0;
+
+            for (std::size_t i = 0; i < Phoneme::Total; ++i) {
+                values[i] = value(layer, i, a_face);
+            }
+            for (std::size_t i = 0; i < kPresetModifiers; ++i) {
+                values[Phoneme::Total + i] = value(layer, i, a_face);
+            }
+
+            std::uint32_t expression = Expression::MoodNeutral;
+            for (std::uint32_t i = 0; i < Expression::Total; ++i) {
+                expression = value(moods, i, a_face) > value(moods, expression, a_face) ? i : expression;
+            }
+
+            values[30] = static_cast<float>(expression);
+            values[31] = value(moods, expression, a_face);
+
+            return values;
+        };
+
+        SnapshotBoard board;
+
+        for (std::size_t face = 0; face < a_faces; ++face) {
+            board.Publish(faceKey(face), makeSnapshot(face));
+        }
+
+        for (std::size_t face = 0; face < a_faces; ++face) {
+            FaceSnapshot snapshot;
+            result.identical = result.identical && board.Read(faceKey(face), snapshot);
+
+            for (auto layer : { SnapshotLayer::Dialogue, SnapshotLayer::Script, SnapshotLayer::Output }) {
+                auto values = ToPreset(snapshot, layer);
+                result.identical = result.identical && values == expected(face, layer);
+
+                // applying what was read sets the same 0 - 200 values again
+                auto preset = MakePreset(values, false, {});
+                result.identical = result.identical && preset && preset->expression == static_cast<std::uint32_t>(values[30]) &&
+                                   preset->expressionValue == std::lround(values[31] * 100.0f);
+
+                for (std::size_t i = 0; preset && i < Phoneme::Total; ++i) {
+                    result.identical = result.identical && preset->phonemes[i] == std::lround(values[i] * 100.0f);
+                }
+                for (std::size_t i = 0; preset && i < kPresetModifiers; ++i) {
+                    result.identical = result.identical && preset->modifiers[i] == std::lround(values[Phoneme::Total + i] * 100.0f);
+                }
+
+                // and a captured preset holds it in its steps of 0.01
+                result.identical = result.identical && Unpack(Pack(values)) == values;
+            }
+        }
+
+        // keyframes narrower than the layout read 0 past their count, no moods at all read as neutral at 0
+        {
+            FaceSnapshot snapshot;
+            std::array<float, 8> channels;
+            channels.fill(0.5f);
+
+            FaceSnapshot::Copy({ channels.data(), channels.size() }, snapshot.phonemes[1], snapshot.phonemeCount[1]);
+            FaceSnapshot::Copy({ channels.data(), channels.size() }, snapshot.modifiers[1], snapshot.modifierCount[1]);
+
+            auto values = ToPreset(snapshot, SnapshotLayer::Script);
+
+            for (std::size_t i = 0; i < Phoneme::Total; ++i) {
+                result.identical = result.identical && values[i] == (i < channels.size() ? 0.5f : 0.0f);
+                result.identical = result.identical && values[Phoneme::Total + i % kPresetModifiers] == (i % kPresetModifiers < channels.size() ? 0.5f : 0.0f);
+            }
+
+            result.identical = result.identical && values[30] == static_cast<float>(Expression::MoodNeutral) && values[31] == 0.0f;
+        }
+
+        double stateNs = 0.0;
+        double getterNs = 0.0;
+        float sum = 0.0f;
+
+        for (std::uint32_t call = 0; call < a_calls; ++call) {
+            auto face = faceKey(call % a_faces);
+            FaceSnapshot snapshot;
+
+            auto start = std::chrono::steady_clock::now();
+            {
+                board.Read(face, snapshot);
+                auto values = ToPreset(snapshot, SnapshotLayer::Script);
+                std::vector<float> array(values.begin(), values.end());
+                sum += array[call % kPresetSize];
+            }
+            auto middle = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < kPresetSize; ++i) {
+                board.Read(face, snapshot);
+                sum += snapshot.phonemes[1][i % Phoneme::Total];
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            stateNs += std::chrono::duration<double, std::nano>(middle - start).count();
+            getterNs += std::chrono::duration<double, std::nano>(end - middle).count();
+        }
+
+        result.stateNs = stateNs / a_calls;
+        result.getterNs = getterNs / a_calls;
+        result.identical = result.identical && sum > 0.0f;
+
+        return result;
+    }
+
+    struct UnlockedResult
+    {
+        double lockedNs{ 0.0 };    // per face, the lock held for the whole update
+        double heldNs{ 0.0 };      // per face, the lock held to copy the face out and write the result back
+        double unlockedNs{ 0.0 };  // per face, copy, update and write back
+        std::uint64_t conflicts{ 0 };
+        bool identical{ true };
+    };
+
+    // a BenchFace as the plugin copies BSFaceGenAnimationData out, its only timer is the blink value;
+    // the layer 1 steps run on the face first, as the plugin runs them under the lock, returns whether layer 1 moved
+    bool LoadScratch(BenchFace& a_face, float a_timeDelta, ScratchFace::State& a_state)
+    {
+        auto moved = a_face.TransitionUpdate(a_timeDelta);
+        a_face.DialogueModifiersUpdate(a_timeDelta);
+        a_face.DialoguePhonemesUpdate(a_timeDelta);
+
+        for (std::size_t i = 0; i < ScratchFace::kLayers; ++i) {
+            auto values = a_face.Values(static_cast<Layer>(i));
+            auto& layer = a_state.layers[i];
+
+            layer.count = static_cast<std::uint32_t>(values.size());
+            layer.timer = static_cast<Layer>(i) == Layer::Modifier2 ? a_face.BlinkValue() : 0.0f;
+            std::copy(values.begin(), values.end(), layer.values.begin());
+        }
+
+        a_state.eyes = a_face.GetEyesState();
+
+        return moved;
+    }
+
+    // returns the conflicts
+    std::uint32_t StoreScratch(BenchFace& a_face, const ScratchFace& a_scratch)
+    {
+        ScratchFace::View current;
+        for (std::size_t i = 0; i < ScratchFace::kLayers; ++i) {
+            current[i] = { a_face.Values(static_cast<Layer>(i)), static_cast<Layer>(i) == Layer::Modifier2 ? a_face.BlinkValue() : 0.0f };
+        }
+
+        auto plan = a_scratch.Plan(current, a_face.GetEyesState());
+
+        for (std::size_t i = 0; i < ScratchFace::kLayers; ++i) {
+            auto& result = a_scratch.Output().layers[i];
+
+            if (plan.values & (1u << i)) {
+                std::copy_n(result.values.begin(), result.count, a_face.Values(static_cast<Layer>(i)).begin());
+            }
+            if ((plan.timers & (1u << i)) && static_cast<Layer>(i) == Layer::Modifier2) {
+                a_face.BlinkValue() = result.timer;
+            }
+        }
+
+        if (plan.values & ScratchFace::kEyes) {
+            a_face.SetEyesState(a_scratch.Output().eyes);
+        }
+
+        return static_cast<std::uint32_t>(std::popcount(plan.conflicts));
+    }
+
+    // a_faces updated in place and on a copy in lockstep, alive and dead, smooth and regular, with a script
+    // changing phonemes and squints between frames; both have to stay bitwise equal
+    UnlockedResult RunUnlocked(std::size_t a_faces, std::uint32_t a_frames)
+    {
+        UnlockedResult result;
+
+        auto script = [](BenchFace& a_face, std::size_t a_index, std::uint32_t a_frame) {
+            if ((a_frame + a_index) % 30 == 0) {
+                a_face.Values(Layer::Phoneme2)[a_index % Phoneme::Total] = static_cast<float>(a_frame % 100) / 100.0f;
+                a_face.Values(Layer::Modifier2)[Modifier::SquintLeft] = static_cast<float>(a_frame % 7) / 10.0f;
+            }
+        };
+
+        for (auto smooth : { true, false }) {
+            std::vector<BenchFace> locked;
+            std::vector<Rng> lockedRngs;
+
+            for (std::size_t i = 0; i < a_faces; ++i) {
+                locked.push_back(MakeFace(i, i % 5 == 0));
+                lockedRngs.emplace_back(Rng::kDefaultSeed, i);
+            }
+
+            auto unlocked = locked;
+            auto unlockedRngs = lockedRngs;
+            ScratchFace scratch;
+
+            double lockedNs = 0.0;
+            double heldNs = 0.0;
+            double unlockedNs = 0.0;
+
+            for (std::uint32_t frame = 0; frame < a_frames; ++frame) {
+                for (std::size_t i = 0; i < a_faces; ++i) {
+                    script(locked[i], i, frame);
+                    script(unlocked[i], i, frame);
+
+                    auto context = MakeContext(smooth);
+
+                    context.rng = &lockedRngs[i];
+                    auto start = std::chrono::steady_clock::now();
+                    if (smooth) {
+                        SmoothUpdate(locked[i], context);
+                    } else {
+                        RegularUpdate(locked[i], context);
+                    }
+                    auto middle = std::chrono::steady_clock::now();
+
+                    context = MakeContext(smooth);
+                    context.rng = &unlockedRngs[i];
+
+                    auto moved = LoadScratch(unlocked[i], context.timeDelta, scratch.Input());
+                    auto loaded = std::chrono::steady_clock::now();
+                    scratch.Begin(unlocked[i].Hold(), unlocked[i].Dialogue(), moved);
+                    if (smooth) {
+                        SmoothUpdate(scratch, context);
+                    } else {
+                        RegularUpdate(scratch, context);
+                    }
+                    scratch.End();
+                    auto updated = std::chrono::steady_clock::now();
+                    result.conflicts += StoreScratch(unlocked[i], scratch);
+                    auto end = std::chrono::steady_clock::now();
+
+                    lockedNs += std::chrono::duration<double, std::nano>(middle - start).count();
+                    heldNs += std::chrono::duration<double, std::nano>((loaded - middle) + (end - updated)).count();
+                    unlockedNs += std::chrono::duration<double, std::nano>(end - middle).count();
+                }
+
+                result.identical = result.identical && locked == unlocked;
+            }
+
+            result.lockedNs += lockedNs / (2.0 * a_frames * a_faces);
+            result.heldNs += heldNs / (2.0 * a_frames * a_faces);
+            result.unlockedNs += unlockedNs / (2.0 * a_frames * a_faces);
+        }
+
+        // nobody wrote while the copies were out
+        result.identical = result.identical && result.conflicts == 0;
+
+        // a script write landing while the copy is out: a channel the update doesn't produce keeps the script's value and
+        // the update's blink and eyes still go in, an output channel the update also wrote keeps the other writer's value
+        for (auto smooth : { true, false }) {
+            auto face = MakeFace(1, false);
+            Rng rng(Rng::kDefaultSeed, 1);
+            ScratchFace scratch;
+
+            // blinking, so the update moves the blink value
+            auto eyes = face.GetEyesState();
+            eyes.blinkStage = BlinkStage::BlinkDown;
+            face.SetEyesState(eyes);
+
+            auto context = MakeContext(smooth);
+            context.rng = &rng;
+
+            auto moved = LoadScratch(face, context.timeDelta, scratch.Input());
+            scratch.Begin(face.Hold(), face.Dialogue(), moved);
+            if (smooth) {
+                SmoothUpdate(scratch, context);
+            } else {
+                RegularUpdate(scratch, context);
+            }
+            scratch.End();
+
+            face.Values(Layer::Modifier2)[Modifier::SquintRight] = 0.75f;
+            face.Values(Layer::Modifier3)[Modifier::SquintRight] = 0.5f;
+
+            auto conflicts = StoreScratch(face, scratch);
+            auto stored = face.GetEyesState();
+
+            result.identical = result.identical && conflicts == 1 &&
+                               face.Values(Layer::Modifier2)[Modifier::SquintRight] == 0.75f &&
+                               face.Values(Layer::Modifier3)[Modifier::SquintRight] == 0.5f &&
+                               face.BlinkValue() == scratch.Output()[Layer::Modifier2].timer && (!smooth || face.BlinkValue() != 0.0f) &&
+                               std::memcmp(&stored, &scratch.Output().eyes, sizeof(EyesState)) == 0 &&
+                               face.Values(Layer::Expression3)[Expression::MoodHappy + 1] == scratch.Output()[Layer::Expression3].values[Expression::MoodHappy + 1];
+        }
+
+        return result;
+    }
+
+    struct SpeedResult
+    {
+        double tableNs{ 0.0 };  // per read, a_readers threads reading while a_writers threads write
+        double mapNs{ 0.0 };    // per read of an unordered_map behind a mutex, the same load
+        std::uint64_t evictedLRU{ 0 };
+        bool identical{ true };
+    };
+
+    // a_faces faces read once a frame by a_readers update threads while a_writers threads keep setting, clearing
+    // and unloading speeds of a crowd twice the table's cap; every face has one speed, so any other value read is torn
+    SpeedResult RunSpeeds(std::size_t a_faces, std::size_t a_writers, std::size_t a_readers, std::uint32_t a_reads)
+    {
+        SpeedResult result;
+
+        auto faceKey = [](std::size_t a_face) { return (a_face + 1) * 0x230; };
+        auto faceSpeed = [](std::uintptr_t a_key) { return static_cast<float>(a_key % 997 + 1) * 0.01f; };
+        auto crowd = SpeedTable::kMaxEntries * 2;
+
+        auto run = [&](auto& a_set, auto& a_get) {
+            std::atomic<std::size_t> reading{ a_readers };
+            std::atomic<bool> torn{ false };
+            std::atomic<std::int64_t> readNs{ 0 };
+            std::vector<std::thread> threads;
+
+            for (std::size_t writer = 0; writer < a_writers; ++writer) {
+                threads.emplace_back([&, writer]() {
+                    Rng rng(Rng::kDefaultSeed, writer);
+                    auto owner = static_cast<std::uint32_t>(writer + 1);
+
+                    for (std::uint64_t i = 0; reading.load(std::memory_order_acquire); ++i) {
+                        auto key = faceKey(rng.Next() % crowd);
+                        a_set(key, owner, i % 1000 == 999 ? -1.0f : rng.Next() % 4 ? faceSpeed(key) : 0.0f);
+                        std::this_thread::yield();
+                    }
+                });
+            }
+
+            for (std::size_t reader = 0; reader < a_readers; ++reader) {
+                threads.emplace_back([&, reader]() {
+                    std::uint32_t epoch = 0;
+                    std::uint32_t read = 0;
+
+                    auto start = std::chrono::steady_clock::now();
+                    while (read < a_reads) {
+                        ++epoch;
+                        for (std::size_t face = reader; face < a_faces && read < a_reads; face += a_readers, ++read) {
+                            auto key = faceKey(face);
+                            auto speed = a_get(key, epoch);
+                            if (speed != -1.0f && speed != faceSpeed(key)) {
+                                torn.store(true, std::memory_order_relaxed);
+                            }
+                        }
+                    }
+                    auto end = std::chrono::steady_clock::now();
+
+                    readNs += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                    reading.fetch_sub(1, std::memory_order_release);
+                });
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            result.identical = result.identical && !torn.load();
+
+            return static_cast<double>(readNs.load()) / (static_cast<double>(a_reads) * static_cast<double>(a_readers));
+        };
+
+        {
+            auto table = std::make_unique<SpeedTable>();
+
+            // -1 unloads the owner
+            auto set = [&](std::uintptr_t a_key, std::uint32_t a_owner, float a_speed) {
+                if (a_speed < 0.0f) {
+                    table->EraseOwner(a_owner);
+                } else {
+                    table->Set(a_key, a_owner, a_speed);
+                }
+            };
+            auto get = [&](std::uintptr_t a_key, std::uint32_t a_epoch) {
+                table->Tick(a_epoch);
+                return table->Get(a_key, -1.0f);
+            };
+
+            result.tableNs = run(set, get);
+
+            auto stats = table->GetStats();
+            result.evictedLRU = stats.evictedLRU;
+            result.identical = result.identical && stats.size <= SpeedTable::kMaxEntries &&
+                               stats.hits + stats.misses == static_cast<std::uint64_t>(a_reads) * a_readers;
+        }
+
+        {
+            std::mutex lock;
+            std::unordered_map<std::uintptr_t, std::pair<std::uint32_t, float>> map;
+
+            auto set = [&](std::uintptr_t a_key, std::uint32_t a_owner, float a_speed) {
+                std::lock_guard locker(lock);
+                if (a_speed < 0.0f) {
+                    std::erase_if(map, [&](auto& a_entry) { return a_entry.second.first == a_owner; });
+                } else if (a_speed == 0.0f) {
+                    map.erase(a_key);
+                } else {
+                    map[a_key] = { a_owner, a_speed };
+                }
+            };
+            auto get = [&](std::uintptr_t a_key, std::uint32_t) {
+                std::lock_guard locker(lock);
+                auto entry = map.find(a_key);
+                return entry != map.end() ? entry->second.second : -1.0f;
+            };
+
+            result.mapNs = run(set, get);
+        }
+
+        return result;
+    }
+
+    struct DrawResult
+    {
+        double randNs{ 0.0 };   // per draw, std::rand and pow
+        double curveNs{ 0.0 };  // per draw, Rng and PowerCurve
+        double distance{ 0.0 };  // largest gap between the two cdfs
+        bool identical{ true };
+    };
+
+    // a_draws delays drawn for each exponent the default profiles use, and one read from a table
+    DrawResult RunDraws(std::uint32_t a_draws)
+    {
+        DrawResult result;
+
+        for (auto exponent : { 1.0f, 2.0f, 0.5f, 3.5f }) {
+            std::vector<float> before(a_draws);
+            std::vector<float> after(a_draws);
+
+            std::srand(1);
+            auto start = std::chrono::steady_clock::now();
+            for (auto& draw : before) {
+                draw = 0.5f + 3.5f * std::pow(static_cast<float>(std::rand()) / RAND_MAX, exponent);
+            }
+            auto middle = std::chrono::steady_clock::now();
+
+            Rng rng{ Rng::kDefaultSeed };
+            PowerCurve curve{ exponent };
+            for (auto& draw : after) {
+                draw = Random(rng, 0.5f, 4.0f, curve);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            result.randNs += std::chrono::duration<double, std::nano>(middle - start).count();
+            result.curveNs += std::chrono::duration<double, std::nano>(end - middle).count();
+
+            std::sort(before.begin(), before.end());
+            std::sort(after.begin(), after.end());
+
+            std::size_t i = 0;
+            std::size_t j = 0;
+            while (i < before.size() && j < after.size()) {
+                auto x = std::min(before[i], after[j]);
+                while (i < before.size() && before[i] == x) {
+                    ++i;
+                }
+                while (j < after.size() && after[j] == x) {
+                    ++j;
+                }
+                result.distance = std::max(result.distance, std::abs(static_cast<double>(i) - static_cast<double>(j)) / a_draws);
+            }
+        }
+
+        result.randNs /= a_draws * 4.0;
+        result.curveNs /= a_draws * 4.0;
+        // two sample sets of one distribution are this far apart less than once in a thousand runs
+        result.identical = result.distance < 1.95 * std::sqrt(2.0 / a_draws);
+
+        return result;
+    }
+}
+
+int main(int a_argc, char** a_argv)
+{
+    std::size_t faces = 50;
+    std::uint32_t frames = 20000;
+
+    for (int i = 1; i + 1 < a_argc; i += 2) {
+        std::string_view arg{ a_argv[i] };
+        if (arg == "--faces") {
+            faces = static_cast<std::size_t>(std::max(1l, std::strtol(a_argv[i + 1], nullptr, 10)));
+        } else if (arg == "--frames") {
+            frames = static_cast<std::uint32_t>(std::max(1l, std::strtol(a_argv[i + 1], nullptr, 10)));
+        }
+    }
+
+    for (auto& params : eyesOffset) {
+        params = { -0.1f, 0.1f, -0.05f, 0.05f, 0.5f, 4.0f, 1.0f, 0.0f, PowerCurve(1.0f) };
+    }
+
+    std::printf("%zu faces, %u frames, kernels %s\n", faces, frames, ToString(SelectKernels()));
+    std::printf("%-16s %12s %12s %8s\n", "faces", "full ns", "idle ns", "saved");
+
+    auto failed = false;
+
+    for (auto dead : { false, true }) {
+        for (auto smooth : { true, false }) {
+            auto result = Run(faces, dead, smooth, frames);
+            char name[32];
+            std::snprintf(name, sizeof(name), "%s %s", dead ? "dead" : "idle", smooth ? "smooth" : "regular");
+
+            std::printf("%-16s %12.0f %12.0f %7.1f%%%s\n", name, result.fullNs, result.idleNs,
+                100.0 * (1.0 - result.idleNs / std::max(1.0, result.fullNs)), result.identical ? "" : "  DIFFERENT OUTPUT");
+
+            failed = failed || !result.identical;
+        }
+    }
+
+    std::printf("\n%-16s %12s %12s %8s\n", "update context", "per call ns", "context ns", "saved");
+
+    auto context = RunContext(faces, frames);
+
+    std::printf("%-16s %12.1f %12.1f %7.1f%%%s\n", "per face", context.perCallNs, context.contextNs,
+        100.0 * (1.0 - context.contextNs / std::max(1e-9, context.perCallNs)), context.identical ? "" : "  DIFFERENT OUTPUT");
+
+    failed = failed || !context.identical;
+
+    std::printf("\n%-16s %12s %12s %8s\n", "merge kernels", "lambda ns", "kernel ns", "saved");
+
+    for (auto [name, width, modifiers] : { std::tuple<const char*, std::size_t, bool>{ "phonemes", Phoneme::Total, false }, { "modifiers", Modifier::Total, true }, { "custom", 8, false } }) {
+        auto result = RunMerge(faces, width, modifiers, frames);
+
+        std::printf("%-16s %12.1f %12.1f %7.1f%%%s\n", name, result.lambdaNs, result.kernelNs,
+            100.0 * (1.0 - result.kernelNs / std::max(0.001, result.lambdaNs)), result.identical ? "" : "  DIFFERENT OUTPUT");
+
+        failed = failed || !result.identical;
+    }
+
+    std::printf("\n%-16s %12s %12s %8s  faces per band\n", "level of detail", "ns", "updates", "saved");
+
+    auto full = RunLod(faces, LodPolicy{}, frames);
+
+    for (auto* policy : { "off", "defaults" }) {
+        auto result = policy[0] == 'o' ? full : RunLod(faces, MakeLodPolicy(), frames);
+
+        std::printf("%-16s %12.0f %12.1f %7.1f%%  %zu %zu %zu %zu%s\n", policy, result.ns, result.updates,
+            100.0 * (1.0 - result.ns / std::max(1.0, full.ns)),
+            result.bands[0], result.bands[1], result.bands[2], result.bands[3], result.timeKept ? "" : "  TIME LOST");
+
+        failed = failed || !result.timeKept;
+    }
+
+    std::printf("\n%-16s %12s %12s %8s %12s %12s %8s\n", "frame budget", "us/frame", "updates", "overrun", "fewest runs", "most runs", "max wait");
+
+    for (auto us : { 0, 2000, 1000, 500 }) {
+        auto result = RunBudget(faces * 4, static_cast<std::uint64_t>(us) * 1000, frames);
+        char name[32];
+        std::snprintf(name, sizeof(name), us ? "%d us" : "unlimited", us);
+
+        auto fair = result.maxWait <= FrameBudget::kMaxWait && result.priorityRan && result.timeKept;
+
+        std::printf("%-16s %12.0f %12.1f %7.1f%% %12llu %12llu %8llu%s\n", name, result.spent / 1000.0, result.updates, result.overruns,
+            static_cast<unsigned long long>(result.minRuns), static_cast<unsigned long long>(result.maxRuns), static_cast<unsigned long long>(result.maxWait),
+            fair ? "" : "  BROKEN");
+
+        failed = failed || !fair;
+    }
+
+    std::printf("\n%-16s %12s %12s %8s\n", "preset to crowd", "single ns", "batch ns", "saved");
+
+    auto broadcast = RunBroadcast(faces, std::max(1u, frames / 10));
+
+    std::printf("%-16s %12.1f %12.1f %7.1f%%%s\n", "per actor", broadcast.singleNs, broadcast.broadcastNs,
+        100.0 * (1.0 - broadcast.broadcastNs / std::max(1e-9, broadcast.singleNs)), broadcast.identical ? "" : "  DIFFERENT OUTPUT");
+
+    failed = failed || !broadcast.identical;
+
+    std::printf("\n%-16s %12s %12s %8s %12s %12s\n", "command queue", "queue ns", "task ns", "merged", "unchanged", "ring full");
+
+    for (auto senders : { 1, 4 }) {
+        auto result = RunCommands(faces, senders, 2, frames * 50);
+        char name[32];
+        std::snprintf(name, sizeof(name), "%d sender%s", senders, senders > 1 ? "s" : "");
+
+        std::printf("%-16s %12.1f %12.1f %7.1f%% %11.1f%% %12llu%s\n", name, result.queueNs, result.taskNs, result.coalesced, result.dropped,
+            static_cast<unsigned long long>(result.overflows), result.identical ? "" : "  DIFFERENT OUTPUT");
+
+        failed = failed || !result.identical;
+    }
+
+    std::printf("\n%-16s %12s %12s %12s\n", "named presets", "parse ns", "cache ns", "lookup ns");
+
+    auto presets = RunPresets(faces * 20, frames * 50);
+
+    std::printf("%-16s %12.1f %12.1f %12.1f%s\n", "per preset", presets.parseNs, presets.cacheNs, presets.lookupNs, presets.identical ? "" : "  BROKEN");
+
+    failed = failed || !presets.identical;
+
+    std::printf("\n%-16s %12s %12s\n", "sequences", "step ns", "writes");
+
+    auto sequences = RunSequences(faces, frames);
+
+    std::printf("%-16s %12.1f %12.1f%s\n", "per face", sequences.stepNs, sequences.writes, sequences.identical ? "" : "  BROKEN");
+
+    failed = failed || !sequences.identical;
+
+    std::printf("\n%-16s %12s %12s %8s %12s %12s %12s\n", "transitions", "stepper ns", "planned ns", "saved", "linear ns", "step spread", "plan spread");
+
+    auto transitions = RunTransitions(faces, frames);
+
+    std::printf("%-16s %12.1f %12.1f %7.1f%% %12.1f %12u %12u%s\n", "per face", transitions.stepperNs, transitions.plannedNs,
+        100.0 * (1.0 - transitions.plannedNs / std::max(1e-9, transitions.stepperNs)), transitions.linearNs, transitions.stepperSpread, transitions.plannedSpread,
+        transitions.identical ? "" : "  BROKEN");
+
+    failed = failed || !transitions.identical;
+
+    std::printf("\n%-16s %12s %12s %12s %12s %12s\n", "snapshots", "publish ns", "idle ns", "read ns", "locked ns", "retries");
+
+    auto snapshots = RunSnapshots(faces, 2, 4, frames * 50);
+
+    std::printf("%-16s %12.1f %12.1f %12.1f %12.1f %12.3f%s\n", "per call", snapshots.publishNs, snapshots.idleNs, snapshots.readNs, snapshots.lockedNs, snapshots.retries,
+        snapshots.identical ? "" : "  BROKEN");
+
+    failed = failed || !snapshots.identical;
+
+    std::printf("\n%-16s %12s %12s\n", "expression state", "state ns", "getters ns");
+
+    auto state = RunExpressionState(faces, frames * 10);
+
+    std::printf("%-16s %12.1f %12.1f%s\n", "per face", state.stateNs, state.getterNs, state.identical ? "" : "  BROKEN");
+
+    failed = failed || !state.identical;
+
+    std::printf("\n%-16s %12s %12s %12s %12s\n", "unlocked update", "locked ns", "held ns", "unlocked ns", "conflicts");
+
+    auto unlocked = RunUnlocked(faces, frames / 4);
+
+    std::printf("%-16s %12.1f %12.1f %12.1f %12llu%s\n", "per face", unlocked.lockedNs, unlocked.heldNs, unlocked.unlockedNs,
+        static_cast<unsigned long long>(unlocked.conflicts), unlocked.identical ? "" : "  DIFFERENT OUTPUT");
+
+    failed = failed || !unlocked.identical;
+
+    std::printf("\n%-16s %12s %12s %8s %12s\n", "speed table", "table ns", "map ns", "saved", "evicted");
+
+    auto speeds = RunSpeeds(faces, 2, 4, frames * 50);
+
+    std::printf("%-16s %12.1f %12.1f %7.1f%% %12llu%s\n", "per read", speeds.tableNs, speeds.mapNs,
+        100.0 * (1.0 - speeds.tableNs / std::max(1e-9, speeds.mapNs)), static_cast<unsigned long long>(speeds.evictedLRU),
+        speeds.identical ? "" : "  BROKEN");
+
+    failed = failed || !speeds.identical;
+
+    std::printf("\n%-16s %12s %12s %8s %12s\n", "delay draws", "rand ns", "curve ns", "saved", "distance");
+
+    auto draws = RunDraws(std::max(1000u, frames * 5));
+
+    std::printf("%-16s %12.1f %12.1f %7.1f%% %12.4f%s\n", "per draw", draws.randNs, draws.curveNs,
+        100.0 * (1.0 - draws.curveNs / std::max(1e-9, draws.randNs)), draws.distance, draws.identical ? "" : "  DIFFERENT DISTRIBUTION");
+
+    failed = failed || !draws.identical;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+#include "Blend.h"
+#include "Transition.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(MFGFIX_X64)
+#include <immintrin.h>
+#endif
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        using AnimMerge_t = void (*)(std::span<const float>, std::span<const float>, std::span<float>, float);
+
+        AnimMerge_t animMerge = Kernels::AnimMergeScalar;
+
+        void AnimMergeRange(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step, std::size_t a_begin, std::size_t a_end)
+        {
+            for (std::size_t i = a_begin; i < a_end; ++i) {
+                auto dialogue = i < a_dialogue.size() ? a_dialogue[i] : 0.0f;
+                if (i >= a_target.size() || (std::fabs(a_target[i]) < FLT_EPSILON && std::fabs(dialogue) > FLT_EPSILON)) {
+                    a_result[i] = dialogue;
+                } else if (std::fabs(a_result[i] - a_target[i]) < a_step) {
+                    a_result[i] = a_target[i];
+                } else {
+                    a_result[i] = a_result[i] + a_step * (a_target[i] > a_result[i] ? 1 : -1);
+                }
+            }
+        }
+
+        std::size_t AnimMergeCount(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result)
+        {
+            return std::min(std::max(a_dialogue.size(), a_target.size()), a_result.size());
+        }
+
+        // lanes where all three layers are present, the rest goes through the scalar path
+        std::size_t AnimMergeVectorCount(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result)
+        {
+            return std::min({ a_dialogue.size(), a_target.size(), a_result.size() });
+        }
+    }
+
+    void AnimMerge(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step)
+    {
+        animMerge(a_dialogue, a_target, a_result, a_step);
+    }
+
+    SimdLevel SelectKernels(SimdLevel a_max)
+    {
+        auto level = std::min(GetSupportedSimdLevel(), a_max);
+
+        switch (level) {
+        case SimdLevel::AVX2:
+            animMerge = Kernels::AnimMergeAVX2;
+            break;
+        case SimdLevel::SSE41:
+            animMerge = Kernels::AnimMergeSSE41;
+            break;
+        default:
+            animMerge = Kernels::AnimMergeScalar;
+            break;
+        }
+
+        Kernels::SelectTransitionKernels(level);
+
+        return level;
+    }
+
+    namespace Kernels
+    {
+        void AnimMergeScalar(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step)
+        {
+            AnimMergeRange(a_dialogue, a_target, a_result, a_step, 0, AnimMergeCount(a_dialogue, a_target, a_result));
+        }
+
+#if defined(MFGFIX_X64)
+        MFGFIX_TARGET("sse4.1")
+        void AnimMergeSSE41(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step)
+        {
+            const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const auto epsilon = _mm_set1_ps(FLT_EPSILON);
+            const auto step = _mm_set1_ps(a_step);
+            const auto negStep = _mm_set1_ps(a_step * -1);
+
+            auto vectorCount = AnimMergeVectorCount(a_dialogue, a_target, a_result) & ~std::size_t{ 3 };
+
+            for (std::size_t i = 0; i < vectorCount; i += 4) {
+                auto dialogue = _mm_loadu_ps(a_dialogue.data() + i);
+                auto target = _mm_loadu_ps(a_target.data() + i);
+                auto result = _mm_loadu_ps(a_result.data() + i);
+
+                auto useDialogue = _mm_and_ps(_mm_cmplt_ps(_mm_and_ps(target, absMask), epsilon), _mm_cmpgt_ps(_mm_and_ps(dialogue, absMask), epsilon));
+                auto snap = _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(result, target), absMask), step);
+                auto stepped = _mm_add_ps(result, _mm_blendv_ps(negStep, step, _mm_cmpgt_ps(target, result)));
+
+                result = _mm_blendv_ps(stepped, target, snap);
+                result = _mm_blendv_ps(result, dialogue, useDialogue);
+
+                _mm_storeu_ps(a_result.data() + i, result);
+            }
+
+            AnimMergeRange(a_dialogue, a_target, a_result, a_step, vectorCount, AnimMergeCount(a_dialogue, a_target, a_result));
+        }
+
+        MFGFIX_TARGET("avx2")
+        void AnimMergeAVX2(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step)
+        {
+            const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+            const auto epsilon = _mm256_set1_ps(FLT_EPSILON);
+            const auto step = _mm256_set1_ps(a_step);
+            const auto negStep = _mm256_set1_ps(a_step * -1);
+
+            auto vectorCount = AnimMergeVectorCount(a_dialogue, a_target, a_result) & ~std::size_t{ 7 };
+
+            for (std::size_t i = 0; i < vectorCount; i += 8) {
+                auto dialogue = _mm256_loadu_ps(a_dialogue.data() + i);
+                auto target = _mm256_loadu_ps(a_target.data() + i);
+                auto result = _mm256_loadu_ps(a_result.data() + i);
+
+                auto useDialogue = _mm256_and_ps(_mm256_cmp_ps(_mm256_and_ps(target, absMask), epsilon, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_and_ps(dialogue, absMask), epsilon, _CMP_GT_OQ));
+                auto snap = _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(result, target), absMask), step, _CMP_LT_OQ);
+                auto stepped = _mm256_add_ps(result, _mm256_blendv_ps(negStep, step, _mm256_cmp_ps(target, result, _CMP_GT_OQ)));
+
+                result = _mm256_blendv_ps(stepped, target, snap);
+                result = _mm256_blendv_ps(result, dialogue, useDialogue);
+
+                _mm256_storeu_ps(a_result.data() + i, result);
+            }
+
+            // 17 wide layers leave a 4 wide block and a single lane after the 8 wide loop
+            _mm256_zeroupper();
+            AnimMergeSSE41(a_dialogue.subspan(std::min(vectorCount, a_dialogue.size())), a_target.subspan(std::min(vectorCount, a_target.size())), a_result.subspan(vectorCount), a_step);
+        }
+#else
+        void AnimMergeSSE41(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step)
+        {
+            AnimMergeScalar(a_dialogue, a_target, a_result, a_step);
+        }
+
+        void AnimMergeAVX2(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step)
+        {
+            AnimMergeScalar(a_dialogue, a_target, a_result, a_step);
+        }
+#endif
+    }
+}
@@ -0,0 +1,89 @@
+#include "Blend.h"
+
+#include <algorithm>
+
+namespace MfgFix::Core
+{
+    // expression layers are copied whole (Copy), not merged, a 17 wide expression merge would be the modifier kernel
+    static_assert(std::uint32_t{ Expression::Total } == std::uint32_t{ Modifier::Total });
+
+    float PhonemeThreshold(float a_percent)
+    {
+        return std::clamp(a_percent, 0.0f, 200.0f) / 100.0f;
+    }
+
+    std::uint32_t ActiveExpression(std::span<const float> a_expressions)
+    {
+        std::uint32_t expression = Expression::MoodNeutral;
+
+        if (a_expressions.size() <= expression) {
+            return expression;
+        }
+
+        for (std::uint32_t i = 0; i < a_expressions.size(); ++i) {
+            if (a_expressions[i] > a_expressions[expression]) {
+                expression = i;
+            }
+        }
+
+        return expression;
+    }
+
+    void MergeNonZero(std::span<const float> a_src, std::span<float> a_dst)
+    {
+        if (a_src.size() == a_dst.size()) {
+            switch (a_src.size()) {
+            case Phoneme::Total:
+                return Kernels::MergeNonZero<Phoneme::Total>(a_src.data(), a_dst.data());
+            case Modifier::Total:  // same width as expressions
+                return Kernels::MergeNonZero<Modifier::Total>(a_src.data(), a_dst.data());
+            }
+        }
+
+        auto count = std::min(a_src.size(), a_dst.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            a_dst[i] = a_src[i] != 0.0f ? a_src[i] : a_dst[i];
+        }
+    }
+
+    void MergeModifiers(std::span<const float> a_src, std::span<float> a_dst)
+    {
+        if (a_src.size() == Modifier::Total && a_dst.size() == Modifier::Total) {
+            return Kernels::MergeModifiers<Modifier::Total>(a_src.data(), a_dst.data());
+        }
+
+        MergeNonZero(a_src, a_dst);
+
+        if (a_src.size() <= Modifier::LookUp || a_dst.size() <= Modifier::LookUp) {
+            return;
+        }
+
+        if (a_src[Modifier::LookDown] != 0.0f || a_src[Modifier::LookLeft] != 0.0f || a_src[Modifier::LookRight] != 0.0f || a_src[Modifier::LookUp] != 0.0f) {
+            a_dst[Modifier::LookDown] = a_src[Modifier::LookDown];
+            a_dst[Modifier::LookLeft] = a_src[Modifier::LookLeft];
+            a_dst[Modifier::LookRight] = a_src[Modifier::LookRight];
+            a_dst[Modifier::LookUp] = a_src[Modifier::LookUp];
+        }
+    }
+
+    void MergeAboveThreshold(std::span<float> a_src, std::span<float> a_dst, float a_threshold)
+    {
+        auto count = std::min(a_src.size(), a_dst.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            if (a_src[i] >= a_threshold) {
+                a_dst[i] = a_src[i];
+            } else {
+                a_src[i] = 0.0f;
+            }
+        }
+    }
+
+    void ZeroBelowThreshold(std::span<float> a_values, float a_threshold)
+    {
+        for (auto& value : a_values) {
+            if (value < a_threshold) {
+                value = 0.0f;
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Channels.h"
+#include "Cpu.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace MfgFix::Core
+{
+    // dialogue phoneme threshold setting (percent) to keyframe value
+    float PhonemeThreshold(float a_percent);
+
+    // index of the strongest expression, MoodNeutral if none is above it
+    std::uint32_t ActiveExpression(std::span<const float> a_expressions);
+
+    // copy every non-zero source value over the destination
+    // engine layer widths go through the fixed width kernels, anything else through a runtime loop
+    void MergeNonZero(std::span<const float> a_src, std::span<float> a_dst);
+
+    // same as MergeNonZero, but Look* modifiers are always copied as a group so a partial eye override can't mix with eye tracking
+    void MergeModifiers(std::span<const float> a_src, std::span<float> a_dst);
+
+    // copy source values at or above threshold, zero the ones below it in the source
+    void MergeAboveThreshold(std::span<float> a_src, std::span<float> a_dst, float a_threshold);
+
+    void ZeroBelowThreshold(std::span<float> a_values, float a_threshold);
+
+    // step result toward target by a_step, falling back to dialogue values where target is unset
+    // dispatches to the kernel picked by SelectKernels, scalar until then
+    void AnimMerge(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step);
+
+    // picks the widest kernels supported by the cpu, capped at a_max, returns the selected level
+    SimdLevel SelectKernels(SimdLevel a_max = SimdLevel::AVX2);
+
+    namespace Kernels
+    {
+        // reference implementation, the vector kernels must match it bit for bit
+        void AnimMergeScalar(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step);
+        void AnimMergeSSE41(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step);
+        void AnimMergeAVX2(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_step);
+
+        // select instead of branch so the fixed trip count vectorizes into masked blends
+        template <std::size_t N>
+        inline void MergeNonZero(const float* a_src, float* a_dst)
+        {
+            for (std::size_t i = 0; i < N; ++i) {
+                a_dst[i] = a_src[i] != 0.0f ? a_src[i] : a_dst[i];
+            }
+        }
+
+        template <std::size_t N>
+        inline void MergeModifiers(const float* a_src, float* a_dst)
+        {
+            static_assert(N > Modifier::LookUp);
+
+            bool look = (a_src[Modifier::LookDown] != 0.0f) | (a_src[Modifier::LookLeft] != 0.0f) | (a_src[Modifier::LookRight] != 0.0f) | (a_src[Modifier::LookUp] != 0.0f);
+
+            MergeNonZero<N>(a_src, a_dst);
+
+            for (std::size_t i = Modifier::LookDown; i <= Modifier::LookUp; ++i) {
+                a_dst[i] = look ? a_src[i] : a_dst[i];
+            }
+        }
+    }
+}
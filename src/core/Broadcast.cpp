@@ -0,0 +1,43 @@
+#include "Broadcast.h"
+
+#include <cmath>
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        std::int32_t Scale(float a_value, float a_scale)
+        {
+            return static_cast<std::int32_t>(std::round(a_value * 100.0f * a_scale));
+        }
+    }
+
+    std::optional<ExpressionPreset> MakePreset(std::span<const float> a_values, bool a_openMouth, const PresetScale& a_scale)
+    {
+        if (a_values.size() != kPresetSize) {
+            return std::nullopt;
+        }
+
+        ExpressionPreset preset;
+
+        preset.expression = static_cast<std::uint32_t>(static_cast<std::int32_t>(a_values[30]));
+        preset.expressionValue = Scale(a_values[31], a_scale.expression);
+
+        // strength 0 asks for the dynamic one, expression 0 has always been left out of it
+        if (preset.expression > 0 && preset.expressionValue == 0) {
+            preset.expressionValue = a_scale.expressionPower;
+        }
+
+        preset.setPhonemes = !a_openMouth;
+
+        for (std::size_t i = 0; i < preset.phonemes.size(); ++i) {
+            preset.phonemes[i] = Scale(a_values[i], a_scale.phonemes);
+        }
+
+        for (std::size_t i = 0; i < preset.modifiers.size(); ++i) {
+            preset.modifiers[i] = Scale(a_values[Phoneme::Total + i], a_scale.modifiers);
+        }
+
+        return preset;
+    }
+}
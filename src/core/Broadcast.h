@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Channels.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace MfgFix::Core
+{
+    // an expression preset as Papyrus hands it over, see MfgConsoleFuncExt.psc:
+    // 16 phonemes, 14 modifiers (no head channels), expression id and its strength, all 0.0 - 1.0 but the id
+    inline constexpr std::size_t kPresetSize = 32;
+    inline constexpr std::size_t kPresetModifiers = Modifier::SquintRight + 1;
+
+    struct PresetScale
+    {
+        std::int32_t expressionPower{ 0 };  // used when the preset sets an expression with strength 0
+        float expression{ 1.0f };
+        float modifiers{ 1.0f };
+        float phonemes{ 1.0f };
+    };
+
+    // a preset scaled to the 0 - 200 values the keyframes are set with, computed once for any number of actors
+    struct ExpressionPreset
+    {
+        std::uint32_t expression{ 0 };
+        std::int32_t expressionValue{ 0 };
+        bool setPhonemes{ true };  // false leaves the mouth as it is
+        std::array<std::int32_t, Phoneme::Total> phonemes{};
+        std::array<std::int32_t, kPresetModifiers> modifiers{};
+    };
+
+    // nothing if a_values isn't kPresetSize long
+    std::optional<ExpressionPreset> MakePreset(std::span<const float> a_values, bool a_openMouth, const PresetScale& a_scale);
+
+    // the actors one call works on, nulls and repeats dropped, in the order given
+    template <class T>
+    std::vector<T*> UniqueTargets(std::span<T* const> a_targets)
+    {
+        std::vector<std::pair<T*, std::size_t>> sorted;
+        sorted.reserve(a_targets.size());
+
+        for (std::size_t i = 0; i < a_targets.size(); ++i) {
+            if (a_targets[i]) {
+                sorted.emplace_back(a_targets[i], i);
+            }
+        }
+
+        // first occurrence of every target, back in call order
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end(), [](auto& a_lhs, auto& a_rhs) { return a_lhs.first == a_rhs.first; }), sorted.end());
+        std::sort(sorted.begin(), sorted.end(), [](auto& a_lhs, auto& a_rhs) { return a_lhs.second < a_rhs.second; });
+
+        std::vector<T*> targets;
+        targets.reserve(sorted.size());
+
+        for (auto& entry : sorted) {
+            targets.push_back(entry.first);
+        }
+
+        return targets;
+    }
+}
@@ -0,0 +1,141 @@
+#include "Budget.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace MfgFix::Core
+{
+    FrameBudget::Ticket FrameBudget::Admit(BudgetState& a_state, float a_timeDelta, bool a_priority, Stats* a_stats)
+    {
+        auto frame = _frame.load(std::memory_order_acquire);
+
+        // the face is back, a new frame started; on a lost race frame holds the new one
+        if (a_state.seenFrame == frame) {
+            if (_frame.compare_exchange_strong(frame, frame + 1, std::memory_order_acq_rel)) {
+                CloseFrame(a_stats);
+                ++frame;
+            }
+        }
+
+        a_state.seenFrame = frame;
+
+        Ticket ticket{ true, a_priority, 0.0f };
+
+        if (!a_priority) {
+            auto wait = a_state.ranFrame ? static_cast<std::uint32_t>(std::min<std::uint64_t>(frame - a_state.ranFrame, kMaxWait)) : kMaxWait;
+            auto budget = _budget.load(std::memory_order_relaxed);
+            auto threshold = _threshold.load(std::memory_order_relaxed);
+            auto fits = !budget || _spent.load(std::memory_order_relaxed) + _averageCost.load(std::memory_order_relaxed) <= budget;
+
+            // faces that waited exactly the threshold share what the longer waiting ones leave, first come first served
+            auto turn = fits && (wait > threshold || (wait == threshold && _quota.fetch_sub(1, std::memory_order_relaxed) > 0));
+
+            ticket.run = turn || wait >= kMaxWait;
+
+            if (!ticket.run) {
+                a_state.pending += a_timeDelta;
+                _waiting[wait].fetch_add(1, std::memory_order_relaxed);
+                return ticket;
+            }
+
+            if (!turn) {
+                _forcedFrame.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        ticket.timeDelta = std::exchange(a_state.pending, 0.0f) + a_timeDelta;
+        a_state.ranFrame = frame;
+
+        return ticket;
+    }
+
+    void FrameBudget::Spent(const Ticket& a_ticket, std::uint64_t a_cost)
+    {
+        _spent.fetch_add(a_cost, std::memory_order_relaxed);
+
+        if (a_ticket.priority) {
+            _prioritySpent.fetch_add(a_cost, std::memory_order_relaxed);
+        } else {
+            // running average over about 16 updates, a lost race only loses one sample
+            auto average = _averageCost.load(std::memory_order_relaxed);
+            _averageCost.store(average ? average - average / 16 + a_cost / 16 : a_cost, std::memory_order_relaxed);
+        }
+    }
+
+    FrameBudget::Counters FrameBudget::GetCounters() const
+    {
+        return {
+            _frames.load(std::memory_order_relaxed),
+            _overruns.load(std::memory_order_relaxed),
+            _deferred.load(std::memory_order_relaxed),
+            _forced.load(std::memory_order_relaxed)
+        };
+    }
+
+    void FrameBudget::CloseFrame(Stats* a_stats)
+    {
+        auto spent = _spent.exchange(0, std::memory_order_relaxed);
+        auto prioritySpent = _prioritySpent.exchange(0, std::memory_order_relaxed);
+        auto forced = _forcedFrame.exchange(0, std::memory_order_relaxed);
+
+        std::array<std::uint32_t, kMaxWait + 1> waiting;
+        std::uint64_t deferred = 0;
+
+        for (std::size_t i = 0; i < waiting.size(); ++i) {
+            waiting[i] = _waiting[i].exchange(0, std::memory_order_relaxed);
+            deferred += waiting[i];
+        }
+
+        auto budget = _budget.load(std::memory_order_relaxed);
+        auto overrun = budget && spent > budget;
+
+        _frames.fetch_add(1, std::memory_order_relaxed);
+        _overruns.fetch_add(overrun ? 1 : 0, std::memory_order_relaxed);
+        _deferred.fetch_add(deferred, std::memory_order_relaxed);
+        _forced.fetch_add(forced, std::memory_order_relaxed);
+
+        // how many optional faces the next frame fits, and the wait that lets as many in, longest waiting first
+        // deferred faces come back having waited one frame more, the ones that ran start over at 1
+        auto average = _averageCost.load(std::memory_order_relaxed);
+        auto capacity = budget && average ? (budget > prioritySpent ? (budget - prioritySpent) / average : 0) : std::numeric_limits<std::uint64_t>::max();
+
+        std::uint32_t threshold = 1;
+        std::uint64_t count = 0;
+
+        for (auto wait = kMaxWait; wait > 1; --wait) {
+            if (count + waiting[wait - 1] >= capacity) {
+                threshold = wait;
+                break;
+            }
+            count += waiting[wait - 1];
+        }
+
+        // an eighth of the capacity is held back for faces costing more than the average
+        auto quota = capacity - std::min(count, capacity);
+        quota -= std::min(quota, capacity / 8);
+
+        _threshold.store(threshold, std::memory_order_relaxed);
+        _quota.store(static_cast<std::int64_t>(std::min<std::uint64_t>(quota, std::numeric_limits<std::int64_t>::max())), std::memory_order_relaxed);
+
+        if (a_stats) {
+            a_stats->Add(Probe::FaceFrame, spent);
+            a_stats->Count(Counter::BudgetFrames);
+            a_stats->Count(Counter::BudgetOverruns, overrun ? 1 : 0);
+            a_stats->Count(Counter::BudgetDeferred, deferred);
+            a_stats->Count(Counter::BudgetForced, forced);
+        }
+    }
+
+    bool LockDeferral::Defer(float a_step)
+    {
+        if (frames >= kMaxDeferred) {
+            return false;
+        }
+
+        time = a_step;
+        ++frames;
+
+        return true;
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Stats.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace MfgFix::Core
+{
+    // what the scheduler knows about a face, owned by it
+    struct BudgetState
+    {
+        std::uint64_t seenFrame{ 0 };  // frame the face last asked in
+        std::uint64_t ranFrame{ 0 };   // frame it last ran in, 0 never
+        float pending{ 0.0f };         // time of the frames it was deferred
+    };
+
+    // Caps the time spent on face updates per frame. Priority faces (dialogue) always run, the others share what's left
+    // round-robin: the faces that waited longest go first, a face deferred for kMaxWait frames runs regardless.
+    // Frames are counted by faces coming back: a face asking a second time starts the next frame. Cost is in any unit as long as the budget uses the same.
+    // Admit and Spent may be called from several threads, the accounting is approximate across the frame boundary.
+    class FrameBudget
+    {
+    public:
+        static constexpr std::uint32_t kMaxWait = 32;
+
+        struct Ticket
+        {
+            bool run{ true };
+            bool priority{ false };
+            float timeDelta{ 0.0f };  // deferred frames included
+        };
+
+        struct Counters
+        {
+            std::uint64_t frames{ 0 };
+            std::uint64_t overruns{ 0 };  // frames that spent more than the budget
+            std::uint64_t deferred{ 0 };  // face updates put off to a later frame
+            std::uint64_t forced{ 0 };    // face updates run over budget after waiting kMaxWait frames
+        };
+
+        // 0 is unlimited
+        void SetBudget(std::uint64_t a_cost) { _budget.store(a_cost, std::memory_order_relaxed); }
+        std::uint64_t Budget() const { return _budget.load(std::memory_order_relaxed); }
+
+        // a_stats gets the cost of every closed frame and the counters, may be null
+        Ticket Admit(BudgetState& a_state, float a_timeDelta, bool a_priority, Stats* a_stats = nullptr);
+
+        // after a face the ticket let run
+        void Spent(const Ticket& a_ticket, std::uint64_t a_cost);
+
+        Counters GetCounters() const;
+
+        // frames done so far
+        std::uint64_t Frame() const { return _frame.load(std::memory_order_relaxed) - 1; }
+
+    private:
+        void CloseFrame(Stats* a_stats);
+
+        std::atomic<std::uint64_t> _budget{ 0 };
+        std::atomic<std::uint64_t> _frame{ 1 };
+
+        // current frame
+        std::atomic<std::uint64_t> _spent{ 0 };
+        std::atomic<std::uint64_t> _prioritySpent{ 0 };
+        std::atomic<std::uint64_t> _forcedFrame{ 0 };
+        std::array<std::atomic<std::uint32_t>, kMaxWait + 1> _waiting{};  // optional faces deferred, by frames waited
+
+        // from the frames before
+        std::atomic<std::uint32_t> _threshold{ 1 };  // frames an optional face has to wait before it may run
+        std::atomic<std::int64_t> _quota{ std::numeric_limits<std::int64_t>::max() };  // faces at exactly the threshold that may run
+        std::atomic<std::uint64_t> _averageCost{ 0 };
+
+        std::atomic<std::uint64_t> _frames{ 0 };
+        std::atomic<std::uint64_t> _overruns{ 0 };
+        std::atomic<std::uint64_t> _deferred{ 0 };
+        std::atomic<std::uint64_t> _forced{ 0 };
+    };
+
+    // Frames a face put off because another thread held its lock. A deferred frame's time is added to the next one,
+    // after kMaxDeferred frames in a row the face waits for the lock instead.
+    struct LockDeferral
+    {
+        static constexpr std::uint32_t kMaxDeferred = 4;
+
+        float time{ 0.0f };  // the step of the last deferred frame, earlier deferred frames included
+        std::uint32_t frames{ 0 };
+
+        // the step of a frame with a_timeDelta of its own
+        float Step(float a_timeDelta) const { return time + a_timeDelta; }
+
+        // false once the face has put off kMaxDeferred frames, a_step is what Step returned
+        bool Defer(float a_step);
+
+        // the frame ran, its step included the deferred time
+        void Ran()
+        {
+            time = 0.0f;
+            frames = 0;
+        }
+    };
+}
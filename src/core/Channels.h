@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MfgFix::Core
+{
+    // Channel layout of RE::BSFaceGenKeyframeMultiple, mirrored here so the core does not depend on CommonLib
+
+    namespace Expression
+    {
+        enum : std::uint32_t
+        {
+            DialogueAnger = 0,
+            DialogueFear,
+            DialogueHappy,
+            DialogueSad,
+            DialogueSurprise,
+            DialoguePuzzled,
+            DialogueDisgusted,
+            MoodNeutral,
+            MoodAnger,
+            MoodFear,
+            MoodHappy,
+            MoodSad,
+            MoodSurprise,
+            MoodPuzzled,
+            MoodDisgusted,
+            CombatAnger,
+            CombatShout,
+
+            Total
+        };
+    }
+
+    namespace Modifier
+    {
+        enum : std::uint32_t
+        {
+            BlinkLeft = 0,
+            BlinkRight,
+            BrowDownLeft,
+            BrowDownRight,
+            BrowInLeft,
+            BrowInRight,
+            BrowUpLeft,
+            BrowUpRight,
+            LookDown,
+            LookLeft,
+            LookRight,
+            LookUp,
+            SquintLeft,
+            SquintRight,
+            HeadPitch,
+            HeadRoll,
+            HeadYaw,
+
+            Total
+        };
+    }
+
+    namespace Phoneme
+    {
+        enum : std::uint32_t
+        {
+            Aah = 0,
+            BigAah,
+            BMP,
+            ChJSh,
+            DST,
+            Eee,
+            Eh,
+            FV,
+            I,
+            K,
+            N,
+            Oh,
+            OohQ,
+            R,
+            Th,
+            W,
+
+            Total
+        };
+    }
+
+    // keyframe layers of one face: 1 = dialogue / transition, 2 = script and console, 3 = output
+    enum class Layer : std::uint32_t
+    {
+        Expression1 = 0,
+        Expression2,
+        Expression3,
+        Modifier1,
+        Modifier2,
+        Modifier3,
+        Phoneme1,
+        Phoneme2,
+        Phoneme3,
+        Custom1,
+        Custom2,
+        Custom3,
+
+        Total
+    };
+}
@@ -0,0 +1,42 @@
+#include "Clock.h"
+#include "Cpu.h"
+
+#include <chrono>
+
+#if defined(MFGFIX_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace MfgFix::Core
+{
+    std::uint64_t ReadTicks()
+    {
+#if defined(MFGFIX_X64)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(ReadNanoseconds());
+#endif
+    }
+
+    std::int64_t ReadNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double TickRate::Seconds() const
+    {
+        return static_cast<double>(ReadNanoseconds() - _time.load(std::memory_order_relaxed)) * 1e-9;
+    }
+
+    double TickRate::TicksPerSecond() const
+    {
+        auto ticks = ReadTicks() - _ticks.load(std::memory_order_relaxed);
+        auto nanoseconds = ReadNanoseconds() - _time.load(std::memory_order_relaxed);
+
+        return nanoseconds > 0 ? static_cast<double>(ticks) * 1e9 / static_cast<double>(nanoseconds) : 1e9;
+    }
+}
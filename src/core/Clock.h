@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace MfgFix::Core
+{
+    // time stamp counter on x64, steady_clock nanoseconds elsewhere
+    std::uint64_t ReadTicks();
+
+    // steady_clock nanoseconds
+    std::int64_t ReadNanoseconds();
+
+    // tick frequency measured against steady_clock since the last Restart
+    class TickRate
+    {
+    public:
+        TickRate() { Restart(); }
+
+        void Restart()
+        {
+            _ticks.store(ReadTicks(), std::memory_order_relaxed);
+            _time.store(ReadNanoseconds(), std::memory_order_relaxed);
+        }
+
+        double Seconds() const;
+        double TicksPerSecond() const;
+
+    private:
+        std::atomic<std::uint64_t> _ticks;
+        std::atomic<std::int64_t> _time;
+    };
+}
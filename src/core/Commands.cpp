@@ -0,0 +1,485 @@
+#include "Commands.h"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        constexpr std::uint32_t kAllPhonemes = (1u << Phoneme::Total) - 1;
+        constexpr std::uint32_t kAllModifiers = (1u << kPresetModifiers) - 1;
+
+        constexpr std::uint64_t kIndexMask = 0xFFFFFFFF;
+
+        std::int32_t Clamp(std::int32_t a_value)
+        {
+            return std::clamp(a_value, 0, 200);
+        }
+
+        class SlotGuard
+        {
+        public:
+            explicit SlotGuard(std::atomic<bool>& a_lock) :
+                _lock(a_lock)
+            {
+                while (_lock.exchange(true, std::memory_order_acquire)) {
+                    while (_lock.load(std::memory_order_relaxed)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            SlotGuard(const SlotGuard&) = delete;
+            SlotGuard& operator=(const SlotGuard&) = delete;
+
+            ~SlotGuard() { _lock.store(false, std::memory_order_release); }
+
+        private:
+            std::atomic<bool>& _lock;
+        };
+    }
+
+    PresetPool::PresetPool()
+    {
+        for (std::uint32_t i = 0; i + 1 < kSlots; ++i) {
+            _slots[i].next.store(i + 1, std::memory_order_relaxed);
+        }
+
+        _free.store(0, std::memory_order_release);
+    }
+
+    std::uint32_t PresetPool::Add(const ExpressionPreset& a_preset, std::uint32_t a_refs)
+    {
+        auto head = _free.load(std::memory_order_acquire);
+        std::uint32_t slot;
+
+        do {
+            slot = static_cast<std::uint32_t>(head & kIndexMask);
+            if (slot == kSlots) {
+                return kSlots;
+            }
+        } while (!_free.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | _slots[slot].next.load(std::memory_order_relaxed),
+            std::memory_order_acq_rel, std::memory_order_acquire));
+
+        _slots[slot].preset = a_preset;
+        _slots[slot].refs.store(a_refs, std::memory_order_release);
+
+        return slot;
+    }
+
+    void PresetPool::Release(std::uint32_t a_slot, std::uint32_t a_refs)
+    {
+        auto& slot = _slots[a_slot];
+
+        if (!a_refs || slot.refs.fetch_sub(a_refs, std::memory_order_acq_rel) != a_refs) {
+            return;
+        }
+
+        auto head = _free.load(std::memory_order_relaxed);
+
+        do {
+            slot.next.store(static_cast<std::uint32_t>(head & kIndexMask), std::memory_order_relaxed);
+        } while (!_free.compare_exchange_weak(head, (head & ~kIndexMask) | a_slot, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void PendingFace::Merge(const FaceCommand& a_command, const ExpressionPreset* a_preset)
+    {
+        owner = a_command.owner;
+        speed = a_command.speed;
+
+        switch (a_command.kind) {
+        case CommandKind::Phoneme:
+            if (a_command.id < Phoneme::Total) {
+                phonemeMask |= 1u << a_command.id;
+                phonemes[a_command.id] = Clamp(a_command.value);
+            }
+            break;
+        case CommandKind::Modifier:
+            if (a_command.id < kPresetModifiers) {
+                modifierMask |= 1u << a_command.id;
+                modifiers[a_command.id] = Clamp(a_command.value);
+            }
+            break;
+        case CommandKind::Expression:
+            setExpression = true;
+            expression = a_command.id;
+            expressionValue = Clamp(a_command.value);
+            break;
+        case CommandKind::ClearPhonemes:
+            phonemeMask = kAllPhonemes;
+            phonemes.fill(0);
+            break;
+        case CommandKind::ClearModifiers:
+            modifierMask = kAllModifiers;
+            modifiers.fill(0);
+            break;
+        case CommandKind::ResetOverride:
+        case CommandKind::ResetAll:
+            phonemeMask = 0;
+            modifierMask = 0;
+            setExpression = false;
+            reset = std::max(reset, a_command.kind == CommandKind::ResetAll ? FaceReset::All : FaceReset::Override);
+            break;
+        case CommandKind::Preset:
+            if (!a_preset) {
+                break;
+            }
+
+            setExpression = true;
+            expression = a_preset->expression;
+            expressionValue = Clamp(a_preset->expressionValue);
+
+            if (a_preset->setPhonemes) {
+                phonemeMask = kAllPhonemes;
+                std::transform(a_preset->phonemes.begin(), a_preset->phonemes.end(), phonemes.begin(), Clamp);
+            }
+
+            modifierMask = kAllModifiers;
+            std::transform(a_preset->modifiers.begin(), a_preset->modifiers.end(), modifiers.begin(), Clamp);
+            break;
+        }
+    }
+
+    CommandQueue::CommandQueue() :
+        _cells(std::make_unique<Cell[]>(kCapacity)),
+        _buckets(std::make_unique<Bucket[]>(kBuckets))
+    {
+        for (std::size_t i = 0; i < kCapacity; ++i) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void CommandQueue::Push(const FaceCommand& a_command, Stats* a_stats)
+    {
+        if (!TryPush(a_command)) {
+            CountOverflow(a_stats);
+
+            do {
+                MakeRoom(a_stats);
+            } while (!TryPush(a_command));
+        }
+
+        _queued.fetch_add(1, std::memory_order_relaxed);
+
+        if (a_stats) {
+            a_stats->Count(Counter::CommandsQueued);
+        }
+    }
+
+    void CommandQueue::PushPreset(const ExpressionPreset& a_preset, std::span<FaceCommand> a_commands, Stats* a_stats)
+    {
+        if (a_commands.empty()) {
+            return;
+        }
+
+        // the slots are held by queued commands only, draining frees them
+        auto slot = _presets.Add(a_preset, static_cast<std::uint32_t>(a_commands.size()));
+        if (slot == PresetPool::kSlots) {
+            CountOverflow(a_stats);
+
+            do {
+                MakeRoom(a_stats);
+                slot = _presets.Add(a_preset, static_cast<std::uint32_t>(a_commands.size()));
+            } while (slot == PresetPool::kSlots);
+        }
+
+        for (auto& command : a_commands) {
+            command.kind = CommandKind::Preset;
+            command.value = static_cast<std::int32_t>(slot);
+
+            if (!TryPush(command)) {
+                CountOverflow(a_stats);
+
+                do {
+                    MakeRoom(a_stats);
+                } while (!TryPush(command));
+            }
+        }
+
+        _queued.fetch_add(a_commands.size(), std::memory_order_relaxed);
+
+        if (a_stats) {
+            a_stats->Count(Counter::CommandsQueued, a_commands.size());
+        }
+    }
+
+    bool CommandQueue::Pending(std::uintptr_t a_face, Stats* a_stats)
+    {
+        if (!Empty()) {
+            Drain(a_stats);
+        }
+
+        if (_pending.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        auto slot = Find(a_face);
+
+        return slot && slot->pending.load(std::memory_order_acquire);
+    }
+
+    bool CommandQueue::Take(std::uintptr_t a_face, PendingFace& a_pending, Stats* a_stats)
+    {
+        if (!Pending(a_face, a_stats)) {
+            return false;
+        }
+
+        auto slot = Find(a_face);
+        if (!slot) {
+            return false;
+        }
+
+        SlotGuard guard(slot->lock);
+
+        // the drainer may have given the slot to another face meanwhile
+        if (!slot->pending.load(std::memory_order_relaxed) || Find(a_face) != slot) {
+            return false;
+        }
+
+        a_pending = slot->face;
+        slot->pending.store(false, std::memory_order_relaxed);
+        _pending.fetch_sub(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    void CommandQueue::FindStale(std::uint32_t a_passes, std::vector<StaleFace>& a_stale, Stats* a_stats)
+    {
+        a_stale.clear();
+
+        if (!Empty()) {
+            Drain(a_stats);
+        }
+
+        if (_pending.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            auto& bucket = _buckets[i];
+
+            for (std::size_t way = 0; way < kWays; ++way) {
+                auto& slot = bucket.slots[way];
+                if (!slot.pending.load(std::memory_order_acquire)) {
+                    continue;
+                }
+
+                SlotGuard guard(slot.lock);
+
+                if (slot.pending.load(std::memory_order_relaxed) && ++slot.age > a_passes) {
+                    a_stale.push_back({ bucket.keys[way].load(std::memory_order_relaxed), slot.face.owner });
+                }
+            }
+        }
+    }
+
+    std::size_t CommandQueue::EraseOwner(std::uint32_t a_owner)
+    {
+        std::size_t erased = 0;
+
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            for (auto& slot : _buckets[i].slots) {
+                if (!slot.pending.load(std::memory_order_acquire)) {
+                    continue;
+                }
+
+                SlotGuard guard(slot.lock);
+
+                if (slot.pending.load(std::memory_order_relaxed) && slot.face.owner == a_owner) {
+                    slot.pending.store(false, std::memory_order_relaxed);
+                    ++erased;
+                }
+            }
+        }
+
+        _pending.fetch_sub(erased, std::memory_order_relaxed);
+
+        return erased;
+    }
+
+    void CommandQueue::Clear()
+    {
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            for (auto& slot : _buckets[i].slots) {
+                SlotGuard guard(slot.lock);
+
+                if (slot.pending.load(std::memory_order_relaxed)) {
+                    slot.pending.store(false, std::memory_order_relaxed);
+                    _pending.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    CommandQueue::Counters CommandQueue::GetCounters() const
+    {
+        return {
+            _queued.load(std::memory_order_relaxed),
+            _coalesced.load(std::memory_order_relaxed),
+            _overflows.load(std::memory_order_relaxed),
+            _lost.load(std::memory_order_relaxed),
+            _pending.load(std::memory_order_relaxed)
+        };
+    }
+
+    bool CommandQueue::TryPush(const FaceCommand& a_command)
+    {
+        auto position = _tail.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        // bounded multi producer ring, a cell's sequence says whose turn it is: position when free, position + 1 when full
+        for (;;) {
+            cell = &_cells[position & (kCapacity - 1)];
+
+            auto sequence = cell->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::int64_t>(sequence - position);
+
+            if (difference == 0) {
+                if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->command = a_command;
+        cell->sequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    void CommandQueue::CountOverflow(Stats* a_stats)
+    {
+        _overflows.fetch_add(1, std::memory_order_relaxed);
+
+        if (a_stats) {
+            a_stats->Count(Counter::CommandsOverflows);
+        }
+    }
+
+    void CommandQueue::MakeRoom(Stats* a_stats)
+    {
+        if (!Drain(a_stats)) {
+            std::this_thread::yield();
+        }
+    }
+
+    bool CommandQueue::Drain(Stats* a_stats)
+    {
+        if (_draining.exchange(true, std::memory_order_acquire)) {
+            return false;
+        }
+
+        std::uint64_t coalesced = 0;
+        std::uint64_t lost = 0;
+
+        // at most one ring's worth, senders that keep pushing don't hold this update up
+        for (std::size_t i = 0; i < kCapacity; ++i) {
+            auto position = _head.load(std::memory_order_relaxed);
+            auto& cell = _cells[position & (kCapacity - 1)];
+
+            if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+                break;
+            }
+
+            auto command = cell.command;
+            cell.sequence.store(position + kCapacity, std::memory_order_release);
+            _head.store(position + 1, std::memory_order_release);
+
+            auto preset = command.kind == CommandKind::Preset ? &_presets[static_cast<std::uint32_t>(command.value)] : nullptr;
+
+            switch (Merge(command, preset)) {
+            case MergeResult::Coalesced:
+                ++coalesced;
+                break;
+            case MergeResult::Lost:
+                ++lost;
+                break;
+            default:
+                break;
+            }
+
+            if (preset) {
+                _presets.Release(static_cast<std::uint32_t>(command.value));
+            }
+        }
+
+        _draining.store(false, std::memory_order_release);
+
+        _coalesced.fetch_add(coalesced, std::memory_order_relaxed);
+        _lost.fetch_add(lost, std::memory_order_relaxed);
+
+        if (a_stats) {
+            a_stats->Count(Counter::CommandsCoalesced, coalesced);
+            a_stats->Count(Counter::CommandsLost, lost);
+        }
+
+        return true;
+    }
+
+    CommandQueue::MergeResult CommandQueue::Merge(const FaceCommand& a_command, const ExpressionPreset* a_preset)
+    {
+        auto& bucket = GetBucket(a_command.face);
+        auto free = kWays;
+
+        // the face's own slot, or the first one nothing is pending in
+        for (std::size_t way = 0; way < kWays; ++way) {
+            if (bucket.keys[way].load(std::memory_order_relaxed) == a_command.face) {
+                free = way;
+                break;
+            }
+
+            if (free == kWays && !bucket.slots[way].pending.load(std::memory_order_acquire)) {
+                free = way;
+            }
+        }
+
+        if (free == kWays) {
+            return MergeResult::Lost;
+        }
+
+        auto& slot = bucket.slots[free];
+        SlotGuard guard(slot.lock);
+
+        // only the drainer sets pending, a slot found empty is still empty
+        if (slot.pending.load(std::memory_order_relaxed)) {
+            slot.face.Merge(a_command, a_preset);
+            return MergeResult::Coalesced;
+        }
+
+        bucket.keys[free].store(a_command.face, std::memory_order_release);
+        slot.face = {};
+        slot.face.Merge(a_command, a_preset);
+        slot.age = 0;
+        slot.pending.store(true, std::memory_order_release);
+        _pending.fetch_add(1, std::memory_order_release);
+
+        return MergeResult::Added;
+    }
+
+    CommandQueue::Slot* CommandQueue::Find(std::uintptr_t a_face)
+    {
+        auto& bucket = GetBucket(a_face);
+
+        for (std::size_t way = 0; way < kWays; ++way) {
+            if (bucket.keys[way].load(std::memory_order_acquire) == a_face) {
+                return &bucket.slots[way];
+            }
+        }
+
+        return nullptr;
+    }
+
+    CommandQueue::Bucket& CommandQueue::GetBucket(std::uintptr_t a_face)
+    {
+        // faces are at least 16 byte aligned, a multiplicative hash spreads the rest over the buckets
+        constexpr auto kShift = 64 - std::countr_zero(kBuckets);
+
+        return _buckets[static_cast<std::size_t>(((static_cast<std::uint64_t>(a_face) >> 4) * 0x9E3779B97F4A7C15ull) >> kShift)];
+    }
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "Broadcast.h"
+#include "Stats.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace MfgFix::Core
+{
+    enum class CommandKind : std::uint8_t
+    {
+        Phoneme = 0,
+        Modifier,
+        Expression,
+        ClearPhonemes,   // every phoneme to 0
+        ClearModifiers,  // every script modifier to 0
+        ResetOverride,   // expression override off, layers reset
+        ResetAll,        // both of the above, then ResetOverride
+        Preset           // value is a PresetPool slot
+    };
+
+    // a write to one face, fixed size, presets ride in a PresetPool slot
+    struct FaceCommand
+    {
+        std::uintptr_t face{ 0 };  // animData pointer
+        std::uint32_t owner{ 0 };  // actor that sent it
+        CommandKind kind{ CommandKind::Phoneme };
+        std::uint8_t id{ 0 };
+        std::int32_t value{ 0 };
+        float speed{ 0.0f };  // transition speed the face gets with it, 0 snaps
+    };
+
+    // Preset payloads shared by the commands of one call, any number of actors read the same slot.
+    // A slot is freed when every command holding it was drained. Add and Release from any thread, nothing locks.
+    class PresetPool
+    {
+    public:
+        static constexpr std::uint32_t kSlots = 256;
+
+        PresetPool();
+
+        // a slot holding a_preset for a_refs commands, kSlots if all are taken
+        std::uint32_t Add(const ExpressionPreset& a_preset, std::uint32_t a_refs);
+
+        // one command holding a_slot is done with it
+        void Release(std::uint32_t a_slot, std::uint32_t a_refs = 1);
+
+        const ExpressionPreset& operator[](std::uint32_t a_slot) const { return _slots[a_slot].preset; }
+
+    private:
+        struct Slot
+        {
+            ExpressionPreset preset;
+            std::atomic<std::uint32_t> refs{ 0 };
+            std::atomic<std::uint32_t> next{ kSlots };
+        };
+
+        // free list head, slot index and a tag bumped on every pop against ABA
+        std::atomic<std::uint64_t> _free{ 0 };
+        std::array<Slot, kSlots> _slots;
+    };
+
+    enum class FaceReset : std::uint8_t
+    {
+        None = 0,
+        Override,
+        All
+    };
+
+    // everything sent to one face since it last updated, coalesced: the last write to a channel wins and a reset
+    // drops the writes before it. Applied as reset first, then expression, phonemes and modifiers.
+    struct PendingFace
+    {
+        std::uint32_t owner{ 0 };
+        float speed{ 0.0f };
+        FaceReset reset{ FaceReset::None };
+        bool setExpression{ false };
+        std::uint32_t expression{ 0 };
+        std::int32_t expressionValue{ 0 };
+        std::uint32_t phonemeMask{ 0 };  // bit per phoneme written
+        std::uint32_t modifierMask{ 0 };
+        std::array<std::int32_t, Phoneme::Total> phonemes{};
+        std::array<std::int32_t, kPresetModifiers> modifiers{};
+
+        // values are clamped to 0 - 200 like the keyframes are set
+        void Merge(const FaceCommand& a_command, const ExpressionPreset* a_preset);
+
+        bool Empty() const { return reset == FaceReset::None && !setExpression && !phonemeMask && !modifierMask; }
+    };
+
+    // a face whose writes waited too long for its update, see CommandQueue::FindStale
+    struct StaleFace
+    {
+        std::uintptr_t face{ 0 };
+        std::uint32_t owner{ 0 };
+    };
+
+    // Commands from script threads to the face updates that apply them. Senders push into a bounded lock-free ring
+    // (many producers); whichever update finds it non-empty drains it, one at a time, into per face PendingFace
+    // slots, and every face takes its own slot when it updates. Nothing is allocated per command.
+    // The slots are preallocated, kWays per bucket; a face keeps its slot while it's empty until another face of the
+    // bucket needs it. Faces that don't update are left to FindStale.
+    class CommandQueue
+    {
+    public:
+        static constexpr std::size_t kCapacity = 4096;  // power of two
+        static constexpr std::size_t kBuckets = 128;    // power of two
+        static constexpr std::size_t kWays = 8;         // faces of a bucket with writes pending at once
+
+        struct Counters
+        {
+            std::uint64_t queued{ 0 };
+            std::uint64_t coalesced{ 0 };  // commands merged into one already pending for their face
+            std::uint64_t overflows{ 0 };  // pushes that found the ring or the preset pool full and drained it first
+            std::uint64_t lost{ 0 };       // commands for a face whose bucket had no slot left
+            std::size_t pending{ 0 };      // faces with something to apply
+        };
+
+        CommandQueue();
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        // a full ring is drained into the pending faces by the sender itself, or by whoever is draining it already,
+        // so nothing is lost or reordered; senders only wait while another thread drains
+        void Push(const FaceCommand& a_command, Stats* a_stats = nullptr);
+
+        // a_preset for every face of a_commands, their kind and value are set here
+        void PushPreset(const ExpressionPreset& a_preset, std::span<FaceCommand> a_commands, Stats* a_stats = nullptr);
+
+        // drains the ring unless another thread is on it, then tells if anything is pending for a_face
+        bool Pending(std::uintptr_t a_face, Stats* a_stats = nullptr);
+
+        // drains the ring unless another thread is on it, then hands over what's pending for a_face
+        bool Take(std::uintptr_t a_face, PendingFace& a_pending, Stats* a_stats = nullptr);
+
+        // one pass of the fallback for faces that don't update, run once a frame: drains the ring, ages what's pending
+        // by a pass and puts the faces that waited more than a_passes passes into a_stale, to be handed over with Take
+        void FindStale(std::uint32_t a_passes, std::vector<StaleFace>& a_stale, Stats* a_stats = nullptr);
+
+        // drops what's pending from a_owner, for actors that unload; returns how many faces
+        std::size_t EraseOwner(std::uint32_t a_owner);
+
+        void Clear();
+
+        Counters GetCounters() const;
+
+        bool Empty() const { return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_acquire); }
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::uint64_t> sequence{ 0 };
+            FaceCommand command;
+        };
+
+        // locked only to merge into, take or age it, never for long
+        struct Slot
+        {
+            std::atomic<bool> lock{ false };
+            std::atomic<bool> pending{ false };
+            std::uint32_t age{ 0 };  // FindStale passes since the first write
+            PendingFace face;
+        };
+
+        // the keys on a line of their own, a face that has nothing pending reads only that;
+        // keys are only written by the drainer, with the slot locked
+        struct alignas(64) Bucket
+        {
+            std::array<std::atomic<std::uintptr_t>, kWays> keys{};
+            std::array<Slot, kWays> slots;
+        };
+
+        enum class MergeResult
+        {
+            Added,
+            Coalesced,
+            Lost
+        };
+
+        bool TryPush(const FaceCommand& a_command);
+
+        // false if another thread is draining
+        bool Drain(Stats* a_stats);
+
+        // by the drainer only
+        MergeResult Merge(const FaceCommand& a_command, const ExpressionPreset* a_preset);
+
+        // the slot of a_face, null if it has none
+        Slot* Find(std::uintptr_t a_face);
+
+        // after a push found no room, CountOverflow once and MakeRoom until it fits
+        void CountOverflow(Stats* a_stats);
+        void MakeRoom(Stats* a_stats);
+
+        Bucket& GetBucket(std::uintptr_t a_face);
+
+        std::unique_ptr<Cell[]> _cells;
+        alignas(64) std::atomic<std::uint64_t> _tail{ 0 };  // next push
+        alignas(64) std::atomic<std::uint64_t> _head{ 0 };  // next pop, written by the drainer only
+        std::atomic<bool> _draining{ false };
+
+        std::unique_ptr<Bucket[]> _buckets;
+        std::atomic<std::size_t> _pending{ 0 };
+
+        PresetPool _presets;
+
+        std::atomic<std::uint64_t> _queued{ 0 };
+        std::atomic<std::uint64_t> _coalesced{ 0 };
+        std::atomic<std::uint64_t> _overflows{ 0 };
+        std::atomic<std::uint64_t> _lost{ 0 };
+    };
+}
@@ -0,0 +1,93 @@
+#include "Cpu.h"
+
+#if defined(MFGFIX_X64)
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+#if defined(MFGFIX_X64)
+        void cpuid(std::uint32_t a_leaf, std::uint32_t a_subleaf, std::uint32_t (&a_regs)[4])
+        {
+#if defined(_MSC_VER)
+            int regs[4];
+            __cpuidex(regs, static_cast<int>(a_leaf), static_cast<int>(a_subleaf));
+            for (int i = 0; i < 4; ++i) {
+                a_regs[i] = static_cast<std::uint32_t>(regs[i]);
+            }
+#else
+            __cpuid_count(a_leaf, a_subleaf, a_regs[0], a_regs[1], a_regs[2], a_regs[3]);
+#endif
+        }
+
+        std::uint64_t xgetbv(std::uint32_t a_index)
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(a_index);
+#else
+            std::uint32_t eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(a_index));
+            return (static_cast<std::uint64_t>(edx) << 32) | eax;
+#endif
+        }
+
+        SimdLevel DetectSimdLevel()
+        {
+            std::uint32_t regs[4];
+
+            cpuid(0, 0, regs);
+            auto maxLeaf = regs[0];
+
+            cpuid(1, 0, regs);
+            bool sse41 = (regs[2] & (1u << 19)) != 0;
+            bool osxsave = (regs[2] & (1u << 27)) != 0;
+            bool avx = (regs[2] & (1u << 28)) != 0;
+
+            if (!sse41) {
+                return SimdLevel::Scalar;
+            }
+
+            // ymm state has to be enabled by the os, not only supported by the cpu
+            if (!osxsave || !avx || (xgetbv(0) & 0x6) != 0x6 || maxLeaf < 7) {
+                return SimdLevel::SSE41;
+            }
+
+            cpuid(7, 0, regs);
+            bool avx2 = (regs[1] & (1u << 5)) != 0;
+
+            return avx2 ? SimdLevel::AVX2 : SimdLevel::SSE41;
+        }
+#else
+        SimdLevel DetectSimdLevel()
+        {
+            return SimdLevel::Scalar;
+        }
+#endif
+    }
+
+    SimdLevel GetSupportedSimdLevel()
+    {
+        static const SimdLevel level = DetectSimdLevel();
+
+        return level;
+    }
+
+    const char* ToString(SimdLevel a_level)
+    {
+        switch (a_level) {
+        case SimdLevel::SSE41:
+            return "SSE4.1";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        default:
+            return "scalar";
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MFGFIX_X64
+#endif
+
+// lets a single translation unit carry kernels for several instruction sets, msvc doesn't need it
+#if defined(_MSC_VER) && !defined(__clang__)
+#define MFGFIX_TARGET(a_isa)
+#else
+#define MFGFIX_TARGET(a_isa) __attribute__((target(a_isa)))
+#endif
+
+namespace MfgFix::Core
+{
+    enum class SimdLevel : std::uint32_t
+    {
+        Scalar = 0,
+        SSE41,
+        AVX2
+    };
+
+    // highest level supported by both the cpu and the os (CPUID/XGETBV)
+    SimdLevel GetSupportedSimdLevel();
+
+    const char* ToString(SimdLevel a_level);
+}
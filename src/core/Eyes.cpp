@@ -0,0 +1,202 @@
+#include "Eyes.h"
+#include "Channels.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        constexpr float pi_180 = 0.0174532925f;
+
+        float deg2rad(float a_degrees)
+        {
+            return a_degrees * pi_180;
+        }
+
+        const PowerCurve blinkDelayCurve{ 2.0f };
+    }
+
+    TrackParams MakeTrackParams(float a_trackEyeXY, float a_trackEyeZ, float a_trackSpeed, float a_timeDelta)
+    {
+        auto headingMax = deg2rad(a_trackEyeXY);
+        auto pitchMax = deg2rad(a_trackEyeZ);
+
+        return { headingMax, pitchMax, headingMax != 0.0f ? 1.0f / headingMax : 0.0f, pitchMax != 0.0f ? 1.0f / pitchMax : 0.0f, a_trackSpeed * a_timeDelta };
+    }
+
+    float BlinkUpdate(BlinkStage& a_stage, float& a_timer, const BlinkParams& a_params, float a_timeDelta, bool a_hold, Rng& a_rng)
+    {
+        a_timer = std::max(a_timer - a_timeDelta, 0.0f);
+        auto blinkValue = 0.0f;
+
+        switch (a_stage) {
+        case BlinkStage::BlinkDelay:
+            {
+                blinkValue = 0.0f;
+
+                if (a_timer == 0.0f) {
+                    a_stage = BlinkStage::BlinkDown;
+                    a_timer = a_params.downTime;
+                }
+
+                break;
+            }
+        case BlinkStage::BlinkDown:
+            {
+                blinkValue = a_params.downTime != 0.0f ? 1.0f - a_timer / a_params.downTime : 1.0f;
+
+                if (a_timer == 0.0f) {
+                    a_stage = BlinkStage::BlinkUp;
+                    a_timer = a_params.upTime;
+                }
+
+                break;
+            }
+        case BlinkStage::BlinkUp:
+            {
+                blinkValue = a_params.upTime != 0.0f ? a_timer / a_params.upTime : 0.0f;
+
+                if (a_timer == 0.0f) {
+                    a_stage = BlinkStage::BlinkDelay;
+                    a_timer = Random(a_rng, a_params.delayMin, a_params.delayMax, blinkDelayCurve);
+                }
+
+                break;
+            }
+        case BlinkStage::BlinkDownAndWait1:
+            {
+                if (a_hold) {
+                    blinkValue = a_params.downTime != 0.0f ? 1.0f - a_timer / a_params.downTime : 1.0f;
+                } else {
+                    blinkValue = 1.0f;
+                    a_stage = BlinkStage::BlinkUp;
+                    a_timer = a_params.upTime;
+                }
+
+                break;
+            }
+        case BlinkStage::BlinkDownAndWait2:
+            {
+                a_stage = BlinkStage::BlinkDownAndWait1;
+
+                break;
+            }
+        default:
+            {
+                blinkValue = 0.0f;
+                a_stage = BlinkStage::BlinkDelay;
+                a_timer = Random(a_rng, a_params.delayMin, a_params.delayMax, blinkDelayCurve);
+
+                break;
+            }
+        }
+
+        return std::clamp(blinkValue, 0.0f, 1.0f);
+    }
+
+    float EyesBlinkingUpdate(EyesState& a_eyes, const BlinkParams& a_params, float a_timeDelta, bool a_hold, Rng& a_rng)
+    {
+        return BlinkUpdate(a_eyes.blinkStage, a_eyes.blinkTimer, a_params, a_timeDelta, a_hold, a_rng);
+    }
+
+    bool EyesOffsetTimerUpdate(EyesState& a_eyes, float a_timeDelta)
+    {
+        a_eyes.offsetTimer = std::max(a_eyes.offsetTimer - a_timeDelta, 0.0f);
+
+        return a_eyes.offsetTimer <= 0.0f;
+    }
+
+    void EyesOffsetSelect(EyesState& a_eyes, const EyesOffsetParams& a_params, Rng& a_rng)
+    {
+        a_eyes.offsetTimer = Random(a_rng, a_params.delayMin, a_params.delayMax, a_params.delayCurve);
+
+        if (a_params.zeroChance > 0.0f) {
+            a_eyes.headingOffset = a_rng.Uniform() < a_params.zeroChance ? 0.0f : Random(a_rng, a_params.headingMin, a_params.headingMax);
+            a_eyes.pitchOffset = a_rng.Uniform() < a_params.zeroChance ? 0.0f : Random(a_rng, a_params.pitchMin, a_params.pitchMax);
+        } else {
+            a_eyes.headingOffset = Random(a_rng, a_params.headingMin, a_params.headingMax);
+            a_eyes.pitchOffset = Random(a_rng, a_params.pitchMin, a_params.pitchMax);
+        }
+    }
+
+    void EyesDirectionUpdate(EyesState& a_eyes, const TrackParams& a_track, std::span<float> a_modifiers)
+    {
+        auto headingMax = a_track.headingMax;
+        auto pitchMax = a_track.pitchMax;
+
+        a_eyes.heading = std::clamp(a_eyes.headingBase + a_eyes.headingOffset, a_eyes.heading - a_track.deltaMax, a_eyes.heading + a_track.deltaMax);
+        a_eyes.pitch = std::clamp(a_eyes.pitchBase + a_eyes.pitchOffset, a_eyes.pitch - a_track.deltaMax, a_eyes.pitch + a_track.deltaMax);
+        a_eyes.heading = std::clamp(a_eyes.heading, -headingMax, headingMax);
+        a_eyes.pitch = std::clamp(a_eyes.pitch, -pitchMax, pitchMax);
+
+        a_modifiers[Modifier::LookLeft] = a_eyes.heading < 0.0f ? -a_eyes.heading * a_track.headingMaxInv : 0.0f;
+        a_modifiers[Modifier::LookRight] = a_eyes.heading > 0.0f ? a_eyes.heading * a_track.headingMaxInv : 0.0f;
+        a_modifiers[Modifier::LookDown] = a_eyes.pitch < 0.0f ? -a_eyes.pitch * a_track.pitchMaxInv : 0.0f;
+        a_modifiers[Modifier::LookUp] = a_eyes.pitch > 0.0f ? a_eyes.pitch * a_track.pitchMaxInv : 0.0f;
+    }
+
+    void EyesDirectionRemove(const EyesState& a_eyes, const TrackParams& a_track, std::span<float> a_modifiers)
+    {
+        a_modifiers[Modifier::LookLeft] -= a_eyes.heading < 0.0f ? -a_eyes.heading * a_track.headingMaxInv : 0.0f;
+        a_modifiers[Modifier::LookRight] -= a_eyes.heading > 0.0f ? a_eyes.heading * a_track.headingMaxInv : 0.0f;
+        a_modifiers[Modifier::LookDown] -= a_eyes.pitch < 0.0f ? -a_eyes.pitch * a_track.pitchMaxInv : 0.0f;
+        a_modifiers[Modifier::LookUp] -= a_eyes.pitch > 0.0f ? a_eyes.pitch * a_track.pitchMaxInv : 0.0f;
+    }
+
+    void EyesDirectionSmoothUpdate(EyesState& a_eyes, const TrackParams& a_track, std::span<float> a_modifiers)
+    {
+        auto headingMax = a_track.headingMax;
+        auto pitchMax = a_track.pitchMax;
+
+        float modifierLeft = a_modifiers[Modifier::LookLeft];
+        float modifierRight = a_modifiers[Modifier::LookRight];
+        float modifierDown = a_modifiers[Modifier::LookDown];
+        float modifierUp = a_modifiers[Modifier::LookUp];
+
+        float modifierHeadingOffset = (modifierLeft > 0 ? -modifierLeft * headingMax : 0.0f) + (modifierRight > 0 ? modifierRight * headingMax : 0.0f);
+        float modifierPitchOffset = (modifierDown > 0 ? -modifierDown * pitchMax : 0.0f) + (modifierUp > 0 ? modifierUp * pitchMax : 0.0f);
+
+        a_eyes.heading = std::clamp(a_eyes.headingBase + a_eyes.headingOffset, a_eyes.heading - a_track.deltaMax, a_eyes.heading + a_track.deltaMax);
+        a_eyes.pitch = std::clamp(a_eyes.pitchBase + a_eyes.pitchOffset, a_eyes.pitch - a_track.deltaMax, a_eyes.pitch + a_track.deltaMax);
+
+        if ((a_eyes.heading + modifierHeadingOffset) > headingMax) {
+            a_eyes.heading = headingMax - modifierHeadingOffset;
+        } else if ((a_eyes.heading + modifierHeadingOffset) < -headingMax) {
+            a_eyes.heading = -headingMax - modifierHeadingOffset;
+        }
+
+        if ((a_eyes.pitch + modifierPitchOffset) > pitchMax) {
+            a_eyes.pitch = pitchMax - modifierPitchOffset;
+        } else if ((a_eyes.pitch + modifierPitchOffset) < -pitchMax) {
+            a_eyes.pitch = -pitchMax - modifierPitchOffset;
+        }
+
+        float currentHeading = a_eyes.heading + modifierHeadingOffset;
+        float currentPitch = a_eyes.pitch + modifierPitchOffset;
+
+        a_modifiers[Modifier::LookLeft] = std::clamp(currentHeading < 0.0f ? -currentHeading * a_track.headingMaxInv : 0.0f, 0.0f, 1.0f);
+        a_modifiers[Modifier::LookRight] = std::clamp(currentHeading > 0.0f ? currentHeading * a_track.headingMaxInv : 0.0f, 0.0f, 1.0f);
+        a_modifiers[Modifier::LookDown] = std::clamp(currentPitch < 0.0f ? -currentPitch * a_track.pitchMaxInv : 0.0f, 0.0f, 1.0f);
+        a_modifiers[Modifier::LookUp] = std::clamp(currentPitch > 0.0f ? currentPitch * a_track.pitchMaxInv : 0.0f, 0.0f, 1.0f);
+    }
+
+    void BlinkOverlayRemove(std::span<float> a_result, std::span<const float> a_target, std::span<const float> a_dialogue, float a_blinkValue)
+    {
+        if (a_blinkValue < (1.0f - FLT_EPSILON)) {
+            a_result[Modifier::BlinkLeft] = (float)(1.0f + (a_result[Modifier::BlinkLeft] - 1.0f) / (1.0 - a_blinkValue));
+            a_result[Modifier::BlinkRight] = (float)(1.0f + (a_result[Modifier::BlinkRight] - 1.0f) / (1.0 - a_blinkValue));
+        } else {
+            a_result[Modifier::BlinkLeft] = a_target[Modifier::BlinkLeft] != 0 ? a_target[Modifier::BlinkLeft] : a_dialogue[Modifier::BlinkLeft];
+            a_result[Modifier::BlinkRight] = a_target[Modifier::BlinkRight] != 0 ? a_target[Modifier::BlinkRight] : a_dialogue[Modifier::BlinkRight];
+        }
+    }
+
+    void BlinkOverlayApply(std::span<float> a_result, float a_blinkValue)
+    {
+        a_result[Modifier::BlinkLeft] = 1.0f - (1.0f - a_result[Modifier::BlinkLeft]) * (1.0f - a_blinkValue);
+        a_result[Modifier::BlinkRight] = 1.0f - (1.0f - a_result[Modifier::BlinkRight]) * (1.0f - a_blinkValue);
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Channels.h"
+#include "Random.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace MfgFix::Core
+{
+    enum class BlinkStage : std::uint32_t
+    {
+        BlinkDelay = 0,
+        BlinkDown,
+        BlinkUp,
+        WaitForLookDown,
+        BlinkDownAndWait1,
+        BlinkDownAndWait2
+    };
+
+    struct EyesState
+    {
+        BlinkStage blinkStage{ BlinkStage::BlinkDelay };
+        float blinkTimer{ 0.0f };
+        float offsetTimer{ 0.0f };
+        float headingOffset{ 0.0f };
+        float pitchOffset{ 0.0f };
+        float heading{ 0.0f };      // headingBase + headingOffset, rate limited
+        float pitch{ 0.0f };        // pitchBase + pitchOffset, rate limited
+        float headingBase{ 0.0f };  // set by the engine (head tracking)
+        float pitchBase{ 0.0f };    // set by the engine (head tracking)
+    };
+
+    struct BlinkParams
+    {
+        float downTime{ 0.0f };
+        float upTime{ 0.0f };
+        float delayMin{ 0.0f };
+        float delayMax{ 0.0f };
+    };
+
+    // expressions sharing one eyes movement profile
+    namespace Emotion
+    {
+        enum : std::uint32_t
+        {
+            Angry = 0,
+            Happy,
+            Surprise,
+            Sad,
+            Fear,
+            Neutral,
+            Puzzled,
+            Disgusted,
+            CombatAnger,
+            CombatShout,
+
+            Total
+        };
+    }
+
+    // by expression id
+    inline constexpr std::array<std::uint32_t, Expression::Total> kExpressionEmotion{
+        Emotion::Angry,      // DialogueAnger
+        Emotion::Fear,       // DialogueFear
+        Emotion::Happy,      // DialogueHappy
+        Emotion::Sad,        // DialogueSad
+        Emotion::Surprise,   // DialogueSurprise
+        Emotion::Puzzled,    // DialoguePuzzled
+        Emotion::Disgusted,  // DialogueDisgusted
+        Emotion::Neutral,    // MoodNeutral
+        Emotion::Angry,      // MoodAnger
+        Emotion::Fear,       // MoodFear
+        Emotion::Happy,      // MoodHappy
+        Emotion::Sad,        // MoodSad
+        Emotion::Surprise,   // MoodSurprise
+        Emotion::Puzzled,    // MoodPuzzled
+        Emotion::Disgusted,  // MoodDisgusted
+        Emotion::CombatAnger,
+        Emotion::CombatShout
+    };
+
+    // neutral for anything out of range (no active expression)
+    constexpr std::uint32_t EmotionOf(std::uint32_t a_expression)
+    {
+        return a_expression < kExpressionEmotion.size() ? kExpressionEmotion[a_expression] : Emotion::Neutral;
+    }
+
+    struct EyesOffsetParams
+    {
+        float headingMin{ 0.0f };
+        float headingMax{ 0.0f };
+        float pitchMin{ 0.0f };
+        float pitchMax{ 0.0f };
+        float delayMin{ 0.0f };
+        float delayMax{ 0.0f };
+        float delayExponent{ 1.0f };  // shape of the delay distribution, 1.0 is uniform
+        float zeroChance{ 0.0f };     // chance for each offset axis to stay centered
+        PowerCurve delayCurve{ delayExponent };  // rebuild after changing delayExponent
+    };
+
+    struct TrackParams
+    {
+        float headingMax{ 0.0f };     // radians
+        float pitchMax{ 0.0f };       // radians
+        float headingMaxInv{ 0.0f };  // 1 / headingMax, 0 when there is no limit
+        float pitchMaxInv{ 0.0f };    // 1 / pitchMax, 0 when there is no limit
+        float deltaMax{ 0.0f };       // radians this update
+    };
+
+    TrackParams MakeTrackParams(float a_trackEyeXY, float a_trackEyeZ, float a_trackSpeed, float a_timeDelta);
+
+    // advances the blink state machine, returns the blink value in [0, 1]
+    // a_hold keeps eyes closed while the engine holds BlinkDownAndWait1 (dead, sleeping, unconscious)
+    float BlinkUpdate(BlinkStage& a_stage, float& a_timer, const BlinkParams& a_params, float a_timeDelta, bool a_hold, Rng& a_rng);
+    float EyesBlinkingUpdate(EyesState& a_eyes, const BlinkParams& a_params, float a_timeDelta, bool a_hold, Rng& a_rng);
+
+    // counts down the saccade timer, returns true when a new offset has to be selected
+    bool EyesOffsetTimerUpdate(EyesState& a_eyes, float a_timeDelta);
+    void EyesOffsetSelect(EyesState& a_eyes, const EyesOffsetParams& a_params, Rng& a_rng);
+
+    // moves eyes toward base + offset and writes Look* modifiers
+    void EyesDirectionUpdate(EyesState& a_eyes, const TrackParams& a_track, std::span<float> a_modifiers);
+
+    // smooth update counterparts: eye direction is layered on top of the animated Look* modifiers
+    void EyesDirectionRemove(const EyesState& a_eyes, const TrackParams& a_track, std::span<float> a_modifiers);
+    void EyesDirectionSmoothUpdate(EyesState& a_eyes, const TrackParams& a_track, std::span<float> a_modifiers);
+
+    // smooth update keeps the blink value multiplied into the animated Blink* modifiers, these undo and redo it
+    void BlinkOverlayRemove(std::span<float> a_result, std::span<const float> a_target, std::span<const float> a_dialogue, float a_blinkValue);
+    void BlinkOverlayApply(std::span<float> a_result, float a_blinkValue);
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace MfgFix::Core
+{
+    // a T for every face, keyed by the face (animData pointer), created on first use
+    // a face is leased to one update at a time, Acquire from any thread
+    // the engine reuses the address of an unloaded face for the next one, Erase it when its actor goes
+    template <class T>
+    class FaceTable
+    {
+    public:
+        static constexpr std::size_t kShards = 16;
+        static constexpr std::size_t kMaxPerShard = 64;  // above it, faces not updated for as many acquires are dropped
+
+    private:
+        struct Entry
+        {
+            T value;
+            std::atomic<bool> inUse{ false };
+            std::uint64_t lastUse{ 0 };
+            bool erased{ false };  // while leased, starts over on the next acquire
+        };
+
+    public:
+        class Lease
+        {
+        public:
+            Lease() = default;
+            explicit Lease(Entry* a_entry) :
+                _entry(a_entry)
+            {}
+
+            Lease(Lease&& a_other) noexcept :
+                _entry(std::exchange(a_other._entry, nullptr))
+            {}
+
+            Lease& operator=(Lease&& a_other) noexcept
+            {
+                if (this != &a_other) {
+                    Release();
+                    _entry = std::exchange(a_other._entry, nullptr);
+                }
+                return *this;
+            }
+
+            ~Lease() { Release(); }
+
+            T* get() const { return _entry ? &_entry->value : nullptr; }
+            T* operator->() const { return get(); }
+            explicit operator bool() const { return _entry != nullptr; }
+
+        private:
+            void Release()
+            {
+                if (_entry) {
+                    _entry->inUse.store(false, std::memory_order_release);
+                    _entry = nullptr;
+                }
+            }
+
+            Entry* _entry{ nullptr };
+        };
+
+        // empty if the face is already leased to another update
+        Lease Acquire(std::uintptr_t a_key)
+        {
+            auto& shard = _shards[(a_key >> 4) % kShards];
+
+            std::lock_guard locker(shard.lock);
+
+            auto& entry = shard.entries[a_key];
+            if (!entry) {
+                entry = std::make_unique<Entry>();
+            }
+
+            if (entry->inUse.exchange(true, std::memory_order_acquire)) {
+                return {};
+            }
+
+            if (entry->erased) {
+                entry = std::make_unique<Entry>();
+                entry->inUse.store(true, std::memory_order_relaxed);
+            }
+
+            entry->lastUse = ++shard.clock;
+
+            if (shard.entries.size() > kMaxPerShard) {
+                std::erase_if(shard.entries, [&](auto& a_entry) {
+                    auto& other = a_entry.second;
+                    return other->lastUse + kMaxPerShard < shard.clock && !other->inUse.load(std::memory_order_acquire);
+                });
+            }
+
+            return Lease(entry.get());
+        }
+
+        // a_func on the T of a_key if it has one, leased or not, so only for what T lets other threads touch
+        template <class F>
+        void Visit(std::uintptr_t a_key, F&& a_func)
+        {
+            auto& shard = _shards[(a_key >> 4) % kShards];
+
+            std::lock_guard locker(shard.lock);
+
+            if (auto it = shard.entries.find(a_key); it != shard.entries.end() && !it->second->erased) {
+                a_func(it->second->value);
+            }
+        }
+
+        // a leased face is kept until its update is done and starts over the next time it's acquired
+        void Erase(std::uintptr_t a_key)
+        {
+            auto& shard = _shards[(a_key >> 4) % kShards];
+
+            std::lock_guard locker(shard.lock);
+
+            auto it = shard.entries.find(a_key);
+            if (it == shard.entries.end()) {
+                return;
+            }
+
+            if (it->second->inUse.load(std::memory_order_acquire)) {
+                it->second->erased = true;
+            } else {
+                shard.entries.erase(it);
+            }
+        }
+
+        // leased faces stay
+        void Clear()
+        {
+            for (auto& shard : _shards) {
+                std::lock_guard locker(shard.lock);
+
+                std::erase_if(shard.entries, [](auto& a_entry) { return !a_entry.second->inUse.load(std::memory_order_acquire); });
+            }
+        }
+
+        std::size_t Size() const
+        {
+            std::size_t size = 0;
+
+            for (auto& shard : _shards) {
+                std::lock_guard locker(shard.lock);
+                size += shard.entries.size();
+            }
+
+            return size;
+        }
+
+    private:
+        struct Shard
+        {
+            mutable std::mutex lock;
+            std::unordered_map<std::uintptr_t, std::unique_ptr<Entry>> entries;
+            std::uint64_t clock{ 0 };
+        };
+
+        std::array<Shard, kShards> _shards;
+    };
+}
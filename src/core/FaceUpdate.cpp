@@ -0,0 +1,26 @@
+#include "FaceUpdate.h"
+
+namespace MfgFix::Core
+{
+    EyesTimers EyesTimersUpdate(EyesState& a_eyes, const FaceUpdateContext& a_context, bool a_hold)
+    {
+        EyesTimers result;
+
+        result.blinkValue = EyesBlinkingUpdate(a_eyes, a_context.blink, a_context.timeDelta, a_hold, *a_context.rng);
+        result.offsetDue = !a_hold && EyesOffsetTimerUpdate(a_eyes, a_context.timeDelta);
+
+        return result;
+    }
+
+    void SmoothMerge(const FaceUpdateContext& a_context, TransitionLayer a_layer, std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result)
+    {
+        if (!a_context.transition) {
+            AnimMerge(a_dialogue, a_target, a_result, a_context.animationStep);
+            return;
+        }
+
+        // the durations are for speed 1.0, the speed of the actor scales them like it scales the step
+        auto duration = a_context.transitionParams->duration[static_cast<std::size_t>(a_layer)] * a_context.speed;
+        (*a_context.transition)[a_layer].Merge(a_dialogue, a_target, a_result, duration, a_context.timeDelta, a_context.transitionParams->ease, a_context.transition->Writes());
+    }
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "Blend.h"
+#include "Eyes.h"
+#include "Idle.h"
+#include "Lod.h"
+#include "Timeline.h"
+#include "Transition.h"
+
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace MfgFix::Core
+{
+    // everything a single face update needs from outside the face, resolved once per call
+    struct FaceUpdateContext
+    {
+        static constexpr std::uint32_t kUnresolved = ~std::uint32_t{ 0 };
+
+        float timeDelta{ 0.0f };
+        float speed{ 0.0f };
+        float animationStep{ 0.0f };  // timeDelta / speed, smooth update only
+        float phonemeThreshold{ 0.0f };
+        BlinkParams blink;
+        TrackParams track;                             // deltaMax scaled to timeDelta
+        std::span<const EyesOffsetParams> eyesOffset;  // by expression id
+        Rng* rng{ nullptr };
+        std::uint32_t activeExpression{ kUnresolved };  // filled on first use, expression layer 3 is final by then
+        Timeline* timeline{ nullptr };                  // null unless recording
+        std::uint64_t face{ 0 };                        // id of the face on the timeline
+        IdleFace* idle{ nullptr };                      // null updates every face in full
+        std::uint32_t lodParts{ LodPart::All };         // parts of the update the face's level of detail keeps
+        FaceTransition* transition{ nullptr };          // null steps every channel by animationStep
+        const TransitionParams* transitionParams{ nullptr };
+    };
+
+    struct EyesTimers
+    {
+        float blinkValue{ 0.0f };
+        bool offsetDue{ false };  // a new eyes offset has to be selected
+    };
+
+    // advances blink and saccade timers of a face
+    EyesTimers EyesTimersUpdate(EyesState& a_eyes, const FaceUpdateContext& a_context, bool a_hold);
+
+    // one smoothed layer 3 toward its targets, along the face's planned transition if it has one
+    void SmoothMerge(const FaceUpdateContext& a_context, TransitionLayer a_layer, std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result);
+
+    // The update steps below are shared by the game and the trace replayer. Face provides:
+    //   std::span<float> Values(Layer)
+    //   bool IsZero(Layer), void Reset(Layer), void Copy(Layer a_src, Layer a_dst)    keyframe semantics of the engine
+    //   bool TransitionUpdate(float), void DialogueModifiersUpdate(float), void DialoguePhonemesUpdate(float)
+    //                          layer 1 updates done by the engine, TransitionUpdate true if it may have moved expression layer 1
+    //   EyesTimers EyesTimersUpdate(const FaceUpdateContext&)
+    //   EyesState GetEyesState(), void SetEyesState(const EyesState&)
+    //   float& BlinkValue()    blink value multiplied into the smooth output, kept in modifier layer 2's timer
+    //   bool Hold()            blink hold, also freezes eyes movement
+    //   bool Dialogue()        dialogue data attached
+
+    template <class Face>
+    std::uint32_t ActiveExpression(Face& a_face, FaceUpdateContext& a_context)
+    {
+        if (a_context.activeExpression == FaceUpdateContext::kUnresolved) {
+            a_context.activeExpression = ActiveExpression(a_face.Values(Layer::Expression3));
+        }
+
+        return a_context.activeExpression;
+    }
+
+    template <class Face>
+    void EyesMovementUpdate(Face& a_face, FaceUpdateContext& a_context, bool a_offsetDue)
+    {
+        if (a_offsetDue) {
+            auto eyes = a_face.GetEyesState();
+            EyesOffsetSelect(eyes, a_context.eyesOffset[ActiveExpression(a_face, a_context)], *a_context.rng);
+            a_face.SetEyesState(eyes);
+        }
+    }
+
+    // drops blinks and new eyes offsets if the level of detail switched them off
+    // eyes the engine closed on purpose (BlinkDownAndWait*, dead or sleeping faces) stay closed
+    template <class Face>
+    EyesTimers EyesTimersLodUpdate(Face& a_face, FaceUpdateContext& a_context)
+    {
+        auto result = a_face.EyesTimersUpdate(a_context);
+
+        if (!(a_context.lodParts & LodPart::Blink)) {
+            auto stage = a_face.GetEyesState().blinkStage;
+            if (stage == BlinkStage::BlinkDelay || stage == BlinkStage::BlinkDown || stage == BlinkStage::BlinkUp) {
+                result.blinkValue = 0.0f;
+            }
+        }
+        if (!(a_context.lodParts & LodPart::Saccades)) {
+            result.offsetDue = false;
+        }
+
+        return result;
+    }
+
+    // the timers of the frame, and whether a resting face can leave its modifiers as they are
+    template <class Face>
+    std::pair<EyesTimers, bool> EyesTimersIdleUpdate(Face& a_face, FaceUpdateContext& a_context, IdleFace::Mode a_mode)
+    {
+        auto result = EyesTimersLodUpdate(a_face, a_context);
+        auto same = a_context.idle && a_context.idle->SameTimers(result.blinkValue, result.offsetDue);
+
+        return { result, same && a_mode == IdleFace::Mode::Resting };
+    }
+
+    template <class Face>
+    IdleFace::Mode IdleBegin(Face& a_face, FaceUpdateContext& a_context, bool a_smooth, bool a_moved)
+    {
+        auto mode = a_context.idle ? a_context.idle->Begin(a_face, a_smooth, a_moved) : IdleFace::Mode::Full;
+
+        // a transition on its way can leave a frame as it found it, early on a flat curve, without being done
+        return a_context.transition && a_context.transition->Moving() ? IdleFace::Mode::Full : mode;
+    }
+
+    template <class Face>
+    void IdleEnd(Face& a_face, FaceUpdateContext& a_context, IdleFace::Mode a_mode)
+    {
+        if (a_context.idle) {
+            a_context.idle->End(a_face, a_mode, a_context.timeDelta != 0.0f);
+        }
+    }
+
+    template <class Face>
+    void RegularUpdate(Face& a_face, FaceUpdateContext& a_context)
+    {
+        // only moves expression layer 1, done first so the idle check sees the result
+        auto moved = a_face.TransitionUpdate(a_context.timeDelta);
+
+        auto mode = IdleBegin(a_face, a_context, false, moved);
+        if (mode == IdleFace::Mode::Frozen) {
+            return;
+        }
+
+        // expressions
+        if (mode == IdleFace::Mode::Full) {
+            TimelineScope scope(a_context.timeline, Span::Expressions, a_context.face);
+
+            a_face.Reset(Layer::Expression3);
+
+            if (!a_face.IsZero(Layer::Expression1)) {
+                a_face.Copy(Layer::Expression1, Layer::Expression3);
+            }
+            if (!a_face.IsZero(Layer::Expression2)) {
+                a_face.Copy(Layer::Expression2, Layer::Expression3);
+            }
+        }
+
+        // modifiers
+        {
+            TimelineScope scope(a_context.timeline, Span::Modifiers, a_context.face);
+
+            // nothing else changes, so there's nothing for IdleEnd to look at either
+            auto [eyesTimers, resting] = EyesTimersIdleUpdate(a_face, a_context, mode);
+            if (resting) {
+                return;
+            }
+
+            a_face.Reset(Layer::Modifier3);
+
+            a_face.DialogueModifiersUpdate(a_context.timeDelta);
+
+            auto modifier3 = a_face.Values(Layer::Modifier3);
+
+            modifier3[Modifier::BlinkLeft] = eyesTimers.blinkValue;
+            modifier3[Modifier::BlinkRight] = eyesTimers.blinkValue;
+
+            MergeModifiers(a_face.Values(Layer::Modifier1), modifier3);
+
+            if (!a_face.Hold()) {
+                EyesMovementUpdate(a_face, a_context, eyesTimers.offsetDue);
+
+                auto eyes = a_face.GetEyesState();
+                EyesDirectionUpdate(eyes, a_context.track, modifier3);
+                a_face.SetEyesState(eyes);
+            }
+
+            MergeModifiers(a_face.Values(Layer::Modifier2), modifier3);
+        }
+
+        if (mode == IdleFace::Mode::Full) {
+            // phonemes
+            {
+                TimelineScope scope(a_context.timeline, Span::Phonemes, a_context.face);
+
+                a_face.Reset(Layer::Phoneme3);
+
+                a_face.DialoguePhonemesUpdate(a_context.timeDelta);
+
+                MergeNonZero(a_face.Values(Layer::Phoneme1), a_face.Values(Layer::Phoneme3));
+                if (a_face.Dialogue()) {
+                    MergeAboveThreshold(a_face.Values(Layer::Phoneme2), a_face.Values(Layer::Phoneme3), a_context.phonemeThreshold);
+                } else {
+                    MergeNonZero(a_face.Values(Layer::Phoneme2), a_face.Values(Layer::Phoneme3));
+                }
+            }
+
+            // custom
+            {
+                TimelineScope scope(a_context.timeline, Span::Custom, a_context.face);
+
+                a_face.Reset(Layer::Custom3);
+
+                MergeNonZero(a_face.Values(Layer::Custom1), a_face.Values(Layer::Custom3));
+                MergeNonZero(a_face.Values(Layer::Custom2), a_face.Values(Layer::Custom3));
+            }
+        }
+
+        IdleEnd(a_face, a_context, mode);
+    }
+
+    template <class Face>
+    void SmoothUpdate(Face& a_face, FaceUpdateContext& a_context)
+    {
+        auto moved = a_face.TransitionUpdate(a_context.timeDelta);
+
+        auto mode = IdleBegin(a_face, a_context, true, moved);
+        if (mode == IdleFace::Mode::Frozen) {
+            return;
+        }
+
+        // expressions
+        if (mode == IdleFace::Mode::Full) {
+            TimelineScope scope(a_context.timeline, Span::Expressions, a_context.face);
+
+            SmoothMerge(a_context, TransitionLayer::Expression, a_face.Values(Layer::Expression1), a_face.Values(Layer::Expression2), a_face.Values(Layer::Expression3));
+        }
+
+        // modifiers
+        {
+            TimelineScope scope(a_context.timeline, Span::Modifiers, a_context.face);
+
+            // nothing else changes, so there's nothing for IdleEnd to look at either
+            auto [eyesTimers, resting] = EyesTimersIdleUpdate(a_face, a_context, mode);
+            if (resting) {
+                return;
+            }
+
+            a_face.DialogueModifiersUpdate(a_context.timeDelta);
+
+            auto modifier3 = a_face.Values(Layer::Modifier3);
+            auto& blinkValue = a_face.BlinkValue();
+
+            BlinkOverlayRemove(modifier3, a_face.Values(Layer::Modifier2), a_face.Values(Layer::Modifier1), blinkValue);
+
+            blinkValue = eyesTimers.blinkValue;
+
+            if (!a_face.Hold()) {
+                EyesDirectionRemove(a_face.GetEyesState(), a_context.track, modifier3);
+
+                EyesMovementUpdate(a_face, a_context, eyesTimers.offsetDue);
+            }
+
+            SmoothMerge(a_context, TransitionLayer::Modifier, a_face.Values(Layer::Modifier1), a_face.Values(Layer::Modifier2), modifier3);
+
+            BlinkOverlayApply(modifier3, blinkValue);
+
+            if (!a_face.Hold()) {
+                auto eyes = a_face.GetEyesState();
+                EyesDirectionSmoothUpdate(eyes, a_context.track, modifier3);
+                a_face.SetEyesState(eyes);
+            }
+        }
+
+        if (mode == IdleFace::Mode::Full) {
+            // phonemes
+            {
+                TimelineScope scope(a_context.timeline, Span::Phonemes, a_context.face);
+
+                a_face.DialoguePhonemesUpdate(a_context.timeDelta);
+
+                if (a_face.Dialogue()) {
+                    ZeroBelowThreshold(a_face.Values(Layer::Phoneme2), a_context.phonemeThreshold);
+                }
+                SmoothMerge(a_context, TransitionLayer::Phoneme, a_face.Values(Layer::Phoneme1), a_face.Values(Layer::Phoneme2), a_face.Values(Layer::Phoneme3));
+            }
+
+            // custom
+            {
+                TimelineScope scope(a_context.timeline, Span::Custom, a_context.face);
+
+                SmoothMerge(a_context, TransitionLayer::Custom, a_face.Values(Layer::Custom1), a_face.Values(Layer::Custom2), a_face.Values(Layer::Custom3));
+            }
+        }
+
+        IdleEnd(a_face, a_context, mode);
+    }
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "Channels.h"
+#include "Eyes.h"
+#include "FaceTable.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace MfgFix::Core
+{
+    // What a face looked like after its last update, so faces that stopped changing can skip most of the next one.
+    // An update that left the expression, phoneme and custom layers exactly as the update before left them is a fixed point:
+    // as long as nothing wrote those layers since and no dialogue is attached, running it again changes nothing.
+    // Whatever writes the layers outside the update (scripts, the console, sequences, dialogue ending) calls Written,
+    // and the engine moving expression layer 1 is reported by the update, so telling that nothing did is one compare.
+    // Such idle faces only run the modifiers step, which owns the blink and eyes channels.
+    // If the last modifiers step was a fixed point as well, apart from the blink and saccade timers counting down, the face
+    // rests: only the timers run, and the modifiers step only when they bring a blink value or an eyes offset it hasn't seen.
+    // Held faces (dead, unconscious) resting in BlinkDownAndWait1 whose modifiers and eyes are a fixed point too are frozen,
+    // nothing runs for them.
+    // A frame that didn't move time (timeDelta 0) proves nothing, it never makes a face idle.
+    class IdleFace
+    {
+    public:
+        static constexpr std::uint32_t kMaxChannels = 32;
+
+        enum class Mode : std::uint32_t
+        {
+            Full = 0,
+            Idle,
+            Resting,
+            Frozen
+        };
+
+        // layers of the face were written outside its update, from any thread; the next update runs in full
+        void Written() { _written.fetch_add(1, std::memory_order_release); }
+
+        // call after the engine moved expression layer 1, a_moved if that changed it; a_smooth tells the update kind apart
+        template <class Face>
+        Mode Begin(Face& a_face, bool a_smooth, bool a_moved)
+        {
+            auto written = _written.load(std::memory_order_acquire);
+            auto same = written == _seenWritten && !a_moved;
+
+            _seenWritten = written;
+            _untouched = same;
+
+            // the engine aims the eyes between updates, the rest of the pose is written with the layers
+            auto samePose = false;
+            auto sameEyes = SyncEyes(a_face, samePose);
+            auto tracked = a_face.Hold() && a_face.GetEyesState().blinkStage == BlinkStage::BlinkDownAndWait1;
+
+            auto mode = Mode::Full;
+
+            if (same && _staticFixed && _smooth == a_smooth && !a_face.Dialogue()) {
+                if (tracked && sameEyes && _modifiersFixed) {
+                    mode = Mode::Frozen;
+                } else if (samePose && _poseFixed) {
+                    mode = Mode::Resting;
+                } else {
+                    mode = Mode::Idle;
+                }
+            }
+
+            _smooth = a_smooth;
+            _modifiersTracked = tracked;
+
+            return mode;
+        }
+
+        // the timers of every frame that runs them, true if they leave the modifiers where the last ones did
+        bool SameTimers(float a_blinkValue, bool a_offsetDue)
+        {
+            auto same = _timersValid && !a_offsetDue && std::memcmp(&_timersBlinkValue, &a_blinkValue, sizeof(float)) == 0;
+
+            _timersBlinkValue = a_blinkValue;
+            _timersValid = true;
+
+            return same;
+        }
+
+        // a_stepped false for a frame with no time passing
+        // the layers are held against what the last update of them left, which is what this one found unless something
+        // wrote them in between; such a frame only starts over
+        template <class Face>
+        void End(Face& a_face, Mode a_mode, bool a_stepped)
+        {
+            if (a_mode == Mode::Frozen) {
+                return;
+            }
+
+            auto proves = _untouched && a_stepped;
+
+            if (a_mode == Mode::Full) {
+                _staticFixed = SyncLayers(a_face, kStaticLayers, _static) && proves;
+            }
+
+            auto modifiers = SyncLayers(a_face, kModifierLayers, _modifiers);
+            auto pose = false;
+            auto eyes = SyncEyes(a_face, pose);
+
+            _modifiersFixed = _modifiersTracked && modifiers && eyes && proves;
+            _poseFixed = modifiers && pose && proves;
+        }
+
+    private:
+        static constexpr std::array kStaticLayers{
+            Layer::Expression1, Layer::Expression2, Layer::Expression3,
+            Layer::Phoneme1, Layer::Phoneme2, Layer::Phoneme3,
+            Layer::Custom1, Layer::Custom2, Layer::Custom3
+        };
+        static constexpr std::array kModifierLayers{ Layer::Modifier1, Layer::Modifier2, Layer::Modifier3 };
+
+        // values of all layers back to back, only as wide as the layers are, to keep the extra cache lines down
+        template <std::size_t N>
+        struct Layers
+        {
+            std::array<std::uint32_t, N> counts{};
+            std::array<float, N * kMaxChannels> values{};
+            bool valid{ false };
+        };
+
+        // bitwise, so -0.0 and 0.0 differ just like they would after the update
+        static bool SameBits(const float* a_lhs, const float* a_rhs, std::uint32_t a_count)
+        {
+            return std::memcmp(a_lhs, a_rhs, a_count * sizeof(float)) == 0;
+        }
+
+        // copies the face layers into a_layers, returns true if nothing differed
+        template <class Face, std::size_t N>
+        static bool SyncLayers(Face& a_face, const std::array<Layer, N>& a_ids, Layers<N>& a_layers)
+        {
+            auto same = a_layers.valid;
+            std::uint32_t offset = 0;
+
+            for (std::size_t i = 0; i < N; ++i) {
+                auto values = a_face.Values(a_ids[i]);
+
+                if (values.size() > kMaxChannels) {
+                    a_layers.valid = false;
+                    return false;
+                }
+
+                auto count = static_cast<std::uint32_t>(values.size());
+                auto stored = a_layers.values.data() + offset;
+
+                // once a width changed everything behind it moved, copy the rest
+                if (!same || a_layers.counts[i] != count || !SameBits(stored, values.data(), count)) {
+                    a_layers.counts[i] = count;
+                    std::memcpy(stored, values.data(), values.size_bytes());
+                    same = false;
+                }
+
+                offset += count;
+            }
+
+            a_layers.valid = true;
+
+            return same;
+        }
+
+        // the eyes and blink value into what the last call saw, both parts always, a stale half could match by accident later
+        // a_pose is set if everything but the eyes timers matched, the result is whether everything did
+        template <class Face>
+        bool SyncEyes(Face& a_face, bool& a_pose)
+        {
+            auto eyes = a_face.GetEyesState();
+            auto blinkValue = a_face.BlinkValue();
+
+            auto sameTimers = _eyes.blinkStage == eyes.blinkStage &&
+                              std::memcmp(&_eyes.blinkTimer, &eyes.blinkTimer, sizeof(float)) == 0 &&
+                              std::memcmp(&_eyes.offsetTimer, &eyes.offsetTimer, sizeof(float)) == 0;
+            auto samePose = std::memcmp(&_eyes.headingOffset, &eyes.headingOffset, sizeof(EyesState) - offsetof(EyesState, headingOffset)) == 0 &&
+                            std::memcmp(&_blinkValue, &blinkValue, sizeof(float)) == 0;
+
+            _eyes = eyes;
+            _blinkValue = blinkValue;
+
+            a_pose = samePose;
+
+            return samePose && sameTimers;
+        }
+
+        Layers<kStaticLayers.size()> _static;
+        Layers<kModifierLayers.size()> _modifiers;
+        EyesState _eyes;  // headingOffset onwards is the pose, everything before the timers
+        float _blinkValue{ 0.0f };
+        std::atomic<std::uint32_t> _written{ 0 };
+        std::uint32_t _seenWritten{ 0 };
+        bool _untouched{ false };  // nothing wrote the layers since the last update
+        bool _smooth{ false };
+        bool _staticFixed{ false };
+        float _timersBlinkValue{ 0.0f };
+        bool _timersValid{ false };
+        bool _modifiersTracked{ false };
+        bool _modifiersFixed{ false };
+        bool _poseFixed{ false };
+    };
+
+    // IdleFace of every face
+    using IdleFaces = FaceTable<IdleFace>;
+}
@@ -0,0 +1,56 @@
+#include "Lod.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MfgFix::Core
+{
+    float ScreenSize(float a_radius, float a_distance, float a_fov)
+    {
+        auto halfWidth = a_distance * std::tan(std::clamp(a_fov, 0.01f, 3.1f) * 0.5f);
+
+        return halfWidth > a_radius ? a_radius / halfWidth : 1.0f;
+    }
+
+    LodPolicy::LodPolicy(std::span<const LodBand> a_bands, float a_refreshInterval) :
+        _refreshInterval(std::max(a_refreshInterval, 0.0f))
+    {
+        for (auto& band : a_bands.first(std::min(a_bands.size(), kMaxBands - 1))) {
+            auto& previous = _bands[_size - 1];
+            auto& next = _bands[_size++];
+
+            next = band;
+            next.distance = std::max(next.distance, previous.distance);
+            next.screenSize = std::min(next.screenSize, previous.screenSize);
+            next.interval = std::max(next.interval, 1u);
+        }
+    }
+
+    std::uint32_t LodPolicy::Select(std::uint32_t a_current, const LodView& a_view) const
+    {
+        std::uint32_t band = 0;
+
+        for (std::uint32_t i = 1; i < _size; ++i) {
+            auto& next = _bands[i];
+            auto margin = i <= a_current ? kHysteresis : 0.0f;
+
+            if (a_view.distance < next.distance * (1.0f - margin) || a_view.screenSize > next.screenSize * (1.0f + margin)) {
+                break;
+            }
+
+            band = i;
+        }
+
+        return band;
+    }
+
+    void LodPolicy::Enter(LodState& a_state, std::uintptr_t a_key, std::uint32_t a_band) const
+    {
+        if (a_state.band == a_band) {
+            return;
+        }
+
+        a_state.band = a_band;
+        a_state.wait = static_cast<std::uint32_t>((a_key >> 4) % (*this)[a_band].interval);
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "FaceTable.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace MfgFix::Core
+{
+    // parts of the face update a level of detail band can switch off
+    namespace LodPart
+    {
+        enum : std::uint32_t
+        {
+            Blink = 1 << 0,      // eyes open while off, held (closed) eyes stay closed
+            Saccades = 1 << 1,   // new eyes offsets, the current one is kept while off
+            Smoothing = 1 << 2,  // smooth transitions, values snap to their targets while off
+
+            All = Blink | Saccades | Smoothing
+        };
+    }
+
+    struct LodBand
+    {
+        float distance{ 0.0f };                // camera distance the band starts at, game units
+        float screenSize{ 1.0f };              // ... if the head also covers at most this fraction of the view
+        std::uint32_t interval{ 1 };           // updates once every this many frames
+        std::uint32_t parts{ LodPart::All };  // LodPart flags
+    };
+
+    // where a face is seen from
+    struct LodView
+    {
+        float distance{ 0.0f };
+        float screenSize{ 1.0f };
+    };
+
+    // a sphere of a_radius at a_distance as a fraction of the view width, a_fov horizontal in radians
+    float ScreenSize(float a_radius, float a_distance, float a_fov);
+
+    // what a face went through so far, owned by the policy
+    struct LodState
+    {
+        std::uint32_t band{ 0 };
+        std::uint32_t wait{ 0 };     // frames to skip before the next update
+        float pending{ 0.0f };       // time of the skipped frames
+        float refresh{ 0.0f };       // seconds until the band is selected again
+    };
+
+    using LodFaces = FaceTable<LodState>;
+
+    // Picks a band per face from its distance and projected size, bands get farther and cheaper in order.
+    // Band 0 is full detail. A face moves into a farther band once it's past that band's distance and small enough,
+    // and back only once it's clearly in front of it again, so faces sitting on a threshold don't flip every refresh.
+    class LodPolicy
+    {
+    public:
+        static constexpr std::size_t kMaxBands = 4;
+        static constexpr float kHysteresis = 0.1f;
+
+        // full detail only
+        LodPolicy() = default;
+
+        // a_bands follow band 0, out of order thresholds are raised to the previous band's, intervals to at least 1
+        LodPolicy(std::span<const LodBand> a_bands, float a_refreshInterval);
+
+        std::uint32_t Select(std::uint32_t a_current, const LodView& a_view) const;
+
+        // One frame of a face. Selects its band again when due, a_measure() returns the LodView and is only called then.
+        // Returns the time delta to update the face with, all skipped frames included, or nothing if it skips this one.
+        template <class Measure>
+        std::optional<float> Step(LodState& a_state, std::uintptr_t a_key, float a_timeDelta, Measure&& a_measure) const
+        {
+            a_state.refresh -= a_timeDelta;
+
+            if (a_state.refresh <= 0.0f) {
+                a_state.refresh = _refreshInterval;
+                Enter(a_state, a_key, Select(a_state.band, a_measure()));
+            }
+
+            a_state.pending += a_timeDelta;
+
+            if (a_state.wait > 0) {
+                --a_state.wait;
+                return std::nullopt;
+            }
+
+            a_state.wait = (*this)[a_state.band].interval - 1;
+
+            return std::exchange(a_state.pending, 0.0f);
+        }
+
+        const LodBand& operator[](std::uint32_t a_band) const { return _bands[a_band < _size ? a_band : 0]; }
+        std::size_t Size() const { return _size; }
+        float RefreshInterval() const { return _refreshInterval; }
+
+    private:
+        // faces entering a band are spread over its interval by key, so a crowd doesn't update on the same frame
+        void Enter(LodState& a_state, std::uintptr_t a_key, std::uint32_t a_band) const;
+
+        std::array<LodBand, kMaxBands> _bands{};
+        std::size_t _size{ 1 };
+        float _refreshInterval{ 0.5f };
+    };
+}
@@ -0,0 +1,734 @@
+#include "Presets.h"
+#include "Text.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <system_error>
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        constexpr std::size_t kExpressionId = 30;
+        constexpr std::size_t kMaxDepth = 64;
+
+        char Lower(char a_char)
+        {
+            return a_char >= 'A' && a_char <= 'Z' ? static_cast<char>(a_char - 'A' + 'a') : a_char;
+        }
+
+        // ASCII only, the way the game compares BSFixedStrings
+        int CompareNames(std::string_view a_lhs, std::string_view a_rhs)
+        {
+            auto size = std::min(a_lhs.size(), a_rhs.size());
+
+            for (std::size_t i = 0; i < size; ++i) {
+                auto lhs = static_cast<unsigned char>(Lower(a_lhs[i]));
+                auto rhs = static_cast<unsigned char>(Lower(a_rhs[i]));
+                if (lhs != rhs) {
+                    return lhs < rhs ? -1 : 1;
+                }
+            }
+
+            return a_lhs.size() == a_rhs.size() ? 0 : (a_lhs.size() < a_rhs.size() ? -1 : 1);
+        }
+
+        void AppendUtf8(std::string& a_text, std::uint32_t a_code)
+        {
+            if (a_code < 0x80) {
+                a_text += static_cast<char>(a_code);
+            } else if (a_code < 0x800) {
+                a_text += static_cast<char>(0xC0 | a_code >> 6);
+                a_text += static_cast<char>(0x80 | (a_code & 0x3F));
+            } else if (a_code < 0x10000) {
+                a_text += static_cast<char>(0xE0 | a_code >> 12);
+                a_text += static_cast<char>(0x80 | (a_code >> 6 & 0x3F));
+                a_text += static_cast<char>(0x80 | (a_code & 0x3F));
+            } else {
+                a_text += static_cast<char>(0xF0 | a_code >> 18);
+                a_text += static_cast<char>(0x80 | (a_code >> 12 & 0x3F));
+                a_text += static_cast<char>(0x80 | (a_code >> 6 & 0x3F));
+                a_text += static_cast<char>(0x80 | (a_code & 0x3F));
+            }
+        }
+
+        // just enough JSON for preset files: strings, numbers and anything else skipped over
+        class Parser
+        {
+        public:
+            explicit Parser(std::string_view a_text) :
+                _text(a_text)
+            {
+                if (_text.starts_with("\xEF\xBB\xBF")) {
+                    _position = 3;
+                }
+            }
+
+            void Parse(PresetParse& a_result)
+            {
+                if (!Expect('{')) {
+                    return Finish(a_result);
+                }
+
+                if (!Consume('}')) {
+                    do {
+                        std::string name;
+                        if (!String(name) || !Expect(':')) {
+                            return Finish(a_result);
+                        }
+
+                        PackedPreset preset;
+                        bool valid;
+                        if (!Preset(preset, valid)) {
+                            return Finish(a_result);
+                        }
+
+                        if (valid) {
+                            a_result.presets.push_back({ std::move(name), preset });
+                        } else {
+                            a_result.skipped.push_back(std::move(name));
+                        }
+                    } while (Consume(','));
+
+                    if (!Expect('}')) {
+                        return Finish(a_result);
+                    }
+                }
+
+                SkipSpace();
+                if (_position != _text.size()) {
+                    Fail("unexpected text after the object");
+                }
+
+                Finish(a_result);
+            }
+
+        private:
+            void Finish(PresetParse& a_result)
+            {
+                if (!_error.empty()) {
+                    a_result.presets.clear();
+                    a_result.skipped.clear();
+                    a_result.error = std::move(_error);
+                }
+            }
+
+            bool Fail(const char* a_message)
+            {
+                if (_error.empty()) {
+                    auto line = std::count(_text.begin(), _text.begin() + std::min(_position, _text.size()), '\n') + 1;
+                    AppendFormat(_error, "line %zu: %s", static_cast<std::size_t>(line), a_message);
+                }
+
+                return false;
+            }
+
+            void SkipSpace()
+            {
+                while (_position < _text.size() && (_text[_position] == ' ' || _text[_position] == '\t' || _text[_position] == '\n' || _text[_position] == '\r')) {
+                    ++_position;
+                }
+            }
+
+            char Peek()
+            {
+                SkipSpace();
+                return _position < _text.size() ? _text[_position] : '\0';
+            }
+
+            bool Consume(char a_char)
+            {
+                if (Peek() != a_char) {
+                    return false;
+                }
+
+                ++_position;
+                return true;
+            }
+
+            bool Expect(char a_char)
+            {
+                if (Consume(a_char)) {
+                    return true;
+                }
+
+                std::string message = "expected '";
+                message += a_char;
+                message += '\'';
+                return Fail(message.c_str());
+            }
+
+            bool Hex(std::uint32_t& a_code)
+            {
+                if (_position + 4 > _text.size()) {
+                    return Fail("truncated \\u escape");
+                }
+
+                auto first = _text.data() + _position;
+                auto [end, error] = std::from_chars(first, first + 4, a_code, 16);
+                if (error != std::errc{} || end != first + 4) {
+                    return Fail("bad \\u escape");
+                }
+
+                _position += 4;
+                return true;
+            }
+
+            bool String(std::string& a_text)
+            {
+                if (!Expect('"')) {
+                    return false;
+                }
+
+                while (_position < _text.size()) {
+                    auto c = _text[_position++];
+
+                    if (c == '"') {
+                        return true;
+                    } else if (static_cast<unsigned char>(c) < 0x20) {
+                        return Fail("control character in string");
+                    } else if (c != '\\') {
+                        a_text += c;
+                        continue;
+                    }
+
+                    if (_position == _text.size()) {
+                        break;
+                    }
+
+                    switch (_text[_position++]) {
+                    case '"':
+                        a_text += '"';
+                        break;
+                    case '\\':
+                        a_text += '\\';
+                        break;
+                    case '/':
+                        a_text += '/';
+                        break;
+                    case 'b':
+                        a_text += '\b';
+                        break;
+                    case 'f':
+                        a_text += '\f';
+                        break;
+                    case 'n':
+                        a_text += '\n';
+                        break;
+                    case 'r':
+                        a_text += '\r';
+                        break;
+                    case 't':
+                        a_text += '\t';
+                        break;
+                    case 'u':
+                        {
+                            std::uint32_t code;
+                            if (!Hex(code)) {
+                                return false;
+                            }
+
+                            // a surrogate pair is two escapes
+                            if (code >= 0xD800 && code < 0xDC00 && _text.substr(_position, 2) == "\\u") {
+                                _position += 2;
+
+                                std::uint32_t low;
+                                if (!Hex(low)) {
+                                    return false;
+                                }
+                                if (low < 0xDC00 || low >= 0xE000) {
+                                    return Fail("bad surrogate pair");
+                                }
+
+                                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                            }
+
+                            AppendUtf8(a_text, code);
+                            break;
+                        }
+                    default:
+                        return Fail("bad escape");
+                    }
+                }
+
+                return Fail("unterminated string");
+            }
+
+            bool Number(float& a_value)
+            {
+                auto c = Peek();
+                if (c != '-' && (c < '0' || c > '9')) {
+                    return Fail("expected a number");
+                }
+
+                // a bit more than JSON allows gets through (leading zeros, -inf), Pack clamps whatever it is
+                double value;
+                auto first = _text.data() + _position;
+                auto [end, error] = std::from_chars(first, _text.data() + _text.size(), value);
+                if (error != std::errc{}) {
+                    return Fail("bad number");
+                }
+
+                _position += end - first;
+                a_value = static_cast<float>(value);
+
+                return true;
+            }
+
+            bool Skip(std::size_t a_depth)
+            {
+                if (a_depth > kMaxDepth) {
+                    return Fail("nested too deep");
+                }
+
+                switch (Peek()) {
+                case '"':
+                    {
+                        std::string ignored;
+                        return String(ignored);
+                    }
+                case '[':
+                    ++_position;
+                    if (Consume(']')) {
+                        return true;
+                    }
+                    do {
+                        if (!Skip(a_depth + 1)) {
+                            return false;
+                        }
+                    } while (Consume(','));
+                    return Expect(']');
+                case '{':
+                    ++_position;
+                    if (Consume('}')) {
+                        return true;
+                    }
+                    do {
+                        std::string ignored;
+                        if (!String(ignored) || !Expect(':') || !Skip(a_depth + 1)) {
+                            return false;
+                        }
+                    } while (Consume(','));
+                    return Expect('}');
+                case 't':
+                    return Literal("true");
+                case 'f':
+                    return Literal("false");
+                case 'n':
+                    return Literal("null");
+                default:
+                    {
+                        float ignored;
+                        return Number(ignored);
+                    }
+                }
+            }
+
+            bool Literal(std::string_view a_literal)
+            {
+                if (_text.substr(_position, a_literal.size()) != a_literal) {
+                    return Fail("unexpected value");
+                }
+
+                _position += a_literal.size();
+                return true;
+            }
+
+            // a_valid if the value is an array of kPresetSize numbers, anything else is skipped
+            bool Preset(PackedPreset& a_preset, bool& a_valid)
+            {
+                a_valid = false;
+
+                if (Peek() != '[') {
+                    return Skip(1);
+                }
+
+                ++_position;
+
+                std::array<float, kPresetSize> values{};
+                std::size_t count = 0;
+                bool numbers = true;
+
+                if (!Consume(']')) {
+                    do {
+                        auto c = Peek();
+                        if (c == '-' || (c >= '0' && c <= '9')) {
+                            float value;
+                            if (!Number(value)) {
+                                return false;
+                            }
+                            if (count < values.size()) {
+                                values[count] = value;
+                            }
+                        } else {
+                            numbers = false;
+                            if (!Skip(2)) {
+                                return false;
+                            }
+                        }
+                        ++count;
+                    } while (Consume(','));
+
+                    if (!Expect(']')) {
+                        return false;
+                    }
+                }
+
+                if (numbers && count == kPresetSize) {
+                    a_preset = Pack(values);
+                    a_valid = true;
+                }
+
+                return true;
+            }
+
+            std::string_view _text;
+            std::size_t _position{ 0 };
+            std::string _error;
+        };
+
+        void AppendString(std::string& a_text, std::string_view a_string)
+        {
+            a_text += '"';
+
+            for (auto c : a_string) {
+                if (c == '"' || c == '\\') {
+                    a_text += '\\';
+                    a_text += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    AppendFormat(a_text, "\\u%04x", static_cast<unsigned>(c));
+                } else {
+                    a_text += c;
+                }
+            }
+
+            a_text += '"';
+        }
+
+        void Append(std::vector<std::byte>& a_buffer, const void* a_data, std::size_t a_size)
+        {
+            auto bytes = static_cast<const std::byte*>(a_data);
+            a_buffer.insert(a_buffer.end(), bytes, bytes + a_size);
+        }
+
+        std::string FileName(const std::filesystem::path& a_path)
+        {
+            auto name = a_path.filename().u8string();
+            return { name.begin(), name.end() };
+        }
+    }
+
+    PackedPreset Pack(std::span<const float> a_values)
+    {
+        PackedPreset preset;
+
+        for (std::size_t i = 0; i < preset.values.size() && i < a_values.size(); ++i) {
+            auto value = i == kExpressionId ? a_values[i] : a_values[i] * 100.0f;
+            auto limit = i == kExpressionId ? 255.0f : 200.0f;
+
+            // NaN ends up 0
+            preset.values[i] = value > 0.0f ? static_cast<std::uint8_t>(std::lround(std::min(value, limit))) : 0;
+        }
+
+        return preset;
+    }
+
+    std::array<float, kPresetSize> Unpack(const PackedPreset& a_preset)
+    {
+        std::array<float, kPresetSize> values;
+
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = i == kExpressionId ? a_preset.values[i] : a_preset.values[i] / 100.0f;
+        }
+
+        return values;
+    }
+
+    PresetTable::PresetTable(std::vector<NamedPreset> a_presets)
+    {
+        // stable, the last of a name is kept
+        std::stable_sort(a_presets.begin(), a_presets.end(), [](auto& a_lhs, auto& a_rhs) { return CompareNames(a_lhs.name, a_rhs.name) < 0; });
+
+        _entries.reserve(a_presets.size());
+        _presets.reserve(a_presets.size());
+
+        for (std::size_t i = 0; i < a_presets.size(); ++i) {
+            if (i + 1 < a_presets.size() && CompareNames(a_presets[i].name, a_presets[i + 1].name) == 0) {
+                continue;
+            }
+
+            _entries.push_back({ static_cast<std::uint32_t>(_names.size()), static_cast<std::uint32_t>(a_presets[i].name.size()) });
+            _presets.push_back(a_presets[i].preset);
+            _names += a_presets[i].name;
+        }
+    }
+
+    const PackedPreset* PresetTable::Find(std::string_view a_name) const
+    {
+        auto index = LowerBound(a_name);
+
+        return index < _entries.size() && CompareNames(Name(index), a_name) == 0 ? &_presets[index] : nullptr;
+    }
+
+    void PresetTable::Set(std::string_view a_name, const PackedPreset& a_preset)
+    {
+        auto index = LowerBound(a_name);
+
+        if (index < _entries.size() && CompareNames(Name(index), a_name) == 0) {
+            _presets[index] = a_preset;
+            return;
+        }
+
+        _entries.insert(_entries.begin() + index, { static_cast<std::uint32_t>(_names.size()), static_cast<std::uint32_t>(a_name.size()) });
+        _presets.insert(_presets.begin() + index, a_preset);
+        _names += a_name;
+    }
+
+    bool PresetTable::Assign(std::string a_names, std::vector<Entry> a_entries, std::vector<PackedPreset> a_presets)
+    {
+        if (a_entries.size() != a_presets.size()) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < a_entries.size(); ++i) {
+            auto& entry = a_entries[i];
+            if (entry.nameOffset > a_names.size() || entry.nameSize > a_names.size() - entry.nameOffset) {
+                return false;
+            }
+
+            // lookups rely on the order
+            if (i > 0) {
+                auto& previous = a_entries[i - 1];
+                if (CompareNames({ a_names.data() + previous.nameOffset, previous.nameSize }, { a_names.data() + entry.nameOffset, entry.nameSize }) >= 0) {
+                    return false;
+                }
+            }
+        }
+
+        _names = std::move(a_names);
+        _entries = std::move(a_entries);
+        _presets = std::move(a_presets);
+
+        return true;
+    }
+
+    std::size_t PresetTable::LowerBound(std::string_view a_name) const
+    {
+        auto it = std::lower_bound(_entries.begin(), _entries.end(), a_name, [this](const Entry& a_entry, std::string_view a_value) {
+            return CompareNames({ _names.data() + a_entry.nameOffset, a_entry.nameSize }, a_value) < 0;
+        });
+
+        return static_cast<std::size_t>(it - _entries.begin());
+    }
+
+    PresetParse ParsePresets(std::string_view a_text)
+    {
+        PresetParse result;
+        Parser(a_text).Parse(result);
+
+        return result;
+    }
+
+    std::string FormatPresets(const PresetTable& a_table)
+    {
+        std::string text = "{\n";
+
+        for (std::size_t i = 0; i < a_table.Size(); ++i) {
+            text += "    ";
+            AppendString(text, a_table.Name(i));
+            text += ": [ ";
+
+            auto values = Unpack(a_table.Preset(i));
+            for (std::size_t j = 0; j < values.size(); ++j) {
+                AppendFormat(text, j + 1 < values.size() ? "%g, " : "%g", values[j]);
+            }
+
+            text += i + 1 < a_table.Size() ? " ],\n" : " ]\n";
+        }
+
+        text += "}\n";
+
+        return text;
+    }
+
+    std::vector<PresetSource> FindPresetSources(const std::filesystem::path& a_directory)
+    {
+        std::vector<PresetSource> sources;
+        std::error_code error;
+
+        for (auto it = std::filesystem::directory_iterator(a_directory, error); !error && it != std::filesystem::directory_iterator(); it.increment(error)) {
+            auto extension = FileName(it->path().extension());
+            if (!it->is_regular_file(error) || CompareNames(extension, ".json") != 0) {
+                continue;
+            }
+
+            PresetSource source;
+            source.path = it->path();
+            source.writeTime = static_cast<std::int64_t>(it->last_write_time(error).time_since_epoch().count());
+            source.size = it->file_size(error);
+            sources.push_back(std::move(source));
+        }
+
+        std::sort(sources.begin(), sources.end(), [](auto& a_lhs, auto& a_rhs) { return a_lhs.path.filename() < a_rhs.path.filename(); });
+
+        return sources;
+    }
+
+    std::uint64_t PresetSourcesKey(std::span<const PresetSource> a_sources)
+    {
+        // FNV-1a
+        std::uint64_t key = 0xCBF29CE484222325;
+
+        auto hash = [&](const void* a_data, std::size_t a_size) {
+            auto bytes = static_cast<const std::uint8_t*>(a_data);
+            for (std::size_t i = 0; i < a_size; ++i) {
+                key = (key ^ bytes[i]) * 0x100000001B3;
+            }
+        };
+
+        for (auto& source : a_sources) {
+            auto name = FileName(source.path);
+            std::uint64_t size = source.size;
+
+            hash(name.data(), name.size() + 1);
+            hash(&source.writeTime, sizeof(source.writeTime));
+            hash(&size, sizeof(size));
+        }
+
+        return key;
+    }
+
+    bool SavePresetCache(const std::filesystem::path& a_path, const PresetTable& a_table, std::uint64_t a_key)
+    {
+        PresetCacheHeader header;
+        header.key = a_key;
+        header.count = static_cast<std::uint32_t>(a_table.Size());
+        header.namesSize = static_cast<std::uint32_t>(a_table.Names().size());
+
+        std::vector<std::byte> buffer;
+        Append(buffer, &header, sizeof(header));
+        Append(buffer, a_table.Entries().data(), a_table.Entries().size_bytes());
+        Append(buffer, a_table.Presets().data(), a_table.Presets().size_bytes());
+        Append(buffer, a_table.Names().data(), a_table.Names().size());
+
+        std::FILE* file = nullptr;
+#if defined(_WIN32)
+        if (_wfopen_s(&file, a_path.c_str(), L"wb") != 0) {
+            file = nullptr;
+        }
+#else
+        file = std::fopen(a_path.c_str(), "wb");
+#endif
+        if (!file) {
+            return false;
+        }
+
+        auto written = std::fwrite(buffer.data(), 1, buffer.size(), file);
+
+        return std::fclose(file) == 0 && written == buffer.size();
+    }
+
+    bool LoadPresetCache(const std::filesystem::path& a_path, PresetTable& a_table, std::uint64_t a_key)
+    {
+        MappedFile file;
+        if (!file.Open(a_path)) {
+            return false;
+        }
+
+        auto data = file.Data();
+        if (data.size() < sizeof(PresetCacheHeader)) {
+            return false;
+        }
+
+        PresetCacheHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (header.magic != PresetCacheHeader::kMagic || header.version != PresetCacheHeader::kVersion ||
+            header.presetSize != sizeof(PackedPreset) || header.key != a_key) {
+            return false;
+        }
+
+        auto entriesSize = header.count * sizeof(PresetTable::Entry);
+        auto presetsSize = header.count * sizeof(PackedPreset);
+        if (data.size() != sizeof(header) + entriesSize + presetsSize + header.namesSize) {
+            return false;
+        }
+
+        auto offset = sizeof(header);
+
+        std::vector<PresetTable::Entry> entries(header.count);
+        std::memcpy(entries.data(), data.data() + offset, entriesSize);
+        offset += entriesSize;
+
+        std::vector<PackedPreset> presets(header.count);
+        std::memcpy(presets.data(), data.data() + offset, presetsSize);
+        offset += presetsSize;
+
+        std::string names(reinterpret_cast<const char*>(data.data() + offset), header.namesSize);
+
+        return a_table.Assign(std::move(names), std::move(entries), std::move(presets));
+    }
+
+    PresetTable LoadPresets(const std::filesystem::path& a_directory, const std::filesystem::path& a_cache, PresetLoad& a_load)
+    {
+        auto sources = FindPresetSources(a_directory);
+        auto key = PresetSourcesKey(sources);
+
+        a_load.files = sources.size();
+
+        PresetTable table;
+        if (sources.empty()) {
+            return table;
+        }
+
+        if (LoadPresetCache(a_cache, table, key)) {
+            a_load.cached = true;
+            return table;
+        }
+
+        std::vector<NamedPreset> presets;
+
+        for (auto& source : sources) {
+            auto name = FileName(source.path);
+
+            MappedFile file;
+            if (!file.Open(source.path)) {
+                a_load.errors.push_back(name + ": can't be read or is empty");
+                ++a_load.failed;
+                continue;
+            }
+
+            auto data = file.Data();
+            auto parse = ParsePresets({ reinterpret_cast<const char*>(data.data()), data.size() });
+
+            if (!parse.error.empty()) {
+                a_load.errors.push_back(name + ": " + parse.error);
+                ++a_load.failed;
+                continue;
+            }
+
+            for (auto& skipped : parse.skipped) {
+                std::string error = name + ": ";
+                AppendFormat(error, "\"%s\" isn't an array of %zu numbers", skipped.c_str(), kPresetSize);
+                a_load.errors.push_back(std::move(error));
+            }
+
+            a_load.skipped += parse.skipped.size();
+
+            std::move(parse.presets.begin(), parse.presets.end(), std::back_inserter(presets));
+        }
+
+        table = PresetTable(std::move(presets));
+
+        if (a_load.failed == 0) {
+            SavePresetCache(a_cache, table, key);
+        }
+
+        return table;
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Broadcast.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MfgFix::Core
+{
+    // a preset as the registry stores it, one byte per value of the Papyrus array:
+    // channels and the expression strength in steps of 0.01 up to 2.0, the expression id as is
+    struct PackedPreset
+    {
+        std::array<std::uint8_t, kPresetSize> values{};
+
+        bool operator==(const PackedPreset&) const = default;
+    };
+
+    static_assert(sizeof(PackedPreset) == kPresetSize);
+
+    PackedPreset Pack(std::span<const float> a_values);
+    std::array<float, kPresetSize> Unpack(const PackedPreset& a_preset);
+
+    struct NamedPreset
+    {
+        std::string name;
+        PackedPreset preset;
+    };
+
+    // presets by name, compared without case like Papyrus strings are
+    // names are interned in one pool, entries are kept sorted by name and looked up by binary search
+    class PresetTable
+    {
+    public:
+        struct Entry
+        {
+            std::uint32_t nameOffset;
+            std::uint32_t nameSize;
+        };
+
+        PresetTable() = default;
+
+        // a later preset replaces an earlier one of the same name
+        explicit PresetTable(std::vector<NamedPreset> a_presets);
+
+        const PackedPreset* Find(std::string_view a_name) const;
+
+        // adds a_preset or replaces the one already stored under a_name
+        void Set(std::string_view a_name, const PackedPreset& a_preset);
+
+        std::size_t Size() const { return _entries.size(); }
+
+        std::string_view Name(std::size_t a_index) const { return { _names.data() + _entries[a_index].nameOffset, _entries[a_index].nameSize }; }
+        const PackedPreset& Preset(std::size_t a_index) const { return _presets[a_index]; }
+
+        std::span<const Entry> Entries() const { return _entries; }
+        std::span<const PackedPreset> Presets() const { return _presets; }
+        std::string_view Names() const { return _names; }
+
+        // takes over the arrays of a cache, false if they don't fit together
+        bool Assign(std::string a_names, std::vector<Entry> a_entries, std::vector<PackedPreset> a_presets);
+
+    private:
+        // first entry not less than a_name
+        std::size_t LowerBound(std::string_view a_name) const;
+
+        std::string _names;
+        std::vector<Entry> _entries;
+        std::vector<PackedPreset> _presets;  // same index as _entries
+    };
+
+    struct PresetParse
+    {
+        std::vector<NamedPreset> presets;
+        std::vector<std::string> skipped;  // members that aren't an array of kPresetSize numbers
+        std::string error;                 // syntax error, presets is empty then
+    };
+
+    // a JSON object of "name": [ kPresetSize numbers ], the layout ApplyExpressionPreset takes
+    PresetParse ParsePresets(std::string_view a_text);
+
+    // a_table as ParsePresets reads it back
+    std::string FormatPresets(const PresetTable& a_table);
+
+    // a preset file and what its cache entry is keyed by
+    struct PresetSource
+    {
+        std::filesystem::path path;
+        std::int64_t writeTime{ 0 };
+        std::uintmax_t size{ 0 };
+    };
+
+    // the *.json files of a_directory sorted by name, later files win over earlier ones
+    std::vector<PresetSource> FindPresetSources(const std::filesystem::path& a_directory);
+
+    std::uint64_t PresetSourcesKey(std::span<const PresetSource> a_sources);
+
+    // file layout: header, Entry[count], PackedPreset[count], names
+    struct PresetCacheHeader
+    {
+        static constexpr std::array<char, 8> kMagic{ 'M', 'F', 'G', 'P', 'R', 'S', 'E', 'T' };
+        static constexpr std::uint32_t kVersion = 1;
+
+        std::array<char, 8> magic{ kMagic };
+        std::uint32_t version{ kVersion };
+        std::uint32_t presetSize{ sizeof(PackedPreset) };
+        std::uint64_t key{ 0 };
+        std::uint32_t count{ 0 };
+        std::uint32_t namesSize{ 0 };
+    };
+
+    bool SavePresetCache(const std::filesystem::path& a_path, const PresetTable& a_table, std::uint64_t a_key);
+
+    // false if the cache is missing, malformed or was written for other sources
+    bool LoadPresetCache(const std::filesystem::path& a_path, PresetTable& a_table, std::uint64_t a_key);
+
+    struct PresetLoad
+    {
+        std::size_t files{ 0 };
+        std::size_t failed{ 0 };   // files that couldn't be read or parsed, they add nothing
+        std::size_t skipped{ 0 };  // members that aren't presets
+        bool cached{ false };
+        std::vector<std::string> errors;  // file and what's wrong with it
+    };
+
+    // the presets of a_directory, from a_cache while it matches the sources, compiled and cached again otherwise;
+    // nothing is cached while a file fails, so it's reported again on the next load
+    PresetTable LoadPresets(const std::filesystem::path& a_directory, const std::filesystem::path& a_cache, PresetLoad& a_load);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace MfgFix::Core
+{
+    // immutable value shared with reader threads: readers take a reference to the current copy, writers swap in a new one
+    // a replaced copy is freed when the last reader holding it lets go, however long that takes
+    template <class T>
+    class Published
+    {
+    public:
+        using Pointer = std::shared_ptr<const T>;
+
+        // what one thread last read, the value stays alive until the thread reads it again after a publish
+        // a thread_local reader costs one acquire load of the version per read and never touches the shared count
+        class Reader
+        {
+        public:
+            // the current value, valid until the next Get of this reader
+            const T& Get(const Published& a_published)
+            {
+                auto version = a_published._version.load(std::memory_order_acquire);
+
+                if (version != _version) {
+                    _value = a_published.Get();
+                    _version = version;
+                }
+
+                return *_value;
+            }
+
+        private:
+            Pointer _value;
+            std::uint64_t _version{ 0 };
+        };
+
+        explicit Published(T a_value = {}) :
+            _current(std::make_shared<const T>(std::move(a_value)))
+        {}
+
+        Published(const Published&) = delete;
+        Published& operator=(const Published&) = delete;
+
+        // never null, keep it for as long as the value is used
+        Pointer Get() const
+        {
+            return _current.load(std::memory_order_acquire);
+        }
+
+        void Publish(T a_value)
+        {
+            std::lock_guard locker(_writeLock);
+            _current.store(std::make_shared<const T>(std::move(a_value)), std::memory_order_release);
+            _version.fetch_add(1, std::memory_order_release);
+        }
+
+        // copy of the current value, modified by a_func and published, writers don't lose each other's changes
+        template <class F>
+        void Update(F&& a_func)
+        {
+            std::lock_guard locker(_writeLock);
+
+            T value = *_current.load(std::memory_order_relaxed);
+            a_func(value);
+            _current.store(std::make_shared<const T>(std::move(value)), std::memory_order_release);
+            _version.fetch_add(1, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<Pointer> _current;
+        std::atomic<std::uint64_t> _version{ 1 };  // goes up after every publish, readers start at 0
+        std::mutex _writeLock;
+    };
+}
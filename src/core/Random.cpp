@@ -0,0 +1,77 @@
+#include "Random.h"
+
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        std::uint64_t SplitMix64(std::uint64_t& a_state)
+        {
+            auto z = (a_state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // settings reloads find the tables of the exponents they had before, a handful in practice
+        const PowerCurve::Table* SharedTable(float a_exponent)
+        {
+            static std::mutex lock;
+            static std::vector<std::pair<float, std::unique_ptr<const PowerCurve::Table>>> tables;
+
+            std::lock_guard locker(lock);
+
+            for (auto& [exponent, table] : tables) {
+                if (exponent == a_exponent) {
+                    return table.get();
+                }
+            }
+
+            if (tables.size() >= PowerCurve::kMaxTables) {
+                return nullptr;
+            }
+
+            auto table = std::make_unique<PowerCurve::Table>();
+            for (std::size_t i = 0; i <= PowerCurve::kSegments; ++i) {
+                (*table)[i] = std::pow(static_cast<float>(i) / PowerCurve::kSegments, a_exponent);
+            }
+
+            return tables.emplace_back(a_exponent, std::move(table)).second.get();
+        }
+    }
+
+    Rng::Rng() :
+        Rng((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}())
+    {}
+
+    Rng::Rng(std::uint64_t a_seed, std::uint64_t a_stream)
+    {
+        // splitmix expands the seed, also keeps the state away from all zero
+        auto state = a_seed ^ SplitMix64(a_stream);
+
+        auto low = SplitMix64(state);
+        auto high = SplitMix64(state);
+
+        _state = { static_cast<std::uint32_t>(low), static_cast<std::uint32_t>(low >> 32), static_cast<std::uint32_t>(high), static_cast<std::uint32_t>(high >> 32) };
+    }
+
+    PowerCurve::PowerCurve(float a_exponent) :
+        _exponent(a_exponent)
+    {
+        if (a_exponent == 1.0f) {
+            _kind = Kind::Identity;
+        } else if (a_exponent == 2.0f) {
+            _kind = Kind::Square;
+        } else if (a_exponent == 0.5f) {
+            _kind = Kind::Sqrt;
+        } else {
+            _table = SharedTable(a_exponent);
+            _kind = _table ? Kind::Table : Kind::Pow;
+        }
+    }
+}
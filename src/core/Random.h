@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace MfgFix::Core
+{
+    // xoshiro128**, 16 bytes of state, owned by one face or one thread and never shared
+    class Rng
+    {
+    public:
+        using State = std::array<std::uint32_t, 4>;
+
+        static constexpr std::uint64_t kDefaultSeed = 0x6D66676669784E47;  // "mfgfixNG"
+
+        // seeded from std::random_device
+        Rng();
+
+        // same seed and stream, same sequence
+        explicit Rng(std::uint64_t a_seed, std::uint64_t a_stream = 0);
+
+        std::uint32_t Next()
+        {
+            auto result = Rotl(_state[1] * 5, 7) * 9;
+            auto t = _state[1] << 9;
+
+            _state[2] ^= _state[0];
+            _state[3] ^= _state[1];
+            _state[1] ^= _state[2];
+            _state[0] ^= _state[3];
+            _state[2] ^= t;
+            _state[3] = Rotl(_state[3], 11);
+
+            return result;
+        }
+
+        // [0, 1), 24 bits
+        float Uniform()
+        {
+            return static_cast<float>(Next() >> 8) * 0x1.0p-24f;
+        }
+
+        // raw state, used to record and replay the exact sequence
+        const State& GetState() const { return _state; }
+        void SetState(const State& a_state) { _state = a_state; }
+
+    private:
+        static std::uint32_t Rotl(std::uint32_t a_value, int a_shift)
+        {
+            return (a_value << a_shift) | (a_value >> (32 - a_shift));
+        }
+
+        State _state;
+    };
+
+    // u^exponent for u in [0, 1]: the inverse cdf of the delay distributions
+    // common exponents are computed directly, anything else is read from a table built once per exponent and shared
+    // by every curve with it, so a curve is as small as its exponent; past kMaxTables exponents u^exponent is computed
+    class PowerCurve
+    {
+    public:
+        static constexpr std::size_t kSegments = 256;
+        static constexpr std::size_t kMaxTables = 64;
+
+        using Table = std::array<float, kSegments + 1>;
+
+        PowerCurve() = default;
+        explicit PowerCurve(float a_exponent);
+
+        float operator()(float a_u) const
+        {
+            switch (_kind) {
+            case Kind::Identity:
+                return a_u;
+            case Kind::Square:
+                return a_u * a_u;
+            case Kind::Sqrt:
+                return std::sqrt(a_u);
+            case Kind::Pow:
+                return std::pow(a_u, _exponent);
+            default:
+                {
+                    auto& table = *_table;
+                    auto x = a_u * kSegments;
+                    auto i = static_cast<std::size_t>(x);
+                    if (i >= kSegments) {
+                        return table[kSegments];
+                    }
+                    if (i == 0) {
+                        return std::pow(a_u, _exponent);  // steepest for exponents below 1, rare enough to compute
+                    }
+                    return table[i] + (table[i + 1] - table[i]) * (x - static_cast<float>(i));
+                }
+            }
+        }
+
+        float Exponent() const { return _exponent; }
+
+    private:
+        enum class Kind : std::uint32_t
+        {
+            Identity,
+            Square,
+            Sqrt,
+            Table,
+            Pow
+        };
+
+        float _exponent{ 1.0f };
+        Kind _kind{ Kind::Identity };
+        const Table* _table{ nullptr };  // Kind::Table only, lives as long as the process
+    };
+
+    inline float Random(Rng& a_rng, float a_min, float a_max)
+    {
+        return a_min + (a_max - a_min) * a_rng.Uniform();
+    }
+
+    inline float Random(Rng& a_rng, float a_min, float a_max, const PowerCurve& a_curve)
+    {
+        return a_min + (a_max - a_min) * a_curve(a_rng.Uniform());
+    }
+}
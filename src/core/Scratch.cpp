@@ -0,0 +1,121 @@
+#include "Scratch.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace MfgFix::Core
+{
+    bool ScratchFace::Keyframe::SameValues(std::span<const float> a_values) const
+    {
+        return count == a_values.size() && std::memcmp(values.data(), a_values.data(), count * sizeof(float)) == 0;
+    }
+
+    bool ScratchFace::Keyframe::SameTimer(float a_timer) const
+    {
+        return std::bit_cast<std::uint32_t>(timer) == std::bit_cast<std::uint32_t>(a_timer);
+    }
+
+    bool ScratchFace::SameEyes(const EyesState& a_lhs, const EyesState& a_rhs)
+    {
+        auto same = [](float a_x, float a_y) { return std::bit_cast<std::uint32_t>(a_x) == std::bit_cast<std::uint32_t>(a_y); };
+
+        return a_lhs.blinkStage == a_rhs.blinkStage &&
+               same(a_lhs.blinkTimer, a_rhs.blinkTimer) && same(a_lhs.offsetTimer, a_rhs.offsetTimer) &&
+               same(a_lhs.headingOffset, a_rhs.headingOffset) && same(a_lhs.pitchOffset, a_rhs.pitchOffset) &&
+               same(a_lhs.heading, a_rhs.heading) && same(a_lhs.pitch, a_rhs.pitch);
+    }
+
+    void ScratchFace::Begin(bool a_hold, bool a_dialogue, bool a_moved)
+    {
+        // only as wide as the layers are, a copy of the whole state costs more than the update saves
+        for (std::size_t i = 0; i < kLayers; ++i) {
+            auto& input = _input.layers[i];
+            auto& output = _output.layers[i];
+
+            output.count = input.count;
+            output.timer = input.timer;
+            std::copy_n(input.values.begin(), input.count, output.values.begin());
+        }
+
+        _output.eyes = _input.eyes;
+        _resets = 0;
+        _changedValues = 0;
+        _changedTimers = 0;
+        _hold = a_hold;
+        _dialogue = a_dialogue;
+        _moved = a_moved;
+    }
+
+    void ScratchFace::End()
+    {
+        _changedValues = _resets;
+        _changedTimers = _resets;
+
+        for (std::size_t i = 0; i < kLayers; ++i) {
+            auto& input = _input.layers[i];
+            auto& output = _output.layers[i];
+
+            _changedValues |= output.SameValues(input.Values()) ? 0 : 1u << i;
+            _changedTimers |= output.SameTimer(input.timer) ? 0 : 1u << i;
+        }
+
+        _changedValues |= SameEyes(_output.eyes, _input.eyes) ? 0 : kEyes;
+    }
+
+    ScratchFace::StorePlan ScratchFace::Plan(const View& a_current, const EyesState& a_eyes) const
+    {
+        StorePlan plan;
+
+        for (auto changed = _changedValues | _changedTimers; changed & ~kEyes; changed &= changed - 1) {
+            auto i = static_cast<std::size_t>(std::countr_zero(changed));
+            auto bit = 1u << i;
+            auto& input = _input.layers[i];
+            auto& current = a_current[i];
+
+            // a reset may do more than zero the values, the layer goes back whole or not at all
+            if (_resets & bit) {
+                if (input.SameValues(current.values) && input.SameTimer(current.timer)) {
+                    plan.values |= bit;
+                    plan.timers |= bit;
+                } else {
+                    plan.conflicts |= bit;
+                }
+                continue;
+            }
+
+            if (_changedValues & bit) {
+                (input.SameValues(current.values) ? plan.values : plan.conflicts) |= bit;
+            }
+            if (_changedTimers & bit) {
+                (input.SameTimer(current.timer) ? plan.timers : plan.conflicts) |= bit;
+            }
+        }
+
+        if (_changedValues & kEyes) {
+            (SameEyes(a_eyes, _input.eyes) ? plan.values : plan.conflicts) |= kEyes;
+        }
+
+        return plan;
+    }
+
+    bool ScratchFace::IsZero(Layer a_layer)
+    {
+        auto values = Values(a_layer);
+        return std::all_of(values.begin(), values.end(), [](float a_value) { return a_value == 0.0f; });
+    }
+
+    void ScratchFace::Reset(Layer a_layer)
+    {
+        auto values = Values(a_layer);
+        std::fill(values.begin(), values.end(), 0.0f);
+        _resets |= Bit(a_layer);
+    }
+
+    void ScratchFace::Copy(Layer a_src, Layer a_dst)
+    {
+        auto src = Values(a_src);
+        auto dst = Values(a_dst);
+        std::copy_n(src.begin(), std::min(src.size(), dst.size()), dst.begin());
+    }
+}
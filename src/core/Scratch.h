@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Channels.h"
+#include "Eyes.h"
+#include "FaceUpdate.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace MfgFix::Core
+{
+    // A face's layers and eyes copied out from under its lock, so the update steps run on the copy with the lock released.
+    // The owner fills Input() with the lock held, Begin() starts the output from it, the update changes the output only,
+    // End() notes what it changed, and Plan() tells what to write back once the lock is held again, against what the face
+    // holds by then. Only Input() and Plan() need the lock.
+    // Engine steps on layer 1 (transition, dialogue) are left to the owner, who runs them with the lock held before filling
+    // Input(): the dialogue steps do nothing here, like for the replayer, and TransitionUpdate reports what Begin was told.
+    class ScratchFace
+    {
+    public:
+        static constexpr std::size_t kLayers = static_cast<std::size_t>(Layer::Total);
+        static constexpr std::uint32_t kMaxChannels = 32;
+
+        // one bit per layer, the eyes above them
+        static constexpr std::uint32_t kEyes = 1u << kLayers;
+
+        struct Keyframe
+        {
+            std::array<float, kMaxChannels> values{};
+            std::uint32_t count{ 0 };
+            float timer{ 0.0f };
+
+            std::span<float> Values() { return { values.data(), count }; }
+            std::span<const float> Values() const { return { values.data(), count }; }
+
+            // bitwise, a NaN a script wrote is still the same value
+            bool SameValues(std::span<const float> a_values) const;
+            bool SameTimer(float a_timer) const;
+        };
+
+        // a keyframe of the face itself, to plan a store against without copying it out again
+        struct KeyframeView
+        {
+            std::span<const float> values;
+            float timer{ 0.0f };
+        };
+
+        using View = std::array<KeyframeView, kLayers>;
+
+        struct State
+        {
+            std::array<Keyframe, kLayers> layers;
+            EyesState eyes;
+
+            Keyframe& operator[](Layer a_layer) { return layers[static_cast<std::size_t>(a_layer)]; }
+            const Keyframe& operator[](Layer a_layer) const { return layers[static_cast<std::size_t>(a_layer)]; }
+        };
+
+        // what to write back: values and timers the update changed that nobody else changed since the copy, the eyes
+        // as a values bit; conflicts were changed on both sides and keep what the other writer left
+        // a layer's values and timer are apart, scripts set the values of modifier layer 2 while the update moves its timer
+        struct StorePlan
+        {
+            std::uint32_t values{ 0 };
+            std::uint32_t timers{ 0 };
+            std::uint32_t conflicts{ 0 };
+        };
+
+        static constexpr std::uint32_t Bit(Layer a_layer) { return 1u << static_cast<std::uint32_t>(a_layer); }
+
+        // the eyes fields an update writes, the bases belong to head tracking
+        static bool SameEyes(const EyesState& a_lhs, const EyesState& a_rhs);
+
+        // after filling Input(), the lock may be released already; a_moved if the engine moved expression layer 1
+        void Begin(bool a_hold, bool a_dialogue, bool a_moved);
+
+        // after the update, before taking the lock again
+        void End();
+
+        State& Input() { return _input; }
+        const State& Input() const { return _input; }
+        const State& Output() const { return _output; }
+
+        // layers the update reset, the engine's own reset may do more than zero the values
+        std::uint32_t Resets() const { return _resets; }
+
+        // with the lock held again after End(), a_current and a_eyes being the face as it is now
+        StorePlan Plan(const View& a_current, const EyesState& a_eyes) const;
+
+        // the face concept of FaceUpdate.h, on the output
+        std::span<float> Values(Layer a_layer) { return _output[a_layer].Values(); }
+        bool IsZero(Layer a_layer);
+        void Reset(Layer a_layer);
+        void Copy(Layer a_src, Layer a_dst);
+
+        bool TransitionUpdate(float) { return _moved; }
+        void DialogueModifiersUpdate(float) {}
+        void DialoguePhonemesUpdate(float) {}
+
+        EyesTimers EyesTimersUpdate(const FaceUpdateContext& a_context) { return Core::EyesTimersUpdate(_output.eyes, a_context, _hold); }
+
+        EyesState GetEyesState() const { return _output.eyes; }
+        void SetEyesState(const EyesState& a_eyes) { _output.eyes = a_eyes; }
+
+        float& BlinkValue() { return _output[Layer::Modifier2].timer; }
+        bool Hold() const { return _hold; }
+        bool Dialogue() const { return _dialogue; }
+
+    private:
+        State _input;
+        State _output;
+        std::uint32_t _resets{ 0 };
+        std::uint32_t _changedValues{ 0 };  // the eyes as kEyes
+        std::uint32_t _changedTimers{ 0 };
+        bool _hold{ false };
+        bool _dialogue{ false };
+        bool _moved{ false };
+    };
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace MfgFix::Core
+{
+    // a T copied in and out under a sequence counter: one writer at a time, any number of readers that never block it
+    // the counter is odd while a store is under way, a read that saw it change starts over
+    // the words are atomics so a read racing a store is a retry, not a data race
+    template <class T>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+        static constexpr std::size_t kFullWords = sizeof(T) / sizeof(std::uint64_t);
+
+        // spins before a reader starts yielding to a writer that was preempted mid store
+        static constexpr std::uint32_t kSpins = 64;
+
+        SeqLock() { Store(T{}); }
+
+        SeqLock(const SeqLock&) = delete;
+        SeqLock& operator=(const SeqLock&) = delete;
+
+        // writers must be serialized by the caller
+        void Store(const T& a_value)
+        {
+            auto bytes = reinterpret_cast<const std::byte*>(&a_value);
+            auto sequence = _sequence.load(std::memory_order_relaxed);
+
+            _sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            // word by word straight from a_value, a staging copy costs more than the stores
+            for (std::size_t i = 0; i < kFullWords; ++i) {
+                std::uint64_t word;
+                std::memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+                _words[i].store(word, std::memory_order_relaxed);
+            }
+
+            if constexpr (kFullWords < kWords) {
+                std::uint64_t word = 0;
+                std::memcpy(&word, bytes + kFullWords * sizeof(word), sizeof(T) % sizeof(word));
+                _words[kFullWords].store(word, std::memory_order_relaxed);
+            }
+
+            _sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        // a consistent copy of the last store; returns its version, the number of stores before it
+        // a_value is written to on every try, it only holds the copy once Load returns
+        std::uint32_t Load(T& a_value, std::uint32_t* a_retries = nullptr) const
+        {
+            auto bytes = reinterpret_cast<std::byte*>(&a_value);
+            std::uint32_t retries = 0;
+
+            for (;;) {
+                auto before = _sequence.load(std::memory_order_acquire);
+
+                if ((before & 1) == 0) {
+                    for (std::size_t i = 0; i < kFullWords; ++i) {
+                        auto word = _words[i].load(std::memory_order_relaxed);
+                        std::memcpy(bytes + i * sizeof(word), &word, sizeof(word));
+                    }
+
+                    if constexpr (kFullWords < kWords) {
+                        auto word = _words[kFullWords].load(std::memory_order_relaxed);
+                        std::memcpy(bytes + kFullWords * sizeof(word), &word, sizeof(T) % sizeof(word));
+                    }
+
+                    std::atomic_thread_fence(std::memory_order_acquire);
+
+                    if (_sequence.load(std::memory_order_relaxed) == before) {
+                        if (a_retries) {
+                            *a_retries = retries;
+                        }
+
+                        return before / 2 - 1;
+                    }
+                }
+
+                if (++retries % kSpins == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        std::uint32_t Version() const { return _sequence.load(std::memory_order_acquire) / 2 - 1; }
+
+    private:
+        std::atomic<std::uint32_t> _sequence{ 0 };
+        std::array<std::atomic<std::uint64_t>, kWords> _words{};
+    };
+}
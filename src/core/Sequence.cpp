@@ -0,0 +1,321 @@
+#include "Sequence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        bool IsValid(const SequenceKey& a_key)
+        {
+            if (!(a_key.time >= 0.0f) || !std::isfinite(a_key.time)) {
+                return false;
+            }
+
+            switch (a_key.channel) {
+            case SequenceChannel::Phoneme:
+                return a_key.id < Phoneme::Total;
+            case SequenceChannel::Modifier:
+                return a_key.id < kPresetModifiers;
+            case SequenceChannel::Expression:
+                return a_key.id < Expression::Total;
+            default:
+                return false;
+            }
+        }
+
+        // the expression is one track whatever the id, only one can be set at a time
+        std::pair<SequenceChannel, std::uint8_t> TrackOf(const SequenceKey& a_key)
+        {
+            return { a_key.channel, a_key.channel == SequenceChannel::Expression ? std::uint8_t{ 0 } : a_key.id };
+        }
+
+        // half away from zero like lround, which is a call on every compiler; values are a few hundred at most
+        std::int32_t Round(float a_value)
+        {
+            return static_cast<std::int32_t>(a_value + (a_value < 0.0f ? -0.5f : 0.5f));
+        }
+
+        CommandKind KindOf(SequenceChannel a_channel)
+        {
+            switch (a_channel) {
+            case SequenceChannel::Modifier:
+                return CommandKind::Modifier;
+            case SequenceChannel::Expression:
+                return CommandKind::Expression;
+            default:
+                return CommandKind::Phoneme;
+            }
+        }
+    }
+
+    Sequence MakeSequence(std::vector<SequenceKey> a_keys, float a_duration, bool a_loop, float a_ttl, std::optional<ExpressionPreset> a_next)
+    {
+        std::erase_if(a_keys, [](auto& a_key) { return !IsValid(a_key); });
+
+        std::stable_sort(a_keys.begin(), a_keys.end(), [](auto& a_lhs, auto& a_rhs) {
+            auto lhs = TrackOf(a_lhs);
+            auto rhs = TrackOf(a_rhs);
+            return lhs != rhs ? lhs < rhs : a_lhs.time < a_rhs.time;
+        });
+
+        Sequence sequence;
+        sequence.duration = std::isfinite(a_duration) ? std::max(a_duration, 0.0f) : 0.0f;
+
+        for (std::uint32_t i = 0; i < a_keys.size(); ++i) {
+            auto& key = a_keys[i];
+
+            if (sequence.tracks.empty() || TrackOf(a_keys[sequence.tracks.back().begin]) != TrackOf(key)) {
+                sequence.tracks.push_back({ key.channel, key.id, i, i });
+            }
+
+            sequence.tracks.back().end = i + 1;
+            sequence.duration = std::max(sequence.duration, key.time);
+        }
+
+        sequence.keys = std::move(a_keys);
+        sequence.loop = a_loop && sequence.duration > 0.0f;
+        sequence.ttl = std::isfinite(a_ttl) ? std::max(a_ttl, 0.0f) : 0.0f;
+        sequence.next = std::move(a_next);
+
+        return sequence;
+    }
+
+    void AppendPresetKeys(std::vector<SequenceKey>& a_keys, float a_time, const ExpressionPreset& a_preset)
+    {
+        if (a_preset.setPhonemes) {
+            for (std::size_t i = 0; i < a_preset.phonemes.size(); ++i) {
+                a_keys.push_back({ a_time, SequenceChannel::Phoneme, static_cast<std::uint8_t>(i), a_preset.phonemes[i] });
+            }
+        }
+
+        for (std::size_t i = 0; i < a_preset.modifiers.size(); ++i) {
+            a_keys.push_back({ a_time, SequenceChannel::Modifier, static_cast<std::uint8_t>(i), a_preset.modifiers[i] });
+        }
+
+        a_keys.push_back({ a_time, SequenceChannel::Expression, static_cast<std::uint8_t>(a_preset.expression), a_preset.expressionValue });
+    }
+
+    SequencePlayer::SequencePlayer(std::shared_ptr<const Sequence> a_sequence) :
+        _sequence(std::move(a_sequence)),
+        _segments(_sequence->tracks.size())
+    {}
+
+    bool SequencePlayer::Step(float a_timeDelta, PendingFace& a_out)
+    {
+        auto& sequence = *_sequence;
+        auto timeDelta = std::max(a_timeDelta, 0.0f);
+
+        _elapsed += timeDelta;
+
+        if (sequence.ttl > 0.0f && _elapsed >= sequence.ttl) {
+            FaceCommand reset;
+            reset.kind = CommandKind::ResetAll;
+            a_out.Merge(reset, nullptr);
+            return false;
+        }
+
+        if (_ended) {
+            return true;
+        }
+
+        _time += timeDelta;
+
+        if (_time >= sequence.duration) {
+            if (sequence.loop) {
+                _time = std::fmod(_time, sequence.duration);
+                _wrapped = true;
+                std::fill(_segments.begin(), _segments.end(), Segment{});
+            } else {
+                _time = sequence.duration;
+                _ended = true;
+            }
+        }
+
+        Evaluate(a_out);
+
+        if (!_ended) {
+            return true;
+        }
+
+        if (sequence.next) {
+            FaceCommand next;
+            next.kind = CommandKind::Preset;
+            a_out.Merge(next, &*sequence.next);
+        }
+
+        return sequence.ttl > 0.0f;
+    }
+
+    void SequencePlayer::Evaluate(PendingFace& a_out)
+    {
+        auto& sequence = *_sequence;
+
+        for (std::size_t i = 0; i < sequence.tracks.size(); ++i) {
+            auto& track = sequence.tracks[i];
+            auto& segment = _segments[i];
+
+            while (track.begin + segment.cursor < track.end && sequence.keys[track.begin + segment.cursor].time <= _time) {
+                ++segment.cursor;
+            }
+
+            if (segment.line != segment.cursor) {
+                UpdateLine(track, segment);
+            }
+
+            if (!segment.write) {
+                continue;
+            }
+
+            FaceCommand command;
+            command.kind = KindOf(track.channel);
+            command.id = segment.id;
+            command.value = Round(segment.value + segment.slope * (_time - segment.begin));
+            a_out.Merge(command, nullptr);
+        }
+    }
+
+    void SequencePlayer::UpdateLine(const Sequence::Track& a_track, Segment& a_segment) const
+    {
+        auto& sequence = *_sequence;
+        auto keys = std::span(sequence.keys).subspan(a_track.begin, a_track.end - a_track.begin);
+
+        a_segment.line = a_segment.cursor;
+
+        // the keys around _time, shifted by a pass where a loop wraps
+        const SequenceKey* previous;
+        const SequenceKey* next;
+        float previousTime;
+        float nextTime;
+
+        if (a_segment.cursor == 0) {
+            // the face keeps what it has until the first key
+            a_segment.write = _wrapped;
+            if (!_wrapped) {
+                return;
+            }
+
+            previous = &keys.back();
+            next = &keys.front();
+            previousTime = previous->time - sequence.duration;
+            nextTime = next->time;
+        } else if (a_segment.cursor == keys.size()) {
+            previous = &keys.back();
+            next = sequence.loop ? &keys.front() : previous;
+            previousTime = previous->time;
+            nextTime = sequence.loop ? next->time + sequence.duration : previousTime;
+        } else {
+            previous = &keys[a_segment.cursor - 1];
+            next = &keys[a_segment.cursor];
+            previousTime = previous->time;
+            nextTime = next->time;
+        }
+
+        a_segment.write = true;
+        a_segment.id = previous->id;
+        a_segment.begin = previousTime;
+        a_segment.value = static_cast<float>(previous->value);
+        a_segment.slope = 0.0f;
+
+        if (nextTime > previousTime && (a_track.channel != SequenceChannel::Expression || previous->id == next->id)) {
+            a_segment.slope = static_cast<float>(next->value - previous->value) / (nextTime - previousTime);
+        }
+    }
+
+    void SequenceBoard::Start(std::uintptr_t a_face, std::uint32_t a_owner, std::shared_ptr<const Sequence> a_sequence, float a_speed)
+    {
+        auto& shard = GetShard(a_face);
+        std::lock_guard locker(shard.lock);
+
+        auto [entry, inserted] = shard.faces.insert_or_assign(a_face, Entry{ a_owner, a_speed, false, SequencePlayer(std::move(a_sequence)) });
+        if (inserted) {
+            _count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool SequenceBoard::Stop(std::uintptr_t a_face)
+    {
+        auto& shard = GetShard(a_face);
+        std::lock_guard locker(shard.lock);
+
+        if (!shard.faces.erase(a_face)) {
+            return false;
+        }
+
+        _count.fetch_sub(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    SequenceStep SequenceBoard::Step(std::uintptr_t a_face, float a_timeDelta, PendingFace& a_pending)
+    {
+        if (_count.load(std::memory_order_relaxed) == 0) {
+            return SequenceStep::None;
+        }
+
+        auto& shard = GetShard(a_face);
+        std::lock_guard locker(shard.lock);
+
+        auto it = shard.faces.find(a_face);
+        if (it == shard.faces.end()) {
+            return SequenceStep::None;
+        }
+
+        auto& entry = it->second;
+        auto keep = entry.player.Step(a_timeDelta, a_pending);
+
+        a_pending.owner = entry.owner;
+        a_pending.speed = entry.speed;
+
+        auto step = entry.started ? SequenceStep::Playing : SequenceStep::Started;
+        entry.started = true;
+
+        if (!keep) {
+            shard.faces.erase(it);
+            _count.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        return step;
+    }
+
+    std::size_t SequenceBoard::EraseOwner(std::uint32_t a_owner)
+    {
+        std::size_t erased = 0;
+
+        for (auto& shard : _shards) {
+            std::lock_guard locker(shard.lock);
+            erased += std::erase_if(shard.faces, [&](auto& a_entry) { return a_entry.second.owner == a_owner; });
+        }
+
+        _count.fetch_sub(erased, std::memory_order_relaxed);
+
+        return erased;
+    }
+
+    bool SequenceBoard::EraseForeign(std::uintptr_t a_face, std::uint32_t a_owner)
+    {
+        auto& shard = GetShard(a_face);
+        std::lock_guard locker(shard.lock);
+
+        auto it = shard.faces.find(a_face);
+        if (it == shard.faces.end() || it->second.owner == a_owner) {
+            return false;
+        }
+
+        shard.faces.erase(it);
+        _count.fetch_sub(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    void SequenceBoard::Clear()
+    {
+        for (auto& shard : _shards) {
+            std::lock_guard locker(shard.lock);
+            _count.fetch_sub(shard.faces.size(), std::memory_order_relaxed);
+            shard.faces.clear();
+        }
+    }
+}
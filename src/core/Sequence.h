@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Broadcast.h"
+#include "Commands.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace MfgFix::Core
+{
+    // same numbers as the mode of SetPhonemeModifierSmooth
+    enum class SequenceChannel : std::uint8_t
+    {
+        Phoneme = 0,
+        Modifier,
+        Expression
+    };
+
+    struct SequenceKey
+    {
+        float time{ 0.0f };  // seconds from the start of a pass
+        SequenceChannel channel{ SequenceChannel::Phoneme };
+        std::uint8_t id{ 0 };     // phoneme, modifier or expression id
+        std::int32_t value{ 0 };  // 0 - 200 like the natives take it
+    };
+
+    // keyframes on any phoneme, modifier and the expression, values are interpolated linearly between the keys
+    // of a channel; the expression only while the id stays, it switches at the key that changes it
+    struct Sequence
+    {
+        // the keys of one channel sorted by time, keys[begin, end)
+        struct Track
+        {
+            SequenceChannel channel;
+            std::uint8_t id;
+            std::uint32_t begin;
+            std::uint32_t end;
+        };
+
+        std::vector<SequenceKey> keys;
+        std::vector<Track> tracks;
+        float duration{ 0.0f };  // one pass
+        bool loop{ false };
+        float ttl{ 0.0f };                      // seconds from the start until the face is reset, 0 never
+        std::optional<ExpressionPreset> next;  // applied when a pass ends and the sequence doesn't loop
+    };
+
+    // keys with a channel or id out of range or a negative time are dropped,
+    // a_duration is raised to the last key; a loop needs a duration above 0
+    Sequence MakeSequence(std::vector<SequenceKey> a_keys, float a_duration, bool a_loop, float a_ttl, std::optional<ExpressionPreset> a_next);
+
+    // every channel of a_preset as keys at a_time, for sequences of whole presets
+    void AppendPresetKeys(std::vector<SequenceKey>& a_keys, float a_time, const ExpressionPreset& a_preset);
+
+    // plays one sequence on one face, headless: every step says what the face has to show
+    class SequencePlayer
+    {
+    public:
+        explicit SequencePlayer(std::shared_ptr<const Sequence> a_sequence);
+
+        // advances by a_timeDelta and merges the values of every channel the sequence has into a_out;
+        // false once it's over, a_out then holds the last values and the next preset, or the reset of the ttl
+        bool Step(float a_timeDelta, PendingFace& a_out);
+
+    private:
+        // where a track is, the line between two keys is worked out once per pair of keys
+        struct Segment
+        {
+            static constexpr std::uint32_t kStale = ~0u;
+
+            std::uint32_t cursor{ 0 };       // keys at or before _time
+            std::uint32_t line{ kStale };    // cursor the line below was worked out for
+            bool write{ false };             // nothing before the first key of the first pass
+            std::uint8_t id{ 0 };
+            float begin{ 0.0f };
+            float value{ 0.0f };  // at begin
+            float slope{ 0.0f };  // per second
+        };
+
+        void Evaluate(PendingFace& a_out);
+        void UpdateLine(const Sequence::Track& a_track, Segment& a_segment) const;
+
+        std::shared_ptr<const Sequence> _sequence;
+        std::vector<Segment> _segments;  // per track
+        float _time{ 0.0f };                  // within the pass
+        float _elapsed{ 0.0f };
+        bool _wrapped{ false };  // past the first pass of a loop, the keys before the first one come from the last
+        bool _ended{ false };    // the pass is over, waiting for the ttl
+    };
+
+    enum class SequenceStep : std::uint8_t
+    {
+        None = 0,  // no sequence on the face
+        Started,   // first step of a sequence, the face takes its speed
+        Playing
+    };
+
+    // the sequences playing, one per face at most; started and stopped from script threads,
+    // stepped by the update of their face
+    class SequenceBoard
+    {
+    public:
+        static constexpr std::size_t kShards = 16;
+
+        SequenceBoard() = default;
+        SequenceBoard(const SequenceBoard&) = delete;
+        SequenceBoard& operator=(const SequenceBoard&) = delete;
+
+        // replaces what a_face was playing
+        void Start(std::uintptr_t a_face, std::uint32_t a_owner, std::shared_ptr<const Sequence> a_sequence, float a_speed);
+
+        bool Stop(std::uintptr_t a_face);
+
+        // a_pending, default constructed, gets the owner, speed and writes of the step; a sequence that's over is dropped
+        SequenceStep Step(std::uintptr_t a_face, float a_timeDelta, PendingFace& a_pending);
+
+        // for actors that unload; returns how many faces
+        std::size_t EraseOwner(std::uint32_t a_owner);
+
+        // drops the sequence of a_face if another actor than a_owner started it
+        bool EraseForeign(std::uintptr_t a_face, std::uint32_t a_owner);
+
+        void Clear();
+
+        std::size_t Size() const { return _count.load(std::memory_order_relaxed); }
+
+    private:
+        struct Entry
+        {
+            std::uint32_t owner;
+            float speed;
+            bool started;
+            SequencePlayer player;
+        };
+
+        struct Shard
+        {
+            std::mutex lock;
+            std::unordered_map<std::uintptr_t, Entry> faces;
+        };
+
+        Shard& GetShard(std::uintptr_t a_face) { return _shards[(a_face >> 4) % kShards]; }
+
+        std::array<Shard, kShards> _shards;
+        std::atomic<std::size_t> _count{ 0 };
+    };
+}
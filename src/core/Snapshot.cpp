@@ -0,0 +1,118 @@
+#include "Snapshot.h"
+#include "Blend.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace MfgFix::Core
+{
+    std::array<float, kPresetSize> ToPreset(const FaceSnapshot& a_snapshot, SnapshotLayer a_layer)
+    {
+        std::array<float, kPresetSize> values{};
+
+        auto layer = static_cast<std::size_t>(a_layer) - 1;
+
+        // channels past a keyframe's count are 0 in the snapshot already
+        std::copy_n(a_snapshot.phonemes[layer].begin(), Phoneme::Total, values.begin());
+        std::copy_n(a_snapshot.modifiers[layer].begin(), kPresetModifiers, values.begin() + Phoneme::Total);
+
+        auto moods = a_layer == SnapshotLayer::Output ? 2 : 0;
+        auto expressions = std::span<const float>(a_snapshot.expressions[moods]).first(a_snapshot.expressionCount[moods]);
+        auto expression = ActiveExpression(expressions);
+
+        values[30] = static_cast<float>(expression);
+        values[31] = expression < expressions.size() ? expressions[expression] : 0.0f;
+
+        return values;
+    }
+
+    bool SnapshotBoard::Publish(std::uintptr_t a_face, const FaceSnapshot& a_snapshot)
+    {
+        std::shared_ptr<Slot> slot;
+
+        {
+            auto& shard = GetShard(a_face);
+            std::lock_guard locker(shard.lock);
+
+            auto& entry = shard.faces[a_face];
+            if (!entry.slot) {
+                entry.slot = std::make_shared<Slot>();
+            }
+
+            entry.lastUse = ++shard.tick;
+            slot = entry.slot;
+
+            if (shard.faces.size() > kMaxPerShard) {
+                std::erase_if(shard.faces, [&](const auto& a_entry) { return a_entry.second.lastUse + kMaxPerShard < shard.tick; });
+            }
+        }
+
+        // outside the shard lock, a face has one writer and readers don't wait for each other
+        if (std::memcmp(&slot->last, &a_snapshot, sizeof(FaceSnapshot)) == 0) {
+            return false;
+        }
+
+        slot->last = a_snapshot;
+        slot->snapshot.Store(a_snapshot);
+
+        return true;
+    }
+
+    bool SnapshotBoard::Read(std::uintptr_t a_face, FaceSnapshot& a_snapshot, std::uint32_t* a_version) const
+    {
+        std::shared_ptr<const Slot> slot;
+
+        {
+            auto& shard = GetShard(a_face);
+            std::lock_guard locker(shard.lock);
+
+            auto it = shard.faces.find(a_face);
+            if (it == shard.faces.end()) {
+                return false;
+            }
+
+            slot = it->second.slot;
+        }
+
+        std::uint32_t retries = 0;
+        auto version = slot->snapshot.Load(a_snapshot, &retries);
+
+        if (retries) {
+            _retries.fetch_add(retries, std::memory_order_relaxed);
+        }
+
+        if (a_version) {
+            *a_version = version;
+        }
+
+        return true;
+    }
+
+    bool SnapshotBoard::Erase(std::uintptr_t a_face)
+    {
+        auto& shard = GetShard(a_face);
+        std::lock_guard locker(shard.lock);
+
+        return shard.faces.erase(a_face) != 0;
+    }
+
+    void SnapshotBoard::Clear()
+    {
+        for (auto& shard : _shards) {
+            std::lock_guard locker(shard.lock);
+            shard.faces.clear();
+        }
+    }
+
+    std::size_t SnapshotBoard::Size() const
+    {
+        std::size_t size = 0;
+
+        for (auto& shard : _shards) {
+            std::lock_guard locker(shard.lock);
+            size += shard.faces.size();
+        }
+
+        return size;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Broadcast.h"
+#include "Channels.h"
+#include "SeqLock.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+namespace MfgFix::Core
+{
+    // layers of a face as its last update left them, for readers that don't take the face lock
+    // channels past the count of a keyframe read 0
+    struct FaceSnapshot
+    {
+        static constexpr std::size_t kLayers = 3;  // 1 = dialogue, 2 = script, 3 = output, at index 0 to 2
+
+        std::array<std::array<float, Expression::Total>, kLayers> expressions{};
+        std::array<std::array<float, Modifier::Total>, kLayers> modifiers{};
+        std::array<std::array<float, Phoneme::Total>, kLayers> phonemes{};
+        std::array<std::uint8_t, kLayers> expressionCount{};
+        std::array<std::uint8_t, kLayers> modifierCount{};
+        std::array<std::uint8_t, kLayers> phonemeCount{};
+        bool dialogue{ false };
+        std::array<std::uint8_t, 2> pad{};  // no padding bytes of unknown value, snapshots are compared with memcmp
+
+        // a_values cut or padded with 0 to the width of a_layer
+        template <std::size_t N>
+        static void Copy(std::span<const float> a_values, std::array<float, N>& a_layer, std::uint8_t& a_count)
+        {
+            auto count = a_values.size() < N ? a_values.size() : N;
+
+            for (std::size_t i = 0; i < N; ++i) {
+                a_layer[i] = i < count ? a_values[i] : 0.0f;
+            }
+
+            a_count = static_cast<std::uint8_t>(count);
+        }
+    };
+
+    static_assert(sizeof(FaceSnapshot) == 612);
+
+    // the layers as GetExpressionState numbers them
+    enum class SnapshotLayer : std::uint32_t
+    {
+        Dialogue = 1,
+        Script,
+        Output
+    };
+
+    // a layer in the layout ApplyExpressionPreset takes, values as the keyframes hold them (1.0 = 100);
+    // the expression is the strongest mood of expression1 for dialogue and script, scripts set it there, and of expression3 for the output
+    std::array<float, kPresetSize> ToPreset(const FaceSnapshot& a_snapshot, SnapshotLayer a_layer);
+
+    // the last snapshot of every face, keyed by the face (animData pointer)
+    // a face publishes from its own update with the face lock held, so there is one writer per face;
+    // readers on any thread copy it out of a SeqLock and only take the shard lock to find it
+    // a copy holds a reference to the slot it found, an erase meanwhile frees the slot once the copy is done with it
+    class SnapshotBoard
+    {
+    public:
+        static constexpr std::size_t kShards = 16;
+        static constexpr std::size_t kMaxPerShard = 64;  // above it, faces not published for as many publishes are dropped
+
+        SnapshotBoard() = default;
+        SnapshotBoard(const SnapshotBoard&) = delete;
+        SnapshotBoard& operator=(const SnapshotBoard&) = delete;
+
+        // a_face's writers must be serialized by the caller; false if a_snapshot is what a_face published last
+        bool Publish(std::uintptr_t a_face, const FaceSnapshot& a_snapshot);
+
+        // false if a_face hasn't published since it was erased; a_version gets the number of changes published before this one
+        bool Read(std::uintptr_t a_face, FaceSnapshot& a_snapshot, std::uint32_t* a_version = nullptr) const;
+
+        // for faces that unload, or load at an address another face had
+        bool Erase(std::uintptr_t a_face);
+
+        void Clear();
+
+        std::size_t Size() const;
+
+        // reads that saw a publish under way and started over, since the board was made
+        std::uint64_t Retries() const { return _retries.load(std::memory_order_relaxed); }
+
+    private:
+        struct Slot
+        {
+            SeqLock<FaceSnapshot> snapshot;
+            FaceSnapshot last;  // what snapshot holds, for the writer only: an idle face is a memcmp instead of a store
+        };
+
+        struct Entry
+        {
+            std::shared_ptr<Slot> slot;
+            std::uint64_t lastUse{ 0 };
+        };
+
+        struct Shard
+        {
+            mutable std::mutex lock;
+            std::unordered_map<std::uintptr_t, Entry> faces;
+            std::uint64_t tick{ 0 };  // publishes to the shard
+        };
+
+        Shard& GetShard(std::uintptr_t a_face) { return _shards[(a_face >> 4) % kShards]; }
+        const Shard& GetShard(std::uintptr_t a_face) const { return _shards[(a_face >> 4) % kShards]; }
+
+        std::array<Shard, kShards> _shards;
+        mutable std::atomic<std::uint64_t> _retries{ 0 };
+    };
+}
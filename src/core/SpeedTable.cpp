@@ -0,0 +1,305 @@
+#include "SpeedTable.h"
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        constexpr std::size_t kMask = SpeedTable::kCapacity - 1;
+
+        static_assert((SpeedTable::kCapacity & kMask) == 0);
+
+        // odd sequence while the table layout changes, readers retry across it
+        class WriteSequence
+        {
+        public:
+            explicit WriteSequence(std::atomic<std::uint32_t>& a_sequence) :
+                _sequence(a_sequence),
+                _value(a_sequence.load(std::memory_order_relaxed))
+            {
+                _sequence.store(_value + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+            }
+
+            ~WriteSequence()
+            {
+                _sequence.store(_value + 2, std::memory_order_release);
+            }
+
+        private:
+            std::atomic<std::uint32_t>& _sequence;
+            std::uint32_t _value;
+        };
+    }
+
+    float SpeedTable::Get(std::uintptr_t a_key, float a_default) const
+    {
+        for (;;) {
+            auto sequence = _sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                continue;
+            }
+
+            auto speed = a_default;
+            const Entry* found = nullptr;
+            auto index = Hash(a_key);
+
+            for (std::size_t probe = 0; probe < kCapacity; ++probe) {
+                auto key = _entries[index].key.load(std::memory_order_relaxed);
+                if (key == a_key) {
+                    found = &_entries[index];
+                    speed = found->speed.load(std::memory_order_relaxed);
+                    break;
+                }
+                if (key == 0) {
+                    break;
+                }
+                index = (index + 1) & kMask;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (_sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+
+            if (found) {
+                // only write when stale, keeps the line shared between the update threads
+                auto clock = _clock.load(std::memory_order_relaxed);
+                if (found->lastUse.load(std::memory_order_relaxed) != clock) {
+                    found->lastUse.store(clock, std::memory_order_relaxed);
+                }
+                _reads[ReadStripe()].hits.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                _reads[ReadStripe()].misses.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return speed;
+        }
+    }
+
+    void SpeedTable::Tick(std::uint32_t a_epoch)
+    {
+        // plain stores, every update thread may tick, the epoch only has to be about right
+        auto clock = _clock.load(std::memory_order_relaxed);
+        if (static_cast<std::int32_t>(a_epoch - clock) > 0) {
+            _clock.store(a_epoch, std::memory_order_relaxed);
+        }
+    }
+
+    bool SpeedTable::Set(std::uintptr_t a_key, std::uint32_t a_owner, float a_speed)
+    {
+        if (a_key == 0) {
+            return false;
+        }
+
+        std::lock_guard locker(_writeLock);
+
+        auto clock = _clock.load(std::memory_order_relaxed);
+        auto index = Find(a_key);
+        auto& entry = _entries[index];
+
+        if (entry.key.load(std::memory_order_relaxed) == a_key) {
+            if (a_speed == 0.0f) {
+                WriteSequence sequence(_sequence);
+                Erase(index);
+            } else {
+                // no layout change, the values are read one by one anyway
+                entry.speed.store(a_speed, std::memory_order_relaxed);
+                entry.owner.store(a_owner, std::memory_order_relaxed);
+                entry.lastUse.store(clock, std::memory_order_relaxed);
+            }
+
+            return true;
+        }
+
+        if (a_speed == 0.0f) {
+            return true;
+        }
+
+        WriteSequence sequence(_sequence);
+
+        if (_size.load(std::memory_order_relaxed) >= kMaxEntries) {
+            EraseLeastRecentlyUsed();
+            index = Find(a_key);  // erasing may have shifted the probe chain
+        }
+
+        _entries[index].speed.store(a_speed, std::memory_order_relaxed);
+        _entries[index].owner.store(a_owner, std::memory_order_relaxed);
+        _entries[index].lastUse.store(clock, std::memory_order_relaxed);
+        _entries[index].key.store(a_key, std::memory_order_relaxed);
+        _size.fetch_add(1, std::memory_order_relaxed);
+        ++_inserts;
+
+        return true;
+    }
+
+    std::size_t SpeedTable::EraseOwner(std::uint32_t a_owner)
+    {
+        std::lock_guard locker(_writeLock);
+
+        std::size_t count = 0;
+
+        for (std::size_t index = 0; index < kCapacity;) {
+            auto& entry = _entries[index];
+
+            if (entry.key.load(std::memory_order_relaxed) != 0 && entry.owner.load(std::memory_order_relaxed) == a_owner) {
+                WriteSequence sequence(_sequence);
+                Erase(index);
+                ++count;
+                continue;  // another entry may have shifted into this slot
+            }
+
+            ++index;
+        }
+
+        _evictedUnload += count;
+
+        return count;
+    }
+
+    bool SpeedTable::EraseForeign(std::uintptr_t a_key, std::uint32_t a_owner)
+    {
+        if (a_key == 0) {
+            return false;
+        }
+
+        std::lock_guard locker(_writeLock);
+
+        auto index = Find(a_key);
+        auto& entry = _entries[index];
+
+        if (entry.key.load(std::memory_order_relaxed) != a_key || entry.owner.load(std::memory_order_relaxed) == a_owner) {
+            return false;
+        }
+
+        WriteSequence sequence(_sequence);
+        Erase(index);
+        ++_evictedReuse;
+
+        return true;
+    }
+
+    void SpeedTable::Clear()
+    {
+        std::lock_guard locker(_writeLock);
+        WriteSequence sequence(_sequence);
+
+        for (auto& entry : _entries) {
+            entry.key.store(0, std::memory_order_relaxed);
+            entry.speed.store(0.0f, std::memory_order_relaxed);
+            entry.owner.store(0, std::memory_order_relaxed);
+            entry.lastUse.store(0, std::memory_order_relaxed);
+        }
+
+        _size.store(0, std::memory_order_relaxed);
+    }
+
+    std::size_t SpeedTable::Size() const
+    {
+        return _size.load(std::memory_order_relaxed);
+    }
+
+    SpeedTable::Stats SpeedTable::GetStats() const
+    {
+        std::lock_guard locker(_writeLock);
+
+        Stats stats;
+
+        stats.size = _size.load(std::memory_order_relaxed);
+        stats.memory = sizeof(*this);
+        for (auto& reads : _reads) {
+            stats.hits += reads.hits.load(std::memory_order_relaxed);
+            stats.misses += reads.misses.load(std::memory_order_relaxed);
+        }
+
+        stats.inserts = _inserts;
+        stats.evictedUnload = _evictedUnload;
+        stats.evictedLRU = _evictedLRU;
+        stats.evictedReuse = _evictedReuse;
+
+        return stats;
+    }
+
+    std::size_t SpeedTable::Hash(std::uintptr_t a_key)
+    {
+        // fibonacci hashing, heap pointers share their low bits
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(a_key) * 0x9E3779B97F4A7C15ull) >> 32) & kMask;
+    }
+
+    std::size_t SpeedTable::ReadStripe()
+    {
+        static std::atomic<std::size_t> next{ 0 };
+        thread_local auto stripe = next.fetch_add(1, std::memory_order_relaxed) % kReadStripes;
+
+        return stripe;
+    }
+
+    std::size_t SpeedTable::Find(std::uintptr_t a_key) const
+    {
+        // never full, kMaxEntries leaves empty slots to end every chain
+        auto index = Hash(a_key);
+
+        for (;;) {
+            auto key = _entries[index].key.load(std::memory_order_relaxed);
+            if (key == a_key || key == 0) {
+                return index;
+            }
+            index = (index + 1) & kMask;
+        }
+    }
+
+    void SpeedTable::Erase(std::size_t a_index)
+    {
+        // backward shift deletion, keeps probe chains free of tombstones
+        auto hole = a_index;
+        auto index = a_index;
+
+        for (;;) {
+            index = (index + 1) & kMask;
+
+            auto key = _entries[index].key.load(std::memory_order_relaxed);
+            if (key == 0) {
+                break;
+            }
+
+            // the entry can fill the hole only if its home slot isn't between the hole and itself
+            auto home = Hash(key);
+            if (((index - home) & kMask) >= ((index - hole) & kMask)) {
+                _entries[hole].key.store(key, std::memory_order_relaxed);
+                _entries[hole].speed.store(_entries[index].speed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                _entries[hole].owner.store(_entries[index].owner.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                _entries[hole].lastUse.store(_entries[index].lastUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                hole = index;
+            }
+        }
+
+        _entries[hole].key.store(0, std::memory_order_relaxed);
+        _entries[hole].speed.store(0.0f, std::memory_order_relaxed);
+        _entries[hole].owner.store(0, std::memory_order_relaxed);
+        _size.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void SpeedTable::EraseLeastRecentlyUsed()
+    {
+        auto clock = _clock.load(std::memory_order_relaxed);
+        std::size_t oldest = kCapacity;
+        std::uint32_t oldestAge = 0;
+
+        for (std::size_t index = 0; index < kCapacity; ++index) {
+            if (_entries[index].key.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+
+            auto age = clock - _entries[index].lastUse.load(std::memory_order_relaxed);
+            if (oldest == kCapacity || age > oldestAge) {
+                oldest = index;
+                oldestAge = age;
+            }
+        }
+
+        if (oldest != kCapacity) {
+            Erase(oldest);
+            ++_evictedLRU;
+        }
+    }
+}
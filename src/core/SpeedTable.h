@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace MfgFix::Core
+{
+    // fixed size open addressing table from a face (animData pointer) to its transition speed
+    // readers never lock, they retry only when a write overlapped (seqlock)
+    // writers are serialized among themselves
+    // every entry is tagged with the actor that set it, so entries can be dropped when that actor unloads
+    // and a face address reused by another actor doesn't inherit the speed
+    // entries are stamped with the epoch they were last read or written in, Tick advances it
+    class SpeedTable
+    {
+    public:
+        static constexpr std::size_t kCapacity = 2048;              // power of two
+        static constexpr std::size_t kMaxEntries = kCapacity / 2;  // hard cap, least recently used entries go first
+
+        struct Stats
+        {
+            std::size_t size{ 0 };
+            std::size_t maxEntries{ kMaxEntries };
+            std::size_t memory{ 0 };  // bytes
+            std::uint64_t hits{ 0 };
+            std::uint64_t misses{ 0 };
+            std::uint64_t inserts{ 0 };
+            std::uint64_t evictedUnload{ 0 };
+            std::uint64_t evictedLRU{ 0 };
+            std::uint64_t evictedReuse{ 0 };
+        };
+
+        // speed of a_key, a_default if it has none
+        float Get(std::uintptr_t a_key, float a_default) const;
+
+        // moves the epoch forward to a_epoch, a frame count or a coarse time, earlier epochs are ignored
+        // entries read in the same epoch are equally recent, so a reader stores into an entry once per epoch at most
+        void Tick(std::uint32_t a_epoch);
+
+        // a_speed of 0 removes the entry, returns false only for a null key
+        bool Set(std::uintptr_t a_key, std::uint32_t a_owner, float a_speed);
+
+        // drops every entry set by a_owner, returns how many
+        std::size_t EraseOwner(std::uint32_t a_owner);
+
+        // drops the entry of a_key if it was set by another actor than a_owner
+        bool EraseForeign(std::uintptr_t a_key, std::uint32_t a_owner);
+
+        void Clear();
+
+        std::size_t Size() const;
+        Stats GetStats() const;
+
+    private:
+        struct Entry
+        {
+            std::atomic<std::uintptr_t> key{ 0 };  // 0 is empty
+            std::atomic<float> speed{ 0.0f };
+            std::atomic<std::uint32_t> owner{ 0 };
+            mutable std::atomic<std::uint32_t> lastUse{ 0 };
+        };
+
+        // hit and miss counts spread over cache lines, each reading thread counts on its own most of the time
+        struct alignas(64) ReadCounters
+        {
+            std::atomic<std::uint64_t> hits{ 0 };
+            std::atomic<std::uint64_t> misses{ 0 };
+        };
+
+        static constexpr std::size_t kReadStripes = 8;
+
+        static std::size_t Hash(std::uintptr_t a_key);
+        static std::size_t ReadStripe();
+
+        // writer side, called with _writeLock held
+        std::size_t Find(std::uintptr_t a_key) const;  // index of a_key or of the empty slot ending its probe chain
+        void Erase(std::size_t a_index);
+        void EraseLeastRecentlyUsed();
+
+        std::array<Entry, kCapacity> _entries;
+        std::atomic<std::uint32_t> _sequence{ 0 };
+        std::atomic<std::uint32_t> _clock{ 0 };  // epoch, advanced by Tick, stamped into entries on use
+        std::atomic<std::size_t> _size{ 0 };
+        mutable std::mutex _writeLock;
+
+        mutable std::array<ReadCounters, kReadStripes> _reads;
+        std::uint64_t _inserts{ 0 };
+        std::uint64_t _evictedUnload{ 0 };
+        std::uint64_t _evictedLRU{ 0 };
+        std::uint64_t _evictedReuse{ 0 };
+    };
+}
@@ -0,0 +1,283 @@
+#include "Stats.h"
+#include "Text.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        std::atomic<std::uint64_t> nextStatsId{ 1 };
+    }
+
+    const char* ToString(Probe a_probe)
+    {
+        switch (a_probe) {
+        case Probe::KeyframesUpdate:
+            return "KeyframesUpdate";
+        case Probe::RegularUpdate:
+            return "RegularUpdate";
+        case Probe::SmoothUpdate:
+            return "SmoothUpdate";
+        case Probe::DialogueModifiers:
+            return "DialogueModifiers";
+        case Probe::DialoguePhonemes:
+            return "DialoguePhonemes";
+        case Probe::ReleaseDialogue:
+            return "ReleaseDialogue";
+        case Probe::LockWait:
+            return "LockWait";
+        case Probe::FaceFrame:
+            return "FaceFrame";
+        case Probe::PublishSnapshot:
+            return "PublishSnapshot";
+        case Probe::LockHeld:
+            return "LockHeld";
+        default:
+            return "?";
+        }
+    }
+
+    const char* ToString(Counter a_counter)
+    {
+        switch (a_counter) {
+        case Counter::BudgetFrames:
+            return "BudgetFrames";
+        case Counter::BudgetOverruns:
+            return "BudgetOverruns";
+        case Counter::BudgetDeferred:
+            return "BudgetDeferred";
+        case Counter::BudgetForced:
+            return "BudgetForced";
+        case Counter::CommandsQueued:
+            return "CommandsQueued";
+        case Counter::CommandsCoalesced:
+            return "CommandsCoalesced";
+        case Counter::CommandsDropped:
+            return "CommandsDropped";
+        case Counter::CommandsOverflows:
+            return "CommandsOverflows";
+        case Counter::CommandsLost:
+            return "CommandsLost";
+        case Counter::LockContended:
+            return "LockContended";
+        case Counter::UpdateDeferred:
+            return "UpdateDeferred";
+        case Counter::UpdateForced:
+            return "UpdateForced";
+        case Counter::UpdateConflicts:
+            return "UpdateConflicts";
+        default:
+            return "?";
+        }
+    }
+
+    void Histogram::Snapshot::Merge(const Snapshot& a_other)
+    {
+        count += a_other.count;
+        sum += a_other.sum;
+        max = std::max(max, a_other.max);
+
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            buckets[i] += a_other.buckets[i];
+        }
+    }
+
+    double Histogram::Snapshot::Mean() const
+    {
+        return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+    }
+
+    double Histogram::Snapshot::Percentile(double a_quantile) const
+    {
+        if (!count) {
+            return 0.0;
+        }
+
+        auto rank = std::max(1.0, std::ceil(std::clamp(a_quantile, 0.0, 1.0) * static_cast<double>(count)));
+        std::uint64_t below = 0;
+
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            if (!buckets[i]) {
+                continue;
+            }
+
+            if (static_cast<double>(below + buckets[i]) >= rank) {
+                auto low = i ? std::ldexp(1.0, static_cast<int>(i) - 1) : 0.0;
+                auto high = std::ldexp(1.0, static_cast<int>(i));
+                auto value = low + (high - low) * (rank - static_cast<double>(below)) / static_cast<double>(buckets[i]);
+
+                return std::min(value, static_cast<double>(max));
+            }
+
+            below += buckets[i];
+        }
+
+        return static_cast<double>(max);
+    }
+
+    Histogram::Snapshot Histogram::Read() const
+    {
+        Snapshot snapshot;
+
+        snapshot.count = _count.load(std::memory_order_relaxed);
+        snapshot.sum = _sum.load(std::memory_order_relaxed);
+        snapshot.max = _max.load(std::memory_order_relaxed);
+
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+        }
+
+        return snapshot;
+    }
+
+    void Histogram::Reset()
+    {
+        _count.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+
+        for (auto& bucket : _buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t Histogram::Bucket(std::uint64_t a_ticks)
+    {
+        return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(a_ticks)), kBuckets - 1);
+    }
+
+    Stats::Stats() :
+        _id(nextStatsId.fetch_add(1, std::memory_order_relaxed))
+    {}
+
+    std::uint32_t Stats::RegisterNative(std::string_view a_name)
+    {
+        std::lock_guard locker(_lock);
+
+        auto it = std::find(_nativeNames.begin(), _nativeNames.end(), a_name);
+        if (it != _nativeNames.end()) {
+            return static_cast<std::uint32_t>(it - _nativeNames.begin());
+        }
+
+        if (_nativeNames.size() >= kMaxNatives) {
+            return kNoNative;
+        }
+
+        _nativeNames.emplace_back(a_name);
+
+        return static_cast<std::uint32_t>(_nativeNames.size() - 1);
+    }
+
+    Stats::Report Stats::Collect() const
+    {
+        Report report;
+
+        report.seconds = _rate.Seconds();
+        report.ticksPerSecond = _rate.TicksPerSecond();
+
+        std::lock_guard locker(_lock);
+
+        report.threads = _threads.size();
+
+        for (auto& thread : _threads) {
+            for (std::size_t i = 0; i < report.probes.size(); ++i) {
+                report.probes[i].Merge((*thread)[i].Read());
+            }
+        }
+
+        for (std::size_t i = 0; i < report.counters.size(); ++i) {
+            report.counters[i] = _counters[i].load(std::memory_order_relaxed);
+        }
+
+        for (std::size_t i = 0; i < _nativeNames.size(); ++i) {
+            if (auto calls = _nativeCalls[i].load(std::memory_order_relaxed)) {
+                report.natives.emplace_back(_nativeNames[i], calls);
+            }
+        }
+
+        std::ranges::stable_sort(report.natives, std::ranges::greater{}, &std::pair<std::string, std::uint64_t>::second);
+
+        return report;
+    }
+
+    void Stats::Reset()
+    {
+        std::lock_guard locker(_lock);
+
+        for (auto& thread : _threads) {
+            for (auto& histogram : *thread) {
+                histogram.Reset();
+            }
+        }
+
+        for (auto& calls : _nativeCalls) {
+            calls.store(0, std::memory_order_relaxed);
+        }
+
+        for (auto& counter : _counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+
+        _rate.Restart();
+    }
+
+    std::string Stats::Format(const Report& a_report)
+    {
+        auto us = [&](double a_ticks) { return a_ticks * 1e6 / a_report.ticksPerSecond; };
+
+        auto& updates = a_report[Probe::KeyframesUpdate];
+        auto smooth = a_report[Probe::SmoothUpdate].count;
+        auto regular = a_report[Probe::RegularUpdate].count;
+        auto paths = std::max<std::uint64_t>(smooth + regular, 1);
+
+        std::string text;
+
+        AppendFormat(text, "stats over %.1f s, %zu update threads, %.2f GHz ticks\n", a_report.seconds, a_report.threads, a_report.ticksPerSecond * 1e-9);
+        AppendFormat(text, "updates/s %.0f  smooth %.1f%%  regular %.1f%%\n",
+            a_report.seconds > 0.0 ? static_cast<double>(updates.count) / a_report.seconds : 0.0,
+            100.0 * static_cast<double>(smooth) / static_cast<double>(paths),
+            100.0 * static_cast<double>(regular) / static_cast<double>(paths));
+        AppendFormat(text, "%-18s %10s %9s %9s %9s %9s  us\n", "probe", "count", "mean", "p50", "p99", "max");
+
+        for (std::size_t i = 0; i < a_report.probes.size(); ++i) {
+            auto& probe = a_report.probes[i];
+            AppendFormat(text, "%-18s %10llu %9.2f %9.2f %9.2f %9.2f\n",
+                ToString(static_cast<Probe>(i)), static_cast<unsigned long long>(probe.count),
+                us(probe.Mean()), us(probe.Percentile(0.5)), us(probe.Percentile(0.99)), us(static_cast<double>(probe.max)));
+        }
+
+        if (std::ranges::any_of(a_report.counters, [](std::uint64_t a_count) { return a_count != 0; })) {
+            text += "counters\n";
+            for (std::size_t i = 0; i < a_report.counters.size(); ++i) {
+                AppendFormat(text, "  %-48s %10llu\n", ToString(static_cast<Counter>(i)), static_cast<unsigned long long>(a_report.counters[i]));
+            }
+        }
+
+        if (!a_report.natives.empty()) {
+            text += "native calls\n";
+            for (auto& [name, calls] : a_report.natives) {
+                AppendFormat(text, "  %-48s %10llu\n", name.c_str(), static_cast<unsigned long long>(calls));
+            }
+        }
+
+        return text;
+    }
+
+    Stats::ThreadHistograms& Stats::Local()
+    {
+        thread_local std::uint64_t owner{ 0 };
+        thread_local ThreadHistograms* local{ nullptr };
+
+        if (owner != _id) {
+            std::lock_guard locker(_lock);
+
+            local = _threads.emplace_back(std::make_unique<ThreadHistograms>()).get();
+            owner = _id;
+        }
+
+        return *local;
+    }
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MfgFix::Core
+{
+    // timed sections of the face update
+    enum class Probe : std::uint32_t
+    {
+        KeyframesUpdate = 0,
+        RegularUpdate,
+        SmoothUpdate,
+        DialogueModifiers,
+        DialoguePhonemes,
+        ReleaseDialogue,
+        LockWait,
+        FaceFrame,  // all face updates of a frame, with a frame budget only
+        PublishSnapshot,
+        LockHeld,  // the face update with its lock held, both halves with bUnlockedUpdate
+
+        Total
+    };
+
+    const char* ToString(Probe a_probe);
+
+    // events counted while collecting
+    enum class Counter : std::uint32_t
+    {
+        BudgetFrames = 0,
+        BudgetOverruns,
+        BudgetDeferred,
+        BudgetForced,
+        CommandsQueued,
+        CommandsCoalesced,
+        CommandsDropped,
+        CommandsOverflows,
+        CommandsLost,     // commands for a face with no command slot left
+        LockContended,    // face updates that found their lock taken
+        UpdateDeferred,   // and put the frame off, bDeferOnContention
+        UpdateForced,     // and waited after LockDeferral::kMaxDeferred frames put off
+        UpdateConflicts,  // layers an unlocked update left to a writer that changed them meanwhile
+
+        Total
+    };
+
+    const char* ToString(Counter a_counter);
+
+    // log2 buckets of ticks, bucket i holds [2^(i-1), 2^i)
+    // one thread writes, any thread reads, nothing locks
+    class Histogram
+    {
+    public:
+        static constexpr std::size_t kBuckets = 48;
+
+        struct Snapshot
+        {
+            std::uint64_t count{ 0 };
+            std::uint64_t sum{ 0 };
+            std::uint64_t max{ 0 };
+            std::array<std::uint64_t, kBuckets> buckets{};
+
+            void Merge(const Snapshot& a_other);
+
+            double Mean() const;
+
+            // linear inside the bucket holding the a_quantile sample, never above max
+            double Percentile(double a_quantile) const;
+        };
+
+        void Add(std::uint64_t a_ticks)
+        {
+            Bump(_count, 1);
+            Bump(_sum, a_ticks);
+            Bump(_buckets[Bucket(a_ticks)], 1);
+
+            if (a_ticks > _max.load(std::memory_order_relaxed)) {
+                _max.store(a_ticks, std::memory_order_relaxed);
+            }
+        }
+
+        Snapshot Read() const;
+
+        // samples added while resetting may be lost
+        void Reset();
+
+        static std::size_t Bucket(std::uint64_t a_ticks);
+
+    private:
+        // single writer, a plain load and store instead of a locked add
+        static void Bump(std::atomic<std::uint64_t>& a_value, std::uint64_t a_delta)
+        {
+            a_value.store(a_value.load(std::memory_order_relaxed) + a_delta, std::memory_order_relaxed);
+        }
+
+        std::atomic<std::uint64_t> _count{ 0 };
+        std::atomic<std::uint64_t> _sum{ 0 };
+        std::atomic<std::uint64_t> _max{ 0 };
+        std::array<std::atomic<std::uint64_t>, kBuckets> _buckets{};
+    };
+
+    // per thread histograms of every probe plus call counts of named natives
+    // meant to be one instance per process, a thread alternating between instances registers again each time
+    class Stats
+    {
+    public:
+        static constexpr std::size_t kMaxNatives = 512;
+        static constexpr std::uint32_t kNoNative = kMaxNatives;
+
+        struct Report
+        {
+            double seconds{ 0.0 };         // since the last reset
+            double ticksPerSecond{ 0.0 };  // measured over the same span
+            std::size_t threads{ 0 };
+            std::array<Histogram::Snapshot, static_cast<std::size_t>(Probe::Total)> probes;
+            std::array<std::uint64_t, static_cast<std::size_t>(Counter::Total)> counters{};
+            std::vector<std::pair<std::string, std::uint64_t>> natives;  // called ones only, most calls first
+
+            const Histogram::Snapshot& operator[](Probe a_probe) const { return probes[static_cast<std::size_t>(a_probe)]; }
+        };
+
+        Stats();
+        Stats(const Stats&) = delete;
+        Stats& operator=(const Stats&) = delete;
+
+        void Add(Probe a_probe, std::uint64_t a_ticks)
+        {
+            Local()[static_cast<std::size_t>(a_probe)].Add(a_ticks);
+        }
+
+        void Count(Counter a_counter, std::uint64_t a_count = 1)
+        {
+            _counters[static_cast<std::size_t>(a_counter)].fetch_add(a_count, std::memory_order_relaxed);
+        }
+
+        // the same name always gets the same slot, kNoNative once all slots are taken
+        std::uint32_t RegisterNative(std::string_view a_name);
+
+        void CountNative(std::uint32_t a_slot)
+        {
+            if (a_slot < kMaxNatives) {
+                _nativeCalls[a_slot].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        Report Collect() const;
+        void Reset();
+
+        // plain text table, one line per probe and native
+        static std::string Format(const Report& a_report);
+
+    private:
+        using ThreadHistograms = std::array<Histogram, static_cast<std::size_t>(Probe::Total)>;
+
+        // registers the calling thread on its first sample
+        ThreadHistograms& Local();
+
+        const std::uint64_t _id;
+
+        mutable std::mutex _lock;
+        std::vector<std::unique_ptr<ThreadHistograms>> _threads;
+        std::vector<std::string> _nativeNames;
+        std::array<std::atomic<std::uint64_t>, kMaxNatives> _nativeCalls{};
+        std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(Counter::Total)> _counters{};
+
+        TickRate _rate;
+    };
+
+    // adds the time until Stop or the end of the scope, does nothing without stats
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(Stats* a_stats, Probe a_probe) :
+            _stats(a_stats),
+            _probe(a_probe),
+            _start(a_stats ? ReadTicks() : 0)
+        {}
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer() { Stop(); }
+
+        void Stop()
+        {
+            if (_stats) {
+                _stats->Add(_probe, ReadTicks() - _start);
+                _stats = nullptr;
+            }
+        }
+
+    private:
+        Stats* _stats;
+        Probe _probe;
+        std::uint64_t _start;
+    };
+}
@@ -0,0 +1,29 @@
+#include "Text.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace MfgFix::Core
+{
+    void AppendFormat(std::string& a_text, const char* a_format, ...)
+    {
+        std::va_list args;
+
+        va_start(args, a_format);
+        auto length = std::vsnprintf(nullptr, 0, a_format, args);
+        va_end(args);
+
+        if (length <= 0) {
+            return;
+        }
+
+        auto offset = a_text.size();
+        a_text.resize(offset + static_cast<std::size_t>(length) + 1);
+
+        va_start(args, a_format);
+        std::vsnprintf(a_text.data() + offset, static_cast<std::size_t>(length) + 1, a_format, args);
+        va_end(args);
+
+        a_text.resize(offset + static_cast<std::size_t>(length));
+    }
+}
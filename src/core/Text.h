@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+#if defined(__GNUC__)
+#define MFGFIX_PRINTF(a_format, a_args) __attribute__((format(printf, a_format, a_args)))
+#else
+#define MFGFIX_PRINTF(a_format, a_args)
+#endif
+
+namespace MfgFix::Core
+{
+    // printf into the end of a_text, <format> isn't available everywhere the core builds
+    void AppendFormat(std::string& a_text, const char* a_format, ...) MFGFIX_PRINTF(2, 3);
+}
@@ -0,0 +1,165 @@
+#include "Timeline.h"
+#include "Text.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        std::atomic<std::uint32_t> nextThreadIndex{ 1 };
+    }
+
+    const char* ToString(Span a_span)
+    {
+        switch (a_span) {
+        case Span::RegularUpdate:
+            return "RegularUpdate";
+        case Span::SmoothUpdate:
+            return "SmoothUpdate";
+        case Span::Expressions:
+            return "Expressions";
+        case Span::Modifiers:
+            return "Modifiers";
+        case Span::Phonemes:
+            return "Phonemes";
+        case Span::Custom:
+            return "Custom";
+        case Span::Dialogue:
+            return "Dialogue";
+        case Span::ReleaseDialogue:
+            return "ReleaseDialogue";
+        case Span::SetPhonemeModifierTask:
+            return "SetPhonemeModifierSmooth";
+        case Span::ResetMFGTask:
+            return "ResetMFGSmooth";
+        case Span::ApplyExpressionPresetTask:
+            return "ApplyExpressionPreset";
+        case Span::FaceCommands:
+            return "FaceCommands";
+        case Span::FaceSequences:
+            return "FaceSequences";
+        default:
+            return "?";
+        }
+    }
+
+    const char* Category(Span a_span)
+    {
+        switch (a_span) {
+        case Span::Dialogue:
+        case Span::ReleaseDialogue:
+            return "dialogue";
+        case Span::SetPhonemeModifierTask:
+        case Span::ResetMFGTask:
+        case Span::ApplyExpressionPresetTask:
+        case Span::FaceCommands:
+        case Span::FaceSequences:
+            return "papyrus";
+        default:
+            return "face";
+        }
+    }
+
+    std::uint32_t ThreadIndex()
+    {
+        thread_local std::uint32_t index{ nextThreadIndex.fetch_add(1, std::memory_order_relaxed) };
+
+        return index;
+    }
+
+    Timeline::Timeline(std::size_t a_capacity) :
+        _slots(std::make_unique<Slot[]>(std::bit_ceil(std::max<std::size_t>(a_capacity, 2)))),
+        _mask(std::bit_ceil(std::max<std::size_t>(a_capacity, 2)) - 1)
+    {}
+
+    void Timeline::Add(Span a_span, std::uint64_t a_id, std::uint64_t a_begin, std::uint64_t a_end)
+    {
+        auto index = _head.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = _slots[index & _mask];
+
+        // readers that see the old sequence before and after their copy got the old event intact
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.begin.store(a_begin, std::memory_order_relaxed);
+        slot.duration.store(a_end - a_begin, std::memory_order_relaxed);
+        slot.id.store(a_id, std::memory_order_relaxed);
+        slot.info.store(std::uint64_t{ ThreadIndex() } << 32 | static_cast<std::uint32_t>(a_span), std::memory_order_relaxed);
+
+        slot.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    Timeline::Capture Timeline::Collect() const
+    {
+        Capture capture;
+
+        auto head = _head.load(std::memory_order_acquire);
+        auto first = std::max(_first.load(std::memory_order_relaxed), head > Capacity() ? head - Capacity() : 0);
+
+        capture.ticksPerSecond = _rate.TicksPerSecond();
+        capture.recorded = head - _first.load(std::memory_order_relaxed);
+        capture.events.reserve(static_cast<std::size_t>(head - first));
+
+        for (auto index = first; index < head; ++index) {
+            auto& slot = _slots[index & _mask];
+
+            // a slot whose writer hasn't finished yet, or was lapped by a newer event meanwhile, is skipped
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != index + 1) {
+                ++capture.torn;
+                continue;
+            }
+
+            Event event;
+            event.begin = slot.begin.load(std::memory_order_relaxed);
+            event.duration = slot.duration.load(std::memory_order_relaxed);
+            event.id = slot.id.load(std::memory_order_relaxed);
+
+            auto info = slot.info.load(std::memory_order_relaxed);
+            event.thread = static_cast<std::uint32_t>(info >> 32);
+            event.span = static_cast<Span>(static_cast<std::uint32_t>(info));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence || event.span >= Span::Total) {
+                ++capture.torn;
+                continue;
+            }
+
+            capture.events.push_back(event);
+        }
+
+        return capture;
+    }
+
+    void Timeline::Clear()
+    {
+        _first.store(_head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _rate.Restart();
+    }
+
+    std::string FormatChromeTrace(const Timeline::Capture& a_capture)
+    {
+        auto origin = a_capture.events.empty() ? 0 : std::ranges::min(a_capture.events, {}, &Timeline::Event::begin).begin;
+        auto us = 1e6 / a_capture.ticksPerSecond;
+
+        std::string text;
+        text.reserve(160 * (a_capture.events.size() + 1));
+
+        AppendFormat(text, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"ticksPerSecond\":%.0f,\"recorded\":%llu,\"torn\":%llu},\"traceEvents\":[\n",
+            a_capture.ticksPerSecond, static_cast<unsigned long long>(a_capture.recorded), static_cast<unsigned long long>(a_capture.torn));
+        text += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"mfgfix\"}}";
+
+        for (auto& event : a_capture.events) {
+            AppendFormat(text, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"id\":\"0x%llx\"}}",
+                ToString(event.span), Category(event.span), event.thread,
+                static_cast<double>(event.begin - origin) * us, static_cast<double>(event.duration) * us,
+                static_cast<unsigned long long>(event.id));
+        }
+
+        text += "\n]}\n";
+
+        return text;
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace MfgFix::Core
+{
+    // spans recorded on the timeline
+    enum class Span : std::uint32_t
+    {
+        RegularUpdate = 0,
+        SmoothUpdate,
+        Expressions,
+        Modifiers,
+        Phonemes,
+        Custom,
+        Dialogue,
+        ReleaseDialogue,
+        SetPhonemeModifierTask,
+        ResetMFGTask,
+        ApplyExpressionPresetTask,
+        FaceCommands,
+        FaceSequences,
+
+        Total
+    };
+
+    const char* ToString(Span a_span);
+
+    // "face", "dialogue" or "papyrus", trace viewers filter and color by it
+    const char* Category(Span a_span);
+
+    // small per thread number, stable for the life of the thread
+    std::uint32_t ThreadIndex();
+
+    // fixed size ring of completed spans, the newest ones overwrite the oldest
+    // Add is lock free and wait free for any number of threads, Collect may run concurrently with it
+    class Timeline
+    {
+    public:
+        struct Event
+        {
+            std::uint64_t begin{ 0 };  // ticks
+            std::uint64_t duration{ 0 };
+            std::uint64_t id{ 0 };  // face or actor the span worked on
+            std::uint32_t thread{ 0 };
+            Span span{ Span::Total };
+        };
+
+        struct Capture
+        {
+            std::vector<Event> events;  // in the order they ended
+            double ticksPerSecond{ 1e9 };
+            std::uint64_t recorded{ 0 };  // since the last Clear, including overwritten ones
+            std::uint64_t torn{ 0 };      // being written during Collect, left out
+        };
+
+        // a_capacity is rounded up to a power of two
+        explicit Timeline(std::size_t a_capacity);
+        Timeline(const Timeline&) = delete;
+        Timeline& operator=(const Timeline&) = delete;
+
+        void Add(Span a_span, std::uint64_t a_id, std::uint64_t a_begin, std::uint64_t a_end);
+
+        Capture Collect() const;
+
+        // events added before are left out of later captures
+        void Clear();
+
+        std::size_t Capacity() const { return _mask + 1; }
+
+    private:
+        // sequence is the event index + 1 once the slot holds that event, 0 while it's being written
+        struct Slot
+        {
+            std::atomic<std::uint64_t> sequence{ 0 };
+            std::atomic<std::uint64_t> begin{ 0 };
+            std::atomic<std::uint64_t> duration{ 0 };
+            std::atomic<std::uint64_t> id{ 0 };
+            std::atomic<std::uint64_t> info{ 0 };  // thread << 32 | span
+        };
+
+        std::unique_ptr<Slot[]> _slots;
+        std::uint64_t _mask;
+        std::atomic<std::uint64_t> _head{ 0 };
+        std::atomic<std::uint64_t> _first{ 0 };
+        TickRate _rate;
+    };
+
+    // Chrome / Perfetto trace-event JSON, one complete ("X") event per span, timestamps relative to the oldest one
+    std::string FormatChromeTrace(const Timeline::Capture& a_capture);
+
+    // adds the span at the end of the scope, does nothing without a timeline
+    class TimelineScope
+    {
+    public:
+        TimelineScope(Timeline* a_timeline, Span a_span, std::uint64_t a_id) :
+            _timeline(a_timeline),
+            _span(a_span),
+            _id(a_id),
+            _begin(a_timeline ? ReadTicks() : 0)
+        {}
+
+        TimelineScope(const TimelineScope&) = delete;
+        TimelineScope& operator=(const TimelineScope&) = delete;
+
+        ~TimelineScope()
+        {
+            if (_timeline) {
+                _timeline->Add(_span, _id, _begin, ReadTicks());
+            }
+        }
+
+    private:
+        Timeline* _timeline;
+        Span _span;
+        std::uint64_t _id;
+        std::uint64_t _begin;
+    };
+}
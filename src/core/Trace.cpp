@@ -0,0 +1,442 @@
+#include "Trace.h"
+
+#include <bit>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        constexpr std::size_t kWords = sizeof(TraceRecord) / sizeof(std::uint32_t);
+
+        // one bit per record word
+        using Mask = std::array<std::uint64_t, (kWords + 63) / 64>;
+
+        constexpr std::size_t kMaskSize = sizeof(Mask);
+
+        template <class T>
+        T Load(const std::byte* a_data)
+        {
+            T value;
+            std::memcpy(&value, a_data, sizeof(T));
+            return value;
+        }
+    }
+
+    TraceParams MakeTraceParams(const BlinkParams& a_blink, const TrackParams& a_track, float a_phonemeThreshold, std::span<const EyesOffsetParams> a_eyesOffset)
+    {
+        TraceParams params{};
+
+        params.blink = a_blink;
+        params.track = a_track;
+        params.phonemeThreshold = a_phonemeThreshold;
+
+        for (std::size_t i = 0; i < params.eyesOffset.size() && i < a_eyesOffset.size(); ++i) {
+            auto& src = a_eyesOffset[i];
+            params.eyesOffset[i] = { src.headingMin, src.headingMax, src.pitchMin, src.pitchMax, src.delayMin, src.delayMax, src.delayExponent, src.zeroChance };
+        }
+
+        return params;
+    }
+
+    std::array<EyesOffsetParams, Expression::Total> EyesOffsets(const TraceParams& a_params)
+    {
+        std::array<EyesOffsetParams, Expression::Total> result;
+
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            auto& src = a_params.eyesOffset[i];
+            auto& dst = result[i];
+
+            dst.headingMin = src[0];
+            dst.headingMax = src[1];
+            dst.pitchMin = src[2];
+            dst.pitchMax = src[3];
+            dst.delayMin = src[4];
+            dst.delayMax = src[5];
+            dst.delayExponent = src[6];
+            dst.zeroChance = src[7];
+            dst.delayCurve = PowerCurve(dst.delayExponent);
+        }
+
+        return result;
+    }
+
+    TraceWriter::~TraceWriter()
+    {
+        Close();
+    }
+
+    bool TraceWriter::Open(const std::filesystem::path& a_path)
+    {
+        std::lock_guard locker(_lock);
+
+        if (_file) {
+            return false;
+        }
+
+#if defined(_WIN32)
+        if (_wfopen_s(&_file, a_path.c_str(), L"wb") != 0) {
+            _file = nullptr;
+        }
+#else
+        _file = std::fopen(a_path.c_str(), "wb");
+#endif
+        if (!_file) {
+            return false;
+        }
+
+        _buffer.reserve(kFlushSize + sizeof(TraceRecord) * 2);
+        _records = 0;
+        _bytes = 0;
+
+        TraceHeader header;
+        Append(&header, sizeof(header));
+
+        return true;
+    }
+
+    void TraceWriter::Close()
+    {
+        std::lock_guard locker(_lock);
+
+        if (!_file) {
+            return;
+        }
+
+        Flush();
+        std::fclose(_file);
+
+        _file = nullptr;
+        _previous.clear();
+        _hasParams = false;
+    }
+
+    bool TraceWriter::IsOpen() const
+    {
+        std::lock_guard locker(_lock);
+        return _file != nullptr;
+    }
+
+    void TraceWriter::Write(const TraceParams& a_params, std::uint64_t a_face, const TraceRecord& a_record)
+    {
+        std::lock_guard locker(_lock);
+
+        if (!_file) {
+            return;
+        }
+
+        if (!_hasParams || std::memcmp(&_params, &a_params, sizeof(TraceParams)) != 0) {
+            _params = a_params;
+            _hasParams = true;
+
+            AppendChunk(TraceChunk::Params, sizeof(TraceParams));
+            Append(&a_params, sizeof(TraceParams));
+        }
+
+        // first record of a face is encoded against all zero
+        auto& previous = _previous.try_emplace(a_face).first->second;
+
+        auto before = reinterpret_cast<const std::byte*>(&previous);
+        auto after = reinterpret_cast<const std::byte*>(&a_record);
+
+        Mask mask{};
+        _changed.clear();
+
+        for (std::size_t i = 0; i < kWords; ++i) {
+            auto word = Load<std::uint32_t>(after + i * sizeof(std::uint32_t));
+            if (word != Load<std::uint32_t>(before + i * sizeof(std::uint32_t))) {
+                mask[i / 64] |= std::uint64_t{ 1 } << (i % 64);
+                _changed.push_back(word);
+            }
+        }
+
+        previous = a_record;
+
+        AppendChunk(TraceChunk::Face, sizeof(a_face) + kMaskSize + _changed.size() * sizeof(std::uint32_t));
+        Append(&a_face, sizeof(a_face));
+        Append(mask.data(), kMaskSize);
+        Append(_changed.data(), _changed.size() * sizeof(std::uint32_t));
+
+        ++_records;
+
+        if (_buffer.size() >= kFlushSize) {
+            Flush();
+        }
+    }
+
+    std::uint64_t TraceWriter::Records() const
+    {
+        std::lock_guard locker(_lock);
+        return _records;
+    }
+
+    std::uint64_t TraceWriter::Bytes() const
+    {
+        std::lock_guard locker(_lock);
+        return _bytes;
+    }
+
+    void TraceWriter::Append(const void* a_data, std::size_t a_size)
+    {
+        auto data = static_cast<const std::byte*>(a_data);
+        _buffer.insert(_buffer.end(), data, data + a_size);
+        _bytes += a_size;
+    }
+
+    void TraceWriter::AppendChunk(TraceChunk a_kind, std::size_t a_size)
+    {
+        auto size = static_cast<std::uint32_t>(a_size);
+
+        Append(&a_kind, sizeof(a_kind));
+        Append(&size, sizeof(size));
+    }
+
+    void TraceWriter::Flush()
+    {
+        if (!_buffer.empty()) {
+            std::fwrite(_buffer.data(), 1, _buffer.size(), _file);
+            _buffer.clear();
+        }
+
+        std::fflush(_file);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::filesystem::path& a_path)
+    {
+        Close();
+
+#if defined(_WIN32)
+        _file = ::CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (_file == INVALID_HANDLE_VALUE) {
+            _file = nullptr;
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(_file, &size) || size.QuadPart == 0) {
+            Close();
+            return false;
+        }
+
+        _mapping = ::CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!_mapping) {
+            Close();
+            return false;
+        }
+
+        _data = static_cast<const std::byte*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!_data) {
+            Close();
+            return false;
+        }
+
+        _size = static_cast<std::size_t>(size.QuadPart);
+#else
+        auto fd = ::open(a_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+
+        auto data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED) {
+            return false;
+        }
+
+        ::madvise(data, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+        _data = static_cast<const std::byte*>(data);
+        _size = static_cast<std::size_t>(info.st_size);
+#endif
+
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+#if defined(_WIN32)
+        if (_data) {
+            ::UnmapViewOfFile(_data);
+        }
+        if (_mapping) {
+            ::CloseHandle(_mapping);
+        }
+        if (_file) {
+            ::CloseHandle(_file);
+        }
+
+        _mapping = nullptr;
+        _file = nullptr;
+#else
+        if (_data) {
+            ::munmap(const_cast<std::byte*>(_data), _size);
+        }
+#endif
+
+        _data = nullptr;
+        _size = 0;
+    }
+
+    bool TraceReader::Open(const std::filesystem::path& a_path)
+    {
+        _failed = true;
+
+        if (!_file.Open(a_path)) {
+            return false;
+        }
+
+        auto data = _file.Data();
+        if (data.size() < sizeof(TraceHeader)) {
+            return false;
+        }
+
+        auto header = Load<TraceHeader>(data.data());
+        if (header.magic != TraceHeader::kMagic || header.version != TraceHeader::kVersion ||
+            header.recordSize != sizeof(TraceRecord) || header.paramsSize != sizeof(TraceParams)) {
+            return false;
+        }
+
+        Rewind();
+
+        return true;
+    }
+
+    TraceChunk TraceReader::Next()
+    {
+        auto data = _file.Data();
+
+        while (!_failed && _offset < data.size()) {
+            constexpr std::size_t kChunkHeader = sizeof(TraceChunk) + sizeof(std::uint32_t);
+
+            if (data.size() - _offset < kChunkHeader) {
+                break;
+            }
+
+            auto kind = Load<TraceChunk>(data.data() + _offset);
+            auto size = Load<std::uint32_t>(data.data() + _offset + sizeof(TraceChunk));
+            auto payload = data.data() + _offset + kChunkHeader;
+
+            if (data.size() - _offset - kChunkHeader < size) {
+                break;  // truncated, the game was closed while capturing
+            }
+
+            _offset += kChunkHeader + size;
+
+            switch (kind) {
+            case TraceChunk::Params:
+                if (size != sizeof(TraceParams)) {
+                    _failed = true;
+                    return TraceChunk::None;
+                }
+
+                _params = Load<TraceParams>(payload);
+
+                return kind;
+            case TraceChunk::Face:
+                {
+                    if (size < sizeof(std::uint64_t) + kMaskSize) {
+                        _failed = true;
+                        return TraceChunk::None;
+                    }
+
+                    _face = Load<std::uint64_t>(payload);
+                    auto mask = Load<Mask>(payload + sizeof(std::uint64_t));
+                    auto changed = payload + sizeof(std::uint64_t) + kMaskSize;
+
+                    std::size_t count = 0;
+                    for (auto bits : mask) {
+                        count += static_cast<std::size_t>(std::popcount(bits));
+                    }
+
+                    if (size != sizeof(std::uint64_t) + kMaskSize + count * sizeof(std::uint32_t)) {
+                        _failed = true;
+                        return TraceChunk::None;
+                    }
+
+                    // patched in place, only changed words are touched
+                    auto& record = _previous.try_emplace(_face).first->second;
+                    auto words = reinterpret_cast<std::byte*>(&record);
+
+                    for (std::size_t block = 0; block < mask.size(); ++block) {
+                        for (auto bits = mask[block]; bits; bits &= bits - 1) {
+                            auto i = block * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+                            std::memcpy(words + i * sizeof(std::uint32_t), changed, sizeof(std::uint32_t));
+                            changed += sizeof(std::uint32_t);
+                        }
+                    }
+
+                    _record = &record;
+
+                    return kind;
+                }
+            default:
+                break;  // unknown chunk, skipped
+            }
+        }
+
+        return TraceChunk::None;
+    }
+
+    void TraceReader::Rewind()
+    {
+        _offset = sizeof(TraceHeader);
+        _failed = false;
+        _record = nullptr;
+        _previous.clear();
+    }
+
+    void TraceReplayer::SetParams(const TraceParams& a_params)
+    {
+        _eyesOffset = EyesOffsets(a_params);
+
+        _base.blink = a_params.blink;
+        _base.track = a_params.track;
+        _base.phonemeThreshold = a_params.phonemeThreshold;
+        _base.eyesOffset = _eyesOffset;
+    }
+
+    void TraceReplayer::Replay(std::uint64_t a_face, ReplayFace& a_replay, const TraceRecord& a_record, Timeline* a_timeline)
+    {
+        auto context = _base;
+        context.timeDelta = a_record.timeDelta;
+        context.speed = a_record.speed;
+        context.animationStep = a_record.speed > 0.0f ? a_record.timeDelta / a_record.speed : 0.0f;
+        context.track.deltaMax *= a_record.timeDelta;
+        context.rng = &_rng;
+        context.timeline = a_timeline;
+        context.face = a_face;
+
+        _rng.SetState(a_record.rng);
+
+        if (a_record.speed > 0.0f) {
+            TimelineScope scope(a_timeline, Span::SmoothUpdate, context.face);
+            SmoothUpdate(a_replay, context);
+        } else {
+            TimelineScope scope(a_timeline, Span::RegularUpdate, context.face);
+            RegularUpdate(a_replay, context);
+        }
+    }
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "Eyes.h"
+#include "FaceUpdate.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace MfgFix::Core
+{
+    // one face update: what RegularUpdate / SmoothUpdate read and what they produced
+    // every field is 4 bytes wide, records are delta encoded word by word against the previous record of the same face
+    struct TraceRecord
+    {
+        static constexpr std::uint32_t kMaxChannels = 32;
+        static constexpr std::size_t kLayers = static_cast<std::size_t>(Layer::Total);
+
+        enum Flags : std::uint32_t
+        {
+            kHold = 1 << 0,
+            kDialogue = 1 << 1
+        };
+
+        using Values = std::array<std::array<float, kMaxChannels>, kLayers>;
+
+        float timeDelta;
+        float speed;
+        std::uint32_t flags;
+        Rng::State rng;  // update thread's generator before the update
+        std::array<std::uint32_t, kLayers> counts;
+
+        // dialogue timers after the engine step
+        float modifierTimer;
+        float phonemeTimer;
+
+        EyesState eyesIn;
+        float blinkValueIn;
+        Values in;  // layer 1 after the engine step (transition, dialogue), everything else before the update
+
+        EyesState eyesOut;
+        float blinkValueOut;
+        Values out;
+    };
+
+    static_assert(std::is_trivially_copyable_v<TraceRecord> && sizeof(TraceRecord) % sizeof(std::uint32_t) == 0);
+
+    // settings the update depends on, written whenever they change
+    struct TraceParams
+    {
+        BlinkParams blink;
+        TrackParams track;  // deltaMax per second
+        float phonemeThreshold;
+        std::array<std::array<float, 8>, Expression::Total> eyesOffset;  // EyesOffsetParams up to the delay curve
+    };
+
+    static_assert(std::is_trivially_copyable_v<TraceParams>);
+
+    TraceParams MakeTraceParams(const BlinkParams& a_blink, const TrackParams& a_track, float a_phonemeThreshold, std::span<const EyesOffsetParams> a_eyesOffset);
+    std::array<EyesOffsetParams, Expression::Total> EyesOffsets(const TraceParams& a_params);
+
+    // file layout: header, then chunks of [u8 kind][u32 size][payload]
+    //   params:  TraceParams
+    //   face:    u64 face, bitmask of changed record words in u64 blocks, changed words
+    struct TraceHeader
+    {
+        static constexpr std::array<char, 8> kMagic{ 'M', 'F', 'G', 'T', 'R', 'A', 'C', 'E' };
+        static constexpr std::uint32_t kVersion = 2;  // 2 dropped the eyes timer results of the batched update
+
+        std::array<char, 8> magic{ kMagic };
+        std::uint32_t version{ kVersion };
+        std::uint32_t recordSize{ sizeof(TraceRecord) };
+        std::uint32_t paramsSize{ sizeof(TraceParams) };
+    };
+
+    enum class TraceChunk : std::uint8_t
+    {
+        None = 0,
+        Params,
+        Face
+    };
+
+    // thread safe, faces updated on different threads end up interleaved in one file
+    class TraceWriter
+    {
+    public:
+        TraceWriter() = default;
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+        ~TraceWriter();
+
+        bool Open(const std::filesystem::path& a_path);
+        void Close();
+        bool IsOpen() const;
+
+        // a params chunk goes first whenever a_params differs from the last one written
+        void Write(const TraceParams& a_params, std::uint64_t a_face, const TraceRecord& a_record);
+
+        std::uint64_t Records() const;
+        std::uint64_t Bytes() const;
+
+    private:
+        static constexpr std::size_t kFlushSize = 1 << 20;
+
+        void Append(const void* a_data, std::size_t a_size);
+        void AppendChunk(TraceChunk a_kind, std::size_t a_size);
+        void Flush();
+
+        mutable std::mutex _lock;
+        std::FILE* _file{ nullptr };
+        std::vector<std::byte> _buffer;
+        std::vector<std::uint32_t> _changed;
+        std::unordered_map<std::uint64_t, TraceRecord> _previous;
+        TraceParams _params{};
+        bool _hasParams{ false };
+        std::uint64_t _records{ 0 };
+        std::uint64_t _bytes{ 0 };
+    };
+
+    // read only view of a whole file
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+
+        bool Open(const std::filesystem::path& a_path);
+        void Close();
+
+        std::span<const std::byte> Data() const { return { _data, _size }; }
+
+    private:
+        const std::byte* _data{ nullptr };
+        std::size_t _size{ 0 };
+#if defined(_WIN32)
+        void* _file{ nullptr };
+        void* _mapping{ nullptr };
+#endif
+    };
+
+    // walks the chunks of a mapped trace, face records come back fully decoded
+    class TraceReader
+    {
+    public:
+        bool Open(const std::filesystem::path& a_path);
+
+        // kind of the chunk read, None at the end of the file or on a malformed chunk
+        TraceChunk Next();
+        void Rewind();
+
+        bool Failed() const { return _failed; }
+        std::size_t Size() const { return _file.Data().size(); }
+
+        const TraceParams& Params() const { return _params; }
+        std::uint64_t Face() const { return _face; }
+        const TraceRecord& Record() const { return *_record; }
+
+    private:
+        MappedFile _file;
+        std::size_t _offset{ 0 };
+        bool _failed{ false };
+        TraceParams _params{};
+        std::uint64_t _face{ 0 };
+        const TraceRecord* _record{ nullptr };
+        std::unordered_map<std::uint64_t, TraceRecord> _previous;
+    };
+
+    // a recorded face: layer 1 already holds what the engine computed, so its steps are no-ops here
+    class ReplayFace
+    {
+    public:
+        explicit ReplayFace(const TraceRecord& a_record) :
+            _record(a_record),
+            _values(a_record.in),
+            _eyes(a_record.eyesIn),
+            _blinkValue(a_record.blinkValueIn)
+        {}
+
+        std::span<float> Values(Layer a_layer)
+        {
+            auto i = static_cast<std::size_t>(a_layer);
+            return { _values[i].data(), _record.counts[i] };
+        }
+
+        bool IsZero(Layer a_layer)
+        {
+            auto values = Values(a_layer);
+            return std::all_of(values.begin(), values.end(), [](float a_value) { return a_value == 0.0f; });
+        }
+
+        void Reset(Layer a_layer)
+        {
+            auto values = Values(a_layer);
+            std::fill(values.begin(), values.end(), 0.0f);
+        }
+
+        void Copy(Layer a_src, Layer a_dst)
+        {
+            auto src = Values(a_src);
+            auto dst = Values(a_dst);
+            std::copy_n(src.begin(), std::min(src.size(), dst.size()), dst.begin());
+        }
+
+        bool TransitionUpdate(float) { return true; }  // layer 1 comes as the engine left it, whether it moved isn't recorded
+        void DialogueModifiersUpdate(float) {}
+        void DialoguePhonemesUpdate(float) {}
+
+        EyesTimers EyesTimersUpdate(const FaceUpdateContext& a_context)
+        {
+            return MfgFix::Core::EyesTimersUpdate(_eyes, a_context, Hold());
+        }
+
+        EyesState GetEyesState() const { return _eyes; }
+        void SetEyesState(const EyesState& a_eyes) { _eyes = a_eyes; }
+
+        float& BlinkValue() { return _blinkValue; }
+        bool Hold() const { return _record.flags & TraceRecord::kHold; }
+        bool Dialogue() const { return _record.flags & TraceRecord::kDialogue; }
+
+        const TraceRecord::Values& Result() const { return _values; }
+        const EyesState& Eyes() const { return _eyes; }
+        float Blink() const { return _blinkValue; }
+
+    private:
+        const TraceRecord& _record;
+        TraceRecord::Values _values;
+        EyesState _eyes;
+        float _blinkValue;
+    };
+
+    // feeds records through the update code with the settings of the last params chunk, as the hook ran them
+    class TraceReplayer
+    {
+    public:
+        void SetParams(const TraceParams& a_params);
+
+        void Replay(std::uint64_t a_face, ReplayFace& a_replay, const TraceRecord& a_record, Timeline* a_timeline = nullptr);
+
+    private:
+        std::array<EyesOffsetParams, Expression::Total> _eyesOffset{};
+        FaceUpdateContext _base;
+        Rng _rng{ Rng::kDefaultSeed };
+    };
+}
@@ -0,0 +1,251 @@
+#include "Transition.h"
+#include "Blend.h"
+
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#if defined(MFGFIX_X64)
+#include <immintrin.h>
+#endif
+
+namespace MfgFix::Core
+{
+    namespace
+    {
+        using TransitionStep_t = std::uint32_t (*)(const float*, const float*, const float*, const float*, float, float*, std::size_t);
+
+        TransitionStep_t transitionStep = Kernels::TransitionStepScalar;
+
+        bool FollowsDialogue(float a_dialogue, float a_target)
+        {
+            return std::fabs(a_target) < FLT_EPSILON && std::fabs(a_dialogue) > FLT_EPSILON;
+        }
+
+        // the lanes a_begin to a_end of a step, the bits of the channels following dialogue at their index
+        std::uint32_t TransitionStepRange(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_begin, std::size_t a_end)
+        {
+            std::uint32_t dialogue = 0;
+
+            for (std::size_t i = a_begin; i < a_end; ++i) {
+                auto follow = FollowsDialogue(a_dialogue[i], a_target[i]);
+                auto planned = a_from[i] + a_delta[i] * a_scale;
+                a_out[i] = follow ? a_dialogue[i] : planned;
+                dialogue |= static_cast<std::uint32_t>(follow) << i;
+            }
+
+            return dialogue;
+        }
+
+        float Ease(EaseCurve a_curve, float a_time)
+        {
+            switch (a_curve) {
+            case EaseCurve::SmoothStep:
+                return a_time * a_time * (3.0f - 2.0f * a_time);
+            case EaseCurve::EaseIn:
+                return a_time * a_time;
+            case EaseCurve::EaseOut:
+                return a_time * (2.0f - a_time);
+            default:
+                return a_time;
+            }
+        }
+    }
+
+    const char* ToString(EaseCurve a_curve)
+    {
+        switch (a_curve) {
+        case EaseCurve::Linear:
+            return "linear";
+        case EaseCurve::SmoothStep:
+            return "smoothstep";
+        case EaseCurve::EaseIn:
+            return "ease in";
+        case EaseCurve::EaseOut:
+            return "ease out";
+        default:
+            return "unknown";
+        }
+    }
+
+    EaseTable::EaseTable(EaseCurve a_curve) :
+        _curve(a_curve)
+    {
+        for (std::size_t i = 0; i <= kSamples; ++i) {
+            _values[i] = Ease(a_curve, static_cast<float>(i) / static_cast<float>(kSamples));
+        }
+    }
+
+    TransitionParams MakeTransitionParams(float a_phonemes, float a_modifiers, float a_expressions, float a_curve)
+    {
+        TransitionParams params;
+
+        params.duration[static_cast<std::size_t>(TransitionLayer::Expression)] = std::max(a_expressions, 0.0f);
+        params.duration[static_cast<std::size_t>(TransitionLayer::Modifier)] = std::max(a_modifiers, 0.0f);
+        params.duration[static_cast<std::size_t>(TransitionLayer::Phoneme)] = std::max(a_phonemes, 0.0f);
+        params.duration[static_cast<std::size_t>(TransitionLayer::Custom)] = std::max(a_modifiers, 0.0f);
+
+        auto curve = std::round(a_curve);
+        params.ease = EaseTable(curve >= 0.0f && curve < static_cast<float>(EaseCurve::Total) ? static_cast<EaseCurve>(curve) : EaseCurve::Linear);
+
+        return params;
+    }
+
+    void LayerTransition::Merge(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_duration, float a_timeDelta, const EaseTable& a_ease, std::uint32_t a_written)
+    {
+        // most frames of a plan: nothing written, no channel left dialogue, the layers as wide as when it was made
+        auto same = a_written == _written && a_result.size() == _count && a_dialogue.size() >= _count && a_target.size() >= _count;
+
+        if (!same || !_moving || (_dialogue && LeftDialogue(a_dialogue, a_target))) [[unlikely]] {
+            auto count = std::min(std::max(a_dialogue.size(), a_target.size()), a_result.size());
+
+            // engine layers are as wide as each other, anything else goes through the stepper
+            if (count > kMaxChannels || a_dialogue.size() < count || a_target.size() < count) {
+                AnimMerge(a_dialogue, a_target, a_result, a_duration > 0.0f ? a_timeDelta / a_duration : std::numeric_limits<float>::infinity());
+                Clear();
+                return;
+            }
+
+            // planned from layer 3 as it is, before anything is written to it
+            if (!_planned || !same || _moving) {
+                Plan(a_target, a_result, count, a_duration);
+                _written = a_written;
+            }
+
+            if (!_moving) {
+                AnimMerge(a_dialogue, a_target, a_result, a_duration > 0.0f ? a_timeDelta / a_duration : std::numeric_limits<float>::infinity());
+                return;
+            }
+        }
+
+        _elapsed += a_timeDelta;
+
+        auto time = _elapsed * _rate;
+
+        // once there, the targets themselves so they are hit exactly
+        if (time < 1.0f) {
+            _dialogue = transitionStep(a_dialogue.data(), a_target.data(), _plan.data(), _plan.data() + _count, a_ease.Curve() == EaseCurve::Linear ? time : a_ease(time), a_result.data(), _count);
+        } else {
+            AnimMerge(a_dialogue, a_target, a_result, std::numeric_limits<float>::infinity());
+            _moving = false;
+        }
+    }
+
+    bool LayerTransition::LeftDialogue(std::span<const float> a_dialogue, std::span<const float> a_target) const
+    {
+        for (auto channels = _dialogue; channels; channels &= channels - 1) {
+            auto i = static_cast<std::size_t>(std::countr_zero(channels));
+            if (!FollowsDialogue(a_dialogue[i], a_target[i])) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void LayerTransition::Plan(std::span<const float> a_target, std::span<const float> a_result, std::size_t a_count, float a_duration)
+    {
+        auto from = _plan.data();
+        auto delta = from + a_count;
+        auto moving = false;
+
+        for (std::size_t i = 0; i < a_count; ++i) {
+            from[i] = a_result[i];
+            delta[i] = a_target[i] - from[i];
+            moving = moving || delta[i] != 0.0f;
+        }
+
+        _count = static_cast<std::uint32_t>(a_count);
+        _elapsed = 0.0f;
+        _rate = a_duration > 0.0f ? 1.0f / a_duration : 0.0f;
+        _dialogue = 0;
+        _moving = moving && a_duration > 0.0f;
+        _planned = true;
+    }
+
+    namespace Kernels
+    {
+        std::uint32_t TransitionStepScalar(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_count)
+        {
+            return TransitionStepRange(a_dialogue, a_target, a_from, a_delta, a_scale, a_out, 0, a_count);
+        }
+
+#if defined(MFGFIX_X64)
+        MFGFIX_TARGET("sse4.1")
+        std::uint32_t TransitionStepSSE41(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_count)
+        {
+            const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const auto epsilon = _mm_set1_ps(FLT_EPSILON);
+            const auto scale = _mm_set1_ps(a_scale);
+
+            auto vectorCount = a_count & ~std::size_t{ 3 };
+            std::uint32_t mask = 0;
+
+            for (std::size_t i = 0; i < vectorCount; i += 4) {
+                auto dialogue = _mm_loadu_ps(a_dialogue + i);
+                auto target = _mm_loadu_ps(a_target + i);
+
+                auto follow = _mm_and_ps(_mm_cmplt_ps(_mm_and_ps(target, absMask), epsilon), _mm_cmpgt_ps(_mm_and_ps(dialogue, absMask), epsilon));
+                auto planned = _mm_add_ps(_mm_loadu_ps(a_from + i), _mm_mul_ps(_mm_loadu_ps(a_delta + i), scale));
+
+                _mm_storeu_ps(a_out + i, _mm_blendv_ps(planned, dialogue, follow));
+                mask |= static_cast<std::uint32_t>(_mm_movemask_ps(follow)) << i;
+            }
+
+            return mask | TransitionStepRange(a_dialogue, a_target, a_from, a_delta, a_scale, a_out, vectorCount, a_count);
+        }
+
+        MFGFIX_TARGET("avx2")
+        std::uint32_t TransitionStepAVX2(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_count)
+        {
+            const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+            const auto epsilon = _mm256_set1_ps(FLT_EPSILON);
+            const auto scale = _mm256_set1_ps(a_scale);
+
+            auto vectorCount = a_count & ~std::size_t{ 7 };
+            std::uint32_t mask = 0;
+
+            for (std::size_t i = 0; i < vectorCount; i += 8) {
+                auto dialogue = _mm256_loadu_ps(a_dialogue + i);
+                auto target = _mm256_loadu_ps(a_target + i);
+
+                auto follow = _mm256_and_ps(_mm256_cmp_ps(_mm256_and_ps(target, absMask), epsilon, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_and_ps(dialogue, absMask), epsilon, _CMP_GT_OQ));
+                auto planned = _mm256_add_ps(_mm256_loadu_ps(a_from + i), _mm256_mul_ps(_mm256_loadu_ps(a_delta + i), scale));
+
+                _mm256_storeu_ps(a_out + i, _mm256_blendv_ps(planned, dialogue, follow));
+                mask |= static_cast<std::uint32_t>(_mm256_movemask_ps(follow)) << i;
+            }
+
+            _mm256_zeroupper();
+            return mask | TransitionStepRange(a_dialogue, a_target, a_from, a_delta, a_scale, a_out, vectorCount, a_count);
+        }
+#else
+        std::uint32_t TransitionStepSSE41(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_count)
+        {
+            return TransitionStepScalar(a_dialogue, a_target, a_from, a_delta, a_scale, a_out, a_count);
+        }
+
+        std::uint32_t TransitionStepAVX2(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_count)
+        {
+            return TransitionStepScalar(a_dialogue, a_target, a_from, a_delta, a_scale, a_out, a_count);
+        }
+#endif
+
+        void SelectTransitionKernels(SimdLevel a_level)
+        {
+            switch (a_level) {
+            case SimdLevel::AVX2:
+                transitionStep = TransitionStepAVX2;
+                break;
+            case SimdLevel::SSE41:
+                transitionStep = TransitionStepSSE41;
+                break;
+            default:
+                transitionStep = TransitionStepScalar;
+                break;
+            }
+        }
+    }
+}
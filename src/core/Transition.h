@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Cpu.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace MfgFix::Core
+{
+    enum class EaseCurve : std::uint8_t
+    {
+        Linear = 0,
+        SmoothStep,
+        EaseIn,
+        EaseOut,
+        Total
+    };
+
+    const char* ToString(EaseCurve a_curve);
+
+    // a curve from (0, 0) to (1, 1) sampled once, evaluated by linear interpolation between the samples
+    class EaseTable
+    {
+    public:
+        static constexpr std::size_t kSamples = 64;
+
+        EaseTable() :
+            EaseTable(EaseCurve::Linear)
+        {}
+
+        explicit EaseTable(EaseCurve a_curve);
+
+        // a_time in [0, 1)
+        float operator()(float a_time) const
+        {
+            auto x = a_time * static_cast<float>(kSamples);
+            auto i = static_cast<std::size_t>(x);
+            return _values[i] + (_values[i + 1] - _values[i]) * (x - static_cast<float>(i));
+        }
+
+        EaseCurve Curve() const { return _curve; }
+
+    private:
+        std::array<float, kSamples + 1> _values;
+        EaseCurve _curve;
+    };
+
+    // the smoothed layers, each has its own duration
+    enum class TransitionLayer : std::uint8_t
+    {
+        Expression = 0,
+        Modifier,
+        Phoneme,
+        Custom,
+        Total
+    };
+
+    struct TransitionParams
+    {
+        std::array<float, static_cast<std::size_t>(TransitionLayer::Total)> duration{};  // seconds at speed 1.0, by layer
+        EaseTable ease;
+    };
+
+    // custom channels follow the modifiers; a_curve is rounded to an EaseCurve, linear if out of range
+    TransitionParams MakeTransitionParams(float a_phonemes, float a_modifiers, float a_expressions, float a_curve);
+
+    namespace Kernels
+    {
+        // one frame of a planned layer: a_out gets a_from + a_delta * a_scale, or dialogue where a channel follows it;
+        // returns the channels following dialogue, by bit
+        // the scalar ones are the reference implementation, the vector kernels must match them bit for bit
+        std::uint32_t TransitionStepScalar(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_count);
+        std::uint32_t TransitionStepSSE41(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_count);
+        std::uint32_t TransitionStepAVX2(const float* a_dialogue, const float* a_target, const float* a_from, const float* a_delta, float a_scale, float* a_out, std::size_t a_count);
+
+        // called by SelectKernels
+        void SelectTransitionKernels(SimdLevel a_level);
+    }
+
+    // Moves one layer 3 to its layer 2 targets along a planned curve instead of stepping every channel by the same amount.
+    // A plan is made when the targets are written: every channel gets its start value and the distance to go, so all of
+    // them arrive together once the duration has passed. A frame in between only looks the curve up, linear ones not even
+    // that, and scales the distances by it; nothing compares the targets. Channels without a target follow dialogue like
+    // AnimMerge has them; one that drops out of dialogue while the plan runs is planned again from where dialogue left it.
+    // Once there, or for targets nobody said were written, the layer is stepped like AnimMerge does.
+    // While a plan runs it owns the layer, values written to layer 3 in between are not picked up.
+    class LayerTransition
+    {
+    public:
+        static constexpr std::size_t kMaxChannels = 32;
+
+        // drop-in for AnimMerge, a_duration in seconds; a_written counts the writes to the face's targets so far,
+        // the first merge and one after a write plan; layers wider than kMaxChannels are stepped by a_timeDelta / a_duration
+        void Merge(std::span<const float> a_dialogue, std::span<const float> a_target, std::span<float> a_result, float a_duration, float a_timeDelta, const EaseTable& a_ease, std::uint32_t a_written);
+
+        // true while channels are still on their way
+        bool Moving() const { return _moving; }
+
+        // the next Merge plans from what layer 3 holds then
+        void Clear()
+        {
+            _planned = false;
+            _moving = false;
+        }
+
+    private:
+        void Plan(std::span<const float> a_target, std::span<const float> a_result, std::size_t a_count, float a_duration);
+
+        // a channel that followed dialogue in the last frame doesn't any more
+        bool LeftDialogue(std::span<const float> a_dialogue, std::span<const float> a_target) const;
+
+        // what a frame checks first, in the line the start values begin in
+        std::uint32_t _dialogue{ 0 };  // channels that followed dialogue in the last planned frame
+        std::uint32_t _count{ 0 };
+        std::uint32_t _written{ 0 };  // a_written the plan was made for
+        float _elapsed{ 0.0f };
+        float _rate{ 0.0f };  // 1 / duration
+        bool _moving{ false };
+        bool _planned{ false };
+
+        // start values and distances back to back, each _count wide, so a layer is read in as few lines as it can be;
+        // the last frame steps onto the targets themselves
+        std::array<float, 2 * kMaxChannels> _plan{};
+    };
+
+    struct FaceTransition
+    {
+        FaceTransition() = default;
+        FaceTransition(const FaceTransition& a_other) :
+            layers(a_other.layers),
+            written(a_other.Writes())
+        {}
+
+        LayerTransition& operator[](TransitionLayer a_layer) { return layers[static_cast<std::size_t>(a_layer)]; }
+
+        // layer 2 of the face was written outside its update, from any thread; every layer plans again on its next merge
+        void Written() { written.fetch_add(1, std::memory_order_release); }
+        std::uint32_t Writes() const { return written.load(std::memory_order_acquire); }
+
+        bool Moving() const
+        {
+            return std::ranges::any_of(layers, [](const LayerTransition& a_layer) { return a_layer.Moving(); });
+        }
+
+        void Clear()
+        {
+            for (auto& layer : layers) {
+                layer.Clear();
+            }
+        }
+
+        std::array<LayerTransition, static_cast<std::size_t>(TransitionLayer::Total)> layers;
+        std::atomic<std::uint32_t> written{ 0 };
+    };
+}
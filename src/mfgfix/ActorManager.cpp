@@ -0,0 +1,185 @@
+#include "ActorManager.h"
+#include "BSFaceGenAnimationData.h"
+#include "FaceCommands.h"
+#include "FaceSequences.h"
+#include "FaceSnapshots.h"
+
+#include <numbers>
+
+namespace MfgFix
+{
+    class ActorManager::EventSink :
+        public RE::BSTEventSink<RE::TESObjectLoadedEvent>,
+        public RE::BSTEventSink<RE::TESCellAttachDetachEvent>
+    {
+      public:
+        static EventSink* GetSingleton()
+        {
+            static EventSink singleton;
+
+            return &singleton;
+        }
+
+        RE::BSEventNotifyControl ProcessEvent(const RE::TESObjectLoadedEvent* a_event, RE::BSTEventSource<RE::TESObjectLoadedEvent>*) override
+        {
+            if (!a_event) {
+                return RE::BSEventNotifyControl::kContinue;
+            }
+
+            if (a_event->loaded) {
+                // the new face may sit at an address another actor had set a speed for
+                auto actor = RE::TESForm::LookupByID<RE::Actor>(a_event->formID);
+                auto animData = actor ? actor->GetFaceGenAnimationData() : nullptr;
+
+                if (animData) {
+                    _speed.EraseForeign(reinterpret_cast<std::uintptr_t>(animData), a_event->formID);
+                    FaceSnapshots::Erase(reinterpret_cast<std::uintptr_t>(animData));
+                    FaceSequences::EraseForeign(reinterpret_cast<std::uintptr_t>(animData), a_event->formID);
+                    BSFaceGenAnimationData::EraseRecords(reinterpret_cast<std::uintptr_t>(animData));
+                    SetOwner(reinterpret_cast<std::uintptr_t>(animData), a_event->formID);
+                }
+            } else {
+                Forget(a_event->formID);
+            }
+
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        RE::BSEventNotifyControl ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*) override
+        {
+            // every reference of a cell detaches with it, only actors can have a face
+            if (a_event && !a_event->attached && a_event->reference && a_event->reference->As<RE::Actor>()) {
+                Forget(a_event->reference->GetFormID());
+            }
+
+            return RE::BSEventNotifyControl::kContinue;
+        }
+    };
+
+    Core::LodView ActorManager::GetView(BSFaceGenAnimationData* a_data)
+    {
+        // roughly a human head, for faces without a head node bound
+        constexpr float kHeadRadius = 12.0f;
+
+        auto key = reinterpret_cast<std::uintptr_t>(a_data);
+        auto owner = GetOwner(a_data);
+        auto actor = owner ? RE::TESForm::LookupByID<RE::Actor>(owner) : nullptr;
+        auto camera = RE::PlayerCamera::GetSingleton();
+
+        // the face may have moved on to another actor since
+        if (!actor || reinterpret_cast<std::uintptr_t>(actor->GetFaceGenAnimationData()) != key || !camera || !camera->cameraRoot) {
+            return {};
+        }
+
+        auto head = actor->GetFaceNodeSkinned();
+        auto center = head ? head->worldBound.center : actor->GetPosition();
+        auto radius = head && head->worldBound.radius > 0.0f ? head->worldBound.radius : kHeadRadius;
+        auto distance = camera->cameraRoot->world.translate.GetDistance(center);
+
+        return { distance, Core::ScreenSize(radius, distance, camera->worldFOV * std::numbers::pi_v<float> / 180.0f) };
+    }
+
+    bool ActorManager::IsDialoguePartner(BSFaceGenAnimationData* a_data)
+    {
+        auto topics = RE::MenuTopicManager::GetSingleton();
+        if (!topics) {
+            return false;
+        }
+
+        auto speaker = topics->speaker.get();
+        auto actor = speaker ? speaker->As<RE::Actor>() : nullptr;
+
+        return actor && reinterpret_cast<std::uintptr_t>(actor->GetFaceGenAnimationData()) == reinterpret_cast<std::uintptr_t>(a_data);
+    }
+
+    std::vector<RE::Actor*> ActorManager::GetActorsInRange(RE::TESObjectREFR* a_center, float a_radius, RE::TESFaction* a_faction)
+    {
+        std::vector<RE::Actor*> actors;
+
+        auto center = a_center->GetPosition();
+        auto worldspace = a_center->GetWorldspace();
+        auto radiusSquared = a_radius * a_radius;
+
+        auto consider = [&](RE::Actor* a_actor) {
+            if (a_actor && a_actor->Is3DLoaded() && a_actor->GetWorldspace() == worldspace && (!a_faction || a_actor->IsInFaction(a_faction)) &&
+                center.GetSquaredDistance(a_actor->GetPosition()) <= radiusSquared) {
+                actors.push_back(a_actor);
+            }
+        };
+
+        consider(RE::PlayerCharacter::GetSingleton());
+
+        if (auto processLists = RE::ProcessLists::GetSingleton()) {
+            for (auto& handle : processLists->highActorHandles) {
+                consider(handle.get().get());
+            }
+        }
+
+        return actors;
+    }
+
+    RE::FormID ActorManager::GetOwner(const BSFaceGenAnimationData* a_data)
+    {
+        std::lock_guard locker(_ownersLock);
+
+        auto it = _owners.find(reinterpret_cast<std::uintptr_t>(a_data));
+
+        return it != _owners.end() ? it->second : 0;
+    }
+
+    void ActorManager::SetOwner(std::uintptr_t a_data, RE::FormID a_owner)
+    {
+        std::lock_guard locker(_ownersLock);
+
+        _owners[a_data] = a_owner;
+    }
+
+    bool ActorManager::EraseOwner(RE::FormID a_owner)
+    {
+        std::lock_guard locker(_ownersLock);
+
+        // the snapshots and update records go with the faces, a face that was never seen by its owner is dropped by the caps
+        auto erased = std::erase_if(_owners, [&](auto& a_entry) {
+            if (a_entry.second != a_owner) {
+                return false;
+            }
+
+            FaceSnapshots::Erase(a_entry.first);
+            BSFaceGenAnimationData::EraseRecords(a_entry.first);
+
+            // the next face to update opens the frames instead
+            auto first = a_entry.first;
+            _frameFace.compare_exchange_strong(first, 0, std::memory_order_relaxed);
+            return true;
+        });
+
+        return erased != 0;
+    }
+
+    void ActorManager::Forget(RE::FormID a_owner)
+    {
+        // speeds, commands and sequences own their faces, an actor without one has nothing to drop
+        if (!EraseOwner(a_owner)) {
+            return;
+        }
+
+        _speed.EraseOwner(a_owner);
+        FaceCommands::EraseOwner(a_owner);
+        FaceSequences::EraseOwner(a_owner);
+    }
+
+    void ActorManager::RegisterEvents()
+    {
+        auto holder = RE::ScriptEventSourceHolder::GetSingleton();
+
+        if (!holder) {
+            logger::error("failed to register actor unload events");
+            return;
+        }
+
+        holder->AddEventSink<RE::TESObjectLoadedEvent>(EventSink::GetSingleton());
+        holder->AddEventSink<RE::TESCellAttachDetachEvent>(EventSink::GetSingleton());
+
+        logger::info("registered actor unload events");
+    }
+}
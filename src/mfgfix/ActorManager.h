@@ -1,5 +1,8 @@
 #pragma once
 #include "Settings.h"
+#include "core/Clock.h"
+#include "core/Lod.h"
+#include "core/SpeedTable.h"
 
 namespace MfgFix
 {
@@ -14,35 +17,80 @@ namespace MfgFix
                 return;
 
             if (auto animData = a_actor->GetFaceGenAnimationData()) {
-                auto id = reinterpret_cast<uintptr_t>(animData);
-                auto formId = a_actor->GetFormID();
-
-                if (a_speed == 0.0) {
-                    _mapping.erase(id);
-                    _speed.erase(formId);
-                } else {
-                    _mapping[id] = formId;
-                    _speed[formId] = a_speed;
-                }
+                SetSpeed(reinterpret_cast<BSFaceGenAnimationData*>(animData), a_actor->GetFormID(), a_speed);
             }
         }
 
+        // a_owner is the actor a_data belongs to
+        static inline void SetSpeed(BSFaceGenAnimationData* a_data, RE::FormID a_owner, float a_speed)
+        {
+            _speed.Set(reinterpret_cast<std::uintptr_t>(a_data), a_owner, a_speed);
+            SetOwner(reinterpret_cast<std::uintptr_t>(a_data), a_owner);
+        }
+
         static inline float GetSpeed(BSFaceGenAnimationData* a_data)
         {
-            auto id = reinterpret_cast<uintptr_t>(a_data);
-            if (_mapping.count(id)) {
-                auto formId = _mapping[id];
-                if (_speed.count(formId)) {
-                    return _speed[formId];
-                }
+            return GetSpeed(a_data, Settings::Current()->values.transition.fDefaultSpeed);
+        }
+
+        static inline float GetSpeed(BSFaceGenAnimationData* a_data, float a_default)
+        {
+            return _speed.Get(reinterpret_cast<std::uintptr_t>(a_data), a_default);
+        }
+
+        // first thing in every face update: the face that opened the last frame asking again opens the next one,
+        // which reads the clock and advances the speed table's epoch, a frame at 60 fps per epoch
+        static inline void FrameUpdate(BSFaceGenAnimationData* a_data)
+        {
+            auto key = reinterpret_cast<std::uintptr_t>(a_data);
+            auto first = _frameFace.load(std::memory_order_relaxed);
+
+            if (first == key || (!first && _frameFace.compare_exchange_strong(first, key, std::memory_order_relaxed))) {
+                _speed.Tick(static_cast<std::uint32_t>(_epochs.Seconds() * 60.0));
             }
+        }
 
-            return Settings::Get().transition.fDefaultSpeed;
+        static inline Core::SpeedTable::Stats GetStats()
+        {
+            return _speed.GetStats();
         }
 
+        // camera distance and projected head size of the actor a_data belongs to
+        // full detail ({}) for faces whose actor wasn't seen loading or setting a speed
+        static Core::LodView GetView(BSFaceGenAnimationData* a_data);
+
+        // the actor a_data was last seen on, 0 if none
+        static RE::FormID GetOwner(const BSFaceGenAnimationData* a_data);
+
+        // the player is talking to the actor of a_data
+        static bool IsDialoguePartner(BSFaceGenAnimationData* a_data);
+
+        // loaded actors, the player included, within a_radius of a_center and in a_faction unless it's null
+        // walks the high process list, call from a task
+        static std::vector<RE::Actor*> GetActorsInRange(RE::TESObjectREFR* a_center, float a_radius, RE::TESFaction* a_faction);
+
+        // drops speeds, pending face commands, sequences, snapshots and update records of actors that unload or detach, needs the game event sources (kDataLoaded)
+        static void RegisterEvents();
+
+        // a_owner has a face, everything kept for a face has to set it or isn't dropped when the actor unloads
+        static void SetOwner(std::uintptr_t a_data, RE::FormID a_owner);
+
       private:
-        static inline std::unordered_map<RE::FormID, float> _speed;
-        static inline std::unordered_map<std::uintptr_t, RE::FormID> _mapping;
-        static inline float _defaultSpeed{ 0.f };
+        class EventSink;
+
+        // false if a_owner had no face, then nothing else can be kept for it either
+        static bool EraseOwner(RE::FormID a_owner);
+
+        // everything kept for an actor that unloaded or detached
+        static void Forget(RE::FormID a_owner);
+
+        // face to actor for GetView and the face generators, read a few times per second per face
+        static inline std::mutex _ownersLock;
+        static inline std::unordered_map<std::uintptr_t, RE::FormID> _owners;
+
+        // keyed by animData, read every frame from the update threads, written from UI tasks and game events
+        static inline Core::SpeedTable _speed;
+        static inline Core::TickRate _epochs;
+        static inline std::atomic<std::uintptr_t> _frameFace{ 0 };  // face opening the frames, 0 until one updates
     };
 }
\ No newline at end of file
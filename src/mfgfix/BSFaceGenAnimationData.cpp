@@ -1,29 +1,423 @@
-#include <float.h>
-
 #include "ActorManager.h"
 #include "BSFaceGenAnimationData.h"
+#include "FaceCommands.h"
+#include "FaceSequences.h"
+#include "FaceSnapshots.h"
+#include "HookStats.h"
+#include "HookTimeline.h"
 #include "Offsets.h"
 #include "Settings.h"
+#include "core/Blend.h"
+#include "core/Budget.h"
+#include "core/Scratch.h"
+#include "core/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <optional>
 
 namespace MfgFix
 {
     namespace
     {
-        constexpr float pi_180 = 0.0174532925f;
+        // what the optional update steps keep per face
+        struct FaceRecord
+        {
+            Core::IdleFace idle;        // bSkipIdleFaces
+            Core::LodState lod;         // bEnableLod
+            Core::BudgetState budget;  // fFrameBudget
+            Core::FaceTransition transition;  // bPlannedTransitions
+            Core::LockDeferral deferral;      // bDeferOnContention
+
+            // eyes offsets, seeded on the first update and again when bDeterministicRandom changes
+            Core::Rng rng{ Core::Rng::kDefaultSeed };
+            std::optional<bool> deterministic;  // how rng was seeded, empty until then
+        };
+
+        Core::FaceTable<FaceRecord> faceRecords;
 
-        float rand(float a_min, float a_max)
+        // fFrameBudget, counts ticks
+        Core::FrameBudget frameBudget;
+        Core::TickRate frameBudgetRate;
+
+        // one generator per face instead of std::rand, which locks inside the crt; deterministic faces get their own stream
+        // from the actor, so a face draws the same offsets whichever thread updates it and wherever it was allocated
+        // faces without a record (tracing) share one per update thread, the trace has the state of every update
+        Core::Rng& GetRng(FaceRecord* a_record, const BSFaceGenAnimationData* a_data, bool a_deterministic)
         {
-            return a_min + (a_max - a_min) * (static_cast<float>(std::rand()) / RAND_MAX);
+            if (!a_record) {
+                thread_local Core::Rng rng;
+                thread_local bool deterministic{ false };
+
+                if (deterministic != a_deterministic) {
+                    deterministic = a_deterministic;
+                    rng = a_deterministic ? Core::Rng(Core::Rng::kDefaultSeed) : Core::Rng();
+                }
+
+                return rng;
+            }
+
+            if (a_record->deterministic != a_deterministic) {
+                a_record->deterministic = a_deterministic;
+                a_record->rng = a_deterministic ? Core::Rng(Core::Rng::kDefaultSeed, ActorManager::GetOwner(a_data)) : Core::Rng();
+            }
+
+            return a_record->rng;
         }
 
-        float rand(float a_min, float a_max, float a_exp)
+        BSFaceGenAnimationData::UpdateContext MakeUpdateContext(const SettingsSnapshot& a_settings, const BSFaceGenAnimationData* a_data, FaceRecord* a_record, float a_timeDelta, float a_speed)
         {
-            return a_min + (a_max - a_min) * pow(static_cast<float>(std::rand()) / RAND_MAX, a_exp);
+            BSFaceGenAnimationData::UpdateContext context;
+
+            context.settings = &a_settings;
+            context.timeDelta = a_timeDelta;
+            context.speed = a_speed;
+            context.animationStep = a_speed > 0.0f ? a_timeDelta / a_speed : 0.0f;
+            context.phonemeThreshold = a_settings.phonemeThreshold;
+            context.deterministicRandom = a_settings.values.debug.bDeterministicRandom;
+            context.rng = &GetRng(a_record, a_data, context.deterministicRandom);
+            context.blink = a_settings.blink;
+            context.track = a_settings.track;
+            context.track.deltaMax *= a_timeDelta;
+            context.eyesOffset = a_settings.eyesOffset;
+            context.stats = HookStats::Active(a_settings.values);
+            context.timeline = HookTimeline::Active(a_settings.values);
+            context.face = reinterpret_cast<std::uintptr_t>(a_data);
+
+            return context;
         }
 
-        float deg2rad(float a_degrees)
+        Core::TraceWriter traceWriter;
+        std::atomic<bool> tracing{ false };
+
+        // BSFaceGenAnimationData as the core update steps see it, also records the update while tracing
+        class EngineFace
+        {
+        public:
+            using Keyframe = BSFaceGenAnimationData::Keyframe;
+            using Layer = Core::Layer;
+
+            static constexpr std::array<Keyframe BSFaceGenAnimationData::*, Core::TraceRecord::kLayers> kLayers{
+                &BSFaceGenAnimationData::expression1, &BSFaceGenAnimationData::expression2, &BSFaceGenAnimationData::expression3,
+                &BSFaceGenAnimationData::modifier1, &BSFaceGenAnimationData::modifier2, &BSFaceGenAnimationData::modifier3,
+                &BSFaceGenAnimationData::phoneme1, &BSFaceGenAnimationData::phoneme2, &BSFaceGenAnimationData::phoneme3,
+                &BSFaceGenAnimationData::custom1, &BSFaceGenAnimationData::custom2, &BSFaceGenAnimationData::custom3
+            };
+
+            EngineFace(BSFaceGenAnimationData& a_data, const BSFaceGenAnimationData::UpdateContext& a_context) :
+                _data(a_data),
+                _context(a_context)
+            {
+                if (tracing.load(std::memory_order_relaxed)) {
+                    TraceBegin();
+                }
+            }
+
+            Keyframe& Get(Layer a_layer) { return _data.*kLayers[static_cast<std::size_t>(a_layer)]; }
+
+            std::span<float> Values(Layer a_layer) { return BSFaceGenAnimationData::Values(Get(a_layer)); }
+            bool IsZero(Layer a_layer) { return Get(a_layer).IsZero(); }
+            void Reset(Layer a_layer) { Get(a_layer).Reset(); }
+            void Copy(Layer a_src, Layer a_dst) { Get(a_dst).Copy(&Get(a_src)); }
+
+            bool TransitionUpdate(float a_timeDelta)
+            {
+                auto values = Values(Layer::Expression1);
+
+                // only the idle fast path asks, and only for layers it can hold
+                if (!_context.idle || values.size() > Core::IdleFace::kMaxChannels) {
+                    _data.expression1.TransitionUpdate(a_timeDelta, _data.transitionTarget);
+                    TraceLayer(Layer::Expression1);
+                    return true;
+                }
+
+                std::array<float, Core::IdleFace::kMaxChannels> before;
+                std::copy(values.begin(), values.end(), before.begin());
+
+                _data.expression1.TransitionUpdate(a_timeDelta, _data.transitionTarget);
+                TraceLayer(Layer::Expression1);
+
+                return std::memcmp(before.data(), values.data(), values.size_bytes()) != 0;
+            }
+
+            void DialogueModifiersUpdate(float a_timeDelta)
+            {
+                {
+                    Core::ScopedTimer timer(_context.stats, Core::Probe::DialogueModifiers);
+                    Core::TimelineScope scope(_context.timeline, Core::Span::Dialogue, _context.face);
+                    _data.DialogueModifiersUpdate(a_timeDelta);
+                }
+
+                TraceLayer(Layer::Modifier1);
+            }
+
+            void DialoguePhonemesUpdate(float a_timeDelta)
+            {
+                {
+                    Core::ScopedTimer timer(_context.stats, Core::Probe::DialoguePhonemes);
+                    Core::TimelineScope scope(_context.timeline, Core::Span::Dialogue, _context.face);
+                    _data.DialoguePhonemesUpdate(a_timeDelta);
+                }
+
+                TraceLayer(Layer::Phoneme1);
+            }
+
+            Core::EyesTimers EyesTimersUpdate(const Core::FaceUpdateContext&)
+            {
+                auto eyes = GetEyesState();
+                auto result = Core::EyesTimersUpdate(eyes, _context, Hold());
+                SetEyesState(eyes);
+
+                return result;
+            }
+
+            Core::EyesState GetEyesState() const { return _data.GetEyesState(); }
+            void SetEyesState(const Core::EyesState& a_eyes) { _data.SetEyesState(a_eyes); }
+
+            float& BlinkValue() { return _data.modifier2.timer; }
+            bool Hold() const { return _data.unk21A != 0; }
+            bool Dialogue() const { return _data.dialogueData != nullptr; }
+
+            void TraceEnd()
+            {
+                if (!_record) {
+                    return;
+                }
+
+                for (std::size_t i = 0; i < kLayers.size(); ++i) {
+                    auto values = BSFaceGenAnimationData::Values(_data.*kLayers[i]);
+                    std::copy(values.begin(), values.end(), _record->out[i].begin());
+                }
+
+                _record->eyesOut = GetEyesState();
+                _record->blinkValueOut = BlinkValue();
+
+                auto params = Core::MakeTraceParams(_context.blink, _context.settings->track, _context.phonemeThreshold, _context.settings->eyesOffset);
+                traceWriter.Write(params, reinterpret_cast<std::uintptr_t>(&_data), *_record);
+            }
+
+        private:
+            void TraceBegin()
+            {
+                thread_local Core::TraceRecord record;
+
+                for (std::size_t i = 0; i < kLayers.size(); ++i) {
+                    if ((_data.*kLayers[i]).count > Core::TraceRecord::kMaxChannels) {
+                        return;
+                    }
+                }
+
+                record = {};
+                record.timeDelta = _context.timeDelta;
+                record.speed = _context.speed;
+                record.flags = (Hold() ? Core::TraceRecord::kHold : 0) |
+                               (Dialogue() ? Core::TraceRecord::kDialogue : 0);
+                record.rng = _context.rng->GetState();
+                record.eyesIn = GetEyesState();
+                record.blinkValueIn = BlinkValue();
+
+                for (std::size_t i = 0; i < kLayers.size(); ++i) {
+                    auto values = BSFaceGenAnimationData::Values(_data.*kLayers[i]);
+                    record.counts[i] = static_cast<std::uint32_t>(values.size());
+                    std::copy(values.begin(), values.end(), record.in[i].begin());
+                }
+
+                _record = &record;
+            }
+
+            // layer 1 is recorded after the engine step, the replayer can't run it
+            void TraceLayer(Layer a_layer)
+            {
+                if (!_record) {
+                    return;
+                }
+
+                auto& keyframe = Get(a_layer);
+                std::copy_n(keyframe.values, keyframe.count, _record->in[static_cast<std::size_t>(a_layer)].begin());
+
+                if (a_layer == Layer::Modifier1) {
+                    _record->modifierTimer = keyframe.timer;
+                } else if (a_layer == Layer::Phoneme1) {
+                    _record->phonemeTimer = keyframe.timer;
+                }
+            }
+
+            BSFaceGenAnimationData& _data;
+            const BSFaceGenAnimationData::UpdateContext& _context;
+            Core::TraceRecord* _record{ nullptr };
+        };
+
+        // BSFaceGenAnimationData copied out for bUnlockedUpdate, Load and Store run with the lock held, the update in between without it
+        // the engine steps on layer 1 read dialogueData and transitionTarget, so they run in Load and the copy only has the core steps;
+        // running them first leaves the update as it was, a face in dialogue takes the full update and reads layer 1 after them
+        class UnlockedFace : public Core::ScratchFace
         {
-            return a_degrees * pi_180;
+        public:
+            UnlockedFace(BSFaceGenAnimationData& a_data, const BSFaceGenAnimationData::UpdateContext& a_context) :
+                _data(a_data),
+                _context(a_context)
+            {}
+
+            // faces with layers wider than the copy keep the locked update
+            static bool Fits(const BSFaceGenAnimationData& a_data)
+            {
+                return std::ranges::all_of(EngineFace::kLayers, [&](auto a_layer) { return (a_data.*a_layer).count <= kMaxChannels; });
+            }
+
+            void Load()
+            {
+                EngineFace engine(_data, _context);
+                _moved = engine.TransitionUpdate(_context.timeDelta);
+                engine.DialogueModifiersUpdate(_context.timeDelta);
+                engine.DialoguePhonemesUpdate(_context.timeDelta);
+
+                for (std::size_t i = 0; i < kLayers; ++i) {
+                    auto& keyframe = _data.*EngineFace::kLayers[i];
+                    auto& layer = Input().layers[i];
+
+                    layer.count = keyframe.count;
+                    layer.timer = keyframe.timer;
+                    std::copy_n(keyframe.values, keyframe.count, layer.values.begin());
+                }
+
+                Input().eyes = _data.GetEyesState();
+                _hold = engine.Hold();
+                _dialogue = engine.Dialogue();
+            }
+
+            // with the lock released
+            void Begin() { Core::ScratchFace::Begin(_hold, _dialogue, _moved); }
+
+            // returns the number of layers left to a writer that changed them since Load
+            std::uint32_t Store()
+            {
+                Core::ScratchFace::View current;
+                for (std::size_t i = 0; i < kLayers; ++i) {
+                    auto& keyframe = _data.*EngineFace::kLayers[i];
+                    current[i] = { BSFaceGenAnimationData::Values(keyframe), keyframe.timer };
+                }
+
+                auto plan = Plan(current, _data.GetEyesState());
+
+                for (auto written = plan.values | plan.timers; written & ~kEyes; written &= written - 1) {
+                    auto i = static_cast<std::size_t>(std::countr_zero(written));
+                    auto bit = 1u << i;
+                    auto& keyframe = _data.*EngineFace::kLayers[i];
+                    auto& result = Output().layers[i];
+
+                    if (Resets() & bit) {
+                        keyframe.Reset();
+                    }
+                    if (plan.values & bit) {
+                        std::copy_n(result.values.begin(), keyframe.count, keyframe.values);
+                    }
+                    if (plan.timers & bit) {
+                        keyframe.timer = result.timer;
+                    }
+                }
+
+                if (plan.values & kEyes) {
+                    _data.SetEyesState(Output().eyes);
+                }
+
+                return static_cast<std::uint32_t>(std::popcount(plan.conflicts));
+            }
+
+        private:
+            BSFaceGenAnimationData& _data;
+            const BSFaceGenAnimationData::UpdateContext& _context;
+            bool _moved{ false };
+            bool _hold{ false };
+            bool _dialogue{ false };
+        };
+
+        // takes the face lock, counting when another thread holds it; with a_deferral, puts the frame off instead while it may
+        bool LockFace(std::unique_lock<RE::BSSpinLock>& a_locker, const BSFaceGenAnimationData::UpdateContext& a_context, Core::LockDeferral* a_deferral)
+        {
+            Core::ScopedTimer wait(a_context.stats, Core::Probe::LockWait);
+
+            if (a_locker.try_lock()) {
+                if (a_deferral) {
+                    a_deferral->Ran();
+                }
+                return true;
+            }
+
+            if (a_context.stats) {
+                a_context.stats->Count(Core::Counter::LockContended);
+            }
+
+            if (a_deferral) {
+                if (a_deferral->Defer(a_context.timeDelta)) {
+                    if (a_context.stats) {
+                        a_context.stats->Count(Core::Counter::UpdateDeferred);
+                    }
+                    return false;
+                }
+
+                if (a_context.stats) {
+                    a_context.stats->Count(Core::Counter::UpdateForced);
+                }
+                a_deferral->Ran();
+            }
+
+            a_locker.lock();
+
+            return true;
+        }
+
+        // a_update on the face itself with the lock held throughout, or with bUnlockedUpdate on a copy with the lock released,
+        // then its snapshot published under the lock; false if the frame was put off
+        template <class Update>
+        bool UpdateFace(BSFaceGenAnimationData& a_data, BSFaceGenAnimationData::UpdateContext& a_context, Update a_update)
+        {
+            std::unique_lock locker(a_data.lock, std::defer_lock);
+
+            if (!LockFace(locker, a_context, a_context.deferral)) {
+                return false;
+            }
+
+            if (!a_context.unlocked || !UnlockedFace::Fits(a_data)) {
+                Core::ScopedTimer held(a_context.stats, Core::Probe::LockHeld);
+
+                EngineFace face(a_data, a_context);
+                a_update(face, a_context);
+                face.TraceEnd();
+
+                Core::ScopedTimer publish(a_context.stats, Core::Probe::PublishSnapshot);
+                FaceSnapshots::Publish(&a_data);
+
+                return true;
+            }
+
+            UnlockedFace face(a_data, a_context);
+
+            {
+                Core::ScopedTimer held(a_context.stats, Core::Probe::LockHeld);
+                face.Load();
+            }
+
+            locker.unlock();
+
+            face.Begin();
+            a_update(face, a_context);
+            face.End();
+
+            LockFace(locker, a_context, nullptr);
+
+            Core::ScopedTimer held(a_context.stats, Core::Probe::LockHeld);
+
+            auto conflicts = face.Store();
+            if (conflicts && a_context.stats) {
+                a_context.stats->Count(Core::Counter::UpdateConflicts, conflicts);
+            }
+
+            Core::ScopedTimer publish(a_context.stats, Core::Probe::PublishSnapshot);
+            FaceSnapshots::Publish(&a_data);
+
+            return true;
         }
     }
 
@@ -53,15 +447,7 @@ namespace MfgFix
 
     std::uint32_t BSFaceGenAnimationData::GetActiveExpression() const
     {
-        std::uint32_t expression = Expression::MoodNeutral;
-
-        for (std::uint32_t i = 0; i < expression3.count; ++i) {
-            if (expression3.values[i] > expression3.values[expression]) {
-                expression = i;
-            }
-        }
-
-        return expression;
+        return Core::ActiveExpression(Values(expression3));
     }
 
     void BSFaceGenAnimationData::DialogueModifiersUpdate(float a_timeDelta)
@@ -110,16 +496,16 @@ namespace MfgFix
         }
     }
 
-    void BSFaceGenAnimationData::CheckAndReleaseDialogueData()
+    bool BSFaceGenAnimationData::CheckAndReleaseDialogueData()
     {
         if (!dialogueData || (((dialogueData->refCount & 0x70000000) + 0xD0000000) & 0xEFFFFFFF) != 0) {
-            return;
+            return false;
         }
 
         auto timer = (dialogueData->unk28->unk0 + (dialogueData->unk28->unk4 < 0 ? -dialogueData->unk28->unk4 : 0)) * 0.033f + 0.2f;
 
         if (phoneme1.timer <= timer) {
-            return;
+            return false;
         }
 
         if (REL::Module::IsAE()) {
@@ -139,439 +525,159 @@ namespace MfgFix
         modifier1.Reset();
         phoneme1.Reset();
         dialogueData = nullptr;
-    }
-
-    void BSFaceGenAnimationData::EyesBlinkingUpdate(float a_timeDelta, bool a_blink)
-    {
-        auto& settings = Settings::Get();
 
-        eyesBlinkingTimer = max(eyesBlinkingTimer - a_timeDelta, 0.0f);
-        auto blinkValue = 0.0f;
-
-        switch (eyesBlinkingStage) {
-        case EyesBlinkingStage::BlinkDelay:
-            {
-                blinkValue = 0.0f;
-
-                if (eyesBlinkingTimer == 0.0f) {
-                    eyesBlinkingStage = EyesBlinkingStage::BlinkDown;
-                    eyesBlinkingTimer = settings.eyesBlinking.fBlinkDownTime;
-                }
+        LayersWritten();
 
-                break;
-            }
-        case EyesBlinkingStage::BlinkDown:
-            {
-                blinkValue = settings.eyesBlinking.fBlinkDownTime != 0.0f ? 1.0f - eyesBlinkingTimer / settings.eyesBlinking.fBlinkDownTime : 1.0f;
-
-                if (eyesBlinkingTimer == 0.0f) {
-                    eyesBlinkingStage = EyesBlinkingStage::BlinkUp;
-                    eyesBlinkingTimer = settings.eyesBlinking.fBlinkUpTime;
-                }
-
-                break;
-            }
-        case EyesBlinkingStage::BlinkUp:
-            {
-                blinkValue = settings.eyesBlinking.fBlinkUpTime != 0.0f ? eyesBlinkingTimer / settings.eyesBlinking.fBlinkUpTime : 0.0f;
-
-                if (eyesBlinkingTimer == 0.0f) {
-                    eyesBlinkingStage = EyesBlinkingStage::BlinkDelay;
-                    eyesBlinkingTimer = rand(settings.eyesBlinking.fBlinkDelayMin, settings.eyesBlinking.fBlinkDelayMax, 2.0f);
-                }
-
-                break;
-            }
-        case EyesBlinkingStage::BlinkDownAndWait1:
-            {
-                if (unk21A) {
-                    blinkValue = settings.eyesBlinking.fBlinkDownTime != 0.0f ? 1.0f - eyesBlinkingTimer / settings.eyesBlinking.fBlinkDownTime : 1.0f;
-                } else {
-                    blinkValue = 1.0f;
-                    eyesBlinkingStage = EyesBlinkingStage::BlinkUp;
-                    eyesBlinkingTimer = settings.eyesBlinking.fBlinkUpTime;
-                }
-
-                break;
-            }
-        case EyesBlinkingStage::BlinkDownAndWait2:
-            {
-                eyesBlinkingStage = EyesBlinkingStage::BlinkDownAndWait1;
-
-                break;
-            }
-        default:
-            {
-                blinkValue = 0.0f;
-                eyesBlinkingStage = EyesBlinkingStage::BlinkDelay;
-                eyesBlinkingTimer = rand(settings.eyesBlinking.fBlinkDelayMin, settings.eyesBlinking.fBlinkDelayMax, 2.0f);
-
-                break;
-            }
-        }
-        blinkValue = std::clamp(blinkValue, 0.0f, 1.0f);
-
-        if (a_blink) {
-            modifier3.values[Modifier::BlinkLeft] = blinkValue;
-            modifier3.values[Modifier::BlinkRight] = blinkValue;
-        } else {
-            modifier2.timer = blinkValue;
-        }
+        return true;
     }
 
-    void BSFaceGenAnimationData::EyesMovementUpdate(float a_timeDelta)
+    bool BSFaceGenAnimationData::RegularUpdate(UpdateContext& a_context)
     {
-        auto& settings = Settings::Get();
-
-        eyesOffsetTimer = max(eyesOffsetTimer - a_timeDelta, 0.0f);
-
-        if (eyesOffsetTimer > 0.0f) {
-            return;
-        }
-
-        switch (GetActiveExpression()) {
-        case Expression::DialogueAnger:
-        case Expression::MoodAnger:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionAngry, settings.eyesMovement.fEyeOffsetDelayMaxEmotionAngry, 2.0f);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionAngry, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionAngry);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionAngry, settings.eyesMovement.fEyePitchMaxOffsetEmotionAngry);
-
-                break;
-            }
-        case Expression::DialogueHappy:
-        case Expression::MoodHappy:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionHappy, settings.eyesMovement.fEyeOffsetDelayMaxEmotionHappy, 0.5f);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionHappy, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionHappy);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionHappy, settings.eyesMovement.fEyePitchMaxOffsetEmotionHappy);
-
-                break;
-            }
-        case Expression::DialogueSurprise:
-        case Expression::MoodSurprise:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionSurprise, settings.eyesMovement.fEyeOffsetDelayMaxEmotionSurprise, 0.5f);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionSurprise, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionSurprise);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionSurprise, settings.eyesMovement.fEyePitchMaxOffsetEmotionSurprise);
+        Core::ScopedTimer timer(a_context.stats, Core::Probe::RegularUpdate);
+        Core::TimelineScope scope(a_context.timeline, Core::Span::RegularUpdate, a_context.face);
 
-                break;
-            }
-        case Expression::DialogueSad:
-        case Expression::MoodSad:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionSad, settings.eyesMovement.fEyeOffsetDelayMaxEmotionSad);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionSad, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionSad);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionSad, settings.eyesMovement.fEyePitchMaxOffsetEmotionSad);
-
-                break;
-            }
-        case Expression::DialogueFear:
-        case Expression::MoodFear:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionFear, settings.eyesMovement.fEyeOffsetDelayMaxEmotionFear);
-                eyesHeadingOffset = rand(0.0f, 1.0f) <= 0.5f ? 0.0f : rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionFear, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionFear);
-                eyesPitchOffset = rand(0.0f, 1.0f) <= 0.5f ? 0.0f : rand(settings.eyesMovement.fEyePitchMinOffsetEmotionFear, settings.eyesMovement.fEyePitchMaxOffsetEmotionFear);
-
-                break;
-            }
-        case Expression::DialoguePuzzled:
-        case Expression::MoodPuzzled:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionPuzzled, settings.eyesMovement.fEyeOffsetDelayMaxEmotionPuzzled);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionPuzzled, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionPuzzled);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionPuzzled, settings.eyesMovement.fEyePitchMaxOffsetEmotionPuzzled);
-
-                break;
-            }
-        case Expression::DialogueDisgusted:
-        case Expression::MoodDisgusted:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionDisgusted, settings.eyesMovement.fEyeOffsetDelayMaxEmotionDisgusted);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionDisgusted, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionDisgusted);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionDisgusted, settings.eyesMovement.fEyePitchMaxOffsetEmotionDisgusted);
-
-                break;
-            }
-        case Expression::CombatAnger:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionCombatAnger, settings.eyesMovement.fEyeOffsetDelayMaxEmotionCombatAnger);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionCombatAnger, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionCombatAnger);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionCombatAnger, settings.eyesMovement.fEyePitchMaxOffsetEmotionCombatAnger);
-
-                break;
-            }
-        case Expression::CombatShout:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionCombatShout, settings.eyesMovement.fEyeOffsetDelayMaxEmotionCombatShout);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionCombatShout, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionCombatShout);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionCombatShout, settings.eyesMovement.fEyePitchMaxOffsetEmotionCombatShout);
-
-                break;
-            }
-        default:
-            {
-                eyesOffsetTimer = rand(settings.eyesMovement.fEyeOffsetDelayMinEmotionNeutral, settings.eyesMovement.fEyeOffsetDelayMaxEmotionNeutral, 2.0f);
-                eyesHeadingOffset = rand(settings.eyesMovement.fEyeHeadingMinOffsetEmotionNeutral, settings.eyesMovement.fEyeHeadingMaxOffsetEmotionNeutral);
-                eyesPitchOffset = rand(settings.eyesMovement.fEyePitchMinOffsetEmotionNeutral, settings.eyesMovement.fEyePitchMaxOffsetEmotionNeutral);
-
-                break;
-            }
-        }
+        return UpdateFace(*this, a_context, [](auto& a_face, auto& a_faceContext) { Core::RegularUpdate(a_face, a_faceContext); });
     }
 
-    void BSFaceGenAnimationData::EyesDirectionUpdate(float a_timeDelta)
+    bool BSFaceGenAnimationData::SmoothUpdate(UpdateContext& a_context)
     {
-        auto& settings = Settings::Get();
-
-        auto eyesHeadingMax = deg2rad(settings.eyesMovement.fTrackEyeXY);
-        auto eyesPitchMax = deg2rad(settings.eyesMovement.fTrackEyeZ);
-        auto eyesHeadingDeltaMax = settings.eyesMovement.fTrackSpeed * a_timeDelta;
-        auto eyesPitchDeltaMax = settings.eyesMovement.fTrackSpeed * a_timeDelta;
-
-        eyesHeading = std::clamp(eyesHeadingBase + eyesHeadingOffset, eyesHeading - eyesHeadingDeltaMax, eyesHeading + eyesHeadingDeltaMax);
-        eyesPitch = std::clamp(eyesPitchBase + eyesPitchOffset, eyesPitch - eyesPitchDeltaMax, eyesPitch + eyesPitchDeltaMax);
-        eyesHeading = std::clamp(eyesHeading, -eyesHeadingMax, eyesHeadingMax);
-        eyesPitch = std::clamp(eyesPitch, -eyesPitchMax, eyesPitchMax);
-
-        modifier3.values[Modifier::LookLeft] = eyesHeading < 0.0f ? (eyesHeadingMax != 0.0f ? -eyesHeading / eyesHeadingMax : 0.0f) : 0.0f;
-        modifier3.values[Modifier::LookRight] = eyesHeading > 0.0f ? (eyesHeadingMax != 0.0f ? eyesHeading / eyesHeadingMax : 0.0f) : 0.0f;
-        modifier3.values[Modifier::LookDown] = eyesPitch < 0.0f ? (eyesPitchMax != 0.0f ? -eyesPitch / eyesPitchMax : 0.0f) : 0.0f;
-        modifier3.values[Modifier::LookUp] = eyesPitch > 0.0f ? (eyesPitchMax != 0.0f ? eyesPitch / eyesPitchMax : 0.0f) : 0.0f;
+        Core::ScopedTimer timer(a_context.stats, Core::Probe::SmoothUpdate);
+        Core::TimelineScope scope(a_context.timeline, Core::Span::SmoothUpdate, a_context.face);
+
+        return UpdateFace(*this, a_context, [](auto& a_face, auto& a_faceContext) { Core::SmoothUpdate(a_face, a_faceContext); });
     }
 
-    void BSFaceGenAnimationData::RegularUpdate(float a_timeDelta)
+    bool BSFaceGenAnimationData::KeyframesUpdateHook(float a_timeDelta, bool)
     {
-        RE::BSSpinLockGuard locker(lock);
-
-        // expressions
-        {
-            auto merge = [](Keyframe& a_src, Keyframe& a_dst) {
-                if (!a_src.IsZero()) {
-                    a_dst.Copy(&a_src);
-                }
-            };
+        ActorManager::FrameUpdate(this);
 
-            expression3.Reset();
+        // held by the thread until its next update, a settings change meanwhile publishes a new snapshot and leaves this one alone
+        auto& settings = Settings::CurrentForThread();
 
-            expression1.TransitionUpdate(a_timeDelta, transitionTarget);
+        Core::ScopedTimer timer(HookStats::Active(settings.values), Core::Probe::KeyframesUpdate);
 
-            merge(expression1, expression3);
-            merge(expression2, expression3);
-        }
+        auto& values = settings.values;
+        auto key = reinterpret_cast<std::uintptr_t>(this);
+        auto budget = values.performance.fFrameBudget > 0.0f;
 
-        // modifiers
-        {
-            auto merge = [](Keyframe& a_src, Keyframe& a_dst) {
-                auto count = min(a_src.count, a_dst.count);
-                for (std::uint32_t i = 0; i < count; ++i) {
-                    if (a_src.values[i] != 0.0f) {
-                        a_dst.values[i] = a_src.values[i];
-                    }
-                }
-                if (a_src.values[Modifier::LookDown] != 0.0f || a_src.values[Modifier::LookLeft] != 0.0f || a_src.values[Modifier::LookRight] != 0.0f || a_src.values[Modifier::LookUp] != 0.0f) {
-                    a_dst.values[Modifier::LookDown] = a_src.values[Modifier::LookDown];
-                    a_dst.values[Modifier::LookLeft] = a_src.values[Modifier::LookLeft];
-                    a_dst.values[Modifier::LookRight] = a_src.values[Modifier::LookRight];
-                    a_dst.values[Modifier::LookUp] = a_src.values[Modifier::LookUp];
-                }
-            };
+        // script writes since the last update, then the sequence playing, also when this update is skipped below
+        FaceCommands::Apply(this, HookStats::Active(values));
+        FaceSequences::Update(this, a_timeDelta);
 
-            modifier3.Reset();
+        auto planned = values.transition.bPlannedTransitions;
 
-            DialogueModifiersUpdate(a_timeDelta);
-            EyesBlinkingUpdate(a_timeDelta, true);
+        // traces record every frame of every face in full and with stepped transitions,
+        // the replayer has nothing to compare skipped steps or planned curves against
+        auto defer = values.performance.bDeferOnContention;
 
-            merge(modifier1, modifier3);
+        // every face keeps its generator here
+        auto record = !IsTracing() ? faceRecords.Acquire(key) : Core::FaceTable<FaceRecord>::Lease{};
+        std::uint32_t lodParts = Core::LodPart::All;
 
-            if (!unk21A) {
-                EyesMovementUpdate(a_timeDelta);
-                EyesDirectionUpdate(a_timeDelta);
+        if (record && values.lod.bEnableLod) {
+            auto timeDelta = settings.lod.Step(record->lod, key, a_timeDelta, [&] { return ActorManager::GetView(this); });
+            if (!timeDelta) {
+                // a skipped frame answers the caller like one that ran, the engine's update sets it every call
+                unk217 = true;
+                return unk217;
             }
 
-            merge(modifier2, modifier3);
+            a_timeDelta = *timeDelta;
+            lodParts = settings.lod[record->lod.band].parts;
         }
 
-        // phonemes
-        {
-            auto merge = [](Keyframe& a_src, Keyframe& a_dst) {
-                auto count = min(a_src.count, a_dst.count);
-                for (std::uint32_t i = 0; i < count; ++i) {
-                    if (a_src.values[i] != 0.0f) {
-                        a_dst.values[i] = a_src.values[i];
-                    }
-                }
-            };
-
-            phoneme3.Reset();
+        Core::FrameBudget::Ticket ticket;
+        std::uint64_t start = 0;
 
-            DialoguePhonemesUpdate(a_timeDelta);
+        if (record && budget) {
+            frameBudget.SetBudget(static_cast<std::uint64_t>(values.performance.fFrameBudget * 1e-6 * frameBudgetRate.TicksPerSecond()));
 
-            merge(phoneme1, phoneme3);
-            if (dialogueData) {
-                auto threshold = std::clamp(Settings::Get().dialogue.fDialoguePhonemeThreshold, 0.0f, 200.0f) / 100.0f;
-                auto count = min(phoneme2.count, phoneme3.count);
-                for (std::uint32_t i = 0; i < count; ++i) {
-                    if (phoneme2.values[i] >= threshold) {
-                        phoneme3.values[i] = phoneme2.values[i];
-                    } else {
-                        phoneme2.values[i] = 0.0f;
-                    }
-                }
-            } else {
-                merge(phoneme2, phoneme3);
+            ticket = frameBudget.Admit(record->budget, a_timeDelta, dialogueData || ActorManager::IsDialoguePartner(this), HookStats::Active(values));
+            if (!ticket.run) {
+                unk217 = true;
+                return unk217;
             }
-        }
 
-        // custom
-        {
-            auto merge = [](RE::BSFaceGenKeyframeMultiple& a_src, RE::BSFaceGenKeyframeMultiple& a_dst) {
-                auto count = min(a_src.count, a_dst.count);
-                for (std::uint32_t i = 0; i < count; ++i) {
-                    if (a_src.values[i] != 0.0f) {
-                        a_dst.values[i] = a_src.values[i];
-                    }
-                }
-            };
-
-            custom3.Reset();
-
-            merge(custom1, custom3);
-            merge(custom2, custom3);
+            a_timeDelta = ticket.timeDelta;
+            start = Core::ReadTicks();
         }
-    }
-
-    void BSFaceGenAnimationData::SmoothUpdate(float a_timeDelta)
-    {
-        RE::BSSpinLockGuard locker(lock);
-
-        auto speed = ActorManager::GetSpeed(this);
-        auto animationStep = a_timeDelta / speed;
-
-        auto animMerge = [animationStep](Keyframe& dialogue, Keyframe& modifier, Keyframe& result) {
-            auto count = min(max(dialogue.count, modifier.count), result.count);
-            for (std::uint32_t i = 0; i < count; ++i) {
-                if (i >= modifier.count || (fabs(modifier.values[i]) < FLT_EPSILON && fabs(dialogue.values[i]) > FLT_EPSILON)) {
-                    result.values[i] = dialogue.values[i];
-                } else if (fabs(result.values[i] - modifier.values[i]) < animationStep) {
-                    result.values[i] = modifier.values[i];
-                } else {
-                    result.values[i] = result.values[i] + animationStep * (modifier.values[i] > result.values[i] ? 1 : -1);
-                }
-            }
-        };
 
-        // expressions
-        {
-            expression1.TransitionUpdate(a_timeDelta, transitionTarget);
-
-            animMerge(expression1, expression2, expression3);
+        // after the budget, which carries the time of the frames it skips itself
+        if (record && defer) {
+            a_timeDelta = record->deferral.Step(a_timeDelta);
         }
 
-        // modifiers
-        {
-            auto& settings = Settings::Get();
-
-            auto eyesHeadingMax = deg2rad(settings.eyesMovement.fTrackEyeXY);
-            auto eyesPitchMax = deg2rad(settings.eyesMovement.fTrackEyeZ);
-            auto eyesHeadingDeltaMax = settings.eyesMovement.fTrackSpeed * a_timeDelta;
-            auto eyesPitchDeltaMax = settings.eyesMovement.fTrackSpeed * a_timeDelta;
-
-            DialogueModifiersUpdate(a_timeDelta);
-
-            if (modifier2.timer < (1.0f - FLT_EPSILON)) {
-                modifier3.values[Modifier::BlinkLeft] = (float)(1.0f + (modifier3.values[Modifier::BlinkLeft] - 1.0f) / (1.0 - modifier2.timer));
-                modifier3.values[Modifier::BlinkRight] = (float)(1.0f + (modifier3.values[Modifier::BlinkRight] - 1.0f) / (1.0 - modifier2.timer));
-            } else {
-                modifier3.values[Modifier::BlinkLeft] = modifier2.values[Modifier::BlinkLeft] != 0 ? modifier2.values[Modifier::BlinkLeft] : modifier1.values[Modifier::BlinkLeft];
-                modifier3.values[Modifier::BlinkRight] = modifier2.values[Modifier::BlinkRight] != 0 ? modifier2.values[Modifier::BlinkRight] : modifier1.values[Modifier::BlinkRight];
-            }
-
-            EyesBlinkingUpdate(a_timeDelta, false);
+        auto speed = lodParts & Core::LodPart::Smoothing ? ActorManager::GetSpeed(this, values.transition.fDefaultSpeed) : 0.0f;
+        auto context = MakeUpdateContext(settings, this, record.get(), a_timeDelta, speed);
+        context.lodParts = lodParts;
+        context.idle = record && values.performance.bSkipIdleFaces ? &record->idle : nullptr;
+        context.deferral = record && defer ? &record->deferral : nullptr;
+        context.unlocked = values.performance.bUnlockedUpdate && !IsTracing();
+
+        if (record && planned && context.speed > 0.0f) {
+            context.transition = &record->transition;
+            context.transitionParams = &settings.transition;
+        } else if (record) {
+            // regular updates and the stepper move layer 3 past the plan, the next one starts from where it is then
+            record->transition.Clear();
+        }
 
-            if (!unk21A) {
-                modifier3.values[Modifier::LookLeft] -= eyesHeading < 0.0f ? -eyesHeading / eyesHeadingMax : 0.0f;
-                modifier3.values[Modifier::LookRight] -= eyesHeading > 0.0f ? eyesHeading / eyesHeadingMax : 0.0f;
-                modifier3.values[Modifier::LookDown] -= eyesPitch < 0.0f ? -eyesPitch / eyesPitchMax : 0.0f;
-                modifier3.values[Modifier::LookUp] -= eyesPitch > 0.0f ? eyesPitch / eyesPitchMax : 0.0f;
+        auto ran = context.speed > 0.f ? SmoothUpdate(context) : RegularUpdate(context);
 
-                EyesMovementUpdate(a_timeDelta);
+        if (!ran) {
+            // put off to the next frame, which catches up on the time
+            if (start) {
+                frameBudget.Spent(ticket, Core::ReadTicks() - start);
             }
+            unk217 = true;
+            return unk217;
+        }
 
-            animMerge(modifier1, modifier2, modifier3);
-
-            modifier3.values[Modifier::BlinkLeft] = 1.0f - (1.0f - modifier3.values[Modifier::BlinkLeft]) * (1.0f - modifier2.timer);
-            modifier3.values[Modifier::BlinkRight] = 1.0f - (1.0f - modifier3.values[Modifier::BlinkRight]) * (1.0f - modifier2.timer);
+        auto released = false;
 
-            if (!unk21A) {
-                float modifierLeft = modifier3.values[Modifier::LookLeft];
-                float modifierRight = modifier3.values[Modifier::LookRight];
-                float modifierDown = modifier3.values[Modifier::LookDown];
-                float modifierUp = modifier3.values[Modifier::LookUp];
+        {
+            Core::ScopedTimer release(context.stats, Core::Probe::ReleaseDialogue);
+            Core::TimelineScope scope(context.timeline, Core::Span::ReleaseDialogue, context.face);
+            released = CheckAndReleaseDialogueData();
+        }
 
-                float modifierHeadingOffset = (modifierLeft > 0 ? -modifierLeft * eyesHeadingMax : 0.0f) + (modifierRight > 0 ? modifierRight * eyesHeadingMax : 0.0f);
-                float modifierPitchOffset = (modifierDown > 0 ? -modifierDown * eyesPitchMax : 0.0f) + (modifierUp > 0 ? modifierUp * eyesPitchMax : 0.0f);
+        // the update published under its lock already, only the frame a line of dialogue ends takes it again
+        // so readers see the dialogue end in the same frame
+        if (released) {
+            Core::ScopedTimer publish(context.stats, Core::Probe::PublishSnapshot);
+            RE::BSSpinLockGuard locker(lock);
+            FaceSnapshots::Publish(this);
+        }
 
-                eyesHeading = std::clamp(eyesHeadingBase + eyesHeadingOffset, eyesHeading - eyesHeadingDeltaMax, eyesHeading + eyesHeadingDeltaMax);
-                eyesPitch = std::clamp(eyesPitchBase + eyesPitchOffset, eyesPitch - eyesPitchDeltaMax, eyesPitch + eyesPitchDeltaMax);
+        if (start) {
+            frameBudget.Spent(ticket, Core::ReadTicks() - start);
+        }
 
-                if ((eyesHeading + modifierHeadingOffset) > eyesHeadingMax) {
-                    eyesHeading = eyesHeadingMax - modifierHeadingOffset;
-                } else if ((eyesHeading + modifierHeadingOffset) < -eyesHeadingMax) {
-                    eyesHeading = -eyesHeadingMax - modifierHeadingOffset;
-                }
+        unk217 = true;
 
-                if ((eyesPitch + modifierPitchOffset) > eyesPitchMax) {
-                    eyesPitch = eyesPitchMax - modifierPitchOffset;
-                } else if ((eyesPitch + modifierPitchOffset) < -eyesPitchMax) {
-                    eyesPitch = -eyesPitchMax - modifierPitchOffset;
-                }
+        timer.Stop();
 
-                float currentHeading = eyesHeading + modifierHeadingOffset;
-                float currentPitch = eyesPitch + modifierPitchOffset;
-
-                modifier3.values[Modifier::LookLeft] = currentHeading < 0.0f ? -currentHeading / eyesHeadingMax : 0.0f;
-                modifier3.values[Modifier::LookRight] = currentHeading > 0.0f ? currentHeading / eyesHeadingMax : 0.0f;
-                modifier3.values[Modifier::LookDown] = currentPitch < 0.0f ? -currentPitch / eyesPitchMax : 0.0f;
-                modifier3.values[Modifier::LookUp] = currentPitch > 0.0f ? currentPitch / eyesPitchMax : 0.0f;
-                modifier3.values[Modifier::LookLeft] = std::clamp(modifier3.values[Modifier::LookLeft], 0.0f, 1.0f);
-                modifier3.values[Modifier::LookRight] = std::clamp(modifier3.values[Modifier::LookRight], 0.0f, 1.0f);
-                modifier3.values[Modifier::LookDown] = std::clamp(modifier3.values[Modifier::LookDown], 0.0f, 1.0f);
-                modifier3.values[Modifier::LookUp] = std::clamp(modifier3.values[Modifier::LookUp], 0.0f, 1.0f);
-            }
+        if (context.stats && settings.values.debug.fStatsExportInterval > 0.0f) {
+            HookStats::ExportIfDue(settings.values.debug.fStatsExportInterval);
         }
 
-        DialoguePhonemesUpdate(a_timeDelta);
-
-        // phonemes
-        if (dialogueData) {
-            auto threshold = std::clamp(Settings::Get().dialogue.fDialoguePhonemeThreshold, 0.0f, 200.0f) / 100.0f;
-            for (std::uint32_t i = 0; i < phoneme2.count; ++i) {
-                if (phoneme2.values[i] < threshold) {
-                    phoneme2.values[i] = 0.0f;
-                }
-            }
-            animMerge(phoneme1, phoneme2, phoneme3);
-        } else {
-            animMerge(phoneme1, phoneme2, phoneme3);
-        }
-        // custom
-        animMerge(custom1, custom2, custom3);
+        return unk217;
     }
 
-    bool BSFaceGenAnimationData::KeyframesUpdateHook(float a_timeDelta, bool)
+    Core::EyesState BSFaceGenAnimationData::GetEyesState() const
     {
-        if (ActorManager::GetSpeed(this) > 0.f) {
-            SmoothUpdate(a_timeDelta);
-        } else {
-            RegularUpdate(a_timeDelta);
-        }
-
-        CheckAndReleaseDialogueData();
-
-        unk217 = true;
+        return { eyesBlinkingStage, eyesBlinkingTimer, eyesOffsetTimer, eyesHeadingOffset, eyesPitchOffset, eyesHeading, eyesPitch, eyesHeadingBase, eyesPitchBase };
+    }
 
-        return unk217;
+    void BSFaceGenAnimationData::SetEyesState(const Core::EyesState& a_eyes)
+    {
+        eyesBlinkingStage = a_eyes.blinkStage;
+        eyesBlinkingTimer = a_eyes.blinkTimer;
+        eyesOffsetTimer = a_eyes.offsetTimer;
+        eyesHeadingOffset = a_eyes.headingOffset;
+        eyesPitchOffset = a_eyes.pitchOffset;
+        eyesHeading = a_eyes.heading;
+        eyesPitch = a_eyes.pitch;
     }
 
     void BSFaceGenAnimationData::Init()
@@ -602,4 +708,43 @@ namespace MfgFix
             REL::safe_write(Offsets::BSFaceGenNiNode::sub_3F1800.address() + 0x0139, static_cast<std::uint16_t>(0x47EB));
         }
     }
+
+    void BSFaceGenAnimationData::LayersWritten()
+    {
+        faceRecords.Visit(reinterpret_cast<std::uintptr_t>(this), [](FaceRecord& a_record) {
+            a_record.idle.Written();
+            a_record.transition.Written();
+        });
+    }
+
+    void BSFaceGenAnimationData::EraseRecords(std::uintptr_t a_data)
+    {
+        faceRecords.Erase(a_data);
+    }
+
+    bool BSFaceGenAnimationData::StartTrace(const std::filesystem::path& a_path)
+    {
+        if (!traceWriter.Open(a_path)) {
+            return false;
+        }
+
+        tracing.store(true, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    std::uint64_t BSFaceGenAnimationData::StopTrace()
+    {
+        tracing.store(false, std::memory_order_relaxed);
+
+        auto records = traceWriter.Records();
+        traceWriter.Close();
+
+        return records;
+    }
+
+    bool BSFaceGenAnimationData::IsTracing()
+    {
+        return tracing.load(std::memory_order_relaxed);
+    }
 }
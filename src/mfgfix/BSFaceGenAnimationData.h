@@ -1,5 +1,11 @@
 #pragma once
 
+#include "Settings.h"
+#include "core/Eyes.h"
+#include "core/FaceUpdate.h"
+#include "core/Budget.h"
+#include "core/Stats.h"
+
 namespace MfgFix
 {
     class BSFaceGenAnimationData : public RE::NiExtraData
@@ -10,15 +16,7 @@ namespace MfgFix
         using Phoneme = Keyframe::Phoneme;
         using Modifier = Keyframe::Modifier;
 
-        enum class EyesBlinkingStage : std::uint32_t
-        {
-            BlinkDelay = 0,
-            BlinkDown,
-            BlinkUp,
-            WaitForLookDown,
-            BlinkDownAndWait1,
-            BlinkDownAndWait2
-        };
+        using EyesBlinkingStage = Core::BlinkStage;
 
         struct DialogueData
         {
@@ -38,6 +36,16 @@ namespace MfgFix
             Unk28* unk28;              // 28
         };
 
+        // Core::FaceUpdateContext plus what only the plugin side of the update needs
+        struct UpdateContext : Core::FaceUpdateContext
+        {
+            const SettingsSnapshot* settings{ nullptr };
+            bool deterministicRandom{ false };
+            Core::Stats* stats{ nullptr };            // null unless bCollectStats
+            bool unlocked{ false };                   // bUnlockedUpdate, never while tracing
+            Core::LockDeferral* deferral{ nullptr };  // bDeferOnContention, null waits for the lock
+        };
+
         Keyframe* transitionTarget;           // 18 used to animate transition between expressions
         Keyframe expression1;                 // 20 used by console command and SetExpressionOverride
         Keyframe expression2;                 // 40 unused?
@@ -104,15 +112,31 @@ namespace MfgFix
         std::uint32_t GetActiveExpression() const;
         void DialogueModifiersUpdate(float a_timeDelta);
         void DialoguePhonemesUpdate(float a_timeDelta);
-        void CheckAndReleaseDialogueData();
-        void EyesBlinkingUpdate(float a_timeDelta, bool a_blink);
-        void EyesMovementUpdate(float a_timeDelta);
-        void EyesDirectionUpdate(float a_timeDelta);
-        void RegularUpdate(float a_timeDelta);
-        void SmoothUpdate(float a_timeDelta);
+        // true if the dialogue ended and was released
+        bool CheckAndReleaseDialogueData();
+        // false if the frame was put off, see LockDeferral
+        bool RegularUpdate(UpdateContext& a_context);
+        bool SmoothUpdate(UpdateContext& a_context);
         bool KeyframesUpdateHook(float a_timeDelta, bool a_updateBlinking);
 
+        Core::EyesState GetEyesState() const;
+        void SetEyesState(const Core::EyesState& a_eyes);
+
+        static std::span<float> Values(Keyframe& a_keyframe) { return { a_keyframe.values, a_keyframe.count }; }
+        static std::span<const float> Values(const Keyframe& a_keyframe) { return { a_keyframe.values, a_keyframe.count }; }
+
         static void Init();
+
+        // after writing layers outside the update, so an idle face runs its next one in full and transitions plan again
+        void LayersWritten();
+
+        // drops what the optional update steps kept for the face at a_data, for actors that unload or load into it
+        static void EraseRecords(std::uintptr_t a_data);
+
+        // records every face update to a_path until StopTrace, see src/replay
+        static bool StartTrace(const std::filesystem::path& a_path);
+        static std::uint64_t StopTrace();
+        static bool IsTracing();
     };
 
     static_assert(sizeof(BSFaceGenAnimationData) == 0x230);
@@ -1,6 +1,8 @@
 #include "ConsoleCommands.h"
 #include "ActorManager.h"
 #include "BSFaceGenAnimationData.h"
+#include "HookStats.h"
+#include "HookTimeline.h"
 #include "Offsets.h"
 
 namespace MfgFix::ConsoleCommands
@@ -49,6 +51,8 @@ namespace MfgFix::ConsoleCommands
                 break;
             }
         }
+
+        animData->LayersWritten();
     }
 
     void PrintInfo(RE::TESObjectREFR* a_ref, Keyframe::Type a_keyframeType)
@@ -122,6 +126,109 @@ namespace MfgFix::ConsoleCommands
 
         animData->ClearExpressionOverride();
         animData->Reset(0.0f, true, true, true, false);
+        animData->LayersWritten();
+    }
+
+    void PrintSpeeds()
+    {
+        auto console = RE::ConsoleLog::GetSingleton();
+
+        if (!console) {
+            return;
+        }
+
+        auto stats = ActorManager::GetStats();
+        auto lookups = stats.hits + stats.misses;
+
+        console->Print(std::format("speed entries  {} / {}  ({} bytes)", stats.size, stats.maxEntries, stats.memory).c_str());
+        console->Print(std::format("lookups        {}  hit rate {:.1f}%", lookups, lookups ? 100.0 * stats.hits / lookups : 0.0).c_str());
+        console->Print(std::format("inserts        {}", stats.inserts).c_str());
+        console->Print(std::format("evicted        unload {}  lru {}  reused address {}", stats.evictedUnload, stats.evictedLRU, stats.evictedReuse).c_str());
+    }
+
+    // mfg stats prints, mfg stats 1 starts a new measurement, mfg stats 0 stops collecting
+    void Stats(std::optional<bool> a_enable)
+    {
+        auto console = RE::ConsoleLog::GetSingleton();
+
+        if (!console) {
+            return;
+        }
+
+        if (a_enable) {
+            HookStats::SetEnabled(*a_enable);
+            console->Print(*a_enable ? "stats collection on" : "stats collection off");
+            return;
+        }
+
+        auto report = HookStats::Report();
+
+        for (auto line : std::views::split(std::string_view{ report }, '\n')) {
+            if (!line.empty()) {
+                console->Print(std::string(line.begin(), line.end()).c_str());
+            }
+        }
+    }
+
+    // mfg timeline writes the recorded spans, mfg timeline 1 starts recording, mfg timeline 0 stops
+    void Timeline(std::optional<bool> a_enable)
+    {
+        auto console = RE::ConsoleLog::GetSingleton();
+
+        if (!console) {
+            return;
+        }
+
+        if (a_enable) {
+            HookTimeline::SetEnabled(*a_enable);
+            console->Print(*a_enable ? "timeline recording on" : "timeline recording off");
+            return;
+        }
+
+        std::size_t events = 0;
+
+        if (auto path = HookTimeline::Dump(events)) {
+            console->Print(std::format("{} spans written to {}", events, path->string()).c_str());
+        } else {
+            console->Print("can't write the timeline");
+        }
+    }
+
+    void Trace(std::optional<bool> a_enable)
+    {
+        auto console = RE::ConsoleLog::GetSingleton();
+
+        if (!console) {
+            return;
+        }
+
+        auto tracing = BSFaceGenAnimationData::IsTracing();
+
+        if (!a_enable.value_or(!tracing)) {
+            if (tracing) {
+                console->Print(std::format("trace stopped, {} face updates", BSFaceGenAnimationData::StopTrace()).c_str());
+            }
+            return;
+        }
+
+        if (tracing) {
+            console->Print("trace already running");
+            return;
+        }
+
+        auto directory = SKSE::log::log_directory();
+
+        if (!directory) {
+            return;
+        }
+
+        auto path = *directory / std::format("mfgfix-{:%Y%m%d-%H%M%S}.trace", std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+
+        if (BSFaceGenAnimationData::StartTrace(path)) {
+            console->Print(std::format("tracing face updates to {}", path.string()).c_str());
+        } else {
+            console->Print(std::format("can't open {}", path.string()).c_str());
+        }
     }
 
     bool ModifyFaceGenCommand(const RE::SCRIPT_PARAMETER* a_paramInfo, RE::SCRIPT_FUNCTION::ScriptData* a_scriptData, RE::TESObjectREFR* a_thisObj, RE::TESObjectREFR* a_containingObj, RE::Script* a_scriptObj, RE::ScriptLocals* a_locals, double& a_result, std::uint32_t& a_opcodeOffsetPtr)
@@ -172,6 +279,18 @@ namespace MfgFix::ConsoleCommands
                 } else if (_strnicmp(param1->str, "reset", param1->length) == 0) {
                     Reset(thisObj);
                     return true;
+                } else if (_strnicmp(param1->str, "speeds", param1->length) == 0) {
+                    PrintSpeeds();
+                    return true;
+                } else if (_strnicmp(param1->str, "stats", param1->length) == 0) {
+                    Stats(param2 ? std::optional<bool>(param2->value != 0) : std::nullopt);
+                    return true;
+                } else if (_strnicmp(param1->str, "trace", param1->length) == 0) {
+                    Trace(param2 ? std::optional<bool>(param2->value != 0) : std::nullopt);
+                    return true;
+                } else if (_strnicmp(param1->str, "timeline", param1->length) == 0) {
+                    Timeline(param2 ? std::optional<bool>(param2->value != 0) : std::nullopt);
+                    return true;
                 }
             }
         }
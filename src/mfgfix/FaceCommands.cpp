@@ -0,0 +1,238 @@
+#include "FaceCommands.h"
+#include "ActorManager.h"
+#include "BSFaceGenAnimationData.h"
+#include "FaceSnapshots.h"
+#include "HookStats.h"
+#include "HookTimeline.h"
+#include "core/Blend.h"
+
+namespace MfgFix::FaceCommands
+{
+    namespace
+    {
+        Core::CommandQueue& Get()
+        {
+            static Core::CommandQueue queue;
+
+            return queue;
+        }
+
+        std::int32_t GetValue(const BSFaceGenAnimationData::Keyframe& a_keyframe, std::uint32_t a_id)
+        {
+            return a_id < a_keyframe.count ? std::lround(a_keyframe.values[a_id] * 100.0f) : 0;
+        }
+
+        void SetExpression(BSFaceGenAnimationData* a_data, std::uint32_t a_mood, std::int32_t a_value)
+        {
+            if (a_mood >= Core::Expression::Total) {
+                return;
+            }
+
+            a_data->expressionOverride = false;
+            a_data->SetExpressionOverride(a_mood, a_value / 100.0f);
+            a_data->expressionOverride = true;
+        }
+
+        // the writes a_pending holds, values are clamped already; with the face lock held
+        void ApplyPending(BSFaceGenAnimationData* a_data, const Core::PendingFace& a_pending, Core::Stats* a_stats)
+        {
+            switch (a_pending.reset) {
+            case Core::FaceReset::All:
+                for (std::uint32_t i = 0; i < Core::kPresetModifiers; ++i) {
+                    a_data->modifier2.SetValue(i, 0.0f);
+                }
+                for (std::uint32_t i = 0; i < Core::Phoneme::Total; ++i) {
+                    a_data->phoneme2.SetValue(i, 0.0f);
+                }
+                SetExpression(a_data, Core::ActiveExpression(BSFaceGenAnimationData::Values(a_data->expression1)), 0);
+                [[fallthrough]];
+            case Core::FaceReset::Override:
+                a_data->ClearExpressionOverride();
+                a_data->Reset(0.0f, true, true, true, false);
+                break;
+            default:
+                break;
+            }
+
+            if (a_pending.setExpression) {
+                SetExpression(a_data, a_pending.expression, a_pending.expressionValue);
+            }
+
+            std::uint64_t dropped = 0;
+
+            // values a face already has are left alone
+            for (std::uint32_t i = 0; i < Core::Phoneme::Total; ++i) {
+                if (a_pending.phonemeMask >> i & 1) {
+                    if (GetValue(a_data->phoneme2, i) == a_pending.phonemes[i]) {
+                        ++dropped;
+                    } else {
+                        a_data->phoneme2.SetValue(i, a_pending.phonemes[i] / 100.0f);
+                    }
+                }
+            }
+
+            for (std::uint32_t i = 0; i < Core::kPresetModifiers; ++i) {
+                if (a_pending.modifierMask >> i & 1) {
+                    if (GetValue(a_data->modifier2, i) == a_pending.modifiers[i]) {
+                        ++dropped;
+                    } else {
+                        a_data->modifier2.SetValue(i, a_pending.modifiers[i] / 100.0f);
+                    }
+                }
+            }
+
+            if (a_stats) {
+                a_stats->Count(Core::Counter::CommandsDropped, dropped);
+            }
+
+            a_data->LayersWritten();
+        }
+
+        BSFaceGenAnimationData* GetFace(RE::Actor* a_actor)
+        {
+            return a_actor ? reinterpret_cast<BSFaceGenAnimationData*>(a_actor->GetFaceGenAnimationData()) : nullptr;
+        }
+
+        // frames a write waits for its face to update before the fallback task applies it
+        constexpr std::uint32_t kFallbackFrames = 4;
+
+        std::atomic<bool> fallbackQueued{ false };
+
+        void QueueFallback();
+
+        // faces that don't update (out of sight, not animated) would never take their writes, nor free their slots;
+        // one task per frame while anything is pending, however many natives were called
+        void RunFallback()
+        {
+            static std::vector<Core::StaleFace> stale;  // UI thread only
+
+            auto stats = HookStats::Active();
+
+            Get().FindStale(kFallbackFrames, stale, stats);
+
+            for (auto& face : stale) {
+                auto actor = RE::TESForm::LookupByID<RE::Actor>(face.owner);
+                auto animData = GetFace(actor);
+
+                // the writes were for a face the actor no longer has
+                if (reinterpret_cast<std::uintptr_t>(animData) != face.face) {
+                    Get().EraseOwner(face.owner);
+                    continue;
+                }
+
+                Apply(animData, stats);
+            }
+
+            fallbackQueued.store(false, std::memory_order_release);
+
+            if (Get().GetCounters().pending || !Get().Empty()) {
+                QueueFallback();
+            }
+        }
+
+        void QueueFallback()
+        {
+            if (fallbackQueued.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+
+            if (auto tasks = SKSE::GetTaskInterface()) {
+                tasks->AddUITask(RunFallback);
+            } else {
+                fallbackQueued.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+    bool Send(RE::Actor* a_actor, Core::CommandKind a_kind, std::uint32_t a_id, std::int32_t a_value, float a_speed)
+    {
+        auto animData = GetFace(a_actor);
+        if (!animData) {
+            return false;
+        }
+
+        Core::FaceCommand command;
+        command.face = reinterpret_cast<std::uintptr_t>(animData);
+        command.owner = a_actor->GetFormID();
+        command.kind = a_kind;
+
+        ActorManager::SetOwner(command.face, command.owner);
+        command.id = static_cast<std::uint8_t>(a_id);
+        command.value = a_value;
+        command.speed = a_speed;
+
+        Get().Push(command, HookStats::Active());
+        QueueFallback();
+
+        return true;
+    }
+
+    std::size_t SendPreset(std::span<RE::Actor* const> a_actors, const Core::ExpressionPreset& a_preset, float a_speed)
+    {
+        std::vector<Core::FaceCommand> commands;
+        commands.reserve(a_actors.size());
+
+        for (auto actor : a_actors) {
+            if (auto animData = GetFace(actor)) {
+                Core::FaceCommand command;
+                command.face = reinterpret_cast<std::uintptr_t>(animData);
+                command.owner = actor->GetFormID();
+                command.speed = a_speed;
+                commands.push_back(command);
+
+                ActorManager::SetOwner(command.face, command.owner);
+            }
+        }
+
+        Get().PushPreset(a_preset, commands, HookStats::Active());
+        QueueFallback();
+
+        return commands.size();
+    }
+
+    void Apply(BSFaceGenAnimationData* a_data, Core::Stats* a_stats)
+    {
+        auto face = reinterpret_cast<std::uintptr_t>(a_data);
+
+        // the lock only for faces with writes, taken before the writes so the fallback can't apply older ones after them
+        if (!Get().Pending(face, a_stats)) {
+            return;
+        }
+
+        Core::PendingFace pending;
+
+        {
+            RE::BSSpinLockGuard locker(a_data->lock);
+
+            if (!Get().Take(face, pending, a_stats)) {
+                return;
+            }
+
+            Core::TimelineScope scope(HookTimeline::Active(), Core::Span::FaceCommands, pending.owner);
+
+            ApplyPending(a_data, pending, a_stats);
+            FaceSnapshots::Publish(a_data);
+        }
+
+        ActorManager::SetSpeed(a_data, pending.owner, pending.speed);
+    }
+
+    void Write(BSFaceGenAnimationData* a_data, const Core::PendingFace& a_pending, Core::Stats* a_stats)
+    {
+        RE::BSSpinLockGuard locker(a_data->lock);
+        ApplyPending(a_data, a_pending, a_stats);
+
+        // getters see the write even when LOD or the frame budget skip the update that follows
+        FaceSnapshots::Publish(a_data);
+    }
+
+    void EraseOwner(RE::FormID a_owner)
+    {
+        Get().EraseOwner(a_owner);
+    }
+
+    Core::CommandQueue::Counters GetCounters()
+    {
+        return Get().GetCounters();
+    }
+}
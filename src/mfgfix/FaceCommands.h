@@ -0,0 +1,31 @@
+#pragma once
+
+#include "core/Broadcast.h"
+#include "core/Commands.h"
+
+namespace MfgFix
+{
+    class BSFaceGenAnimationData;
+}
+
+namespace MfgFix::FaceCommands
+{
+    // queues a write to the face of a_actor, applied in its next update under the face lock
+    // a_id and a_value as the natives take them, checked there; false for an actor without a face
+    bool Send(RE::Actor* a_actor, Core::CommandKind a_kind, std::uint32_t a_id, std::int32_t a_value, float a_speed);
+
+    // a_preset for every actor, the preset is stored once; returns how many actors had a face
+    std::size_t SendPreset(std::span<RE::Actor* const> a_actors, const Core::ExpressionPreset& a_preset, float a_speed);
+
+    // what was sent to a_data since its last update, called from the update hook without the face lock held;
+    // faces that don't update for a few frames get it from a UI task
+    void Apply(BSFaceGenAnimationData* a_data, Core::Stats* a_stats);
+
+    // a_pending to a_data under the face lock, the speed is left to the caller
+    void Write(BSFaceGenAnimationData* a_data, const Core::PendingFace& a_pending, Core::Stats* a_stats);
+
+    // drops what's pending for an actor that unloads
+    void EraseOwner(RE::FormID a_owner);
+
+    Core::CommandQueue::Counters GetCounters();
+}
@@ -0,0 +1,74 @@
+#include "FaceSequences.h"
+#include "ActorManager.h"
+#include "BSFaceGenAnimationData.h"
+#include "FaceCommands.h"
+#include "HookTimeline.h"
+
+namespace MfgFix::FaceSequences
+{
+    namespace
+    {
+        Core::SequenceBoard& Get()
+        {
+            static Core::SequenceBoard board;
+
+            return board;
+        }
+
+        std::uintptr_t GetFace(RE::Actor* a_actor)
+        {
+            return a_actor ? reinterpret_cast<std::uintptr_t>(a_actor->GetFaceGenAnimationData()) : 0;
+        }
+    }
+
+    bool Play(RE::Actor* a_actor, std::shared_ptr<const Core::Sequence> a_sequence, float a_speed)
+    {
+        auto face = GetFace(a_actor);
+        if (!face) {
+            return false;
+        }
+
+        ActorManager::SetOwner(face, a_actor->GetFormID());
+        Get().Start(face, a_actor->GetFormID(), std::move(a_sequence), a_speed);
+
+        return true;
+    }
+
+    bool Stop(RE::Actor* a_actor)
+    {
+        auto face = GetFace(a_actor);
+
+        return face && Get().Stop(face);
+    }
+
+    void Update(BSFaceGenAnimationData* a_data, float a_timeDelta)
+    {
+        Core::PendingFace pending;
+
+        auto step = Get().Step(reinterpret_cast<std::uintptr_t>(a_data), a_timeDelta, pending);
+        if (step == Core::SequenceStep::None) {
+            return;
+        }
+
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::FaceSequences, pending.owner);
+
+        if (step == Core::SequenceStep::Started) {
+            ActorManager::SetSpeed(a_data, pending.owner, pending.speed);
+        }
+
+        // held values are skipped by the write, no need to count them as dropped commands
+        if (!pending.Empty()) {
+            FaceCommands::Write(a_data, pending, nullptr);
+        }
+    }
+
+    void EraseOwner(RE::FormID a_owner)
+    {
+        Get().EraseOwner(a_owner);
+    }
+
+    void EraseForeign(std::uintptr_t a_face, RE::FormID a_owner)
+    {
+        Get().EraseForeign(a_face, a_owner);
+    }
+}
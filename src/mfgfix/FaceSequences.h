@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/Sequence.h"
+
+namespace MfgFix
+{
+    class BSFaceGenAnimationData;
+}
+
+namespace MfgFix::FaceSequences
+{
+    // replaces what a_actor was playing, the face starts it in its next update; false for an actor without a face
+    bool Play(RE::Actor* a_actor, std::shared_ptr<const Core::Sequence> a_sequence, float a_speed);
+
+    // the face keeps the values the sequence left, false if it wasn't playing one
+    bool Stop(RE::Actor* a_actor);
+
+    // steps the sequence of a_data, called from the update hook without the face lock held
+    void Update(BSFaceGenAnimationData* a_data, float a_timeDelta);
+
+    void EraseOwner(RE::FormID a_owner);
+
+    // drops the sequence of a_face if another actor than a_owner started it, for faces loading at a reused address
+    void EraseForeign(std::uintptr_t a_face, RE::FormID a_owner);
+}
@@ -0,0 +1,72 @@
+#include "FaceSnapshots.h"
+#include "BSFaceGenAnimationData.h"
+
+namespace MfgFix::FaceSnapshots
+{
+    namespace
+    {
+        Core::SnapshotBoard& Get()
+        {
+            static Core::SnapshotBoard board;
+
+            return board;
+        }
+    }
+
+    Core::FaceSnapshot Capture(const BSFaceGenAnimationData* a_data)
+    {
+        using Data = BSFaceGenAnimationData;
+
+        Core::FaceSnapshot snapshot;
+
+        Core::FaceSnapshot::Copy(Data::Values(a_data->phoneme1), snapshot.phonemes[0], snapshot.phonemeCount[0]);
+        Core::FaceSnapshot::Copy(Data::Values(a_data->phoneme2), snapshot.phonemes[1], snapshot.phonemeCount[1]);
+        Core::FaceSnapshot::Copy(Data::Values(a_data->phoneme3), snapshot.phonemes[2], snapshot.phonemeCount[2]);
+        Core::FaceSnapshot::Copy(Data::Values(a_data->modifier1), snapshot.modifiers[0], snapshot.modifierCount[0]);
+        Core::FaceSnapshot::Copy(Data::Values(a_data->modifier2), snapshot.modifiers[1], snapshot.modifierCount[1]);
+        Core::FaceSnapshot::Copy(Data::Values(a_data->modifier3), snapshot.modifiers[2], snapshot.modifierCount[2]);
+        Core::FaceSnapshot::Copy(Data::Values(a_data->expression1), snapshot.expressions[0], snapshot.expressionCount[0]);
+        Core::FaceSnapshot::Copy(Data::Values(a_data->expression2), snapshot.expressions[1], snapshot.expressionCount[1]);
+        Core::FaceSnapshot::Copy(Data::Values(a_data->expression3), snapshot.expressions[2], snapshot.expressionCount[2]);
+
+        snapshot.dialogue = a_data->dialogueData != nullptr;
+
+        return snapshot;
+    }
+
+    void Publish(const BSFaceGenAnimationData* a_data)
+    {
+        Get().Publish(reinterpret_cast<std::uintptr_t>(a_data), Capture(a_data));
+    }
+
+    bool Read(RE::Actor* a_actor, Core::FaceSnapshot& a_snapshot)
+    {
+        auto animData = a_actor ? reinterpret_cast<BSFaceGenAnimationData*>(a_actor->GetFaceGenAnimationData()) : nullptr;
+
+        if (!animData) {
+            return false;
+        }
+
+        if (!Get().Read(reinterpret_cast<std::uintptr_t>(animData), a_snapshot)) {
+            RE::BSSpinLockGuard locker(animData->lock);
+            a_snapshot = Capture(animData);
+        }
+
+        return true;
+    }
+
+    void Erase(std::uintptr_t a_data)
+    {
+        Get().Erase(a_data);
+    }
+
+    std::size_t Size()
+    {
+        return Get().Size();
+    }
+
+    std::uint64_t Retries()
+    {
+        return Get().Retries();
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "core/Snapshot.h"
+
+namespace MfgFix
+{
+    class BSFaceGenAnimationData;
+}
+
+namespace MfgFix::FaceSnapshots
+{
+    // the layers of a_data as they are now, call with the face lock held
+    Core::FaceSnapshot Capture(const BSFaceGenAnimationData* a_data);
+
+    // Capture for readers that don't take the face lock, call with the face lock held
+    void Publish(const BSFaceGenAnimationData* a_data);
+
+    // the last snapshot of a_actor's face without its lock; one taken under the lock for a face that hasn't published yet,
+    // false for an actor without a face
+    bool Read(RE::Actor* a_actor, Core::FaceSnapshot& a_snapshot);
+
+    // a face that loads at an address another face had, or unloads
+    void Erase(std::uintptr_t a_data);
+
+    std::size_t Size();
+    std::uint64_t Retries();
+}
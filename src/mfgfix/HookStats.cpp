@@ -0,0 +1,71 @@
+#include "HookStats.h"
+
+namespace MfgFix::HookStats
+{
+    namespace
+    {
+        std::atomic<std::int64_t> nextExport{ 0 };  // steady_clock nanoseconds, 0 until the first call
+
+        std::int64_t Now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void Export()
+        {
+            auto directory = SKSE::log::log_directory();
+
+            if (!directory) {
+                return;
+            }
+
+            std::ofstream file(*directory / "mfgfix-stats.txt", std::ios::trunc);
+            file << Report();
+        }
+    }
+
+    Core::Stats& Get()
+    {
+        static Core::Stats stats;
+
+        return stats;
+    }
+
+    void SetEnabled(bool a_enabled)
+    {
+        if (a_enabled) {
+            Get().Reset();
+        }
+
+        Settings::Update([&](Settings& a_settings) { a_settings.debug.bCollectStats = a_enabled; });
+    }
+
+    std::string Report()
+    {
+        auto text = Core::Stats::Format(Get().Collect());
+
+        if (!Active()) {
+            text.insert(0, "collection is off, enable it with bCollectStats or 'mfg stats 1'\n");
+        }
+
+        return text;
+    }
+
+    void ExportIfDue(float a_interval)
+    {
+        auto now = Now();
+        auto due = nextExport.load(std::memory_order_relaxed);
+
+        if (now < due) {
+            return;
+        }
+
+        // one update thread wins the export, the first call only arms the timer
+        auto next = now + static_cast<std::int64_t>(static_cast<double>(a_interval) * 1e9);
+        if (!nextExport.compare_exchange_strong(due, next, std::memory_order_relaxed) || due == 0) {
+            return;
+        }
+
+        Export();
+    }
+}
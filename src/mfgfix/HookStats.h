@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Settings.h"
+#include "core/Stats.h"
+
+namespace MfgFix::HookStats
+{
+    Core::Stats& Get();
+
+    // nullptr unless bCollectStats, callers skip every probe then
+    inline Core::Stats* Active(const Settings& a_settings)
+    {
+        return a_settings.debug.bCollectStats ? &Get() : nullptr;
+    }
+
+    inline Core::Stats* Active()
+    {
+        return Active(Settings::Current()->values);
+    }
+
+    // enabling also starts a new measurement span
+    void SetEnabled(bool a_enabled);
+
+    std::string Report();
+
+    // rewrites mfgfix-stats.txt in the SKSE log directory every a_interval seconds, called from the update hook
+    void ExportIfDue(float a_interval);
+
+    // native that counts its calls before forwarding to F
+    template <auto F>
+    struct CountedNative;
+
+    template <class R, class... Args, R (*F)(Args...)>
+    struct CountedNative<F>
+    {
+        static R Call(Args... a_args)
+        {
+            if (auto stats = Active()) {
+                stats->CountNative(slot);
+            }
+
+            return F(std::forward<Args>(a_args)...);
+        }
+
+        static inline std::uint32_t slot{ Core::Stats::kNoNative };
+    };
+
+    template <auto F>
+    void RegisterFunction(RE::BSScript::IVirtualMachine* a_vm, std::string_view a_name, std::string_view a_script)
+    {
+        CountedNative<F>::slot = Get().RegisterNative(std::format("{}.{}", a_script, a_name));
+
+        a_vm->RegisterFunction(a_name, a_script, CountedNative<F>::Call);
+    }
+}
@@ -0,0 +1,42 @@
+#include "HookTimeline.h"
+
+namespace MfgFix::HookTimeline
+{
+    Core::Timeline& Get()
+    {
+        static Core::Timeline timeline(kEvents);
+
+        return timeline;
+    }
+
+    void SetEnabled(bool a_enabled)
+    {
+        if (a_enabled) {
+            Get().Clear();
+        }
+
+        Settings::Update([&](Settings& a_settings) { a_settings.debug.bRecordTimeline = a_enabled; });
+    }
+
+    std::optional<std::filesystem::path> Dump(std::size_t& a_events)
+    {
+        auto directory = SKSE::log::log_directory();
+
+        if (!directory) {
+            return std::nullopt;
+        }
+
+        auto capture = Get().Collect();
+        auto path = *directory / std::format("mfgfix-{:%Y%m%d-%H%M%S}.json", std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+
+        std::ofstream file(path, std::ios::trunc | std::ios::binary);
+        if (!file) {
+            return std::nullopt;
+        }
+
+        file << Core::FormatChromeTrace(capture);
+        a_events = capture.events.size();
+
+        return path;
+    }
+}
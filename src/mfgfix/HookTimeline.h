@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Settings.h"
+#include "core/Timeline.h"
+
+namespace MfgFix::HookTimeline
+{
+    // about 2.5 MB, the last few seconds of a busy scene
+    inline constexpr std::size_t kEvents = 1 << 16;
+
+    Core::Timeline& Get();
+
+    // nullptr unless bRecordTimeline, nothing is recorded then
+    inline Core::Timeline* Active(const Settings& a_settings)
+    {
+        return a_settings.debug.bRecordTimeline ? &Get() : nullptr;
+    }
+
+    inline Core::Timeline* Active()
+    {
+        return Active(Settings::Current()->values);
+    }
+
+    // enabling also drops everything recorded so far
+    void SetEnabled(bool a_enabled);
+
+    // writes what the ring holds to mfgfix-<time>.json in the SKSE log directory, keeps recording
+    std::optional<std::filesystem::path> Dump(std::size_t& a_events);
+}
@@ -1,7 +1,15 @@
 ﻿#include "MfgConsoleFunc.h"
 #include "ActorManager.h"
 #include "BSFaceGenAnimationData.h"
+#include "FaceCommands.h"
+#include "FaceSequences.h"
+#include "FaceSnapshots.h"
+#include "HookStats.h"
+#include "HookTimeline.h"
+#include "PresetRegistry.h"
 #include "Settings.h"
+#include "core/Blend.h"
+#include "core/Broadcast.h"
 
 namespace MfgFix::MfgConsoleFunc
 {
@@ -22,118 +30,92 @@ namespace MfgFix::MfgConsoleFunc
                 return false;
             }
 
-            auto animData = reinterpret_cast<BSFaceGenAnimationData*>(a_actor->GetFaceGenAnimationData());
-            return animData && animData->dialogueData;
+            Core::FaceSnapshot snapshot;
+            return FaceSnapshots::Read(a_actor, snapshot) && snapshot.dialogue;
         }
-    }
 
-    inline bool SetPhoneme(BSFaceGenAnimationData* animData, std::uint32_t a_id, std::int32_t a_value)
-    {
-        if (!animData) {
-            logger::error("SetPhoneme :: No animdata found");
-            return false;
-        }
-
-        if (a_id > 15) {
-            logger::error("SetPhoneme :: PhonemeId out of range 0-15:id {},value {}", a_id, a_value);
-            return false;
+        // a channel in Papyrus units, 0 past the channels the face has
+        template <std::size_t N>
+        std::int32_t GetChannel(const std::array<float, N>& a_layer, std::uint8_t a_count, std::uint32_t a_id)
+        {
+            return a_id < a_count ? std::lround(a_layer[a_id] * 100.0f) : 0;
         }
-        animData->phoneme2.SetValue(a_id, std::clamp(a_value, 0, 200) / 100.0f);
-        return true;
     }
 
-    inline std::int32_t GetPhoneme(const BSFaceGenAnimationData& animData, std::uint32_t a_id)
+    inline std::string_view GetName(RE::Actor* a_actor)
     {
-        return a_id < animData.phoneme2.count ? std::lround(animData.phoneme2.values[a_id] * 100.0f) : 0;
+        auto base = a_actor->GetActorBase();
+        return base ? base->GetFullName() : "<Unknown>";
     }
 
-    inline bool SetModifier(BSFaceGenAnimationData* animData, std::uint32_t a_id, std::int32_t a_value)
+    // the command a ResetMFGSmooth mode stands for
+    inline std::optional<Core::CommandKind> GetResetCommand(int a_mode)
     {
-        if (!animData) {
-            logger::error("SetModifier :: No animdata found");
-            return false;
-        }
-        if (a_id > 13) {
-            logger::error("SetModifier :: ModifierId is out of range 0-13:id {},value {}", a_id, a_value);
-            return false;
+        switch (a_mode) {
+        case Mode::Reset:
+            return Core::CommandKind::ResetAll;
+        case Mode::Phoneme:
+            return Core::CommandKind::ClearPhonemes;
+        case Mode::Modifier:
+            return Core::CommandKind::ClearModifiers;
+        default:
+            return std::nullopt;
         }
-        animData->modifier2.SetValue(a_id, std::clamp(a_value, 0, 200) / 100.0f);
-
-        return true;
     }
 
-    inline std::int32_t GetModifier(const BSFaceGenAnimationData& animData, std::uint32_t a_id)
+    // a preset of the registry as it's applied, none of ApplyExpressionPreset's scaling
+    inline std::optional<Core::ExpressionPreset> GetNamedPreset(std::string_view a_name)
     {
-        return a_id < animData.modifier2.count ? std::lround(animData.modifier2.values[a_id] * 100.0f) : 0;
+        auto packed = PresetRegistry::Find(a_name);
+        return packed ? Core::MakePreset(Core::Unpack(*packed), false, {}) : std::nullopt;
     }
 
-    inline bool SetExpression(BSFaceGenAnimationData* animData, std::uint32_t a_mood, std::int32_t a_value)
+    bool SetPhonemeModifierSmooth(RE::StaticFunctionTag*, RE::Actor* a_actor, std::int32_t a_mode, std::uint32_t a_id, std::int32_t a_value, float a_speed)
     {
-        if (!animData) {
-            logger::error("SetExpression :: No animdata found");
-            return false;
-        }
-        if (a_mood > 16) {
-            logger::error("SetExpression :: Mood is out of range 0-16:id {}, value {}", a_mood, a_value);
+        if (!a_actor) {
+            logger::error("SetPhonemeModifierSmooth :: No actor selected");
             return false;
         }
 
-        animData->expressionOverride = false;
-        animData->SetExpressionOverride(a_mood, std::clamp(a_value, 0, 200) / 100.0f);
-        animData->expressionOverride = true;
-        return true;
-    }
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::SetPhonemeModifierTask, a_actor->GetFormID());
 
-    std::uint32_t GetActiveExpression(const BSFaceGenAnimationData& a_animData)
-    {
-        std::uint32_t expression = BSFaceGenAnimationData::Expression::MoodNeutral;
+        Core::CommandKind kind;
 
-        for (std::uint32_t i = 0; i < a_animData.expression1.count; ++i) {
-            if (a_animData.expression1.values[i] > a_animData.expression1.values[expression]) {
-                expression = i;
+        switch (a_mode) {
+        case Mode::Reset:
+            kind = Core::CommandKind::ResetOverride;
+            break;
+        case Mode::Phoneme:
+            if (a_id > 15) {
+                logger::error("SetPhoneme :: PhonemeId out of range 0-15:id {},value {}", a_id, a_value);
+                return false;
+            }
+            kind = Core::CommandKind::Phoneme;
+            break;
+        case Mode::Modifier:
+            if (a_id > 13) {
+                logger::error("SetModifier :: ModifierId is out of range 0-13:id {},value {}", a_id, a_value);
+                return false;
             }
+            kind = Core::CommandKind::Modifier;
+            break;
+        case Mode::ExpressionValue:
+            if (a_id > 16) {
+                logger::error("SetExpression :: Mood is out of range 0-16:id {}, value {}", a_id, a_value);
+                return false;
+            }
+            kind = Core::CommandKind::Expression;
+            break;
+        default:
+            return true;
         }
 
-        return expression;
-    }
-
-    bool SetPhonemeModifierSmooth(RE::StaticFunctionTag*, RE::Actor* a_actor, std::int32_t a_mode, std::uint32_t a_id, std::int32_t a_value, float a_speed)
-    {
-        if (!a_actor) {
-            logger::error("SetPhonemeModifierSmooth :: No actor selected");
+        // applied in the face's next update, writes to the same channel before then coalesce
+        if (!FaceCommands::Send(a_actor, kind, a_id, a_value, a_speed)) {
+            logger::error("SetPhonemeModifierSmooth :: No animData found for actor {}", GetName(a_actor));
             return false;
         }
 
-        auto actorPtr = a_actor;
-        SKSE::GetTaskInterface()->AddUITask([actorPtr, a_mode, a_id, a_value, a_speed]() {
-            auto base = actorPtr->GetActorBase();
-            std::string_view name = base ? base->GetFullName() : "<Unknown>";
-            auto animData = reinterpret_cast<BSFaceGenAnimationData*>(actorPtr->GetFaceGenAnimationData());
-            if (!animData) {
-                logger::error("SetPhonemeModifierSmooth [UITask] :: No animData found for actor {}", name);
-                return;
-            }
-            ActorManager::SetSpeed(actorPtr, a_speed);
-            RE::BSSpinLockGuard locker(animData->lock);
-            switch (a_mode) {
-            case -1:
-                animData->ClearExpressionOverride();
-                animData->Reset(0.0f, true, true, true, false);
-                return;
-            case 0:
-                SetPhoneme(animData, a_id, a_value);
-                return;
-            case 1:
-                SetModifier(animData, a_id, a_value);
-                return;
-            case 2:
-                SetExpression(animData, a_id, a_value);
-                return;
-            default:
-                return;
-            }
-        });
-
         return true;
     }
 
@@ -158,24 +140,26 @@ namespace MfgFix::MfgConsoleFunc
             return -1;
         }
 
-        RE::BSSpinLockGuard locker(animData->lock);
+        // what the last update published, the face lock is only taken for a face that hasn't published yet
+        Core::FaceSnapshot snapshot;
+        FaceSnapshots::Read(a_actor, snapshot);
 
         switch (a_mode) {
         case Mode::Phoneme:
             {
-                return a_id < animData->phoneme2.count ? std::lround(animData->phoneme2.values[a_id] * 100.0f) : 0;
+                return GetChannel(snapshot.phonemes[1], snapshot.phonemeCount[1], a_id);
             }
         case Mode::Modifier:
             {
-                return a_id < animData->modifier2.count ? std::lround(animData->modifier2.values[a_id] * 100.0f) : 0;
+                return GetChannel(snapshot.modifiers[1], snapshot.modifierCount[1], a_id);
             }
         case Mode::ExpressionValue:
             {
-                return a_id < animData->expression1.count ? std::lround(animData->expression1.values[a_id] * 100.0f) : 0;
+                return GetChannel(snapshot.expressions[0], snapshot.expressionCount[0], a_id);
             }
         case Mode::ExpressionId:
             {
-                return GetActiveExpression(*animData);
+                return Core::ActiveExpression(std::span<const float>(snapshot.expressions[0]).first(snapshot.expressionCount[0]));
             }
         }
 
@@ -189,38 +173,68 @@ namespace MfgFix::MfgConsoleFunc
             return false;
         }
 
-        auto actorPtr = a_actor;
-        SKSE::GetTaskInterface()->AddUITask([actorPtr, a_mode, a_speed]() {
-            constexpr int kPhonemeCount = 16;
-            constexpr int kModifierCount = 14;
+        auto command = GetResetCommand(a_mode);
+        if (!command) {
+            logger::warn("ResetMFGSmooth: unexpected mode value {}", a_mode);
+            return false;
+        }
+
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::ResetMFGTask, a_actor->GetFormID());
 
-            auto base = actorPtr->GetActorBase();
-            std::string_view name = base ? base->GetFullName() : "<Unknown>";
-            auto animData = reinterpret_cast<BSFaceGenAnimationData*>(actorPtr->GetFaceGenAnimationData());
-            if (!animData) {
-                logger::error("ResetMFGSmooth [UITask] :: No animData found for actor {}", name);
-                return;
+        if (!FaceCommands::Send(a_actor, *command, 0, 0, a_speed)) {
+            logger::error("ResetMFGSmooth :: No animData found for actor {}", GetName(a_actor));
+            return false;
+        }
+
+        return true;
+    }
+
+    // all actors get the reset in the same frame, their next update
+    bool ResetMfgActors(RE::StaticFunctionTag*, std::vector<RE::Actor*> a_actors, int a_mode, float a_speed)
+    {
+        auto actors = Core::UniqueTargets(std::span<RE::Actor* const>(a_actors));
+        if (actors.empty()) {
+            logger::error("ResetMfgActors :: No actor selected");
+            return false;
+        }
+
+        auto command = GetResetCommand(a_mode);
+        if (!command) {
+            logger::warn("ResetMfgActors: unexpected mode value {}", a_mode);
+            return false;
+        }
+
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::ResetMFGTask, 0);
+
+        for (auto actor : actors) {
+            if (!FaceCommands::Send(actor, *command, 0, 0, a_speed)) {
+                logger::error("ResetMfgActors :: No animData found for actor {}", GetName(actor));
             }
-            ActorManager::SetSpeed(actorPtr, a_speed);
-            RE::BSSpinLockGuard locker(animData->lock);
-
-            switch (a_mode) {
-            case -1:
-                for (int m = 0; m < kModifierCount; ++m) SetModifier(animData, m, 0);
-                for (int p = 0; p < kPhonemeCount; ++p) SetPhoneme(animData, p, 0);
-                SetExpression(animData, GetActiveExpression(*animData), 0);
-                animData->ClearExpressionOverride();
-                animData->Reset(0.0f, true, true, true, false);
-                break;
-            case 0:
-                for (int p = 0; p < kPhonemeCount; ++p) SetPhoneme(animData, p, 0);
-                break;
-            case 1:
-                for (int m = 0; m < kModifierCount; ++m) SetModifier(animData, m, 0);
-                break;
-            default:
-                logger::warn("ResetMFGSmooth: unexpected mode value {}", a_mode);
-                break;
+        }
+
+        return true;
+    }
+
+    // the actors are picked in a task, their faces get the reset in their next update
+    bool ResetMfgInRadius(RE::StaticFunctionTag*, RE::TESObjectREFR* a_center, float a_radius, RE::TESFaction* a_faction, int a_mode, float a_speed)
+    {
+        if (!a_center || a_radius <= 0.0f) {
+            logger::error("ResetMfgInRadius :: No center or radius given");
+            return false;
+        }
+
+        auto command = GetResetCommand(a_mode);
+        if (!command) {
+            logger::warn("ResetMfgInRadius: unexpected mode value {}", a_mode);
+            return false;
+        }
+
+        auto centerPtr = a_center;
+        SKSE::GetTaskInterface()->AddUITask([centerPtr, a_radius, a_faction, command = *command, a_speed]() {
+            Core::TimelineScope scope(HookTimeline::Active(), Core::Span::ResetMFGTask, centerPtr->GetFormID());
+
+            for (auto actor : ActorManager::GetActorsInRange(centerPtr, a_radius, a_faction)) {
+                FaceCommands::Send(actor, command, 0, 0, a_speed);
             }
         });
         return true;
@@ -258,61 +272,237 @@ namespace MfgFix::MfgConsoleFunc
             return false;
         }
 
-        constexpr size_t kExpectedSize = 32;
-        if (a_expression.size() != kExpectedSize) {
-            logger::error("ApplyExpressionPreset :: Expression vector incorrect size: {}, expected: {}", a_expression.size(), kExpectedSize);
+        auto preset = Core::MakePreset(a_expression, a_openMouth, { exprPower, exprStrModifier, modStrModifier, phStrModifier });
+        if (!preset) {
+            logger::error("ApplyExpressionPreset :: Expression vector incorrect size: {}, expected: {}", a_expression.size(), Core::kPresetSize);
             return false;
         }
 
-        // Extract key values outside the task for safety
-        const auto exprNum = static_cast<int>(a_expression[30]);
-        int exprStrResult = static_cast<int>(std::round(a_expression[31] * 100.0f * exprStrModifier));
-        if (exprNum > 0 && exprStrResult == 0) {
-            exprStrResult = exprPower;
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::ApplyExpressionPresetTask, a_actor->GetFormID());
+
+        if (!FaceCommands::SendPreset({ &a_actor, 1 }, *preset, a_speed)) {
+            logger::error("ApplyExpressionPreset :: No animData found for actor {}", GetName(a_actor));
+            return false;
         }
 
-        // Copy by value for safe lambda capture
-        auto expressionCopy = a_expression;
-        auto actorPtr = a_actor;
+        return true;
+    }
 
-        // Schedule a safe, thread-aware update
-        SKSE::GetTaskInterface()->AddUITask([actorPtr, expressionCopy, a_openMouth, exprNum, exprStrResult, modStrModifier, phStrModifier, a_speed]() {
-            auto base = actorPtr->GetActorBase();
-            std::string_view name = base ? base->GetFullName() : "<Unknown>";
+    // the preset is scaled and stored once for all actors, their faces take it in their next update
+    bool ApplyExpressionPresetToActors(RE::StaticFunctionTag*, std::vector<RE::Actor*> a_actors, std::vector<float> a_expression, bool a_openMouth, int exprPower, float exprStrModifier, float modStrModifier, float phStrModifier, float a_speed)
+    {
+        auto preset = Core::MakePreset(a_expression, a_openMouth, { exprPower, exprStrModifier, modStrModifier, phStrModifier });
+        if (!preset) {
+            logger::error("ApplyExpressionPresetToActors :: Expression vector incorrect size: {}, expected: {}", a_expression.size(), Core::kPresetSize);
+            return false;
+        }
 
-            auto animData = reinterpret_cast<BSFaceGenAnimationData*>(actorPtr->GetFaceGenAnimationData());
-            if (!animData) {
-                logger::error("ApplyExpressionPreset [UITask] :: No animData found for actor {}", name);
-                return;
-            }
+        auto actors = Core::UniqueTargets(std::span<RE::Actor* const>(a_actors));
+        if (actors.empty()) {
+            logger::error("ApplyExpressionPresetToActors :: No actor selected");
+            return false;
+        }
 
-            ActorManager::SetSpeed(actorPtr, a_speed);
-            RE::BSSpinLockGuard locker(animData->lock);
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::ApplyExpressionPresetTask, 0);
 
-            SetExpression(animData, exprNum, exprStrResult);
+        if (auto sent = FaceCommands::SendPreset(actors, *preset, a_speed); sent < actors.size()) {
+            logger::error("ApplyExpressionPresetToActors :: No animData found for {} of {} actors", actors.size() - sent, actors.size());
+        }
 
-            if (!a_openMouth) {
-                for (int i = 0; i <= 15; ++i) {
-                    int currentVal = GetPhoneme(*animData, i);
-                    int targetIntVal = static_cast<int>(std::round(expressionCopy[i] * 100.0f * phStrModifier));
-                    if (currentVal != targetIntVal) {
-                        SetPhoneme(animData, i, targetIntVal);
-                    }
-                }
+        return true;
+    }
+
+    bool ApplyExpressionPresetInRadius(RE::StaticFunctionTag*, RE::TESObjectREFR* a_center, float a_radius, RE::TESFaction* a_faction, std::vector<float> a_expression, bool a_openMouth, int exprPower, float exprStrModifier, float modStrModifier, float phStrModifier, float a_speed)
+    {
+        if (!a_center || a_radius <= 0.0f) {
+            logger::error("ApplyExpressionPresetInRadius :: No center or radius given");
+            return false;
+        }
+
+        auto preset = Core::MakePreset(a_expression, a_openMouth, { exprPower, exprStrModifier, modStrModifier, phStrModifier });
+        if (!preset) {
+            logger::error("ApplyExpressionPresetInRadius :: Expression vector incorrect size: {}, expected: {}", a_expression.size(), Core::kPresetSize);
+            return false;
+        }
+
+        auto centerPtr = a_center;
+        SKSE::GetTaskInterface()->AddUITask([centerPtr, a_radius, a_faction, preset = *preset, a_speed]() {
+            Core::TimelineScope scope(HookTimeline::Active(), Core::Span::ApplyExpressionPresetTask, centerPtr->GetFormID());
+
+            FaceCommands::SendPreset(ActorManager::GetActorsInRange(centerPtr, a_radius, a_faction), preset, a_speed);
+        });
+
+        return true;
+    }
+
+    bool ApplyNamedPreset(RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_name, float a_speed)
+    {
+        if (!a_actor) {
+            logger::error("ApplyNamedPreset :: No actor selected");
+            return false;
+        }
+
+        auto preset = GetNamedPreset(a_name);
+        if (!preset) {
+            logger::error("ApplyNamedPreset :: No preset named '{}'", a_name.c_str());
+            return false;
+        }
+
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::ApplyExpressionPresetTask, a_actor->GetFormID());
+
+        if (!FaceCommands::SendPreset({ &a_actor, 1 }, *preset, a_speed)) {
+            logger::error("ApplyNamedPreset :: No animData found for actor {}", GetName(a_actor));
+            return false;
+        }
+
+        return true;
+    }
+
+    bool CapturePreset(RE::StaticFunctionTag*, RE::Actor* a_actor, RE::BSFixedString a_name)
+    {
+        if (!a_actor || a_name.empty()) {
+            logger::error("CapturePreset :: No actor or name given");
+            return false;
+        }
+
+        if (!PresetRegistry::Capture(a_actor, a_name)) {
+            logger::error("CapturePreset :: No animData found for actor {}", GetName(a_actor));
+            return false;
+        }
+
+        return true;
+    }
+
+    // a face in one call instead of 32 GetPhonemeModifier calls, read from its snapshot without the face lock
+    std::vector<float> GetExpressionState(RE::StaticFunctionTag*, RE::Actor* a_actor, std::int32_t a_layer)
+    {
+        if (!a_actor) {
+            logger::error("GetExpressionState :: No actor selected");
+            return {};
+        }
+
+        if (a_layer < static_cast<std::int32_t>(Core::SnapshotLayer::Dialogue) || a_layer > static_cast<std::int32_t>(Core::SnapshotLayer::Output)) {
+            logger::error("GetExpressionState :: Layer {} out of range", a_layer);
+            return {};
+        }
+
+        Core::FaceSnapshot snapshot;
+        if (!FaceSnapshots::Read(a_actor, snapshot)) {
+            logger::error("GetExpressionState :: No animData found for actor {}", GetName(a_actor));
+            return {};
+        }
+
+        auto values = Core::ToPreset(snapshot, static_cast<Core::SnapshotLayer>(a_layer));
+
+        return { values.begin(), values.end() };
+    }
+
+    // the sequence is played by the face's update, interpolated between the keys every frame
+    bool PlayExpressionSequence(RE::StaticFunctionTag*, RE::Actor* a_actor, std::vector<float> a_times, std::vector<std::int32_t> a_modes, std::vector<std::int32_t> a_ids, std::vector<std::int32_t> a_values, float a_duration, bool a_loop, float a_ttl, RE::BSFixedString a_next, float a_speed)
+    {
+        if (!a_actor) {
+            logger::error("PlayExpressionSequence :: No actor selected");
+            return false;
+        }
+
+        if (a_times.empty() || a_modes.size() != a_times.size() || a_ids.size() != a_times.size() || a_values.size() != a_times.size()) {
+            logger::error("PlayExpressionSequence :: Key arrays empty or of different sizes: {}, {}, {}, {}", a_times.size(), a_modes.size(), a_ids.size(), a_values.size());
+            return false;
+        }
+
+        std::vector<Core::SequenceKey> keys;
+        keys.reserve(a_times.size());
+
+        for (std::size_t i = 0; i < a_times.size(); ++i) {
+            static constexpr std::int32_t kIds[] = { Core::Phoneme::Total, Core::kPresetModifiers, Core::Expression::Total };
+
+            auto mode = a_modes[i];
+            if (mode < Mode::Phoneme || mode > Mode::ExpressionValue || a_ids[i] < 0 || a_ids[i] >= kIds[mode] || !(a_times[i] >= 0.0f)) {
+                logger::error("PlayExpressionSequence :: Key {} out of range: time {}, mode {}, id {}", i, a_times[i], mode, a_ids[i]);
+                return false;
             }
 
-            for (int i = 16, m = 0; i <= 29; ++i, ++m) {
-                int currentVal = GetModifier(*animData, m);
-                int targetIntVal = static_cast<int>(std::round(expressionCopy[i] * 100.0f * modStrModifier));
-                if (currentVal != targetIntVal) {
-                    SetModifier(animData, m, targetIntVal);
-                }
+            keys.push_back({ a_times[i], static_cast<Core::SequenceChannel>(mode), static_cast<std::uint8_t>(a_ids[i]), a_values[i] });
+        }
+
+        auto next = GetNamedPreset(a_next);
+        if (!next && !a_next.empty()) {
+            logger::error("PlayExpressionSequence :: No preset named '{}'", a_next.c_str());
+            return false;
+        }
+
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::FaceSequences, a_actor->GetFormID());
+
+        auto sequence = std::make_shared<const Core::Sequence>(Core::MakeSequence(std::move(keys), a_duration, a_loop, a_ttl, next));
+
+        if (!FaceSequences::Play(a_actor, std::move(sequence), a_speed)) {
+            logger::error("PlayExpressionSequence :: No animData found for actor {}", GetName(a_actor));
+            return false;
+        }
+
+        return true;
+    }
+
+    // named presets as keys, every channel of them
+    bool PlayPresetSequence(RE::StaticFunctionTag*, RE::Actor* a_actor, std::vector<RE::BSFixedString> a_presets, std::vector<float> a_times, float a_duration, bool a_loop, float a_ttl, RE::BSFixedString a_next, float a_speed)
+    {
+        if (!a_actor) {
+            logger::error("PlayPresetSequence :: No actor selected");
+            return false;
+        }
+
+        if (a_presets.empty() || a_presets.size() != a_times.size()) {
+            logger::error("PlayPresetSequence :: Preset and time arrays empty or of different sizes: {}, {}", a_presets.size(), a_times.size());
+            return false;
+        }
+
+        std::vector<Core::SequenceKey> keys;
+        keys.reserve(a_presets.size() * Core::kPresetSize);
+
+        for (std::size_t i = 0; i < a_presets.size(); ++i) {
+            auto preset = GetNamedPreset(a_presets[i]);
+            if (!preset || !(a_times[i] >= 0.0f)) {
+                logger::error("PlayPresetSequence :: Key {} invalid: preset '{}', time {}", i, a_presets[i].c_str(), a_times[i]);
+                return false;
             }
-        });
+
+            Core::AppendPresetKeys(keys, a_times[i], *preset);
+        }
+
+        auto next = GetNamedPreset(a_next);
+        if (!next && !a_next.empty()) {
+            logger::error("PlayPresetSequence :: No preset named '{}'", a_next.c_str());
+            return false;
+        }
+
+        Core::TimelineScope scope(HookTimeline::Active(), Core::Span::FaceSequences, a_actor->GetFormID());
+
+        auto sequence = std::make_shared<const Core::Sequence>(Core::MakeSequence(std::move(keys), a_duration, a_loop, a_ttl, next));
+
+        if (!FaceSequences::Play(a_actor, std::move(sequence), a_speed)) {
+            logger::error("PlayPresetSequence :: No animData found for actor {}", GetName(a_actor));
+            return false;
+        }
 
         return true;
     }
 
+    bool StopExpressionSequence(RE::StaticFunctionTag*, RE::Actor* a_actor, bool a_reset, float a_speed)
+    {
+        if (!a_actor) {
+            logger::error("StopExpressionSequence :: No actor selected");
+            return false;
+        }
+
+        auto stopped = FaceSequences::Stop(a_actor);
+
+        if (a_reset) {
+            FaceCommands::Send(a_actor, Core::CommandKind::ResetAll, 0, 0, a_speed);
+        }
+
+        return stopped;
+    }
+
 
     RE::Actor* GetPlayerSpeechTarget(RE::StaticFunctionTag*)
     {
@@ -339,17 +529,33 @@ namespace MfgFix::MfgConsoleFunc
         return IsInDialogue(a_actor);
     }
 
+    RE::BSFixedString GetStats(RE::StaticFunctionTag*)
+    {
+        return HookStats::Report();
+    }
+
 
     void Register()
     {
         SKSE::GetPapyrusInterface()->Register([](RE::BSScript::IVirtualMachine* a_vm) {
-            a_vm->RegisterFunction("SetPhonemeModifierSmooth", "MfgConsoleFuncExt", SetPhonemeModifierSmooth);
-            a_vm->RegisterFunction("SetPhonemeModifier", "MfgConsoleFunc", SetPhonemeModifier);
-            a_vm->RegisterFunction("GetPhonemeModifier", "MfgConsoleFunc", GetPhonemeModifier);
-            a_vm->RegisterFunction("ResetMFGSmooth", "MfgConsoleFuncExt", ResetMFGSmooth);
-            a_vm->RegisterFunction("ApplyExpressionPreset", "MfgConsoleFuncExt", ApplyExpressionPreset);
-            a_vm->RegisterFunction("GetPlayerSpeechTarget", "MfgConsoleFuncExt", GetPlayerSpeechTarget);
-            a_vm->RegisterFunction("IsInDialogue", "MfgConsoleFuncExt", IsInDialoguePapyrus);
+            HookStats::RegisterFunction<SetPhonemeModifierSmooth>(a_vm, "SetPhonemeModifierSmooth", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<SetPhonemeModifier>(a_vm, "SetPhonemeModifier", "MfgConsoleFunc");
+            HookStats::RegisterFunction<GetPhonemeModifier>(a_vm, "GetPhonemeModifier", "MfgConsoleFunc");
+            HookStats::RegisterFunction<ResetMFGSmooth>(a_vm, "ResetMFGSmooth", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<ApplyExpressionPreset>(a_vm, "ApplyExpressionPreset", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<ApplyExpressionPresetToActors>(a_vm, "ApplyExpressionPresetToActors", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<ApplyExpressionPresetInRadius>(a_vm, "ApplyExpressionPresetInRadius", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<ResetMfgActors>(a_vm, "ResetMfgActors", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<ResetMfgInRadius>(a_vm, "ResetMfgInRadius", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<ApplyNamedPreset>(a_vm, "ApplyNamedPreset", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<CapturePreset>(a_vm, "CapturePreset", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<GetExpressionState>(a_vm, "GetExpressionState", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<PlayExpressionSequence>(a_vm, "PlayExpressionSequence", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<PlayPresetSequence>(a_vm, "PlayPresetSequence", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<StopExpressionSequence>(a_vm, "StopExpressionSequence", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<GetPlayerSpeechTarget>(a_vm, "GetPlayerSpeechTarget", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<IsInDialoguePapyrus>(a_vm, "IsInDialogue", "MfgConsoleFuncExt");
+            HookStats::RegisterFunction<GetStats>(a_vm, "GetStats", "MfgConsoleFuncExt");
             return true;
         });
     }
@@ -0,0 +1,126 @@
+#include "PresetRegistry.h"
+#include "FaceSnapshots.h"
+#include "core/Published.h"
+#include "core/Trace.h"
+
+namespace MfgFix::PresetRegistry
+{
+    namespace
+    {
+        std::filesystem::path GetDirectory()
+        {
+            wchar_t buf[4096] = L"";
+
+            std::uint32_t size = GetModuleFileNameW(NULL, buf, static_cast<DWORD>(std::size(buf)));
+
+            if (size == 0 || size == std::size(buf)) {
+                return "";
+            }
+
+            std::filesystem::path path{ buf };
+
+            return path.replace_filename(L"Data\\SKSE\\Plugins\\mfgfix");
+        }
+
+        Core::Published<Core::PresetTable>& GetPublished()
+        {
+            static Core::Published<Core::PresetTable> published;
+
+            return published;
+        }
+
+        // what captured.json holds, written back whole on every capture
+        struct Captured
+        {
+            std::mutex lock;
+            Core::PresetTable table;
+        };
+
+        Captured& GetCaptured()
+        {
+            static Captured captured;
+
+            return captured;
+        }
+
+        std::filesystem::path GetCapturedPath()
+        {
+            auto directory = GetDirectory();
+
+            return directory.empty() ? directory : directory / L"presets" / L"captured.json";
+        }
+    }
+
+    void Load()
+    {
+        auto directory = GetDirectory();
+
+        if (directory.empty()) {
+            return;
+        }
+
+        Core::PresetLoad load;
+        auto table = Core::LoadPresets(directory / L"presets", directory / L"presets.bin", load);
+
+        for (auto& error : load.errors) {
+            logger::warn("expression presets :: {}", error);
+        }
+
+        logger::info("{} expression presets from {} files{}", table.Size(), load.files, load.cached ? ", cached" : "");
+
+        GetPublished().Publish(std::move(table));
+
+        // earlier captures, kept when new ones are written
+        Core::MappedFile file;
+        if (file.Open(GetCapturedPath())) {
+            auto data = file.Data();
+            auto parse = Core::ParsePresets({ reinterpret_cast<const char*>(data.data()), data.size() });
+
+            std::lock_guard locker(GetCaptured().lock);
+            GetCaptured().table = Core::PresetTable(std::move(parse.presets));
+        }
+    }
+
+    std::optional<Core::PackedPreset> Find(std::string_view a_name)
+    {
+        auto table = GetPublished().Get();
+        auto preset = table->Find(a_name);
+
+        return preset ? std::optional(*preset) : std::nullopt;
+    }
+
+    bool Capture(RE::Actor* a_actor, std::string_view a_name)
+    {
+        Core::FaceSnapshot snapshot;
+        if (!FaceSnapshots::Read(a_actor, snapshot)) {
+            return false;
+        }
+
+        auto preset = Core::Pack(Core::ToPreset(snapshot, Core::SnapshotLayer::Script));
+
+        GetPublished().Update([&](Core::PresetTable& a_table) { a_table.Set(a_name, preset); });
+
+        auto& captured = GetCaptured();
+        std::lock_guard locker(captured.lock);
+
+        captured.table.Set(a_name, preset);
+
+        auto path = GetCapturedPath();
+        if (path.empty()) {
+            return true;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        std::ofstream file(path, std::ios::trunc | std::ios::binary);
+        if (!file) {
+            logger::error("CapturePreset :: Can't write {}", path.string());
+            return true;
+        }
+
+        file << Core::FormatPresets(captured.table);
+
+        return true;
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "core/Presets.h"
+
+namespace MfgFix::PresetRegistry
+{
+    // the presets of Data/SKSE/Plugins/mfgfix/presets/*.json, through presets.bin next to the folder while it's current
+    void Load();
+
+    // a copy, the table may be replaced by a capture meanwhile
+    std::optional<Core::PackedPreset> Find(std::string_view a_name);
+
+    // the script layers of a_actor's face stored as a_name, and written to captured.json in the presets folder
+    // so it's there next session too
+    bool Capture(RE::Actor* a_actor, std::string_view a_name);
+}
@@ -1,12 +1,31 @@
 #pragma once
 
+#include "core/Channels.h"
+#include "core/Eyes.h"
+#include "core/Lod.h"
+#include "core/Transition.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
 namespace MfgFix
 {
+    struct SettingsSnapshot;
+
     struct Settings
     {
         struct Transition
         {
             float fDefaultSpeed{ 0.0f };
+            bool bPlannedTransitions{ false };
+            float fPhonemeDuration{ 0.6f };
+            float fModifierDuration{ 1.0f };
+            float fExpressionDuration{ 1.0f };
+            float fEaseCurve{ 1.0f };
         };
 
         struct EyesBlinking
@@ -21,67 +40,87 @@ namespace MfgFix
         {
             float fTrackSpeed{ 5.0f };
             float fTrackEyeXY{ 28.0f };
-            float fTrackEyeZ{ 20.0f };
+            float fTrackEyeZ{ 40.0f };
             float fEyeHeadingMinOffsetEmotionAngry{ -0.05f };
             float fEyeHeadingMaxOffsetEmotionAngry{ 0.05f };
             float fEyePitchMinOffsetEmotionAngry{ -0.05f };
             float fEyePitchMaxOffsetEmotionAngry{ 0.1f };
             float fEyeOffsetDelayMinEmotionAngry{ 0.5f };
             float fEyeOffsetDelayMaxEmotionAngry{ 3.0f };
+            float fEyeOffsetDelayExponentEmotionAngry{ 2.0f };
+            float fEyeOffsetZeroChanceEmotionAngry{ 0.0f };
             float fEyeHeadingMinOffsetEmotionHappy{ -0.1f };
             float fEyeHeadingMaxOffsetEmotionHappy{ 0.1f };
             float fEyePitchMinOffsetEmotionHappy{ -0.05f };
             float fEyePitchMaxOffsetEmotionHappy{ 0.1f };
             float fEyeOffsetDelayMinEmotionHappy{ 0.5f };
             float fEyeOffsetDelayMaxEmotionHappy{ 4.0f };
+            float fEyeOffsetDelayExponentEmotionHappy{ 0.5f };
+            float fEyeOffsetZeroChanceEmotionHappy{ 0.0f };
             float fEyeHeadingMinOffsetEmotionSurprise{ -0.1f };
             float fEyeHeadingMaxOffsetEmotionSurprise{ 0.1f };
             float fEyePitchMinOffsetEmotionSurprise{ -0.05f };
             float fEyePitchMaxOffsetEmotionSurprise{ 0.1f };
             float fEyeOffsetDelayMinEmotionSurprise{ 0.5f };
             float fEyeOffsetDelayMaxEmotionSurprise{ 4.0f };
+            float fEyeOffsetDelayExponentEmotionSurprise{ 0.5f };
+            float fEyeOffsetZeroChanceEmotionSurprise{ 0.0f };
             float fEyeHeadingMinOffsetEmotionSad{ -0.1f };
             float fEyeHeadingMaxOffsetEmotionSad{ 0.1f };
             float fEyePitchMinOffsetEmotionSad{ -0.05f };
             float fEyePitchMaxOffsetEmotionSad{ -0.015f };
             float fEyeOffsetDelayMinEmotionSad{ 2.0f };
             float fEyeOffsetDelayMaxEmotionSad{ 3.0f };
+            float fEyeOffsetDelayExponentEmotionSad{ 1.0f };
+            float fEyeOffsetZeroChanceEmotionSad{ 0.0f };
             float fEyeHeadingMinOffsetEmotionFear{ -0.1f };
             float fEyeHeadingMaxOffsetEmotionFear{ 0.1f };
             float fEyePitchMinOffsetEmotionFear{ 0.01f };
             float fEyePitchMaxOffsetEmotionFear{ 0.01f };
             float fEyeOffsetDelayMinEmotionFear{ 0.5f };
             float fEyeOffsetDelayMaxEmotionFear{ 1.5f };
+            float fEyeOffsetDelayExponentEmotionFear{ 1.0f };
+            float fEyeOffsetZeroChanceEmotionFear{ 0.5f };
             float fEyeHeadingMinOffsetEmotionNeutral{ -0.1f };
             float fEyeHeadingMaxOffsetEmotionNeutral{ 0.1f };
             float fEyePitchMinOffsetEmotionNeutral{ -0.025f };
             float fEyePitchMaxOffsetEmotionNeutral{ 0.1f };
             float fEyeOffsetDelayMinEmotionNeutral{ 0.5f };
             float fEyeOffsetDelayMaxEmotionNeutral{ 4.0f };
+            float fEyeOffsetDelayExponentEmotionNeutral{ 2.0f };
+            float fEyeOffsetZeroChanceEmotionNeutral{ 0.0f };
             float fEyeHeadingMinOffsetEmotionPuzzled{ 0.0f };
             float fEyeHeadingMaxOffsetEmotionPuzzled{ 0.0f };
             float fEyePitchMinOffsetEmotionPuzzled{ 0.0f };
             float fEyePitchMaxOffsetEmotionPuzzled{ 0.0f };
             float fEyeOffsetDelayMinEmotionPuzzled{ 3.0f };
             float fEyeOffsetDelayMaxEmotionPuzzled{ 3.0f };
+            float fEyeOffsetDelayExponentEmotionPuzzled{ 1.0f };
+            float fEyeOffsetZeroChanceEmotionPuzzled{ 0.0f };
             float fEyeHeadingMinOffsetEmotionDisgusted{ 0.0f };
             float fEyeHeadingMaxOffsetEmotionDisgusted{ 0.0f };
             float fEyePitchMinOffsetEmotionDisgusted{ 0.0f };
             float fEyePitchMaxOffsetEmotionDisgusted{ 0.0f };
             float fEyeOffsetDelayMinEmotionDisgusted{ 3.0f };
             float fEyeOffsetDelayMaxEmotionDisgusted{ 3.0f };
+            float fEyeOffsetDelayExponentEmotionDisgusted{ 1.0f };
+            float fEyeOffsetZeroChanceEmotionDisgusted{ 0.0f };
             float fEyeHeadingMinOffsetEmotionCombatAnger{ 0.0f };
             float fEyeHeadingMaxOffsetEmotionCombatAnger{ 0.0f };
             float fEyePitchMinOffsetEmotionCombatAnger{ 0.0f };
             float fEyePitchMaxOffsetEmotionCombatAnger{ 0.0f };
             float fEyeOffsetDelayMinEmotionCombatAnger{ 3.0f };
             float fEyeOffsetDelayMaxEmotionCombatAnger{ 3.0f };
+            float fEyeOffsetDelayExponentEmotionCombatAnger{ 1.0f };
+            float fEyeOffsetZeroChanceEmotionCombatAnger{ 0.0f };
             float fEyeHeadingMinOffsetEmotionCombatShout{ 0.0f };
             float fEyeHeadingMaxOffsetEmotionCombatShout{ 0.0f };
             float fEyePitchMinOffsetEmotionCombatShout{ 0.0f };
             float fEyePitchMaxOffsetEmotionCombatShout{ 0.0f };
             float fEyeOffsetDelayMinEmotionCombatShout{ 3.0f };
             float fEyeOffsetDelayMaxEmotionCombatShout{ 3.0f };
+            float fEyeOffsetDelayExponentEmotionCombatShout{ 1.0f };
+            float fEyeOffsetZeroChanceEmotionCombatShout{ 0.0f };
         };
 
         struct Dialogue
@@ -89,14 +128,290 @@ namespace MfgFix
             float fDialoguePhonemeThreshold{ 50.0f };
         };
 
-        static Settings& Get();
+        struct Performance
+        {
+            bool bSkipIdleFaces{ false };
+            float fFrameBudget{ 0.0f };
+            bool bUnlockedUpdate{ false };
+            bool bDeferOnContention{ false };
+        };
+
+        struct Lod
+        {
+            bool bEnableLod{ false };
+            float fLodRefreshInterval{ 0.5f };
+            float fLodMidDistance{ 1000.0f };
+            float fLodMidScreenSize{ 0.08f };
+            float fLodMidInterval{ 2.0f };
+            bool bLodMidBlink{ true };
+            bool bLodMidSaccades{ true };
+            bool bLodMidSmoothing{ true };
+            float fLodFarDistance{ 2500.0f };
+            float fLodFarScreenSize{ 0.04f };
+            float fLodFarInterval{ 4.0f };
+            bool bLodFarBlink{ true };
+            bool bLodFarSaccades{ false };
+            bool bLodFarSmoothing{ true };
+            float fLodDistantDistance{ 4200.0f };
+            float fLodDistantScreenSize{ 0.02f };
+            float fLodDistantInterval{ 8.0f };
+            bool bLodDistantBlink{ true };
+            bool bLodDistantSaccades{ false };
+            bool bLodDistantSmoothing{ false };
+        };
+
+        struct Debug
+        {
+            bool bDeterministicRandom{ false };
+            bool bCollectStats{ false };
+            float fStatsExportInterval{ 0.0f };
+            bool bRecordTimeline{ false };
+        };
 
+        // settings in use, the snapshot stays valid for as long as it's held
+        static std::shared_ptr<const SettingsSnapshot> Current();
+
+        // the settings as the calling thread last read them, refreshed after a change; for the update hook,
+        // valid until the thread calls it again
+        static const SettingsSnapshot& CurrentForThread();
+
+        // applies a_func to a copy of the current settings and publishes the result
+        static void Update(const std::function<void(Settings&)>& a_func);
+
+        // from/to mfgfix.ini next to the game executable
         void Read();
-        void Write();
+        void Write() const;
+
+        // from/to an already loaded ini (CSimpleIniA), missing keys keep their current value
+        template <class Ini>
+        void Read(const Ini& a_ini);
+        template <class Ini>
+        void Write(Ini& a_ini) const;
 
         Transition transition;
         EyesBlinking eyesBlinking;
         EyesMovement eyesMovement;
         Dialogue dialogue;
+        Performance performance;
+        Lod lod;
+        Debug debug;
+    };
+
+    // one entry per ini value, drives Settings::Read/Write and the MFGFIX_Settings natives
+    struct SettingDescriptor
+    {
+        enum class Type
+        {
+            Float,
+            Bool
+        };
+
+        const char* section;
+        const char* key;
+        Type type;
+        float (*get)(const Settings&);
+        void (*set)(Settings&, float);
+    };
+
+    namespace detail
+    {
+        template <auto Group, auto Value>
+        constexpr SettingDescriptor MakeSettingDescriptor(const char* a_section, const char* a_key)
+        {
+            using value_type = std::remove_cvref_t<decltype(std::declval<Settings&>().*Group.*Value)>;
+
+            return {
+                a_section,
+                a_key,
+                std::is_same_v<value_type, bool> ? SettingDescriptor::Type::Bool : SettingDescriptor::Type::Float,
+                [](const Settings& a_settings) { return static_cast<float>(a_settings.*Group.*Value); },
+                [](Settings& a_settings, float a_value) { a_settings.*Group.*Value = static_cast<value_type>(a_value); }
+            };
+        }
+    }
+
+#define MFGFIX_SETTING(a_member, a_section, a_key) detail::MakeSettingDescriptor<&Settings::a_member, &Settings::a_section::a_key>(#a_section, #a_key)
+
+    // ini and GetAllSettings order
+    inline constexpr std::array kSettingDescriptors{
+        MFGFIX_SETTING(transition, Transition, fDefaultSpeed),
+        MFGFIX_SETTING(transition, Transition, bPlannedTransitions),
+        MFGFIX_SETTING(transition, Transition, fPhonemeDuration),
+        MFGFIX_SETTING(transition, Transition, fModifierDuration),
+        MFGFIX_SETTING(transition, Transition, fExpressionDuration),
+        MFGFIX_SETTING(transition, Transition, fEaseCurve),
+        MFGFIX_SETTING(eyesBlinking, EyesBlinking, fBlinkDownTime),
+        MFGFIX_SETTING(eyesBlinking, EyesBlinking, fBlinkUpTime),
+        MFGFIX_SETTING(eyesBlinking, EyesBlinking, fBlinkDelayMin),
+        MFGFIX_SETTING(eyesBlinking, EyesBlinking, fBlinkDelayMax),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fTrackSpeed),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fTrackEyeXY),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fTrackEyeZ),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionAngry),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionAngry),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionAngry),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionAngry),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionAngry),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionAngry),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionAngry),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionAngry),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionHappy),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionHappy),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionHappy),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionHappy),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionHappy),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionHappy),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionHappy),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionHappy),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionSurprise),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionSurprise),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionSurprise),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionSurprise),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionSurprise),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionSurprise),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionSurprise),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionSurprise),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionSad),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionSad),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionSad),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionSad),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionSad),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionSad),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionSad),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionSad),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionFear),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionFear),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionFear),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionFear),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionFear),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionFear),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionFear),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionFear),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionNeutral),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionNeutral),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionNeutral),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionNeutral),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionNeutral),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionNeutral),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionNeutral),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionNeutral),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionPuzzled),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionPuzzled),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionPuzzled),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionPuzzled),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionPuzzled),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionPuzzled),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionPuzzled),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionPuzzled),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionDisgusted),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionDisgusted),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionDisgusted),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionDisgusted),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionDisgusted),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionDisgusted),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionDisgusted),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionDisgusted),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionCombatAnger),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionCombatAnger),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionCombatAnger),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionCombatAnger),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionCombatAnger),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionCombatAnger),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionCombatAnger),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionCombatAnger),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMinOffsetEmotionCombatShout),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeHeadingMaxOffsetEmotionCombatShout),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMinOffsetEmotionCombatShout),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyePitchMaxOffsetEmotionCombatShout),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMinEmotionCombatShout),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayMaxEmotionCombatShout),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetDelayExponentEmotionCombatShout),
+        MFGFIX_SETTING(eyesMovement, EyesMovement, fEyeOffsetZeroChanceEmotionCombatShout),
+        MFGFIX_SETTING(dialogue, Dialogue, fDialoguePhonemeThreshold),
+        MFGFIX_SETTING(performance, Performance, bSkipIdleFaces),
+        MFGFIX_SETTING(performance, Performance, fFrameBudget),
+        MFGFIX_SETTING(performance, Performance, bUnlockedUpdate),
+        MFGFIX_SETTING(performance, Performance, bDeferOnContention),
+        MFGFIX_SETTING(lod, Lod, bEnableLod),
+        MFGFIX_SETTING(lod, Lod, fLodRefreshInterval),
+        MFGFIX_SETTING(lod, Lod, fLodMidDistance),
+        MFGFIX_SETTING(lod, Lod, fLodMidScreenSize),
+        MFGFIX_SETTING(lod, Lod, fLodMidInterval),
+        MFGFIX_SETTING(lod, Lod, bLodMidBlink),
+        MFGFIX_SETTING(lod, Lod, bLodMidSaccades),
+        MFGFIX_SETTING(lod, Lod, bLodMidSmoothing),
+        MFGFIX_SETTING(lod, Lod, fLodFarDistance),
+        MFGFIX_SETTING(lod, Lod, fLodFarScreenSize),
+        MFGFIX_SETTING(lod, Lod, fLodFarInterval),
+        MFGFIX_SETTING(lod, Lod, bLodFarBlink),
+        MFGFIX_SETTING(lod, Lod, bLodFarSaccades),
+        MFGFIX_SETTING(lod, Lod, bLodFarSmoothing),
+        MFGFIX_SETTING(lod, Lod, fLodDistantDistance),
+        MFGFIX_SETTING(lod, Lod, fLodDistantScreenSize),
+        MFGFIX_SETTING(lod, Lod, fLodDistantInterval),
+        MFGFIX_SETTING(lod, Lod, bLodDistantBlink),
+        MFGFIX_SETTING(lod, Lod, bLodDistantSaccades),
+        MFGFIX_SETTING(lod, Lod, bLodDistantSmoothing),
+        MFGFIX_SETTING(debug, Debug, bDeterministicRandom),
+        MFGFIX_SETTING(debug, Debug, bCollectStats),
+        MFGFIX_SETTING(debug, Debug, fStatsExportInterval),
+        MFGFIX_SETTING(debug, Debug, bRecordTimeline),
+    };
+
+#undef MFGFIX_SETTING
+
+    // nullptr for an unknown key, keys are matched case insensitively like the ini
+    const SettingDescriptor* FindSettingDescriptor(std::string_view a_key);
+
+    template <class Ini>
+    void Settings::Read(const Ini& a_ini)
+    {
+        for (auto& descriptor : kSettingDescriptors) {
+            auto value = descriptor.get(*this);
+
+            switch (descriptor.type) {
+            case SettingDescriptor::Type::Bool:
+                value = a_ini.GetBoolValue(descriptor.section, descriptor.key, value != 0.0f) ? 1.0f : 0.0f;
+                break;
+            default:
+                value = static_cast<float>(a_ini.GetDoubleValue(descriptor.section, descriptor.key, value));
+                break;
+            }
+
+            descriptor.set(*this, value);
+        }
+    }
+
+    template <class Ini>
+    void Settings::Write(Ini& a_ini) const
+    {
+        for (auto& descriptor : kSettingDescriptors) {
+            auto value = descriptor.get(*this);
+
+            switch (descriptor.type) {
+            case SettingDescriptor::Type::Bool:
+                a_ini.SetBoolValue(descriptor.section, descriptor.key, value != 0.0f);
+                break;
+            default:
+                a_ini.SetDoubleValue(descriptor.section, descriptor.key, value);
+                break;
+            }
+        }
+    }
+
+    // immutable copy of the settings for the update threads, with everything derived from them computed once
+    struct SettingsSnapshot
+    {
+        SettingsSnapshot();
+        explicit SettingsSnapshot(const Settings& a_values);
+
+        Settings values;
+
+        Core::BlinkParams blink;
+        Core::TrackParams track;  // deltaMax is per second here
+        float phonemeThreshold{ 0.0f };
+        std::array<Core::EyesOffsetParams, Core::Expression::Total> eyesOffset;  // by expression id
+        Core::LodPolicy lod;                                                     // full detail only unless bEnableLod
+        Core::TransitionParams transition;                                       // bPlannedTransitions
     };
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+// the engine independent part of the settings: descriptor lookup and the snapshot, also built into mfgfix-tests
+
+#include "Settings.h"
+#include "core/Blend.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace MfgFix
+{
+    namespace
+    {
+        void Order(float& a_min, float& a_max)
+        {
+            if (a_min > a_max) {
+                std::swap(a_min, a_max);
+            }
+        }
+
+        // ini fields of one eyes movement profile, same order as Core::EyesOffsetParams
+        using EyesProfileFields = std::array<float Settings::EyesMovement::*, 8>;
+
+        using E = Settings::EyesMovement;
+
+        // by Core::Emotion
+        constexpr std::array<EyesProfileFields, Core::Emotion::Total> kEyesProfileFields{ {
+            { &E::fEyeHeadingMinOffsetEmotionAngry, &E::fEyeHeadingMaxOffsetEmotionAngry, &E::fEyePitchMinOffsetEmotionAngry, &E::fEyePitchMaxOffsetEmotionAngry, &E::fEyeOffsetDelayMinEmotionAngry, &E::fEyeOffsetDelayMaxEmotionAngry, &E::fEyeOffsetDelayExponentEmotionAngry, &E::fEyeOffsetZeroChanceEmotionAngry },
+            { &E::fEyeHeadingMinOffsetEmotionHappy, &E::fEyeHeadingMaxOffsetEmotionHappy, &E::fEyePitchMinOffsetEmotionHappy, &E::fEyePitchMaxOffsetEmotionHappy, &E::fEyeOffsetDelayMinEmotionHappy, &E::fEyeOffsetDelayMaxEmotionHappy, &E::fEyeOffsetDelayExponentEmotionHappy, &E::fEyeOffsetZeroChanceEmotionHappy },
+            { &E::fEyeHeadingMinOffsetEmotionSurprise, &E::fEyeHeadingMaxOffsetEmotionSurprise, &E::fEyePitchMinOffsetEmotionSurprise, &E::fEyePitchMaxOffsetEmotionSurprise, &E::fEyeOffsetDelayMinEmotionSurprise, &E::fEyeOffsetDelayMaxEmotionSurprise, &E::fEyeOffsetDelayExponentEmotionSurprise, &E::fEyeOffsetZeroChanceEmotionSurprise },
+            { &E::fEyeHeadingMinOffsetEmotionSad, &E::fEyeHeadingMaxOffsetEmotionSad, &E::fEyePitchMinOffsetEmotionSad, &E::fEyePitchMaxOffsetEmotionSad, &E::fEyeOffsetDelayMinEmotionSad, &E::fEyeOffsetDelayMaxEmotionSad, &E::fEyeOffsetDelayExponentEmotionSad, &E::fEyeOffsetZeroChanceEmotionSad },
+            { &E::fEyeHeadingMinOffsetEmotionFear, &E::fEyeHeadingMaxOffsetEmotionFear, &E::fEyePitchMinOffsetEmotionFear, &E::fEyePitchMaxOffsetEmotionFear, &E::fEyeOffsetDelayMinEmotionFear, &E::fEyeOffsetDelayMaxEmotionFear, &E::fEyeOffsetDelayExponentEmotionFear, &E::fEyeOffsetZeroChanceEmotionFear },
+            { &E::fEyeHeadingMinOffsetEmotionNeutral, &E::fEyeHeadingMaxOffsetEmotionNeutral, &E::fEyePitchMinOffsetEmotionNeutral, &E::fEyePitchMaxOffsetEmotionNeutral, &E::fEyeOffsetDelayMinEmotionNeutral, &E::fEyeOffsetDelayMaxEmotionNeutral, &E::fEyeOffsetDelayExponentEmotionNeutral, &E::fEyeOffsetZeroChanceEmotionNeutral },
+            { &E::fEyeHeadingMinOffsetEmotionPuzzled, &E::fEyeHeadingMaxOffsetEmotionPuzzled, &E::fEyePitchMinOffsetEmotionPuzzled, &E::fEyePitchMaxOffsetEmotionPuzzled, &E::fEyeOffsetDelayMinEmotionPuzzled, &E::fEyeOffsetDelayMaxEmotionPuzzled, &E::fEyeOffsetDelayExponentEmotionPuzzled, &E::fEyeOffsetZeroChanceEmotionPuzzled },
+            { &E::fEyeHeadingMinOffsetEmotionDisgusted, &E::fEyeHeadingMaxOffsetEmotionDisgusted, &E::fEyePitchMinOffsetEmotionDisgusted, &E::fEyePitchMaxOffsetEmotionDisgusted, &E::fEyeOffsetDelayMinEmotionDisgusted, &E::fEyeOffsetDelayMaxEmotionDisgusted, &E::fEyeOffsetDelayExponentEmotionDisgusted, &E::fEyeOffsetZeroChanceEmotionDisgusted },
+            { &E::fEyeHeadingMinOffsetEmotionCombatAnger, &E::fEyeHeadingMaxOffsetEmotionCombatAnger, &E::fEyePitchMinOffsetEmotionCombatAnger, &E::fEyePitchMaxOffsetEmotionCombatAnger, &E::fEyeOffsetDelayMinEmotionCombatAnger, &E::fEyeOffsetDelayMaxEmotionCombatAnger, &E::fEyeOffsetDelayExponentEmotionCombatAnger, &E::fEyeOffsetZeroChanceEmotionCombatAnger },
+            { &E::fEyeHeadingMinOffsetEmotionCombatShout, &E::fEyeHeadingMaxOffsetEmotionCombatShout, &E::fEyePitchMinOffsetEmotionCombatShout, &E::fEyePitchMaxOffsetEmotionCombatShout, &E::fEyeOffsetDelayMinEmotionCombatShout, &E::fEyeOffsetDelayMaxEmotionCombatShout, &E::fEyeOffsetDelayExponentEmotionCombatShout, &E::fEyeOffsetZeroChanceEmotionCombatShout },
+        } };
+
+        Core::EyesOffsetParams MakeEyesOffsetParams(const Settings::EyesMovement& a_settings, std::uint32_t a_emotion)
+        {
+            auto& fields = kEyesProfileFields[a_emotion];
+
+            return { a_settings.*fields[0], a_settings.*fields[1], a_settings.*fields[2], a_settings.*fields[3], a_settings.*fields[4], a_settings.*fields[5], a_settings.*fields[6], a_settings.*fields[7] };
+        }
+
+        Core::LodBand MakeLodBand(float a_distance, float a_screenSize, float a_interval, bool a_blink, bool a_saccades, bool a_smoothing)
+        {
+            return {
+                a_distance,
+                a_screenSize,
+                static_cast<std::uint32_t>(std::clamp(std::round(a_interval), 1.0f, 60.0f)),
+                (a_blink ? Core::LodPart::Blink : 0u) | (a_saccades ? Core::LodPart::Saccades : 0u) | (a_smoothing ? Core::LodPart::Smoothing : 0u)
+            };
+        }
+    }
+
+    SettingsSnapshot::SettingsSnapshot() :
+        SettingsSnapshot(Settings{})
+    {}
+
+    SettingsSnapshot::SettingsSnapshot(const Settings& a_values) :
+        values(a_values)
+    {
+        auto& eyesBlinking = values.eyesBlinking;
+        auto& eyesMovement = values.eyesMovement;
+
+        blink = { eyesBlinking.fBlinkDownTime, eyesBlinking.fBlinkUpTime, eyesBlinking.fBlinkDelayMin, eyesBlinking.fBlinkDelayMax };
+        Order(blink.delayMin, blink.delayMax);
+
+        track = Core::MakeTrackParams(eyesMovement.fTrackEyeXY, eyesMovement.fTrackEyeZ, eyesMovement.fTrackSpeed, 1.0f);
+
+        phonemeThreshold = Core::PhonemeThreshold(values.dialogue.fDialoguePhonemeThreshold);
+
+        std::array<Core::EyesOffsetParams, Core::Emotion::Total> profiles;
+
+        for (std::uint32_t i = 0; i < profiles.size(); ++i) {
+            auto& params = profiles[i];
+
+            params = MakeEyesOffsetParams(eyesMovement, i);
+            Order(params.headingMin, params.headingMax);
+            Order(params.pitchMin, params.pitchMax);
+            Order(params.delayMin, params.delayMax);
+            params.delayExponent = params.delayExponent > 0.0f ? params.delayExponent : 1.0f;
+            params.zeroChance = std::clamp(params.zeroChance, 0.0f, 1.0f);
+            params.delayCurve = Core::PowerCurve(params.delayExponent);
+        }
+
+        for (std::uint32_t i = 0; i < eyesOffset.size(); ++i) {
+            eyesOffset[i] = profiles[Core::EmotionOf(i)];
+        }
+
+        transition = Core::MakeTransitionParams(values.transition.fPhonemeDuration, values.transition.fModifierDuration, values.transition.fExpressionDuration, values.transition.fEaseCurve);
+
+        if (auto& settings = values.lod; settings.bEnableLod) {
+            std::array bands{
+                MakeLodBand(settings.fLodMidDistance, settings.fLodMidScreenSize, settings.fLodMidInterval, settings.bLodMidBlink, settings.bLodMidSaccades, settings.bLodMidSmoothing),
+                MakeLodBand(settings.fLodFarDistance, settings.fLodFarScreenSize, settings.fLodFarInterval, settings.bLodFarBlink, settings.bLodFarSaccades, settings.bLodFarSmoothing),
+                MakeLodBand(settings.fLodDistantDistance, settings.fLodDistantScreenSize, settings.fLodDistantInterval, settings.bLodDistantBlink, settings.bLodDistantSaccades, settings.bLodDistantSmoothing)
+            };
+
+            lod = Core::LodPolicy(bands, settings.fLodRefreshInterval);
+        }
+    }
+
+    const SettingDescriptor* FindSettingDescriptor(std::string_view a_key)
+    {
+        auto it = std::ranges::find_if(kSettingDescriptors, [&](const SettingDescriptor& a_descriptor) {
+            return std::ranges::equal(std::string_view{ a_descriptor.key }, a_key, [](char a_lhs, char a_rhs) {
+                return std::tolower(static_cast<unsigned char>(a_lhs)) == std::tolower(static_cast<unsigned char>(a_rhs));
+            });
+        });
+
+        return it != kSettingDescriptors.end() ? &*it : nullptr;
+    }
+}
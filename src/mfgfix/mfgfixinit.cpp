@@ -4,14 +4,20 @@
 #include "ConsoleCommands.h"
 #include "MfgConsoleFunc.h"
 #include "Offsets.h"
+#include "PresetRegistry.h"
 #include "Settings.h"
 #include "SettingsPapyrus.h"
+#include "core/Blend.h"
 
 namespace MfgFix
 {
     void Init()
     {
-        Settings::Get().Read();
+        Settings::Update([](Settings& a_settings) { a_settings.Read(); });
+
+        logger::info("using {} blend kernels", Core::ToString(Core::SelectKernels()));
+
+        PresetRegistry::Load();
 
         BSFaceGenAnimationData::Init();
         ConsoleCommands::Init();
@@ -20,6 +26,13 @@ namespace MfgFix
         SettingsPapyrus::Register();
         MfgConsoleFunc::Register();
 
+        // game events
+        SKSE::GetMessagingInterface()->RegisterListener([](SKSE::MessagingInterface::Message* a_msg) {
+            if (a_msg && a_msg->type == SKSE::MessagingInterface::kDataLoaded) {
+                ActorManager::RegisterEvents();
+            }
+        });
+
         // Misc
 
         // allow expression change for dead npcs - 1.5 seems to use short jumps which necessitates a smaller offset ???
@@ -0,0 +1,294 @@
+// mfgfix-replay: feeds a trace captured with `mfg trace` through the face update code and reports
+// throughput and every value that doesn't match what the game produced
+
+#include "core/Blend.h"
+#include "core/FaceUpdate.h"
+#include "core/Timeline.h"
+#include "core/Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    constexpr std::array<const char*, TraceRecord::kLayers> kLayerNames{
+        "expression1", "expression2", "expression3",
+        "modifier1", "modifier2", "modifier3",
+        "phoneme1", "phoneme2", "phoneme3",
+        "custom1", "custom2", "custom3"
+    };
+
+    struct Options
+    {
+        const char* path{ nullptr };
+        std::uint32_t repeat{ 1 };
+        float epsilon{ 1e-5f };
+        std::uint32_t report{ 10 };
+        SimdLevel simd{ SimdLevel::AVX2 };
+        const char* timeline{ nullptr };
+    };
+
+    struct Divergence
+    {
+        std::uint64_t records{ 0 };
+        std::uint64_t values{ 0 };
+        float maxError{ 0.0f };
+    };
+
+    class Comparer
+    {
+    public:
+        Comparer(const Options& a_options, Divergence& a_divergence) :
+            _options(a_options),
+            _divergence(a_divergence)
+        {}
+
+        void operator()(std::uint64_t a_index, std::uint64_t a_face, const TraceRecord& a_record, const ReplayFace& a_replay)
+        {
+            _index = a_index;
+            _face = a_face;
+            _diverged = false;
+
+            for (std::size_t layer = 0; layer < TraceRecord::kLayers; ++layer) {
+                for (std::uint32_t i = 0; i < a_record.counts[layer]; ++i) {
+                    Check(kLayerNames[layer], i, a_record.out[layer][i], a_replay.Result()[layer][i]);
+                }
+            }
+
+            auto& expected = a_record.eyesOut;
+            auto& actual = a_replay.Eyes();
+
+            Check("eyes.blinkStage", 0, static_cast<float>(expected.blinkStage), static_cast<float>(actual.blinkStage));
+            Check("eyes.blinkTimer", 0, expected.blinkTimer, actual.blinkTimer);
+            Check("eyes.offsetTimer", 0, expected.offsetTimer, actual.offsetTimer);
+            Check("eyes.headingOffset", 0, expected.headingOffset, actual.headingOffset);
+            Check("eyes.pitchOffset", 0, expected.pitchOffset, actual.pitchOffset);
+            Check("eyes.heading", 0, expected.heading, actual.heading);
+            Check("eyes.pitch", 0, expected.pitch, actual.pitch);
+            Check("blinkValue", 0, a_record.blinkValueOut, a_replay.Blink());
+
+            if (_diverged) {
+                ++_divergence.records;
+            }
+        }
+
+    private:
+        void Check(const char* a_field, std::uint32_t a_channel, float a_expected, float a_actual)
+        {
+            auto error = std::fabs(a_expected - a_actual);
+            if (error <= _options.epsilon && !(std::isnan(a_expected) || std::isnan(a_actual))) {
+                return;
+            }
+
+            _diverged = true;
+            _divergence.maxError = std::max(_divergence.maxError, error);
+
+            if (_divergence.values++ < _options.report) {
+                std::printf("  record %llu face %016llx %s[%u]: expected %.9g, got %.9g\n",
+                    static_cast<unsigned long long>(_index), static_cast<unsigned long long>(_face), a_field, a_channel,
+                    a_expected, a_actual);
+            }
+        }
+
+        const Options& _options;
+        Divergence& _divergence;
+        std::uint64_t _index{ 0 };
+        std::uint64_t _face{ 0 };
+        bool _diverged{ false };
+    };
+
+    struct Pass
+    {
+        std::uint64_t records{ 0 };
+        std::uint64_t regular{ 0 };
+        std::uint64_t smooth{ 0 };
+        std::uint64_t params{ 0 };
+        double seconds{ 0.0 };
+        bool failed{ false };
+    };
+
+    // a_replay false only decodes, the difference between both passes is the update cost
+    template <class F>
+    Pass Run(TraceReader& a_reader, bool a_replay, F&& a_compare, Timeline* a_timeline = nullptr)
+    {
+        Pass pass;
+
+        TraceReplayer replayer;
+
+        a_reader.Rewind();
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (auto chunk = a_reader.Next(); chunk != TraceChunk::None; chunk = a_reader.Next()) {
+            if (chunk == TraceChunk::Params) {
+                replayer.SetParams(a_reader.Params());
+                ++pass.params;
+                continue;
+            }
+
+            auto& record = a_reader.Record();
+
+            if (a_replay) {
+                ReplayFace face(record);
+                replayer.Replay(a_reader.Face(), face, record, a_timeline);
+
+                a_compare(pass.records, a_reader.Face(), record, face);
+            }
+
+            if (record.speed > 0.0f) {
+                ++pass.smooth;
+            } else {
+                ++pass.regular;
+            }
+
+            ++pass.records;
+        }
+
+        pass.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        pass.failed = a_reader.Failed();
+
+        return pass;
+    }
+
+    void Usage()
+    {
+        std::puts(
+            "usage: mfgfix-replay <trace> [options]\n"
+            "  --repeat <n>       replay the trace n times, default 1\n"
+            "  --epsilon <e>      allowed absolute difference, default 1e-5\n"
+            "  --report <n>       divergent values to print, default 10\n"
+            "  --simd <level>     scalar, sse41 or avx2, default avx2 (capped by the cpu)\n"
+            "  --timeline <file>  write the update phases of the first replay as Chrome trace-event JSON");
+    }
+
+    bool ParseOptions(int a_argc, char** a_argv, Options& a_options)
+    {
+        for (int i = 1; i < a_argc; ++i) {
+            std::string_view arg{ a_argv[i] };
+            auto value = i + 1 < a_argc ? a_argv[i + 1] : nullptr;
+
+            if (arg == "--repeat" && value) {
+                a_options.repeat = static_cast<std::uint32_t>(std::max(1l, std::strtol(value, nullptr, 10)));
+                ++i;
+            } else if (arg == "--epsilon" && value) {
+                a_options.epsilon = std::strtof(value, nullptr);
+                ++i;
+            } else if (arg == "--report" && value) {
+                a_options.report = static_cast<std::uint32_t>(std::max(0l, std::strtol(value, nullptr, 10)));
+                ++i;
+            } else if (arg == "--simd" && value) {
+                std::string_view level{ value };
+                if (level == "scalar") {
+                    a_options.simd = SimdLevel::Scalar;
+                } else if (level == "sse41") {
+                    a_options.simd = SimdLevel::SSE41;
+                } else if (level == "avx2") {
+                    a_options.simd = SimdLevel::AVX2;
+                } else {
+                    return false;
+                }
+                ++i;
+            } else if (arg == "--timeline" && value) {
+                a_options.timeline = value;
+                ++i;
+            } else if (!arg.starts_with("--") && !a_options.path) {
+                a_options.path = a_argv[i];
+            } else {
+                return false;
+            }
+        }
+
+        return a_options.path != nullptr;
+    }
+}
+
+int main(int a_argc, char** a_argv)
+{
+    Options options;
+    if (!ParseOptions(a_argc, a_argv, options)) {
+        Usage();
+        return 2;
+    }
+
+    TraceReader reader;
+    if (!reader.Open(options.path)) {
+        std::fprintf(stderr, "%s: not a trace of this version\n", options.path);
+        return 2;
+    }
+
+    auto simd = SelectKernels(options.simd);
+
+    // first pass faults the mapping in, the second one is timed
+    auto decode = Run(reader, false, [](auto&&...) {});
+    if (!decode.failed) {
+        decode = Run(reader, false, [](auto&&...) {});
+    }
+    if (decode.failed) {
+        std::fprintf(stderr, "%s: malformed chunk after %llu records\n", options.path, static_cast<unsigned long long>(decode.records));
+        return 2;
+    }
+
+    std::printf("%s: %.1f MiB, %llu records (%llu regular, %llu smooth), %llu params changes, kernels %s\n",
+        options.path, reader.Size() / (1024.0 * 1024.0),
+        static_cast<unsigned long long>(decode.records), static_cast<unsigned long long>(decode.regular), static_cast<unsigned long long>(decode.smooth),
+        static_cast<unsigned long long>(decode.params), ToString(simd));
+
+    Divergence divergence;
+    Comparer compare(options, divergence);
+
+    Pass replay;
+    double replaySeconds = 0.0;
+
+    // a replayed face update takes well under a microsecond, the timeline is only worth it for a short trace
+    std::unique_ptr<Timeline> timeline;
+    if (options.timeline) {
+        timeline = std::make_unique<Timeline>(std::max<std::size_t>(decode.records * 6, 1));
+    }
+
+    for (std::uint32_t i = 0; i < options.repeat; ++i) {
+        if (i == 0) {
+            replay = Run(reader, true, compare, timeline.get());
+        } else {
+            replay = Run(reader, true, [](auto&&...) {});
+        }
+        replaySeconds += replay.seconds;
+    }
+
+    auto records = static_cast<double>(replay.records) * options.repeat;
+    auto updateSeconds = std::max(0.0, replaySeconds - decode.seconds * options.repeat);
+
+    std::printf("decode  %8.1f ns/record\n", decode.seconds * 1e9 / std::max(1.0, static_cast<double>(decode.records)));
+    std::printf("update  %8.1f ns/record\n", updateSeconds * 1e9 / std::max(1.0, records));
+    std::printf("total   %8.0f records/s\n", records / std::max(1e-9, replaySeconds));
+
+    if (timeline) {
+        auto capture = timeline->Collect();
+        auto json = FormatChromeTrace(capture);
+
+        auto file = std::fopen(options.timeline, "wb");
+        if (!file || std::fwrite(json.data(), 1, json.size(), file) != json.size()) {
+            std::fprintf(stderr, "%s: can't write the timeline\n", options.timeline);
+        } else {
+            std::printf("timeline %zu spans -> %s\n", capture.events.size(), options.timeline);
+        }
+        if (file) {
+            std::fclose(file);
+        }
+    }
+
+    if (divergence.records) {
+        std::printf("DIVERGED: %llu records, %llu values, max error %.9g\n",
+            static_cast<unsigned long long>(divergence.records), static_cast<unsigned long long>(divergence.values), divergence.maxError);
+        return 1;
+    }
+
+    std::puts("no divergence");
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "Test.h"
+
+#include "core/Blend.h"
+
+#include <array>
+#include <cfloat>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    MFGFIX_TEST(PhonemeThresholdClamps)
+    {
+        CHECK(PhonemeThreshold(-10.0f) == 0.0f);
+        CHECK(PhonemeThreshold(50.0f) == 0.5f);
+        CHECK(PhonemeThreshold(500.0f) == 2.0f);
+    }
+
+    MFGFIX_TEST(ActiveExpressionPicksStrongest)
+    {
+        std::array<float, Expression::Total> expressions{};
+        CHECK(ActiveExpression(expressions) == Expression::MoodNeutral);
+
+        expressions[Expression::MoodHappy] = 0.4f;
+        expressions[Expression::DialogueFear] = 0.6f;
+        CHECK(ActiveExpression(expressions) == Expression::DialogueFear);
+
+        // a tie keeps the first, neutral wins ties with itself only
+        expressions[Expression::MoodHappy] = 0.6f;
+        CHECK(ActiveExpression(expressions) == Expression::DialogueFear);
+
+        CHECK(ActiveExpression(std::span<const float>{ expressions.data(), 3 }) == Expression::MoodNeutral);
+    }
+
+    // every width goes through either a fixed width kernel or the runtime loop, both have to copy exactly the non-zero values
+    MFGFIX_TEST(MergeNonZeroAllWidths)
+    {
+        for (std::size_t width : { 1u, 8u, 15u, 16u, 17u, 18u, 32u }) {
+            std::vector<float> src(width);
+            std::vector<float> dst(width);
+            std::vector<float> expected(width);
+
+            for (std::size_t i = 0; i < width; ++i) {
+                src[i] = i % 3 == 0 ? 0.0f : static_cast<float>(i) * 0.1f;
+                dst[i] = -static_cast<float>(i);
+                expected[i] = src[i] != 0.0f ? src[i] : dst[i];
+            }
+
+            MergeNonZero(src, dst);
+            CHECK_SAME(dst, expected);
+        }
+
+        // different widths merge the common part only
+        std::array<float, 4> src{ 1.0f, 0.0f, 3.0f, 4.0f };
+        std::array<float, 3> dst{ 9.0f, 9.0f, 9.0f };
+        MergeNonZero(src, dst);
+        CHECK_SAME(dst, (std::array{ 1.0f, 9.0f, 3.0f }));
+    }
+
+    MFGFIX_TEST(MergeModifiersCopiesLookAsGroup)
+    {
+        std::array<float, Modifier::Total> src{};
+        std::array<float, Modifier::Total> dst{};
+        dst.fill(0.5f);
+
+        // nothing set, nothing copied
+        auto expected = dst;
+        MergeModifiers(src, dst);
+        CHECK_SAME(dst, expected);
+
+        // one look channel takes all four with it, the zeros included
+        src[Modifier::LookLeft] = 0.7f;
+        src[Modifier::SquintLeft] = 0.2f;
+        expected[Modifier::LookDown] = 0.0f;
+        expected[Modifier::LookLeft] = 0.7f;
+        expected[Modifier::LookRight] = 0.0f;
+        expected[Modifier::LookUp] = 0.0f;
+        expected[Modifier::SquintLeft] = 0.2f;
+        MergeModifiers(src, dst);
+        CHECK_SAME(dst, expected);
+
+        // the runtime path of an odd width does the same
+        std::vector<float> wideSrc(src.begin(), src.end());
+        std::vector<float> wideDst(Modifier::Total, 0.5f);
+        wideSrc.push_back(0.0f);
+        wideDst.push_back(0.3f);
+        MergeModifiers(wideSrc, wideDst);
+        CHECK_SAME(std::span<const float>(wideDst).first(Modifier::Total), expected);
+        CHECK(wideDst.back() == 0.3f);
+    }
+
+    MFGFIX_TEST(MergeAboveThresholdZeroesSource)
+    {
+        std::array src{ 0.1f, 0.5f, 0.9f };
+        std::array dst{ 7.0f, 7.0f, 7.0f };
+        MergeAboveThreshold(src, dst, 0.5f);
+        CHECK_SAME(src, (std::array{ 0.0f, 0.5f, 0.9f }));
+        CHECK_SAME(dst, (std::array{ 7.0f, 0.5f, 0.9f }));
+
+        std::array values{ 0.1f, 0.5f, -1.0f };
+        ZeroBelowThreshold(values, 0.5f);
+        CHECK_SAME(values, (std::array{ 0.0f, 0.5f, 0.0f }));
+    }
+
+    MFGFIX_TEST(AnimMergeStepsTowardTarget)
+    {
+        std::array dialogue{ 0.0f, 0.8f, 0.0f, 0.0f };
+        std::array target{ 1.0f, 0.0f, 0.25f, 0.0f };
+        std::array result{ 0.0f, 0.0f, 0.2f, 0.5f };
+
+        Kernels::AnimMergeScalar(dialogue, target, result, 0.1f);
+
+        // a step up, the dialogue value where the target is unset, the rest of a step snaps, a step down to zero
+        CHECK(result[0] == 0.1f);
+        CHECK(result[1] == 0.8f);
+        CHECK(result[2] == 0.25f);
+        CHECK(result[3] == 0.4f);
+
+        // a result wider than both inputs keeps the lanes nobody sets
+        std::array<float, 2> shortTarget{ 1.0f, 1.0f };
+        std::array<float, 3> wide{ 0.0f, 0.0f, 0.6f };
+        Kernels::AnimMergeScalar(std::span<const float>{}, shortTarget, wide, 1.0f);
+        CHECK_SAME(wide, (std::array{ 1.0f, 1.0f, 0.6f }));
+    }
+}
@@ -0,0 +1,185 @@
+#include "Test.h"
+
+#include "core/Broadcast.h"
+#include "core/Commands.h"
+#include "core/Random.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    // how ApplyExpressionPreset scaled a preset before it was computed once per call
+    struct OldPreset
+    {
+        int expression;
+        int expressionValue;
+        std::array<int, Phoneme::Total> phonemes;
+        std::array<int, kPresetModifiers> modifiers;
+    };
+
+    OldPreset MakeOldPreset(const std::vector<float>& a_expression, int exprPower, float exprStrModifier, float modStrModifier, float phStrModifier)
+    {
+        OldPreset preset;
+
+        preset.expression = static_cast<int>(a_expression[30]);
+        preset.expressionValue = static_cast<int>(std::round(a_expression[31] * 100.0f * exprStrModifier));
+        if (preset.expression > 0 && preset.expressionValue == 0) {
+            preset.expressionValue = exprPower;
+        }
+
+        for (int i = 0; i <= 15; ++i) {
+            preset.phonemes[i] = static_cast<int>(std::round(a_expression[i] * 100.0f * phStrModifier));
+        }
+        for (int i = 16, m = 0; i <= 29; ++i, ++m) {
+            preset.modifiers[m] = static_cast<int>(std::round(a_expression[i] * 100.0f * modStrModifier));
+        }
+
+        return preset;
+    }
+
+    std::vector<float> RandomValues(Rng& a_rng)
+    {
+        std::vector<float> values(kPresetSize);
+        for (std::size_t i = 0; i < 30; ++i) {
+            // every tenth channel off, the others anywhere in 0 - 1 and on the steps presets are usually written in
+            values[i] = a_rng.Next() % 10 == 0 ? 0.0f : a_rng.Next() % 2 ? a_rng.Uniform() : static_cast<float>(a_rng.Next() % 21) * 0.05f;
+        }
+        values[30] = static_cast<float>(a_rng.Next() % Expression::Total);
+        values[31] = a_rng.Next() % 4 == 0 ? 0.0f : a_rng.Uniform();
+        return values;
+    }
+
+    // the preset a batch computes once is what every single call computed for itself
+    MFGFIX_TEST(MakePresetMatchesPerCallScaling)
+    {
+        Rng rng{ Rng::kDefaultSeed };
+        std::uint32_t mismatched = 0;
+
+        for (int i = 0; i < 5000; ++i) {
+            auto values = RandomValues(rng);
+            auto power = static_cast<int>(rng.Next() % 101);
+            auto expression = 0.5f + rng.Uniform();
+            auto modifiers = 0.5f + rng.Uniform();
+            auto phonemes = 0.5f + rng.Uniform();
+            auto openMouth = rng.Next() % 2 == 0;
+
+            auto preset = MakePreset(values, openMouth, { power, expression, modifiers, phonemes });
+            auto old = MakeOldPreset(values, power, expression, modifiers, phonemes);
+
+            if (!preset) {
+                ++mismatched;
+                continue;
+            }
+
+            mismatched += static_cast<int>(preset->expression) != old.expression || preset->expressionValue != old.expressionValue ||
+                          preset->setPhonemes == openMouth ||
+                          !std::equal(preset->phonemes.begin(), preset->phonemes.end(), old.phonemes.begin()) ||
+                          !std::equal(preset->modifiers.begin(), preset->modifiers.end(), old.modifiers.begin());
+        }
+
+        CHECK(mismatched == 0);
+    }
+
+    // strength 0 takes exprPower, except for expression 0; any other length is refused
+    MFGFIX_TEST(MakePresetEdges)
+    {
+        std::vector<float> values(kPresetSize, 0.0f);
+
+        values[30] = 3.0f;
+        auto preset = MakePreset(values, false, { 42, 1.0f, 1.0f, 1.0f });
+        CHECK(preset && preset->expression == 3 && preset->expressionValue == 42);
+
+        values[30] = 0.0f;
+        preset = MakePreset(values, false, { 42, 1.0f, 1.0f, 1.0f });
+        CHECK(preset && preset->expression == 0 && preset->expressionValue == 0);
+
+        values[31] = 0.5f;
+        values[16] = 0.25f;
+        preset = MakePreset(values, true, { 0, 2.0f, 2.0f, 1.0f });
+        CHECK(preset && preset->expressionValue == 100 && preset->modifiers[0] == 50 && !preset->setPhonemes);
+
+        CHECK(!MakePreset(std::vector<float>(kPresetSize - 1), false, {}));
+        CHECK(!MakePreset(std::vector<float>(kPresetSize + 1), false, {}));
+        CHECK(!MakePreset({}, false, {}));
+    }
+
+    // nulls and repeats dropped, the first occurrence of every actor kept in call order
+    MFGFIX_TEST(UniqueTargetsKeepsCallOrder)
+    {
+        int actors[5]{};
+        std::vector<int*> targets{ &actors[3], nullptr, &actors[1], &actors[3], &actors[4], &actors[1], nullptr, &actors[0] };
+
+        auto unique = UniqueTargets(std::span<int* const>(targets));
+        CHECK((unique == std::vector<int*>{ &actors[3], &actors[1], &actors[4], &actors[0] }));
+
+        std::vector<int*> none{ nullptr, nullptr };
+        CHECK(UniqueTargets(std::span<int* const>(none)).empty());
+        CHECK(UniqueTargets(std::span<int* const>()).empty());
+    }
+
+    // one preset sent to a crowd reaches every face in full, values clamped like the keyframes; a single face gets the same
+    MFGFIX_TEST(PresetBroadcastReachesEveryFace)
+    {
+        constexpr std::size_t kFaces = 300;
+
+        std::vector<float> values(kPresetSize, 0.0f);
+        for (std::size_t i = 0; i < 30; ++i) {
+            values[i] = static_cast<float>(i) / 20.0f;
+        }
+        values[0] = 2.5f;
+        values[30] = 5.0f;
+        values[31] = 0.8f;
+
+        auto preset = MakePreset(values, false, { 0, 1.0f, 1.0f, 1.0f });
+        CHECK(preset.has_value());
+
+        CommandQueue queue;
+
+        std::vector<FaceCommand> commands(kFaces);
+        for (std::size_t i = 0; i < kFaces; ++i) {
+            commands[i].face = (i + 1) << 4;
+            commands[i].owner = static_cast<std::uint32_t>(0x100 + i);
+            commands[i].speed = 0.5f;
+        }
+
+        // more than the pool has slots, one slot holds the preset for all of them
+        for (int call = 0; call < 2 * static_cast<int>(PresetPool::kSlots); ++call) {
+            queue.PushPreset(*preset, commands);
+        }
+
+        FaceCommand single;
+        single.face = (kFaces + 1) << 4;
+        queue.PushPreset(*preset, { &single, 1 });
+
+        std::uint32_t wrong = 0;
+
+        for (std::size_t i = 0; i <= kFaces; ++i) {
+            PendingFace pending;
+            if (!queue.Take((i + 1) << 4, pending)) {
+                ++wrong;
+                continue;
+            }
+
+            wrong += (i < kFaces && (pending.owner != 0x100 + i || pending.speed != 0.5f)) || !pending.setExpression ||
+                     pending.expression != 5 || pending.expressionValue != 80;
+
+            for (std::size_t channel = 0; channel < Phoneme::Total; ++channel) {
+                wrong += !(pending.phonemeMask >> channel & 1) || pending.phonemes[channel] != (channel ? static_cast<int>(channel) * 5 : 200);
+            }
+            for (std::size_t channel = 0; channel < kPresetModifiers; ++channel) {
+                wrong += !(pending.modifierMask >> channel & 1) || pending.modifiers[channel] != static_cast<int>(Phoneme::Total + channel) * 5;
+            }
+        }
+
+        CHECK(wrong == 0);
+
+        auto counters = queue.GetCounters();
+        CHECK(counters.pending == 0);
+        CHECK(counters.queued == (2 * PresetPool::kSlots) * kFaces + 1);
+    }
+}
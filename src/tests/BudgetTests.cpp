@@ -0,0 +1,135 @@
+#include "Test.h"
+
+#include "core/Budget.h"
+#include "core/Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    // frames put off while the lock is taken hand their time to the next one that runs, at most kMaxDeferred in a row
+    MFGFIX_TEST(LockDeferralKeepsTime)
+    {
+        LockDeferral deferral;
+        Rng rng{ Rng::kDefaultSeed };
+        double passed = 0.0;
+        double stepped = 0.0;
+        std::uint32_t inRow = 0;
+        std::uint32_t mostInRow = 0;
+
+        for (std::uint32_t frame = 0; frame < 1000; ++frame) {
+            auto timeDelta = 1.0f / 60.0f;
+            auto step = deferral.Step(timeDelta);
+            passed += timeDelta;
+
+            // the lock taken 3 frames out of 4
+            if (rng.Next() % 4 != 0 && deferral.Defer(step)) {
+                mostInRow = std::max(mostInRow, ++inRow);
+                continue;
+            }
+
+            deferral.Ran();
+            stepped += step;
+            inRow = 0;
+        }
+
+        stepped += deferral.time;
+
+        CHECK(mostInRow == LockDeferral::kMaxDeferred);
+        CHECK(std::abs(passed - stepped) < 1e-3);
+    }
+
+    // a crowd costing three times the budget: the dialogue faces run every frame, the others take turns,
+    // none waits past kMaxWait, and the time of every deferred frame reaches the face when it runs
+    MFGFIX_TEST(FrameBudgetUnderLoad)
+    {
+        constexpr std::size_t kFaces = 60;
+        constexpr std::size_t kPriority = 3;
+        constexpr std::uint32_t kFrames = 2000;
+        constexpr std::uint64_t kCost = 100;
+
+        FrameBudget budget;
+        budget.SetBudget(kFaces * kCost / 3);
+
+        Rng rng{ Rng::kDefaultSeed };
+        std::vector<BudgetState> states(kFaces);
+        std::vector<double> passed(kFaces, 0.0);
+        std::vector<double> stepped(kFaces, 0.0);
+        std::vector<std::uint32_t> runs(kFaces, 0);
+        std::vector<std::uint32_t> waited(kFaces, 0);
+        std::uint32_t priorityMissed = 0;
+        std::uint32_t mostWaited = 0;
+        std::uint64_t optionalRuns = 0;
+
+        for (std::uint32_t frame = 0; frame < kFrames; ++frame) {
+            auto timeDelta = 1.0f / (30.0f + static_cast<float>(rng.Next() % 60));
+
+            for (std::size_t i = 0; i < kFaces; ++i) {
+                auto priority = i < kPriority;
+                auto ticket = budget.Admit(states[i], timeDelta, priority);
+                passed[i] += timeDelta;
+
+                if (!ticket.run) {
+                    priorityMissed += priority;
+                    mostWaited = std::max(mostWaited, ++waited[i]);
+                    continue;
+                }
+
+                // costs vary around the average, the priority faces cost more
+                budget.Spent(ticket, (priority ? 2 : 1) * (kCost / 2 + rng.Next() % kCost));
+                stepped[i] += ticket.timeDelta;
+                optionalRuns += !priority;
+                ++runs[i];
+                waited[i] = 0;
+            }
+        }
+
+        double lost = 0.0;
+        for (std::size_t i = 0; i < kFaces; ++i) {
+            lost = std::max(lost, std::abs(passed[i] - stepped[i] - states[i].pending));
+        }
+
+        auto least = *std::min_element(runs.begin() + kPriority, runs.end());
+        auto most = *std::max_element(runs.begin() + kPriority, runs.end());
+        auto counters = budget.GetCounters();
+
+        CHECK(priorityMissed == 0);
+        CHECK(runs[0] == kFrames);
+        CHECK(lost < 1e-2);
+        CHECK(mostWaited < FrameBudget::kMaxWait);
+
+        // the others share what the dialogue leaves, about a fifth of them per frame, each in turn;
+        // the faces asking first in a frame get the places at the threshold, but not many more turns
+        auto perFrame = static_cast<double>(optionalRuns) / kFrames;
+        CHECK(perFrame > 0.1 * (kFaces - kPriority) && perFrame < 0.3 * (kFaces - kPriority));
+        CHECK(most <= least + least / 2);
+
+        CHECK(counters.frames == kFrames - 1);
+        CHECK(counters.deferred > 0);
+        CHECK(counters.overruns < kFrames / 10);
+        CHECK(counters.forced < kFaces);  // the faces that never ran, in the first frames
+    }
+
+    // without a budget nobody waits
+    MFGFIX_TEST(FrameBudgetUnlimited)
+    {
+        FrameBudget budget;
+        std::vector<BudgetState> states(10);
+        std::uint32_t deferred = 0;
+
+        for (std::uint32_t frame = 0; frame < 100; ++frame) {
+            for (auto& state : states) {
+                auto ticket = budget.Admit(state, 0.01f, false);
+                deferred += !ticket.run || ticket.timeDelta != 0.01f;
+                budget.Spent(ticket, 1000);
+            }
+        }
+
+        CHECK(deferred == 0);
+        CHECK(budget.GetCounters().deferred == 0 && budget.GetCounters().overruns == 0);
+    }
+}
@@ -0,0 +1,267 @@
+#include "Test.h"
+
+#include "core/Commands.h"
+#include "core/Random.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    FaceCommand MakeCommand(std::uintptr_t a_face, CommandKind a_kind, std::uint8_t a_id, std::int32_t a_value)
+    {
+        FaceCommand command;
+        command.face = a_face;
+        command.owner = static_cast<std::uint32_t>(a_face >> 4);
+        command.kind = a_kind;
+        command.id = a_id;
+        command.value = a_value;
+        return command;
+    }
+
+    // a face as the writes leave it, applied one by one in send order or as coalesced PendingFace
+    struct Face
+    {
+        std::array<std::int32_t, Phoneme::Total> phonemes{};
+        std::array<std::int32_t, kPresetModifiers> modifiers{};
+        std::uint32_t expression{ 0 };
+        std::int32_t expressionValue{ 0 };
+
+        void Apply(const PendingFace& a_pending)
+        {
+            if (a_pending.reset != FaceReset::None) {
+                *this = {};
+            }
+            if (a_pending.setExpression) {
+                expression = a_pending.expression;
+                expressionValue = a_pending.expressionValue;
+            }
+            for (std::size_t i = 0; i < phonemes.size(); ++i) {
+                if (a_pending.phonemeMask >> i & 1) {
+                    phonemes[i] = a_pending.phonemes[i];
+                }
+            }
+            for (std::size_t i = 0; i < modifiers.size(); ++i) {
+                if (a_pending.modifierMask >> i & 1) {
+                    modifiers[i] = a_pending.modifiers[i];
+                }
+            }
+        }
+
+        bool operator==(const Face&) const = default;
+    };
+
+    // the last write to a channel wins, a reset drops what came before it, values are clamped
+    MFGFIX_TEST(CommandsCoalesce)
+    {
+        CommandQueue queue;
+        constexpr std::uintptr_t kFace = 0x1230;
+
+        queue.Push(MakeCommand(kFace, CommandKind::Phoneme, 3, 50));
+        queue.Push(MakeCommand(kFace, CommandKind::Phoneme, 3, 250));
+        queue.Push(MakeCommand(kFace, CommandKind::Modifier, 1, -5));
+
+        PendingFace pending;
+        CHECK(queue.Pending(kFace));
+        CHECK(!queue.Pending(kFace + 0x10));
+        CHECK(queue.Take(kFace, pending));
+        CHECK(pending.phonemeMask == 1u << 3 && pending.phonemes[3] == 200);
+        CHECK(pending.modifierMask == 1u << 1 && pending.modifiers[1] == 0);
+        CHECK(!queue.Take(kFace, pending));
+
+        queue.Push(MakeCommand(kFace, CommandKind::Phoneme, 2, 10));
+        queue.Push(MakeCommand(kFace, CommandKind::ResetOverride, 0, 0));
+        queue.Push(MakeCommand(kFace, CommandKind::Expression, 4, 70));
+
+        pending = {};
+        CHECK(queue.Take(kFace, pending));
+        CHECK(pending.reset == FaceReset::Override && pending.phonemeMask == 0);
+        CHECK(pending.setExpression && pending.expression == 4 && pending.expressionValue == 70);
+
+        auto counters = queue.GetCounters();
+        CHECK(counters.queued == 6 && counters.coalesced == 4 && counters.pending == 0 && counters.lost == 0);
+    }
+
+    // more faces with writes pending than there are slots: the slots taken keep their writes, the others are counted lost,
+    // and once taken the slots serve other faces
+    MFGFIX_TEST(CommandsSlotsRunOut)
+    {
+        constexpr std::size_t kSlots = CommandQueue::kBuckets * CommandQueue::kWays;
+        constexpr std::size_t kFaces = kSlots * 2;
+
+        CommandQueue queue;
+
+        for (std::size_t i = 0; i < kFaces; ++i) {
+            queue.Push(MakeCommand((i + 1) << 4, CommandKind::Phoneme, 0, static_cast<std::int32_t>(i % 200)));
+        }
+
+        std::size_t taken = 0;
+        std::uint32_t wrong = 0;
+
+        for (std::size_t i = 0; i < kFaces; ++i) {
+            PendingFace pending;
+            if (queue.Take((i + 1) << 4, pending)) {
+                ++taken;
+                wrong += pending.phonemes[0] != static_cast<std::int32_t>(i % 200);
+            }
+        }
+
+        auto counters = queue.GetCounters();
+        CHECK(wrong == 0);
+        CHECK(taken <= kSlots && taken > kSlots / 2);
+        CHECK(taken + counters.lost == kFaces);
+        CHECK(counters.pending == 0);
+
+        for (std::size_t i = 0; i < kFaces; ++i) {
+            queue.Push(MakeCommand((kFaces + i + 1) << 4, CommandKind::Modifier, 0, 1));
+
+            PendingFace pending;
+            wrong += !queue.Take((kFaces + i + 1) << 4, pending);
+        }
+
+        CHECK(wrong == 0);
+        CHECK(queue.GetCounters().lost == counters.lost);
+    }
+
+    // writes to a face that doesn't update are listed once they waited more than the passes given, the others never are;
+    // an unloading actor's writes go
+    MFGFIX_TEST(CommandsFindStale)
+    {
+        CommandQueue queue;
+        std::vector<StaleFace> stale;
+
+        constexpr std::uintptr_t kActive = 0x100;
+        constexpr std::uintptr_t kHidden = 0x200;
+        constexpr std::uintptr_t kGone = 0x300;
+
+        queue.Push(MakeCommand(kHidden, CommandKind::Phoneme, 1, 40));
+        queue.Push(MakeCommand(kGone, CommandKind::Phoneme, 1, 40));
+
+        std::uint32_t listedActive = 0;
+        std::uint32_t passes = 0;
+
+        for (; passes < 10; ++passes) {
+            queue.Push(MakeCommand(kActive, CommandKind::Modifier, 2, static_cast<std::int32_t>(passes)));
+
+            queue.FindStale(3, stale);
+
+            listedActive += std::any_of(stale.begin(), stale.end(), [](auto& a_face) { return a_face.face == kActive; });
+
+            PendingFace pending;
+            queue.Take(kActive, pending);
+
+            if (!stale.empty()) {
+                break;
+            }
+        }
+
+        CHECK(passes == 3);
+        CHECK(listedActive == 0);
+        CHECK(stale.size() == 2);
+        CHECK(std::any_of(stale.begin(), stale.end(), [](auto& a_face) { return a_face.face == kHidden && a_face.owner == (kHidden >> 4); }));
+
+        CHECK(queue.EraseOwner(kGone >> 4) == 1);
+
+        PendingFace pending;
+        CHECK(queue.Take(kHidden, pending) && pending.phonemes[1] == 40);
+
+        queue.FindStale(0, stale);
+        CHECK(stale.empty());
+        CHECK(queue.GetCounters().pending == 0);
+    }
+
+    // senders on several threads against updates on others, each face on one thread at a time:
+    // every face ends up as if each command had been applied in the order its sender sent it
+    MFGFIX_TEST(CommandsConcurrent)
+    {
+        constexpr std::size_t kSenders = 3;
+        constexpr std::size_t kUpdaters = 2;
+        constexpr std::size_t kFaces = 48;
+        constexpr std::uint32_t kCommands = 20000;
+
+        CommandQueue queue;
+        std::vector<std::vector<FaceCommand>> streams(kSenders);
+        std::vector<Face> reference(kFaces);
+        std::vector<Face> faces(kFaces);
+        std::vector<std::mutex> locks(kFaces);
+
+        ExpressionPreset preset;
+        preset.expression = 3;
+        preset.expressionValue = 60;
+        preset.phonemes.fill(20);
+        preset.modifiers.fill(30);
+
+        // every face belongs to one sender, so the order of its commands is the sender's
+        for (std::size_t sender = 0; sender < kSenders; ++sender) {
+            Rng rng{ Rng::kDefaultSeed, sender };
+
+            for (std::uint32_t i = 0; i < kCommands; ++i) {
+                auto face = sender + kSenders * (rng.Next() % (kFaces / kSenders));
+                auto roll = rng.Next() % 64;
+                auto kind = roll == 0 ? CommandKind::ResetOverride : roll < 3 ? CommandKind::Preset : static_cast<CommandKind>(rng.Next() % 3);
+                auto id = static_cast<std::uint8_t>(kind == CommandKind::Modifier ? rng.Next() % kPresetModifiers : rng.Next() % Phoneme::Total);
+
+                streams[sender].push_back(MakeCommand((face + 1) << 4, kind, id, static_cast<std::int32_t>(rng.Next() % 5) * 50));
+
+                PendingFace single;
+                single.Merge(streams[sender].back(), &preset);
+                reference[face].Apply(single);
+            }
+        }
+
+        std::atomic<std::size_t> sending{ kSenders };
+
+        std::vector<std::thread> threads;
+        for (std::size_t updater = 0; updater < kUpdaters; ++updater) {
+            threads.emplace_back([&, updater]() {
+                for (auto last = false; !last;) {
+                    last = sending.load(std::memory_order_acquire) == 0 && queue.Empty();
+
+                    for (std::size_t face = updater; face < kFaces; face += kUpdaters) {
+                        std::lock_guard locker(locks[face]);
+
+                        PendingFace pending;
+                        if (queue.Take((face + 1) << 4, pending)) {
+                            faces[face].Apply(pending);
+                        }
+                    }
+                }
+            });
+        }
+
+        for (std::size_t sender = 0; sender < kSenders; ++sender) {
+            threads.emplace_back([&, sender]() {
+                for (auto command : streams[sender]) {
+                    if (command.kind == CommandKind::Preset) {
+                        queue.PushPreset(preset, { &command, 1 });
+                    } else {
+                        queue.Push(command);
+                    }
+                }
+                sending.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // an update that came too early leaves a face for the next frame
+        for (std::size_t face = 0; face < kFaces; ++face) {
+            PendingFace pending;
+            if (queue.Take((face + 1) << 4, pending)) {
+                faces[face].Apply(pending);
+            }
+        }
+
+        auto counters = queue.GetCounters();
+        CHECK(faces == reference);
+        CHECK(counters.queued == kSenders * kCommands);
+        CHECK(counters.pending == 0 && counters.lost == 0);
+    }
+}
@@ -0,0 +1,144 @@
+#include "Test.h"
+
+#include "core/Eyes.h"
+
+#include <array>
+#include <cmath>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    constexpr BlinkParams kBlink{ 0.1f, 0.2f, 1.0f, 2.0f };
+
+    MFGFIX_TEST(TrackParamsInRadians)
+    {
+        auto track = MakeTrackParams(180.0f, 90.0f, 2.0f, 0.5f);
+        CHECK(std::fabs(track.headingMax - 3.14159265f) < 1e-5f);
+        CHECK(std::fabs(track.pitchMax - 1.57079633f) < 1e-5f);
+        CHECK(track.headingMaxInv == 1.0f / track.headingMax);
+        CHECK(track.deltaMax == 1.0f);
+
+        // no limit, no division by zero
+        auto none = MakeTrackParams(0.0f, 0.0f, 1.0f, 1.0f);
+        CHECK(none.headingMaxInv == 0.0f);
+        CHECK(none.pitchMaxInv == 0.0f);
+    }
+
+    MFGFIX_TEST(BlinkCycle)
+    {
+        Rng rng{ 1 };
+        auto stage = BlinkStage::BlinkDelay;
+        auto timer = 0.05f;
+
+        CHECK(BlinkUpdate(stage, timer, kBlink, 0.05f, false, rng) == 0.0f);
+        CHECK(stage == BlinkStage::BlinkDown);
+        CHECK(timer == kBlink.downTime);
+
+        // half way down, then closed and turning up
+        CHECK(std::fabs(BlinkUpdate(stage, timer, kBlink, 0.05f, false, rng) - 0.5f) < 1e-6f);
+        CHECK(BlinkUpdate(stage, timer, kBlink, 0.05f, false, rng) == 1.0f);
+        CHECK(stage == BlinkStage::BlinkUp);
+
+        CHECK(std::fabs(BlinkUpdate(stage, timer, kBlink, 0.1f, false, rng) - 0.5f) < 1e-6f);
+        CHECK(BlinkUpdate(stage, timer, kBlink, 0.1f, false, rng) == 0.0f);
+
+        // open again, the next blink within the delay range
+        CHECK(stage == BlinkStage::BlinkDelay);
+        CHECK(timer >= kBlink.delayMin && timer <= kBlink.delayMax);
+    }
+
+    MFGFIX_TEST(BlinkHoldKeepsEyesClosed)
+    {
+        Rng rng{ 1 };
+        auto stage = BlinkStage::BlinkDownAndWait2;
+        auto timer = 0.0f;
+
+        BlinkUpdate(stage, timer, kBlink, 0.1f, true, rng);
+        CHECK(stage == BlinkStage::BlinkDownAndWait1);
+
+        for (int i = 0; i < 10; ++i) {
+            CHECK(BlinkUpdate(stage, timer, kBlink, 0.1f, true, rng) == 1.0f);
+            CHECK(stage == BlinkStage::BlinkDownAndWait1);
+        }
+
+        // let go, the eyes open
+        CHECK(BlinkUpdate(stage, timer, kBlink, 0.1f, false, rng) == 1.0f);
+        CHECK(stage == BlinkStage::BlinkUp);
+    }
+
+    MFGFIX_TEST(EyesOffsetSelectInRange)
+    {
+        EyesOffsetParams params{ -0.2f, 0.3f, -0.1f, 0.1f, 0.5f, 1.5f };
+        Rng rng{ 2 };
+        EyesState eyes;
+
+        for (int i = 0; i < 1000; ++i) {
+            EyesOffsetSelect(eyes, params, rng);
+            CHECK(eyes.offsetTimer >= 0.5f && eyes.offsetTimer <= 1.5f);
+            CHECK(eyes.headingOffset >= -0.2f && eyes.headingOffset <= 0.3f);
+            CHECK(eyes.pitchOffset >= -0.1f && eyes.pitchOffset <= 0.1f);
+        }
+
+        params.zeroChance = 1.0f;
+        EyesOffsetSelect(eyes, params, rng);
+        CHECK(eyes.headingOffset == 0.0f && eyes.pitchOffset == 0.0f);
+
+        CHECK(!EyesOffsetTimerUpdate(eyes, 0.1f));
+        eyes.offsetTimer = 0.1f;
+        CHECK(EyesOffsetTimerUpdate(eyes, 0.2f));
+        CHECK(eyes.offsetTimer == 0.0f);
+    }
+
+    MFGFIX_TEST(EyesDirectionRateLimitedAndClamped)
+    {
+        auto track = MakeTrackParams(45.0f, 45.0f, 1.0f, 0.1f);
+        std::array<float, Modifier::Total> modifiers{};
+        EyesState eyes;
+        eyes.headingOffset = 10.0f;
+        eyes.pitchOffset = -0.05f;
+
+        EyesDirectionUpdate(eyes, track, modifiers);
+        CHECK(eyes.heading == track.deltaMax);
+        CHECK(eyes.pitch == -0.05f);
+        CHECK(modifiers[Modifier::LookRight] == eyes.heading * track.headingMaxInv);
+        CHECK(modifiers[Modifier::LookLeft] == 0.0f);
+        CHECK(modifiers[Modifier::LookDown] == 0.05f * track.pitchMaxInv);
+        CHECK(modifiers[Modifier::LookUp] == 0.0f);
+
+        for (int i = 0; i < 100; ++i) {
+            EyesDirectionUpdate(eyes, track, modifiers);
+        }
+        CHECK(eyes.heading == track.headingMax);
+        CHECK(modifiers[Modifier::LookRight] == track.headingMax * track.headingMaxInv);
+
+        // what the smooth update layers on top is taken off again
+        EyesDirectionRemove(eyes, track, modifiers);
+        CHECK(modifiers[Modifier::LookRight] == 0.0f);
+        CHECK(modifiers[Modifier::LookDown] == 0.0f);
+    }
+
+    MFGFIX_TEST(BlinkOverlayRoundTrip)
+    {
+        std::array<float, Modifier::Total> result{};
+        std::array<float, Modifier::Total> target{};
+        std::array<float, Modifier::Total> dialogue{};
+        result[Modifier::BlinkLeft] = 0.2f;
+        result[Modifier::BlinkRight] = 0.4f;
+
+        BlinkOverlayApply(result, 0.5f);
+        CHECK(std::fabs(result[Modifier::BlinkLeft] - 0.6f) < 1e-6f);
+        CHECK(std::fabs(result[Modifier::BlinkRight] - 0.7f) < 1e-6f);
+
+        BlinkOverlayRemove(result, target, dialogue, 0.5f);
+        CHECK(std::fabs(result[Modifier::BlinkLeft] - 0.2f) < 1e-6f);
+        CHECK(std::fabs(result[Modifier::BlinkRight] - 0.4f) < 1e-6f);
+
+        // fully closed can't be undone, the layers give the value back
+        target[Modifier::BlinkLeft] = 0.3f;
+        dialogue[Modifier::BlinkRight] = 0.1f;
+        BlinkOverlayRemove(result, target, dialogue, 1.0f);
+        CHECK(result[Modifier::BlinkLeft] == 0.3f);
+        CHECK(result[Modifier::BlinkRight] == 0.1f);
+    }
+}
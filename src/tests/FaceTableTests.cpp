@@ -0,0 +1,152 @@
+#include "Test.h"
+
+#include "core/FaceTable.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    struct Record
+    {
+        int value{ 0 };
+    };
+
+    // one lease per face at a time, the record stays between leases
+    MFGFIX_TEST(FaceTableLeases)
+    {
+        FaceTable<Record> table;
+
+        {
+            auto lease = table.Acquire(0x1000);
+            CHECK(lease && lease->value == 0);
+            lease->value = 7;
+
+            CHECK(!table.Acquire(0x1000));
+            CHECK(table.Acquire(0x2000));
+        }
+
+        CHECK(table.Acquire(0x1000)->value == 7);
+        CHECK(table.Size() == 2);
+    }
+
+    // an erased face starts over; one erased while leased keeps its record until the update lets go
+    MFGFIX_TEST(FaceTableErase)
+    {
+        FaceTable<Record> table;
+
+        table.Acquire(0x1000)->value = 1;
+        table.Acquire(0x2000)->value = 2;
+
+        table.Erase(0x1000);
+        table.Erase(0x3000);
+        CHECK(table.Size() == 1);
+        CHECK(table.Acquire(0x1000)->value == 0);
+
+        {
+            auto lease = table.Acquire(0x2000);
+            table.Erase(0x2000);
+            CHECK(lease->value == 2);
+            lease->value = 3;
+            CHECK(!table.Acquire(0x2000));
+        }
+
+        CHECK(table.Acquire(0x2000)->value == 0);
+
+        // and is acquired once again only
+        {
+            auto lease = table.Acquire(0x2000);
+            CHECK(lease && !table.Acquire(0x2000));
+        }
+    }
+
+    // visits reach leased faces too, never faces without a record or erased ones, and don't create any
+    MFGFIX_TEST(FaceTableVisit)
+    {
+        FaceTable<Record> table;
+
+        table.Acquire(0x1000)->value = 1;
+
+        auto visits = 0;
+        auto visit = [&](Record& a_record) {
+            ++a_record.value;
+            ++visits;
+        };
+
+        table.Visit(0x1000, visit);
+        table.Visit(0x2000, visit);
+        CHECK(visits == 1 && table.Size() == 1);
+
+        {
+            auto lease = table.Acquire(0x1000);
+            table.Visit(0x1000, visit);
+            CHECK(lease->value == 3);
+
+            table.Erase(0x1000);
+            table.Visit(0x1000, visit);
+            CHECK(visits == 2);
+        }
+    }
+
+    // faces not updated for a while are dropped once a shard is full, the ones in use stay
+    MFGFIX_TEST(FaceTableDropsStaleFaces)
+    {
+        FaceTable<Record> table;
+        constexpr std::uintptr_t kShardStep = FaceTable<Record>::kShards << 4;
+
+        auto kept = table.Acquire(kShardStep);
+        kept->value = 5;
+
+        for (std::uintptr_t i = 2; i < 4 * FaceTable<Record>::kMaxPerShard; ++i) {
+            table.Acquire(i * kShardStep);
+        }
+
+        CHECK(table.Size() <= 2 * FaceTable<Record>::kMaxPerShard + 1);
+        CHECK(kept->value == 5);
+        CHECK(!table.Acquire(kShardStep));
+    }
+
+    // erases from another thread while updates lease the faces never hand out a face twice
+    MFGFIX_TEST(FaceTableConcurrentErase)
+    {
+        constexpr std::uintptr_t kFaces = 32;
+        constexpr int kRounds = 20000;
+
+        FaceTable<Record> table;
+        std::vector<std::atomic<int>> leased(kFaces);
+        std::atomic<std::uint32_t> twice{ 0 };
+        std::atomic<bool> done{ false };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 3; ++thread) {
+            threads.emplace_back([&, thread]() {
+                for (int i = 0; i < kRounds; ++i) {
+                    auto face = static_cast<std::uintptr_t>((i * 7 + thread) % kFaces);
+                    if (auto lease = table.Acquire((face + 1) << 4)) {
+                        twice += leased[face].fetch_add(1) != 0;
+                        ++lease->value;
+                        leased[face].fetch_sub(1);
+                    }
+                }
+            });
+        }
+
+        std::thread eraser([&]() {
+            for (std::uintptr_t i = 0; !done.load(); ++i) {
+                table.Erase((i % kFaces + 1) << 4);
+            }
+        });
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        done = true;
+        eraser.join();
+
+        CHECK(twice.load() == 0);
+        CHECK(table.Size() <= kFaces);
+    }
+}
@@ -0,0 +1,234 @@
+#include "Test.h"
+#include "TestFace.h"
+
+#include "core/FaceUpdate.h"
+
+#include <array>
+
+using namespace MfgFix::Core;
+using MfgFix::Tests::TestFace;
+
+namespace
+{
+    std::array<EyesOffsetParams, Expression::Total> eyesOffset{};
+
+    FaceUpdateContext MakeContext(Rng& a_rng, bool a_smooth)
+    {
+        FaceUpdateContext context;
+
+        context.timeDelta = 1.0f / 60.0f;
+        context.speed = a_smooth ? 0.75f : 0.0f;
+        context.animationStep = a_smooth ? context.timeDelta / context.speed : 0.0f;
+        context.blink = { 0.04f, 0.14f, 0.5f, 8.0f };
+        context.track = MakeTrackParams(30.0f, 15.0f, 3.0f, context.timeDelta);
+        context.phonemeThreshold = PhonemeThreshold(50.0f);
+        context.eyesOffset = eyesOffset;
+        context.rng = &a_rng;
+
+        return context;
+    }
+
+    TestFace MakeFace()
+    {
+        TestFace face;
+
+        face.Values(Layer::Expression1)[Expression::MoodAnger] = 0.3f;
+        face.Values(Layer::Expression2)[Expression::MoodHappy] = 0.5f;
+        face.Values(Layer::Modifier2)[Modifier::SquintLeft] = 0.25f;
+        face.Values(Layer::Phoneme1)[Phoneme::Aah] = 0.2f;
+        face.Values(Layer::Phoneme2)[Phoneme::BMP] = 0.4f;
+        face.Values(Layer::Phoneme2)[Phoneme::Eee] = 0.6f;
+        face.Values(Layer::Custom2)[3] = 0.1f;
+
+        return face;
+    }
+
+    MFGFIX_TEST(RegularUpdateMergesLayers)
+    {
+        Rng rng{ 1 };
+        auto face = MakeFace();
+        auto context = MakeContext(rng, false);
+
+        RegularUpdate(face, context);
+
+        auto expression3 = face.Values(Layer::Expression3);
+        CHECK(expression3[Expression::MoodAnger] == 0.0f);  // a set layer 2 replaces layer 1 whole
+        CHECK(expression3[Expression::MoodHappy] == 0.5f);
+
+        auto modifier3 = face.Values(Layer::Modifier3);
+        CHECK(modifier3[Modifier::SquintLeft] == 0.25f);
+        CHECK(modifier3[Modifier::BlinkLeft] == modifier3[Modifier::BlinkRight]);
+
+        auto phoneme3 = face.Values(Layer::Phoneme3);
+        CHECK(phoneme3[Phoneme::Aah] == 0.2f);
+        CHECK(phoneme3[Phoneme::BMP] == 0.4f);
+        CHECK(face.Values(Layer::Custom3)[3] == 0.1f);
+
+        // with dialogue attached script phonemes below the threshold are dropped, from layer 2 too
+        face.SetDialogue(true);
+        RegularUpdate(face, context);
+        CHECK(phoneme3[Phoneme::BMP] == 0.0f);
+        CHECK(phoneme3[Phoneme::Eee] == 0.6f);
+        CHECK(face.Values(Layer::Phoneme2)[Phoneme::BMP] == 0.0f);
+    }
+
+    MFGFIX_TEST(RegularUpdateHeldFaceKeepsEyesClosed)
+    {
+        Rng rng{ 1 };
+        auto face = MakeFace();
+        auto eyes = face.GetEyesState();
+        eyes.blinkStage = BlinkStage::BlinkDownAndWait1;
+        eyes.headingOffset = 0.3f;
+        face.SetEyesState(eyes);
+        face.SetHold(true);
+
+        for (int i = 0; i < 60; ++i) {
+            auto context = MakeContext(rng, false);
+            RegularUpdate(face, context);
+
+            CHECK(face.Values(Layer::Modifier3)[Modifier::BlinkLeft] == 1.0f);
+        }
+
+        // held eyes don't move
+        CHECK(face.GetEyesState().heading == 0.0f);
+    }
+
+    MFGFIX_TEST(SmoothUpdateArrivesOnTargets)
+    {
+        Rng rng{ 1 };
+        auto face = MakeFace();
+
+        // a smooth transition from nothing takes 1 / animationStep frames
+        for (int i = 0; i < 60; ++i) {
+            auto context = MakeContext(rng, true);
+            SmoothUpdate(face, context);
+
+            if (i == 0) {
+                CHECK(face.Values(Layer::Expression3)[Expression::MoodHappy] == context.animationStep);
+            }
+        }
+
+        CHECK(face.Values(Layer::Expression3)[Expression::MoodHappy] == 0.5f);
+        CHECK(face.Values(Layer::Expression3)[Expression::MoodAnger] == 0.3f);  // layer 1 where layer 2 is unset
+        CHECK(face.Values(Layer::Phoneme3)[Phoneme::Eee] == 0.6f);
+        CHECK(face.Values(Layer::Custom3)[3] == 0.1f);
+    }
+
+    // the same seed has to give the same face, the trace replayer depends on it
+    MFGFIX_TEST(UpdatesAreDeterministic)
+    {
+        Rng lhsRng{ 7 };
+        Rng rhsRng{ 7 };
+        auto lhs = MakeFace();
+        auto rhs = MakeFace();
+
+        for (int i = 0; i < 2000; ++i) {
+            auto smooth = (i / 500) % 2 == 1;
+            auto lhsContext = MakeContext(lhsRng, smooth);
+            auto rhsContext = MakeContext(rhsRng, smooth);
+
+            if (smooth) {
+                SmoothUpdate(lhs, lhsContext);
+                SmoothUpdate(rhs, rhsContext);
+            } else {
+                RegularUpdate(lhs, lhsContext);
+                RegularUpdate(rhs, rhsContext);
+            }
+        }
+
+        CHECK(lhs == rhs);
+    }
+
+    // idle and frozen faces skip work, they have to end up exactly where the full update takes them
+    MFGFIX_TEST(IdleFacesMatchFullUpdate)
+    {
+        for (auto smooth : { false, true }) {
+            for (auto hold : { false, true }) {
+                Rng fullRng{ 3 };
+                Rng idleRng{ 3 };
+                auto full = MakeFace();
+                full.SetHold(hold);
+                if (hold) {
+                    auto eyes = full.GetEyesState();
+                    eyes.blinkStage = BlinkStage::BlinkDownAndWait1;
+                    full.SetEyesState(eyes);
+                }
+                auto idle = full;
+                IdleFace state;
+
+                for (int i = 0; i < 600; ++i) {
+                    auto fullContext = MakeContext(fullRng, smooth);
+                    auto idleContext = MakeContext(idleRng, smooth);
+                    idleContext.idle = &state;
+
+                    if (smooth) {
+                        SmoothUpdate(full, fullContext);
+                        SmoothUpdate(idle, idleContext);
+                    } else {
+                        RegularUpdate(full, fullContext);
+                        RegularUpdate(idle, idleContext);
+                    }
+
+                    // a script changing a layer wakes the face up, and so does the engine moving layer 1
+                    if (i == 300) {
+                        full.Values(Layer::Expression2)[Expression::MoodSad] = 0.7f;
+                        idle.Values(Layer::Expression2)[Expression::MoodSad] = 0.7f;
+                        state.Written();
+                    }
+                    if (i == 450) {
+                        full.SetTransition(Expression::MoodFear, 0.2f);
+                        idle.SetTransition(Expression::MoodFear, 0.2f);
+                    }
+
+                    CHECK(full == idle);
+                }
+            }
+        }
+    }
+
+    // resting faces only run the eyes timers until a blink or a saccade comes; across frame times that vary, frames that
+    // don't move time, level of detail switching blinks and saccades off and a script squinting, they end up where
+    // the full update takes them
+    MFGFIX_TEST(RestingFacesMatchFullUpdate)
+    {
+        for (auto smooth : { false, true }) {
+            Rng fullRng{ 5 };
+            Rng idleRng{ 5 };
+            auto full = MakeFace();
+            auto idle = full;
+            IdleFace state;
+
+            for (int i = 0; i < 3000; ++i) {
+                auto fullContext = MakeContext(fullRng, smooth);
+                auto idleContext = MakeContext(idleRng, smooth);
+
+                auto timeDelta = i % 97 == 0 ? 0.0f : 1.0f / static_cast<float>(30 + i % 50);
+                auto lodParts = (i / 400) % 3 == 1 ? LodPart::All & ~(LodPart::Blink | LodPart::Saccades) : LodPart::All;
+
+                for (auto* context : { &fullContext, &idleContext }) {
+                    context->timeDelta = timeDelta;
+                    context->animationStep = smooth ? timeDelta / context->speed : 0.0f;
+                    context->track = MakeTrackParams(30.0f, 15.0f, 3.0f, timeDelta);
+                    context->lodParts = lodParts;
+                }
+                idleContext.idle = &state;
+
+                if (smooth) {
+                    SmoothUpdate(full, fullContext);
+                    SmoothUpdate(idle, idleContext);
+                } else {
+                    RegularUpdate(full, fullContext);
+                    RegularUpdate(idle, idleContext);
+                }
+
+                if (i == 1500) {
+                    full.Values(Layer::Modifier2)[Modifier::SquintRight] = 0.4f;
+                    idle.Values(Layer::Modifier2)[Modifier::SquintRight] = 0.4f;
+                    state.Written();
+                }
+
+                CHECK(full == idle);
+            }
+        }
+    }
+}
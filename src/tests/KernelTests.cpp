@@ -0,0 +1,130 @@
+#include "Test.h"
+
+#include "core/Blend.h"
+#include "core/Random.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cstdio>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    constexpr std::array<std::size_t, 6> kWidths{ 15, 16, 17, 31, 32, 33 };
+
+    // mostly plain values, with plenty of the edges the masks decide on: zeros of both signs, values around
+    // FLT_EPSILON, results a step or exactly on the target away
+    float RandomValue(Rng& a_rng)
+    {
+        switch (a_rng.Next() % 8) {
+        case 0:
+            return 0.0f;
+        case 1:
+            return -0.0f;
+        case 2:
+            return FLT_EPSILON * Random(a_rng, -2.0f, 2.0f);
+        case 3:
+            return a_rng.Next() % 2 ? FLT_EPSILON : -FLT_EPSILON;
+        default:
+            return Random(a_rng, -1.0f, 1.0f);
+        }
+    }
+
+    struct Case
+    {
+        std::vector<float> dialogue;
+        std::vector<float> target;
+        std::vector<float> result;
+        float step{ 0.0f };
+    };
+
+    // a_dialogue and a_target may be shorter than the result, engine keyframes don't always agree on their counts
+    Case MakeCase(Rng& a_rng, std::size_t a_width, std::size_t a_dialogue, std::size_t a_target)
+    {
+        Case result;
+
+        result.step = a_rng.Next() % 8 == 0 ? 0.0f : Random(a_rng, 0.0f, 0.2f);
+
+        for (std::size_t i = 0; i < a_width; ++i) {
+            result.dialogue.push_back(RandomValue(a_rng));
+            result.target.push_back(RandomValue(a_rng));
+
+            switch (a_rng.Next() % 4) {
+            case 0:
+                result.result.push_back(result.target[i]);
+                break;
+            case 1:
+                result.result.push_back(result.target[i] + (a_rng.Next() % 2 ? result.step : -result.step));
+                break;
+            default:
+                result.result.push_back(RandomValue(a_rng));
+                break;
+            }
+        }
+
+        result.dialogue.resize(a_dialogue);
+        result.target.resize(a_target);
+
+        return result;
+    }
+
+    using AnimMerge_t = void (*)(std::span<const float>, std::span<const float>, std::span<float>, float);
+
+    void CheckKernel(AnimMerge_t a_kernel)
+    {
+        Rng rng{ 42 };
+
+        for (auto width : kWidths) {
+            for (int i = 0; i < 2000; ++i) {
+                // every fourth case with a layer narrower than the result
+                auto dialogue = i % 4 == 1 ? width - 1 - rng.Next() % 4 : width;
+                auto target = i % 4 == 2 ? width - 1 - rng.Next() % 4 : width;
+                auto input = MakeCase(rng, width, dialogue, target);
+
+                auto expected = input.result;
+                auto actual = input.result;
+
+                Kernels::AnimMergeScalar(input.dialogue, input.target, expected, input.step);
+                a_kernel(input.dialogue, input.target, actual, input.step);
+
+                CHECK_SAME(actual, expected);
+            }
+        }
+    }
+
+    MFGFIX_TEST(AnimMergeSSE41MatchesScalar)
+    {
+        if (GetSupportedSimdLevel() < SimdLevel::SSE41) {
+            std::printf("AnimMergeSSE41MatchesScalar: no SSE4.1 on this cpu, skipped\n");
+            return;
+        }
+
+        CheckKernel(Kernels::AnimMergeSSE41);
+    }
+
+    MFGFIX_TEST(AnimMergeAVX2MatchesScalar)
+    {
+        if (GetSupportedSimdLevel() < SimdLevel::AVX2) {
+            std::printf("AnimMergeAVX2MatchesScalar: no AVX2 on this cpu, skipped\n");
+            return;
+        }
+
+        CheckKernel(Kernels::AnimMergeAVX2);
+    }
+
+    // AnimMerge through what SelectKernels picked, for every level the cpu has, the dispatch included
+    MFGFIX_TEST(AnimMergeDispatchMatchesScalar)
+    {
+        for (auto level : { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 }) {
+            auto selected = SelectKernels(level);
+            CHECK(selected == std::min(level, GetSupportedSimdLevel()));
+
+            CheckKernel(AnimMerge);
+        }
+
+        SelectKernels();
+    }
+}
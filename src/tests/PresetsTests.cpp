@@ -0,0 +1,215 @@
+#include "Test.h"
+
+#include "core/Presets.h"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    std::vector<float> MakeValues(float a_base)
+    {
+        std::vector<float> values(kPresetSize);
+        for (std::size_t i = 0; i < kPresetSize; ++i) {
+            values[i] = a_base + static_cast<float>(i) * 0.01f;
+        }
+        values[30] = 7.0f;
+        return values;
+    }
+
+    std::string PresetJson(const std::vector<float>& a_values)
+    {
+        std::string text = "[";
+        for (std::size_t i = 0; i < a_values.size(); ++i) {
+            text += (i ? ", " : "") + std::to_string(a_values[i]);
+        }
+        return text + "]";
+    }
+
+    void WriteFile(const std::filesystem::path& a_path, const std::string& a_text)
+    {
+        std::ofstream(a_path, std::ios::binary) << a_text;
+    }
+
+    // steps of 0.01 up to 2.0, the expression id as is; anything out of range or NaN clamped
+    MFGFIX_TEST(PresetPacking)
+    {
+        auto values = MakeValues(0.2f);
+        auto unpacked = Unpack(Pack(values));
+
+        float worst = 0.0f;
+        for (std::size_t i = 0; i < kPresetSize; ++i) {
+            worst = std::max(worst, std::abs(unpacked[i] - values[i]));
+        }
+        CHECK(worst <= 0.005f);
+        CHECK(unpacked[30] == 7.0f);
+
+        values[0] = 3.0f;
+        values[1] = -1.0f;
+        values[2] = std::numeric_limits<float>::quiet_NaN();
+        values[30] = 300.0f;
+        auto packed = Pack(values);
+        CHECK(packed.values[0] == 200 && packed.values[1] == 0 && packed.values[2] == 0 && packed.values[30] == 255);
+
+        // a packed preset packs to itself
+        CHECK(Pack(Unpack(packed)) == packed);
+
+        // short arrays leave the rest at 0
+        CHECK(Pack(std::vector<float>{ 0.5f }).values[0] == 50 && Pack(std::vector<float>{ 0.5f }).values[1] == 0);
+    }
+
+    // lookups ignore ASCII case, the last preset of a name wins, Set keeps the table sorted
+    MFGFIX_TEST(PresetTableLookup)
+    {
+        auto first = Pack(MakeValues(0.1f));
+        auto second = Pack(MakeValues(0.3f));
+        auto third = Pack(MakeValues(0.5f));
+
+        PresetTable table({ { "Smile", first }, { "frown", second }, { "SMILE", third }, { "angry", first } });
+
+        CHECK(table.Size() == 3);
+        CHECK(table.Find("smile") && *table.Find("smile") == third);
+        CHECK(table.Find("FROWN") && *table.Find("FROWN") == second);
+        CHECK(!table.Find("smil") && !table.Find("smiles") && !table.Find(""));
+        CHECK(table.Name(0) == "angry" && table.Name(2) == "SMILE");
+
+        table.Set("Blank", second);
+        table.Set("angry", third);
+        CHECK(table.Size() == 4);
+        CHECK(table.Name(1) == "Blank");
+        CHECK(*table.Find("ANGRY") == third && *table.Find("blank") == second);
+
+        // arrays out of order or pointing past the names aren't taken
+        PresetTable other;
+        CHECK(!other.Assign("ab", { { 1, 1 }, { 0, 1 } }, { first, second }));
+        CHECK(!other.Assign("ab", { { 1, 2 } }, { first }));
+        CHECK(!other.Assign("ab", { { 0, 1 } }, {}));
+        CHECK(other.Assign("ab", { { 0, 1 }, { 1, 1 } }, { first, second }) && *other.Find("B") == second);
+    }
+
+    // presets, skipped members, escapes and a byte order mark; what FormatPresets writes reads back the same
+    MFGFIX_TEST(PresetParsing)
+    {
+        auto values = MakeValues(0.0f);
+        std::string text = "\xEF\xBB\xBF{\n"
+                           "  \"happy \\\"one\\\"\": " + PresetJson(values) + ",\n"
+                           "  \"short\": [1, 2, 3],\n"
+                           "  \"comment\": { \"note\": [true, null, \"x\"] },\n"
+                           "  \"mixed\": [\"x\", " + PresetJson(MakeValues(0.0f)).substr(1) + ",\n"
+                           "  \"caf\\u00e9 \\ud83d\\ude00\": " + PresetJson(MakeValues(0.5f)) + "\n"
+                           "}\n";
+
+        auto parse = ParsePresets(text);
+        CHECK(parse.error.empty());
+        CHECK(parse.presets.size() == 2);
+        CHECK(parse.skipped == (std::vector<std::string>{ "short", "comment", "mixed" }));
+        CHECK(parse.presets[0].name == "happy \"one\"" && parse.presets[0].preset == Pack(values));
+        CHECK(parse.presets[1].name == "caf\xC3\xA9 \xF0\x9F\x98\x80");
+
+        PresetTable table(parse.presets);
+        auto again = ParsePresets(FormatPresets(table));
+        CHECK(again.error.empty() && again.presets.size() == 2);
+        CHECK(PresetTable(again.presets).Presets().size() == 2);
+        CHECK(again.presets[0].preset == table.Preset(0) && again.presets[1].preset == table.Preset(1));
+        CHECK(again.presets[0].name == table.Name(0) && again.presets[1].name == table.Name(1));
+
+        CHECK(ParsePresets("{}").presets.empty() && ParsePresets("{}").error.empty());
+    }
+
+    // a syntax error says where it is and leaves nothing behind
+    MFGFIX_TEST(PresetParseErrors)
+    {
+        auto parse = ParsePresets("{\n\"a\": " + PresetJson(MakeValues(0.0f)) + ",\n\"b\": [1, 2,\n}");
+        CHECK(parse.presets.empty() && parse.skipped.empty());
+        CHECK(parse.error.starts_with("line 4:"));
+
+        CHECK(!ParsePresets("").error.empty());
+        CHECK(!ParsePresets("[]").error.empty());
+        CHECK(!ParsePresets("{\"a\": 1} x").error.empty());
+        CHECK(!ParsePresets("{\"a\": \"\\q\"}").error.empty());
+        CHECK(!ParsePresets("{\"a\": \"unterminated}").error.empty());
+        CHECK(!ParsePresets("{\"a\": \"\\u12\"}").error.empty());
+        CHECK(!ParsePresets("{\"a\": tru}").error.empty());
+        CHECK(!ParsePresets("{\"a\": " + std::string(100, '[') + std::string(100, ']') + "}").error.empty());
+    }
+
+    // the cache is taken while the sources are the same, a changed or broken file compiles them again;
+    // a file that fails to parse is reported and keeps the presets from being cached
+    MFGFIX_TEST(PresetLoadAndCache)
+    {
+        auto directory = std::filesystem::temp_directory_path() / "mfgfix-tests-presets";
+        auto cache = std::filesystem::temp_directory_path() / "mfgfix-tests-presets.bin";
+
+        std::filesystem::remove_all(directory);
+        std::filesystem::remove(cache);
+        std::filesystem::create_directories(directory);
+
+        WriteFile(directory / "a.json", "{ \"smile\": " + PresetJson(MakeValues(0.1f)) + ", \"frown\": " + PresetJson(MakeValues(0.2f)) + " }");
+        WriteFile(directory / "b.JSON", "{ \"Smile\": " + PresetJson(MakeValues(0.3f)) + ", \"bad\": [1] }");
+        WriteFile(directory / "c.txt", "not a preset file");
+
+        PresetLoad load;
+        auto table = LoadPresets(directory, cache, load);
+        CHECK(load.files == 2 && load.failed == 0 && load.skipped == 1 && !load.cached);
+        CHECK(load.errors.size() == 1);
+        CHECK(table.Size() == 2);
+        CHECK(table.Find("smile") && *table.Find("smile") == Pack(MakeValues(0.3f)));
+        CHECK(std::filesystem::exists(cache));
+
+        load = {};
+        auto cached = LoadPresets(directory, cache, load);
+        CHECK(load.cached);
+        CHECK(cached.Size() == table.Size() && cached.Names() == table.Names());
+        CHECK(*cached.Find("FROWN") == *table.Find("frown"));
+
+        // another size and write time, the cache no longer matches
+        WriteFile(directory / "a.json", "{ \"smile\": " + PresetJson(MakeValues(0.4f)) + " }");
+        std::filesystem::last_write_time(directory / "a.json", std::filesystem::last_write_time(directory / "a.json") + std::chrono::seconds(5));
+
+        load = {};
+        table = LoadPresets(directory, cache, load);
+        CHECK(!load.cached && table.Size() == 1);
+
+        // a broken file adds nothing and isn't cached over
+        WriteFile(directory / "d.json", "{ \"oops\": [1, 2 }");
+
+        load = {};
+        table = LoadPresets(directory, cache, load);
+        CHECK(!load.cached && load.failed == 1 && table.Size() == 1);
+        CHECK(load.errors.size() == 2 && load.errors.back().starts_with("d.json: line 1:"));
+
+        load = {};
+        LoadPresets(directory, cache, load);
+        CHECK(!load.cached && load.failed == 1);
+
+        // a truncated cache is ignored
+        std::filesystem::remove(directory / "d.json");
+        load = {};
+        table = LoadPresets(directory, cache, load);
+        auto key = PresetSourcesKey(FindPresetSources(directory));
+        PresetTable fromCache;
+        CHECK(LoadPresetCache(cache, fromCache, key) && fromCache.Size() == 1);
+        CHECK(!LoadPresetCache(cache, fromCache, key + 1));
+
+        std::filesystem::resize_file(cache, std::filesystem::file_size(cache) - 1);
+        CHECK(!LoadPresetCache(cache, fromCache, key));
+
+        load = {};
+        table = LoadPresets(directory, cache, load);
+        CHECK(!load.cached && table.Size() == 1);
+
+        load = {};
+        LoadPresets(directory / "missing", cache, load);
+        CHECK(load.files == 0);
+
+        std::filesystem::remove_all(directory);
+        std::filesystem::remove(cache);
+    }
+}
@@ -0,0 +1,157 @@
+#include "Test.h"
+
+#include "core/Published.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    std::atomic<std::int64_t> alive{ 0 };
+
+    // the n-th publish has every field n, a read mixing two publishes or of a freed copy shows
+    struct Value
+    {
+        Value() { ++alive; }
+        explicit Value(std::uint32_t a_version) :
+            version(a_version)
+        {
+            fields.fill(a_version);
+            ++alive;
+        }
+        Value(const Value& a_other) :
+            version(a_other.version),
+            fields(a_other.fields)
+        {
+            ++alive;
+        }
+        Value& operator=(const Value&) = default;
+        ~Value()
+        {
+            fields.fill(0xDEADBEEF);
+            --alive;
+        }
+
+        bool Whole() const
+        {
+            return std::all_of(fields.begin(), fields.end(), [&](std::uint32_t a_field) { return a_field == version; });
+        }
+
+        std::uint32_t version{ 0 };
+        std::array<std::uint32_t, 64> fields{};
+    };
+
+    // a reader keeps what it got however many publishes come after, the copy goes when the reader lets go
+    MFGFIX_TEST(PublishedHeldValueOutlivesPublishes)
+    {
+        {
+            Published<Value> published{ Value(1) };
+
+            auto held = published.Get();
+
+            for (std::uint32_t version = 2; version < 1000; ++version) {
+                published.Publish(Value(version));
+            }
+
+            CHECK(held->version == 1 && held->Whole());
+            CHECK(published.Get()->version == 999);
+            CHECK(alive.load() == 2);
+
+            held.reset();
+            CHECK(alive.load() == 1);
+
+            published.Update([](Value& a_value) { a_value = Value(a_value.version + 1); });
+            CHECK(published.Get()->version == 1000 && published.Get()->Whole());
+        }
+
+        CHECK(alive.load() == 0);
+    }
+
+    // a reader sees every publish on its next read and keeps its copy alive until then
+    MFGFIX_TEST(PublishedReaderFollowsPublishes)
+    {
+        {
+            Published<Value> published{ Value(1) };
+            Published<Value>::Reader reader;
+
+            auto& first = reader.Get(published);
+            CHECK(first.version == 1);
+            CHECK(&reader.Get(published) == &first);
+
+            published.Publish(Value(2));
+            published.Update([](Value& a_value) { a_value = Value(a_value.version + 1); });
+
+            // the replaced copies, the one the reader holds included, until it reads again
+            CHECK(first.version == 1 && first.Whole());
+            CHECK(alive.load() == 2);
+
+            CHECK(reader.Get(published).version == 3 && reader.Get(published).Whole());
+            CHECK(alive.load() == 1);
+        }
+
+        CHECK(alive.load() == 0);
+    }
+
+    // writers publishing and updating while readers hold what they read across yields,
+    // every read is one publish, whole, and versions never go back
+    MFGFIX_TEST(PublishedConcurrentReadersWriters)
+    {
+        constexpr std::size_t kWriters = 2;
+        constexpr std::size_t kReaders = 4;
+        constexpr std::uint32_t kPublishes = 20000;
+
+        {
+            Published<Value> published{ Value(0) };
+            std::atomic<std::uint32_t> next{ 0 };
+            std::atomic<std::size_t> writing{ kWriters };
+            std::atomic<std::uint64_t> broken{ 0 };
+
+            std::vector<std::thread> threads;
+
+            // Update serializes the writers, so versions go up by one
+            for (std::size_t writer = 0; writer < kWriters; ++writer) {
+                threads.emplace_back([&]() {
+                    while (next.fetch_add(1, std::memory_order_relaxed) < kPublishes) {
+                        published.Update([](Value& a_value) { a_value = Value(a_value.version + 1); });
+                    }
+
+                    writing.fetch_sub(1, std::memory_order_release);
+                });
+            }
+
+            for (std::size_t reader = 0; reader < kReaders; ++reader) {
+                threads.emplace_back([&]() {
+                    std::uint64_t threadBroken = 0;
+                    std::uint32_t seen = 0;
+
+                    do {
+                        auto value = published.Get();
+                        threadBroken += !value->Whole() || value->version < seen;
+                        seen = value->version;
+
+                        // held while the writers go on
+                        std::this_thread::yield();
+                        threadBroken += !value->Whole() || value->version != seen;
+                    } while (writing.load(std::memory_order_acquire));
+
+                    broken += threadBroken;
+                });
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            CHECK(broken.load() == 0);
+            CHECK(published.Get()->version == kPublishes);
+            CHECK(alive.load() == 1);
+        }
+
+        CHECK(alive.load() == 0);
+    }
+}
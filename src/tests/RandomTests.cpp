@@ -0,0 +1,148 @@
+#include "Test.h"
+
+#include "core/Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    constexpr std::size_t kSamples = 50000;
+
+    // largest distance between the empirical cdfs of two sample sets, both sorted
+    double KolmogorovSmirnov(const std::vector<float>& a_lhs, const std::vector<float>& a_rhs)
+    {
+        double worst = 0.0;
+        std::size_t i = 0;
+        std::size_t j = 0;
+
+        while (i < a_lhs.size() && j < a_rhs.size()) {
+            auto x = std::min(a_lhs[i], a_rhs[j]);
+            while (i < a_lhs.size() && a_lhs[i] == x) {
+                ++i;
+            }
+            while (j < a_rhs.size() && a_rhs[j] == x) {
+                ++j;
+            }
+            worst = std::max(worst, std::abs(static_cast<double>(i) / a_lhs.size() - static_cast<double>(j) / a_rhs.size()));
+        }
+
+        return worst;
+    }
+
+    // two sets of kSamples from one distribution are this far apart less than once in a thousand runs
+    double Critical()
+    {
+        return 1.95 * std::sqrt(2.0 / kSamples);
+    }
+
+    // how the hook drew before it had a generator per thread: std::rand scaled to [0, 1], then pow
+    std::vector<float> OldDraws(float a_min, float a_max, float a_exponent)
+    {
+        std::srand(1);
+
+        std::vector<float> draws(kSamples);
+        for (auto& draw : draws) {
+            auto u = static_cast<float>(std::rand()) / RAND_MAX;
+            draw = a_min + (a_max - a_min) * std::pow(u, a_exponent);
+        }
+
+        std::sort(draws.begin(), draws.end());
+        return draws;
+    }
+
+    std::vector<float> NewDraws(float a_min, float a_max, float a_exponent)
+    {
+        Rng rng{ Rng::kDefaultSeed };
+        PowerCurve curve{ a_exponent };
+
+        std::vector<float> draws(kSamples);
+        for (auto& draw : draws) {
+            draw = Random(rng, a_min, a_max, curve);
+        }
+
+        std::sort(draws.begin(), draws.end());
+        return draws;
+    }
+
+    // same seed and stream, same sequence; another stream or seed, another sequence; a saved state replays it
+    MFGFIX_TEST(RngDeterministic)
+    {
+        Rng lhs{ 42, 3 };
+        Rng rhs{ 42, 3 };
+        Rng stream{ 42, 4 };
+        Rng seed{ 43, 3 };
+
+        std::uint32_t same = 0;
+        std::uint32_t otherStream = 0;
+        std::uint32_t otherSeed = 0;
+
+        for (int i = 0; i < 1000; ++i) {
+            auto value = lhs.Next();
+            same += value == rhs.Next();
+            otherStream += value == stream.Next();
+            otherSeed += value == seed.Next();
+        }
+
+        CHECK(same == 1000);
+        CHECK(otherStream < 2);
+        CHECK(otherSeed < 2);
+
+        auto state = lhs.GetState();
+        auto first = lhs.Next();
+        lhs.Next();
+        lhs.SetState(state);
+        CHECK(lhs.Next() == first);
+    }
+
+    // Uniform against the uniform cdf, and a 50 bucket histogram against its even shares
+    MFGFIX_TEST(RngUniformDistribution)
+    {
+        Rng rng{ Rng::kDefaultSeed };
+
+        std::vector<float> draws(kSamples);
+        for (auto& draw : draws) {
+            draw = rng.Uniform();
+        }
+        std::sort(draws.begin(), draws.end());
+
+        double worst = 0.0;
+        for (std::size_t i = 0; i < draws.size(); ++i) {
+            worst = std::max({ worst, std::abs(static_cast<double>(i + 1) / kSamples - draws[i]), std::abs(static_cast<double>(i) / kSamples - draws[i]) });
+        }
+
+        // one sample set against a known cdf, p = 0.001
+        CHECK(worst < 1.95 / std::sqrt(static_cast<double>(kSamples)));
+        CHECK(draws.front() >= 0.0f && draws.back() < 1.0f);
+
+        std::vector<std::uint32_t> buckets(50, 0);
+        for (auto draw : draws) {
+            ++buckets[static_cast<std::size_t>(draw * buckets.size())];
+        }
+
+        auto share = static_cast<double>(kSamples) / buckets.size();
+        double chiSquare = 0.0;
+        for (auto count : buckets) {
+            chiSquare += (count - share) * (count - share) / share;
+        }
+
+        // 49 degrees of freedom, p = 0.001
+        CHECK(chiSquare < 85.35);
+    }
+
+    // the delay draws for every kind of curve, square, root and table, against the std::rand and pow they replaced
+    MFGFIX_TEST(RandomMatchesOldDistributions)
+    {
+        for (auto exponent : { 1.0f, 2.0f, 0.5f, 0.75f, 3.5f }) {
+            auto distance = KolmogorovSmirnov(OldDraws(0.5f, 4.0f, exponent), NewDraws(0.5f, 4.0f, exponent));
+            CHECK(distance < Critical());
+        }
+
+        // a distribution that differs is told apart, so the test can fail
+        CHECK(KolmogorovSmirnov(OldDraws(0.5f, 4.0f, 2.0f), NewDraws(0.5f, 4.0f, 2.2f)) > Critical());
+    }
+}
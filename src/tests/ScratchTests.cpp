@@ -0,0 +1,204 @@
+#include "Test.h"
+#include "TestFace.h"
+
+#include "core/FaceUpdate.h"
+#include "core/Scratch.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+using namespace MfgFix::Core;
+using MfgFix::Tests::TestFace;
+
+namespace
+{
+    std::array<EyesOffsetParams, Expression::Total> eyesOffset{};
+
+    FaceUpdateContext MakeContext(Rng& a_rng, bool a_smooth)
+    {
+        FaceUpdateContext context;
+
+        context.timeDelta = 1.0f / 60.0f;
+        context.speed = a_smooth ? 0.75f : 0.0f;
+        context.animationStep = a_smooth ? context.timeDelta / context.speed : 0.0f;
+        context.blink = { 0.04f, 0.14f, 0.5f, 8.0f };
+        context.track = MakeTrackParams(30.0f, 15.0f, 3.0f, context.timeDelta);
+        context.phonemeThreshold = PhonemeThreshold(50.0f);
+        context.eyesOffset = eyesOffset;
+        context.rng = &a_rng;
+
+        return context;
+    }
+
+    TestFace MakeFace()
+    {
+        TestFace face;
+
+        face.Values(Layer::Expression1)[Expression::MoodAnger] = 0.3f;
+        face.Values(Layer::Expression2)[Expression::MoodHappy] = 0.5f;
+        face.Values(Layer::Modifier2)[Modifier::SquintLeft] = 0.25f;
+        face.Values(Layer::Phoneme1)[Phoneme::Aah] = 0.2f;
+        face.Values(Layer::Phoneme2)[Phoneme::BMP] = 0.4f;
+        face.Values(Layer::Phoneme2)[Phoneme::Eee] = 0.6f;
+        face.Values(Layer::Custom2)[3] = 0.1f;
+
+        return face;
+    }
+
+    // the copy the plugin takes with the lock held, the layer 1 step first; the only timer of a TestFace is the blink value
+    void Load(TestFace& a_face, const FaceUpdateContext& a_context, ScratchFace& a_scratch)
+    {
+        auto moved = a_face.TransitionUpdate(a_context.timeDelta);
+        a_face.DialogueModifiersUpdate(a_context.timeDelta);
+        a_face.DialoguePhonemesUpdate(a_context.timeDelta);
+
+        auto& input = a_scratch.Input();
+
+        for (std::size_t i = 0; i < ScratchFace::kLayers; ++i) {
+            auto layer = static_cast<Layer>(i);
+            auto values = a_face.Values(layer);
+
+            input.layers[i].count = static_cast<std::uint32_t>(values.size());
+            input.layers[i].timer = layer == Layer::Modifier2 ? a_face.BlinkValue() : 0.0f;
+            std::copy(values.begin(), values.end(), input.layers[i].values.begin());
+        }
+
+        input.eyes = a_face.GetEyesState();
+
+        a_scratch.Begin(a_face.Hold(), a_face.Dialogue(), moved);
+    }
+
+    // the write back with the lock held again, returns the conflicts
+    std::uint32_t Store(TestFace& a_face, const ScratchFace& a_scratch)
+    {
+        ScratchFace::View current;
+        for (std::size_t i = 0; i < ScratchFace::kLayers; ++i) {
+            auto layer = static_cast<Layer>(i);
+            current[i] = { a_face.Values(layer), layer == Layer::Modifier2 ? a_face.BlinkValue() : 0.0f };
+        }
+
+        auto plan = a_scratch.Plan(current, a_face.GetEyesState());
+
+        for (std::size_t i = 0; i < ScratchFace::kLayers; ++i) {
+            auto layer = static_cast<Layer>(i);
+            auto& result = a_scratch.Output().layers[i];
+
+            if (plan.values & ScratchFace::Bit(layer)) {
+                std::copy_n(result.values.begin(), result.count, a_face.Values(layer).begin());
+            }
+            if ((plan.timers & ScratchFace::Bit(layer)) && layer == Layer::Modifier2) {
+                a_face.BlinkValue() = result.timer;
+            }
+        }
+
+        if (plan.values & ScratchFace::kEyes) {
+            a_face.SetEyesState(a_scratch.Output().eyes);
+        }
+
+        return static_cast<std::uint32_t>(std::popcount(plan.conflicts));
+    }
+
+    void Update(ScratchFace& a_face, FaceUpdateContext& a_context, bool a_smooth)
+    {
+        if (a_smooth) {
+            SmoothUpdate(a_face, a_context);
+        } else {
+            RegularUpdate(a_face, a_context);
+        }
+    }
+
+    // the update on a copy written back ends up where the update in place takes the face, idle or not, held or in dialogue,
+    // with the engine moving layer 1 and a script writing between frames; nobody writes while the copy is out
+    MFGFIX_TEST(ScratchUpdateMatchesInPlace)
+    {
+        for (auto smooth : { false, true }) {
+            for (auto variant : { 0, 1, 2 }) {
+                Rng lockedRng{ 9 };
+                Rng scratchRng{ 9 };
+                auto locked = MakeFace();
+                locked.SetHold(variant == 1);
+                locked.SetDialogue(variant == 2);
+                auto copied = locked;
+                IdleFace lockedIdle;
+                IdleFace scratchIdle;
+                ScratchFace scratch;
+                std::uint32_t conflicts = 0;
+
+                for (int i = 0; i < 600; ++i) {
+                    if (i == 200) {
+                        locked.SetTransition(Expression::MoodFear, 0.2f);
+                        copied.SetTransition(Expression::MoodFear, 0.2f);
+                    }
+                    if (i == 400) {
+                        locked.Values(Layer::Phoneme2)[Phoneme::Oh] = 0.8f;
+                        copied.Values(Layer::Phoneme2)[Phoneme::Oh] = 0.8f;
+                        lockedIdle.Written();
+                        scratchIdle.Written();
+                    }
+
+                    auto lockedContext = MakeContext(lockedRng, smooth);
+                    auto scratchContext = MakeContext(scratchRng, smooth);
+                    lockedContext.idle = &lockedIdle;
+                    scratchContext.idle = &scratchIdle;
+
+                    if (smooth) {
+                        SmoothUpdate(locked, lockedContext);
+                    } else {
+                        RegularUpdate(locked, lockedContext);
+                    }
+
+                    Load(copied, scratchContext, scratch);
+                    Update(scratch, scratchContext, smooth);
+                    scratch.End();
+                    conflicts += Store(copied, scratch);
+
+                    CHECK(locked == copied);
+                }
+
+                CHECK(conflicts == 0);
+            }
+        }
+    }
+
+    // a script writing while the copy is out: a channel the update doesn't write keeps the script's value and the update's
+    // blink and eyes still go in, a layer the update also wrote keeps the script's values whole
+    MFGFIX_TEST(ScratchKeepsWritesMadeMeanwhile)
+    {
+        for (auto smooth : { false, true }) {
+            Rng rng{ 11 };
+            auto face = MakeFace();
+            ScratchFace scratch;
+
+            // blinking, so the update moves the blink value
+            auto eyes = face.GetEyesState();
+            eyes.blinkStage = BlinkStage::BlinkDown;
+            face.SetEyesState(eyes);
+
+            auto context = MakeContext(rng, smooth);
+
+            Load(face, context, scratch);
+            Update(scratch, context, smooth);
+            scratch.End();
+
+            face.Values(Layer::Modifier2)[Modifier::SquintRight] = 0.75f;
+            face.Values(Layer::Modifier3)[Modifier::SquintRight] = 0.5f;
+
+            auto modifier3 = face.Values(Layer::Modifier3);
+            std::array<float, Modifier::Total> written;
+            std::copy(modifier3.begin(), modifier3.end(), written.begin());
+
+            CHECK(Store(face, scratch) == 1);
+
+            CHECK(face.Values(Layer::Modifier2)[Modifier::SquintRight] == 0.75f);
+            CHECK_SAME(face.Values(Layer::Modifier3), written);
+            CHECK(face.BlinkValue() == scratch.Output()[Layer::Modifier2].timer);
+            CHECK(!smooth || face.BlinkValue() != 0.0f);
+
+            auto stored = face.GetEyesState();
+            CHECK(std::memcmp(&stored, &scratch.Output().eyes, sizeof(EyesState)) == 0);
+            CHECK_SAME(face.Values(Layer::Expression3), scratch.Output()[Layer::Expression3].Values());
+        }
+    }
+}
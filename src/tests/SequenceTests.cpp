@@ -0,0 +1,253 @@
+#include "Test.h"
+
+#include "core/Random.h"
+#include "core/Sequence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    // what a face shows of a sequence at a_time within a pass, found from scratch: the keys around it, shifted by
+    // a pass where a loop wraps, linear in between; false before the first key of the first pass
+    bool Reference(const Sequence& a_sequence, const Sequence::Track& a_track, float a_time, bool a_wrapped, std::uint8_t& a_id, std::int32_t& a_value)
+    {
+        std::vector<SequenceKey> keys(a_sequence.keys.begin() + a_track.begin, a_sequence.keys.begin() + a_track.end);
+
+        std::size_t after = 0;
+        while (after < keys.size() && keys[after].time <= a_time) {
+            ++after;
+        }
+
+        SequenceKey previous;
+        SequenceKey next;
+        float previousTime;
+        float nextTime;
+
+        if (after == 0) {
+            if (!a_wrapped) {
+                return false;
+            }
+            previous = keys.back();
+            next = keys.front();
+            previousTime = previous.time - a_sequence.duration;
+            nextTime = next.time;
+        } else if (after == keys.size()) {
+            previous = keys.back();
+            next = a_sequence.loop ? keys.front() : previous;
+            previousTime = previous.time;
+            nextTime = a_sequence.loop ? next.time + a_sequence.duration : previousTime;
+        } else {
+            previous = keys[after - 1];
+            next = keys[after];
+            previousTime = previous.time;
+            nextTime = next.time;
+        }
+
+        auto slope = 0.0f;
+        if (nextTime > previousTime && (a_track.channel != SequenceChannel::Expression || previous.id == next.id)) {
+            slope = static_cast<float>(next.value - previous.value) / (nextTime - previousTime);
+        }
+
+        auto value = static_cast<float>(previous.value) + slope * (a_time - previousTime);
+
+        a_id = previous.id;
+        a_value = std::clamp(static_cast<std::int32_t>(value + (value < 0.0f ? -0.5f : 0.5f)), 0, 200);
+        return true;
+    }
+
+    std::vector<SequenceKey> RandomKeys(Rng& a_rng, float a_duration)
+    {
+        std::vector<SequenceKey> keys;
+        auto count = 1 + a_rng.Next() % 40;
+
+        for (std::uint32_t i = 0; i < count; ++i) {
+            SequenceKey key;
+            key.time = a_rng.Next() % 8 == 0 ? 0.0f : a_rng.Uniform() * a_duration;
+            key.channel = static_cast<SequenceChannel>(a_rng.Next() % 3);
+            key.id = static_cast<std::uint8_t>(a_rng.Next() % (key.channel == SequenceChannel::Modifier ? kPresetModifiers : 3));
+            key.value = static_cast<std::int32_t>(a_rng.Next() % 201);
+            keys.push_back(key);
+        }
+
+        // keys on the same time, a step
+        if (keys.size() > 1) {
+            keys.push_back(keys.front());
+            keys.back().value = 200 - keys.front().value;
+        }
+
+        return keys;
+    }
+
+    // the player walks its cursors and caches a line per pair of keys; every step shows what searching the keys
+    // from scratch shows, over random sequences, frame times, loops and passes
+    MFGFIX_TEST(SequencePlayerMatchesReference)
+    {
+        Rng rng{ Rng::kDefaultSeed };
+        std::uint32_t mismatched = 0;
+        std::uint32_t steps = 0;
+
+        for (int round = 0; round < 300; ++round) {
+            auto duration = 0.2f + rng.Uniform() * 3.0f;
+            auto loop = round % 2 == 0;
+            auto sequence = std::make_shared<Sequence>(MakeSequence(RandomKeys(rng, duration), duration, loop, 0.0f, std::nullopt));
+
+            SequencePlayer player(sequence);
+            float time = 0.0f;
+            bool wrapped = false;
+            bool ended = false;
+
+            for (int frame = 0; frame < 400 && !ended; ++frame) {
+                // now and then a frame longer than a pass, or none at all
+                auto timeDelta = frame % 53 == 0 ? duration * 1.5f : frame % 31 == 0 ? 0.0f : 1.0f / (20.0f + static_cast<float>(rng.Next() % 120));
+
+                PendingFace out;
+                auto playing = player.Step(timeDelta, out);
+
+                time += timeDelta;
+                if (time >= sequence->duration) {
+                    if (sequence->loop) {
+                        time = std::fmod(time, sequence->duration);
+                        wrapped = true;
+                    } else {
+                        time = sequence->duration;
+                        ended = true;
+                    }
+                }
+
+                PendingFace expected;
+                for (auto& track : sequence->tracks) {
+                    std::uint8_t id;
+                    std::int32_t value;
+                    if (!Reference(*sequence, track, time, wrapped, id, value)) {
+                        continue;
+                    }
+
+                    FaceCommand command;
+                    command.kind = track.channel == SequenceChannel::Phoneme ? CommandKind::Phoneme : track.channel == SequenceChannel::Modifier ? CommandKind::Modifier : CommandKind::Expression;
+                    command.id = id;
+                    command.value = value;
+                    expected.Merge(command, nullptr);
+                }
+
+                ++steps;
+                mismatched += playing == ended || out.phonemeMask != expected.phonemeMask || out.modifierMask != expected.modifierMask ||
+                              out.phonemes != expected.phonemes || out.modifiers != expected.modifiers || out.setExpression != expected.setExpression ||
+                              (expected.setExpression && (out.expression != expected.expression || out.expressionValue != expected.expressionValue));
+            }
+        }
+
+        CHECK(steps > 50000);
+        CHECK(mismatched == 0);
+    }
+
+    // keys out of range go, tracks are sorted by channel and time, the duration covers the keys, a loop needs one
+    MFGFIX_TEST(MakeSequenceCleansKeys)
+    {
+        std::vector<SequenceKey> keys{
+            { 1.0f, SequenceChannel::Phoneme, 2, 100 },
+            { 0.5f, SequenceChannel::Phoneme, 2, 50 },
+            { -1.0f, SequenceChannel::Phoneme, 2, 50 },
+            { NAN, SequenceChannel::Phoneme, 2, 50 },
+            { 0.0f, SequenceChannel::Phoneme, Phoneme::Total, 50 },
+            { 0.0f, SequenceChannel::Modifier, kPresetModifiers, 50 },
+            { 0.0f, SequenceChannel::Expression, Expression::Total, 50 },
+            { 0.0f, static_cast<SequenceChannel>(7), 0, 50 },
+            { 2.5f, SequenceChannel::Expression, 3, 80 },
+            { 0.2f, SequenceChannel::Expression, 1, 40 },
+        };
+
+        auto sequence = MakeSequence(keys, 1.0f, true, -3.0f, std::nullopt);
+
+        CHECK(sequence.keys.size() == 4);
+        CHECK(sequence.tracks.size() == 2);
+        CHECK(sequence.tracks[0].channel == SequenceChannel::Phoneme && sequence.tracks[0].end - sequence.tracks[0].begin == 2);
+        CHECK(sequence.keys[sequence.tracks[0].begin].time == 0.5f);
+        CHECK(sequence.tracks[1].channel == SequenceChannel::Expression && sequence.tracks[1].end - sequence.tracks[1].begin == 2);
+        CHECK(sequence.duration == 2.5f && sequence.loop && sequence.ttl == 0.0f);
+
+        CHECK(!MakeSequence({}, 0.0f, true, 0.0f, std::nullopt).loop);
+        CHECK(MakeSequence({}, INFINITY, false, INFINITY, std::nullopt).duration == 0.0f);
+    }
+
+    // the expression switches at the key that changes its id instead of blending two expressions
+    MFGFIX_TEST(SequenceExpressionSwitches)
+    {
+        auto sequence = std::make_shared<Sequence>(MakeSequence({ { 0.0f, SequenceChannel::Expression, 1, 0 }, { 1.0f, SequenceChannel::Expression, 2, 100 } }, 1.0f, false, 0.0f, std::nullopt));
+        SequencePlayer player(sequence);
+
+        PendingFace out;
+        player.Step(0.5f, out);
+        CHECK(out.setExpression && out.expression == 1 && out.expressionValue == 0);
+
+        out = {};
+        player.Step(0.5f, out);
+        CHECK(out.expression == 2 && out.expressionValue == 100);
+    }
+
+    // a pass that ends applies the next preset; the ttl resets the face, also in the middle of a loop
+    MFGFIX_TEST(SequenceEnds)
+    {
+        ExpressionPreset next;
+        next.expression = 4;
+        next.expressionValue = 60;
+        next.setPhonemes = false;
+        next.modifiers.fill(10);
+
+        auto once = std::make_shared<Sequence>(MakeSequence({ { 0.0f, SequenceChannel::Phoneme, 0, 0 }, { 1.0f, SequenceChannel::Phoneme, 0, 100 } }, 1.0f, false, 0.0f, next));
+        SequencePlayer player(once);
+
+        PendingFace out;
+        CHECK(player.Step(0.4f, out) && out.phonemes[0] == 40 && !out.setExpression);
+
+        out = {};
+        CHECK(!player.Step(0.7f, out));
+        CHECK(out.phonemes[0] == 100 && out.expression == 4 && out.expressionValue == 60 && out.modifiers[3] == 10);
+
+        auto looping = std::make_shared<Sequence>(MakeSequence({ { 0.0f, SequenceChannel::Modifier, 1, 0 }, { 0.5f, SequenceChannel::Modifier, 1, 100 } }, 1.0f, true, 2.0f, std::nullopt));
+        SequencePlayer loop(looping);
+
+        std::uint32_t frames = 0;
+        for (out = {}; loop.Step(0.1f, out); out = {}) {
+            ++frames;
+        }
+
+        CHECK(frames >= 19 && frames <= 20);
+        CHECK(out.reset == FaceReset::All && out.modifierMask == 0);
+    }
+
+    // one sequence per face; started, stepped, stopped and dropped with the actor that started it
+    MFGFIX_TEST(SequenceBoardFaces)
+    {
+        auto sequence = std::make_shared<Sequence>(MakeSequence({ { 0.0f, SequenceChannel::Phoneme, 0, 50 } }, 1.0f, true, 0.0f, std::nullopt));
+
+        SequenceBoard board;
+        PendingFace pending;
+
+        CHECK(board.Step(0x100, 0.1f, pending) == SequenceStep::None);
+
+        board.Start(0x100, 1, sequence, 0.5f);
+        board.Start(0x200, 2, sequence, 0.0f);
+        board.Start(0x300, 2, sequence, 0.0f);
+        board.Start(0x100, 1, sequence, 0.75f);
+        CHECK(board.Size() == 3);
+
+        CHECK(board.Step(0x100, 0.1f, pending) == SequenceStep::Started);
+        CHECK(pending.owner == 1 && pending.speed == 0.75f && pending.phonemes[0] == 50);
+        CHECK(board.Step(0x100, 0.1f, pending) == SequenceStep::Playing);
+
+        CHECK(board.Stop(0x100) && !board.Stop(0x100));
+        CHECK(board.EraseOwner(2) == 2);
+        CHECK(board.Size() == 0);
+
+        // a face loading at a reused address drops what another actor started there
+        board.Start(0x400, 3, sequence, 0.0f);
+        CHECK(!board.EraseForeign(0x400, 3));
+        CHECK(board.EraseForeign(0x400, 4));
+        CHECK(board.Size() == 0 && board.Step(0x400, 0.1f, pending) == SequenceStep::None);
+    }
+}
@@ -0,0 +1,412 @@
+#include "Test.h"
+
+#include "core/Random.h"
+#include "mfgfix/Settings.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace MfgFix;
+
+namespace
+{
+    std::string Lower(std::string_view a_text)
+    {
+        std::string text{ a_text };
+        std::ranges::transform(text, text.begin(), [](unsigned char a_char) { return static_cast<char>(std::tolower(a_char)); });
+        return text;
+    }
+
+    std::string Trim(std::string_view a_text)
+    {
+        auto begin = a_text.find_first_not_of(" \t\r");
+        auto end = a_text.find_last_not_of(" \t\r");
+        return begin == std::string_view::npos ? std::string{} : std::string{ a_text.substr(begin, end - begin + 1) };
+    }
+
+    // the part of CSimpleIniA Settings reads and writes through, with its formatting:
+    // sections and keys case insensitive, doubles written with %f, bools as true/false and read from true/yes/on/1
+    class TextIni
+    {
+    public:
+        void Load(std::string_view a_text)
+        {
+            std::istringstream stream{ std::string{ a_text } };
+            std::string line;
+            std::string section;
+
+            while (std::getline(stream, line)) {
+                auto text = Trim(line);
+                if (text.empty() || text[0] == ';' || text[0] == '#') {
+                    continue;
+                }
+                if (text.front() == '[' && text.back() == ']') {
+                    section = Lower(text.substr(1, text.size() - 2));
+                    continue;
+                }
+                if (auto equals = text.find('='); equals != std::string::npos) {
+                    _values[section][Lower(Trim(std::string_view{ text }.substr(0, equals)))] = Trim(std::string_view{ text }.substr(equals + 1));
+                }
+            }
+        }
+
+        std::string Save() const
+        {
+            std::string text;
+
+            for (auto& [section, values] : _values) {
+                text += "[" + section + "]\n";
+                for (auto& [key, value] : values) {
+                    text += key + " = " + value + "\n";
+                }
+            }
+
+            return text;
+        }
+
+        const std::string* Find(const char* a_section, const char* a_key) const
+        {
+            auto section = _values.find(Lower(a_section));
+            if (section == _values.end()) {
+                return nullptr;
+            }
+
+            auto value = section->second.find(Lower(a_key));
+            return value != section->second.end() ? &value->second : nullptr;
+        }
+
+        double GetDoubleValue(const char* a_section, const char* a_key, double a_default) const
+        {
+            auto value = Find(a_section, a_key);
+            if (!value) {
+                return a_default;
+            }
+
+            char* end = nullptr;
+            auto result = std::strtod(value->c_str(), &end);
+            return end != value->c_str() ? result : a_default;
+        }
+
+        bool GetBoolValue(const char* a_section, const char* a_key, bool a_default) const
+        {
+            auto value = Find(a_section, a_key);
+            if (!value || value->empty()) {
+                return a_default;
+            }
+
+            switch (std::tolower(static_cast<unsigned char>((*value)[0]))) {
+            case 't':
+            case 'y':
+            case '1':
+                return true;
+            case 'f':
+            case 'n':
+            case '0':
+                return false;
+            case 'o':
+                switch (value->size() > 1 ? std::tolower(static_cast<unsigned char>((*value)[1])) : 0) {
+                case 'n':
+                    return true;
+                case 'f':
+                    return false;
+                }
+                break;
+            }
+
+            return a_default;
+        }
+
+        void SetDoubleValue(const char* a_section, const char* a_key, double a_value)
+        {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "%f", a_value);
+            _values[Lower(a_section)][Lower(a_key)] = buffer;
+        }
+
+        void SetBoolValue(const char* a_section, const char* a_key, bool a_value)
+        {
+            _values[Lower(a_section)][Lower(a_key)] = a_value ? "true" : "false";
+        }
+
+    private:
+        std::map<std::string, std::map<std::string, std::string>> _values;
+    };
+
+    // a value for every setting that differs from its default, exact at the six decimals the ini keeps
+    Settings MakeChangedSettings()
+    {
+        Settings settings;
+        float step = 0.0f;
+
+        for (auto& descriptor : kSettingDescriptors) {
+            auto value = descriptor.get(settings);
+            step += 0.125f;
+
+            if (descriptor.type == SettingDescriptor::Type::Bool) {
+                descriptor.set(settings, value != 0.0f ? 0.0f : 1.0f);
+            } else {
+                descriptor.set(settings, value != step ? step : step + 0.0625f);
+            }
+        }
+
+        return settings;
+    }
+
+    MFGFIX_TEST(SettingsDescriptorsUnique)
+    {
+        for (auto& descriptor : kSettingDescriptors) {
+            CHECK(FindSettingDescriptor(descriptor.key) == &descriptor);
+            CHECK(FindSettingDescriptor(Lower(descriptor.key)) == &descriptor);
+            CHECK(std::string_view{ descriptor.key }.starts_with(descriptor.type == SettingDescriptor::Type::Bool ? "b" : "f"));
+        }
+
+        CHECK(FindSettingDescriptor("fNoSuchSetting") == nullptr);
+        CHECK(FindSettingDescriptor("") == nullptr);
+    }
+
+    // written, saved as text, loaded and read back, every setting comes back as it was
+    MFGFIX_TEST(SettingsIniRoundTrip)
+    {
+        auto written = MakeChangedSettings();
+
+        TextIni out;
+        written.Write(out);
+
+        TextIni in;
+        in.Load(out.Save());
+
+        Settings read;
+        read.Read(in);
+
+        std::uint32_t mismatches = 0;
+        for (auto& descriptor : kSettingDescriptors) {
+            if (descriptor.get(read) != descriptor.get(written)) {
+                std::fprintf(stderr, "%s: wrote %f, read %f\n", descriptor.key, descriptor.get(written), descriptor.get(read));
+                ++mismatches;
+            }
+        }
+
+        CHECK(mismatches == 0);
+    }
+
+    // keys missing from the ini keep the value they had, keys are found whatever their case
+    MFGFIX_TEST(SettingsIniMissingKeysKeepValues)
+    {
+        TextIni ini;
+        ini.Load(
+            "[EyesBlinking]\n"
+            "FBLINKUPTIME = 0.25\n"
+            "; fBlinkDownTime = 9\n"
+            "[performance]\n"
+            "bskipidlefaces = 1\n"
+            "fFrameBudget = not a number\n");
+
+        auto before = MakeChangedSettings();
+        auto read = before;
+        read.Read(ini);
+
+        CHECK(read.eyesBlinking.fBlinkUpTime == 0.25f);
+        CHECK(read.performance.bSkipIdleFaces);
+
+        std::uint32_t changed = 0;
+        for (auto& descriptor : kSettingDescriptors) {
+            changed += descriptor.get(read) != descriptor.get(before);
+        }
+
+        CHECK(changed == (before.performance.bSkipIdleFaces ? 1u : 2u));
+    }
+
+#ifdef MFGFIX_DIST_INI
+    // the ini shipped with the plugin has every setting, in its section, at its default
+    MFGFIX_TEST(SettingsDistIniHasDefaults)
+    {
+        std::ifstream file{ MFGFIX_DIST_INI, std::ios::binary };
+        CHECK(file.is_open());
+
+        std::stringstream text;
+        text << file.rdbuf();
+
+        TextIni ini;
+        ini.Load(text.str());
+
+        auto read = MakeChangedSettings();
+        read.Read(ini);
+
+        Settings defaults;
+
+        for (auto& descriptor : kSettingDescriptors) {
+            auto found = ini.Find(descriptor.section, descriptor.key) != nullptr;
+            auto same = descriptor.get(read) == descriptor.get(defaults);
+
+            if (!found || !same) {
+                std::fprintf(stderr, "%s.%s: %s\n", descriptor.section, descriptor.key, found ? "not the default" : "missing");
+            }
+
+            CHECK(found && same);
+        }
+    }
+#endif
+
+    // what the update threads get: ranges ordered, the threshold clamped, limits in radians
+    MFGFIX_TEST(SettingsSnapshotDerived)
+    {
+        Settings settings;
+        settings.eyesBlinking.fBlinkDelayMin = 6.0f;
+        settings.eyesBlinking.fBlinkDelayMax = 2.0f;
+        settings.eyesMovement.fEyeHeadingMinOffsetEmotionAngry = 0.3f;
+        settings.eyesMovement.fEyeHeadingMaxOffsetEmotionAngry = -0.3f;
+        settings.eyesMovement.fEyeOffsetDelayExponentEmotionAngry = -1.0f;
+        settings.eyesMovement.fEyeOffsetZeroChanceEmotionAngry = 4.0f;
+        settings.eyesMovement.fTrackEyeXY = 90.0f;
+        settings.dialogue.fDialoguePhonemeThreshold = 500.0f;
+
+        SettingsSnapshot snapshot{ settings };
+
+        CHECK(snapshot.blink.delayMin == 2.0f && snapshot.blink.delayMax == 6.0f);
+        CHECK(snapshot.phonemeThreshold == 2.0f);
+        CHECK(std::abs(snapshot.track.headingMax - 1.5707964f) < 1e-6f);
+        CHECK(std::abs(snapshot.track.headingMaxInv * snapshot.track.headingMax - 1.0f) < 1e-6f);
+
+        auto& angry = snapshot.eyesOffset[Core::Expression::MoodAnger];
+        CHECK(angry.headingMin == -0.3f && angry.headingMax == 0.3f);
+        CHECK(angry.delayExponent == 1.0f);
+        CHECK(angry.zeroChance == 1.0f);
+    }
+
+    // the eyes offset the hook selected before the profiles, a case per emotion with its exponent and fear's coin flips
+    void SwitchOffsetSelect(Core::EyesState& a_eyes, std::uint32_t a_expression, const Settings::EyesMovement& a_settings, Core::Rng& a_rng)
+    {
+        using namespace Core::Expression;
+
+        auto rand = [&](float a_min, float a_max, float a_exponent = 1.0f) { return a_min + (a_max - a_min) * std::pow(a_rng.Uniform(), a_exponent); };
+        auto& s = a_settings;
+
+        switch (a_expression) {
+        case DialogueAnger:
+        case MoodAnger:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionAngry, s.fEyeOffsetDelayMaxEmotionAngry, 2.0f);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionAngry, s.fEyeHeadingMaxOffsetEmotionAngry);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionAngry, s.fEyePitchMaxOffsetEmotionAngry);
+            break;
+        case DialogueHappy:
+        case MoodHappy:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionHappy, s.fEyeOffsetDelayMaxEmotionHappy, 0.5f);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionHappy, s.fEyeHeadingMaxOffsetEmotionHappy);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionHappy, s.fEyePitchMaxOffsetEmotionHappy);
+            break;
+        case DialogueSurprise:
+        case MoodSurprise:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionSurprise, s.fEyeOffsetDelayMaxEmotionSurprise, 0.5f);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionSurprise, s.fEyeHeadingMaxOffsetEmotionSurprise);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionSurprise, s.fEyePitchMaxOffsetEmotionSurprise);
+            break;
+        case DialogueSad:
+        case MoodSad:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionSad, s.fEyeOffsetDelayMaxEmotionSad);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionSad, s.fEyeHeadingMaxOffsetEmotionSad);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionSad, s.fEyePitchMaxOffsetEmotionSad);
+            break;
+        case DialogueFear:
+        case MoodFear:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionFear, s.fEyeOffsetDelayMaxEmotionFear);
+            a_eyes.headingOffset = rand(0.0f, 1.0f) < 0.5f ? 0.0f : rand(s.fEyeHeadingMinOffsetEmotionFear, s.fEyeHeadingMaxOffsetEmotionFear);
+            a_eyes.pitchOffset = rand(0.0f, 1.0f) < 0.5f ? 0.0f : rand(s.fEyePitchMinOffsetEmotionFear, s.fEyePitchMaxOffsetEmotionFear);
+            break;
+        case DialoguePuzzled:
+        case MoodPuzzled:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionPuzzled, s.fEyeOffsetDelayMaxEmotionPuzzled);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionPuzzled, s.fEyeHeadingMaxOffsetEmotionPuzzled);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionPuzzled, s.fEyePitchMaxOffsetEmotionPuzzled);
+            break;
+        case DialogueDisgusted:
+        case MoodDisgusted:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionDisgusted, s.fEyeOffsetDelayMaxEmotionDisgusted);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionDisgusted, s.fEyeHeadingMaxOffsetEmotionDisgusted);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionDisgusted, s.fEyePitchMaxOffsetEmotionDisgusted);
+            break;
+        case CombatAnger:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionCombatAnger, s.fEyeOffsetDelayMaxEmotionCombatAnger);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionCombatAnger, s.fEyeHeadingMaxOffsetEmotionCombatAnger);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionCombatAnger, s.fEyePitchMaxOffsetEmotionCombatAnger);
+            break;
+        case CombatShout:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionCombatShout, s.fEyeOffsetDelayMaxEmotionCombatShout);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionCombatShout, s.fEyeHeadingMaxOffsetEmotionCombatShout);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionCombatShout, s.fEyePitchMaxOffsetEmotionCombatShout);
+            break;
+        default:
+            a_eyes.offsetTimer = rand(s.fEyeOffsetDelayMinEmotionNeutral, s.fEyeOffsetDelayMaxEmotionNeutral, 2.0f);
+            a_eyes.headingOffset = rand(s.fEyeHeadingMinOffsetEmotionNeutral, s.fEyeHeadingMaxOffsetEmotionNeutral);
+            a_eyes.pitchOffset = rand(s.fEyePitchMinOffsetEmotionNeutral, s.fEyePitchMaxOffsetEmotionNeutral);
+            break;
+        }
+    }
+
+    // the default profiles select what the switch did, drawing the same random numbers in the same order;
+    // the curves differ from pow by interpolation only, well below what an eye offset can show
+    MFGFIX_TEST(SettingsEyesProfilesMatchSwitch)
+    {
+        Settings settings;
+        SettingsSnapshot snapshot{ settings };
+
+        float worst = 0.0f;
+        std::uint32_t zeros = 0;
+        std::uint32_t mismatched = 0;
+
+        for (std::uint32_t expression = 0; expression < Core::Expression::Total; ++expression) {
+            Core::Rng before{ Core::Rng::kDefaultSeed, expression };
+            Core::Rng after{ Core::Rng::kDefaultSeed, expression };
+
+            for (int i = 0; i < 2000; ++i) {
+                Core::EyesState expected;
+                Core::EyesState selected;
+
+                SwitchOffsetSelect(expected, expression, settings.eyesMovement, before);
+                Core::EyesOffsetSelect(selected, snapshot.eyesOffset[expression], after);
+
+                worst = std::max({ worst, std::abs(expected.offsetTimer - selected.offsetTimer), std::abs(expected.headingOffset - selected.headingOffset),
+                    std::abs(expected.pitchOffset - selected.pitchOffset) });
+                zeros += selected.headingOffset == 0.0f && expected.headingOffset == 0.0f;
+                mismatched += (expected.headingOffset == 0.0f) != (selected.headingOffset == 0.0f);
+            }
+
+            // both drew as many numbers
+            CHECK(before.Next() == after.Next());
+        }
+
+        CHECK(worst < 1e-4f);
+        CHECK(mismatched == 0);
+        CHECK(zeros > 0);
+    }
+
+    // exponents share their curve tables, the ones past the last table are computed, every curve follows u^exponent
+    MFGFIX_TEST(PowerCurveSharedTables)
+    {
+        std::vector<Core::PowerCurve> curves;
+        for (std::size_t i = 0; i < Core::PowerCurve::kMaxTables * 2; ++i) {
+            curves.emplace_back(0.25f + 0.03125f * static_cast<float>(i));
+            curves.emplace_back(0.25f + 0.03125f * static_cast<float>(i));
+        }
+
+        float worst = 0.0f;
+        for (auto& curve : curves) {
+            for (int i = 0; i <= 1000; ++i) {
+                auto u = static_cast<float>(i) / 1000.0f;
+                worst = std::max(worst, std::abs(curve(u) - std::pow(u, curve.Exponent())));
+            }
+            CHECK(curve(0.0f) == 0.0f && curve(1.0f) == 1.0f);
+        }
+
+        // the first interpolated segment of u^0.25 is the worst the tables get
+        CHECK(worst < 1e-2f);
+        CHECK(sizeof(Core::PowerCurve) <= 16);
+        CHECK(sizeof(Core::EyesOffsetParams) <= 48);
+    }
+}
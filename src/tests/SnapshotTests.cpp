@@ -0,0 +1,230 @@
+#include "Test.h"
+
+#include "core/Presets.h"
+#include "core/Snapshot.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    // the n-th publish of a face has every value n, a read mixing two publishes shows
+    FaceSnapshot MakeSnapshot(std::uint32_t a_publish)
+    {
+        FaceSnapshot snapshot;
+        auto value = static_cast<float>(a_publish);
+
+        for (std::size_t layer = 0; layer < FaceSnapshot::kLayers; ++layer) {
+            snapshot.expressions[layer].fill(value);
+            snapshot.modifiers[layer].fill(value);
+            snapshot.phonemes[layer].fill(value);
+        }
+
+        return snapshot;
+    }
+
+    bool Whole(const FaceSnapshot& a_snapshot)
+    {
+        auto expected = MakeSnapshot(static_cast<std::uint32_t>(a_snapshot.phonemes[0][0]));
+        return std::memcmp(&a_snapshot, &expected, sizeof(FaceSnapshot)) == 0;
+    }
+
+    // channel i of keyframe layer l holds (l * 53 + i * 7) % 201 / 100, in steps of 0.01 like the keyframes are set
+    float Channel(std::size_t a_layer, std::size_t a_channel)
+    {
+        return static_cast<float>((a_layer * 53 + a_channel * 7) % 201) / 100.0f;
+    }
+
+    FaceSnapshot MakeLayeredSnapshot()
+    {
+        FaceSnapshot snapshot;
+        std::array<float, Expression::Total> channels;
+
+        for (std::size_t layer = 0; layer < FaceSnapshot::kLayers; ++layer) {
+            for (std::size_t i = 0; i < channels.size(); ++i) {
+                channels[i] = Channel(layer, i);
+            }
+
+            FaceSnapshot::Copy({ channels.data(), Phoneme::Total }, snapshot.phonemes[layer], snapshot.phonemeCount[layer]);
+            FaceSnapshot::Copy({ channels.data(), Modifier::Total }, snapshot.modifiers[layer], snapshot.modifierCount[layer]);
+            FaceSnapshot::Copy({ channels.data(), Expression::Total }, snapshot.expressions[layer], snapshot.expressionCount[layer]);
+        }
+
+        return snapshot;
+    }
+
+    // phonemes then the preset's modifiers of the layer asked for, the strongest mood of expression1 for dialogue and script,
+    // of expression3 for the output
+    MFGFIX_TEST(ToPresetLayout)
+    {
+        auto snapshot = MakeLayeredSnapshot();
+
+        // scripts set moods on expression1, what expression2 holds is never read as the mood
+        snapshot.expressions[1].fill(0.0f);
+        snapshot.expressions[1][Expression::MoodSad] = 2.0f;
+
+        for (auto layer : { SnapshotLayer::Dialogue, SnapshotLayer::Script, SnapshotLayer::Output }) {
+            auto values = ToPreset(snapshot, layer);
+            auto index = static_cast<std::size_t>(layer) - 1;
+            auto moods = layer == SnapshotLayer::Output ? 2 : 0;
+
+            std::uint32_t wrong = 0;
+            for (std::size_t i = 0; i < Phoneme::Total; ++i) {
+                wrong += values[i] != Channel(index, i);
+            }
+            for (std::size_t i = 0; i < kPresetModifiers; ++i) {
+                wrong += values[Phoneme::Total + i] != Channel(index, i);
+            }
+            CHECK(wrong == 0);
+
+            std::uint32_t expression = Expression::MoodNeutral;
+            for (std::uint32_t i = 0; i < Expression::Total; ++i) {
+                expression = Channel(moods, i) > Channel(moods, expression) ? i : expression;
+            }
+
+            CHECK(values[30] == static_cast<float>(expression));
+            CHECK(values[31] == Channel(moods, expression));
+            CHECK(values[30] != static_cast<float>(Expression::MoodSad));
+        }
+    }
+
+    // applying what was read sets the same 0 - 200 values again, a captured preset holds it in its steps of 0.01
+    MFGFIX_TEST(ToPresetRoundTrip)
+    {
+        auto snapshot = MakeLayeredSnapshot();
+
+        for (auto layer : { SnapshotLayer::Dialogue, SnapshotLayer::Script, SnapshotLayer::Output }) {
+            auto values = ToPreset(snapshot, layer);
+            auto preset = MakePreset(values, false, {});
+
+            CHECK(preset.has_value());
+            if (!preset) {
+                continue;
+            }
+
+            CHECK(preset->expression == static_cast<std::uint32_t>(values[30]));
+            CHECK(preset->expressionValue == std::lround(values[31] * 100.0f));
+
+            std::uint32_t wrong = 0;
+            for (std::size_t i = 0; i < Phoneme::Total; ++i) {
+                wrong += preset->phonemes[i] != std::lround(values[i] * 100.0f);
+            }
+            for (std::size_t i = 0; i < kPresetModifiers; ++i) {
+                wrong += preset->modifiers[i] != std::lround(values[Phoneme::Total + i] * 100.0f);
+            }
+            CHECK(wrong == 0);
+
+            CHECK(Unpack(Pack(values)) == values);
+        }
+    }
+
+    // keyframes narrower than the layout read 0 past their count, no moods at all read as neutral at 0
+    MFGFIX_TEST(ToPresetNarrowKeyframes)
+    {
+        FaceSnapshot snapshot;
+        std::array<float, 8> channels;
+        channels.fill(0.5f);
+
+        FaceSnapshot::Copy({ channels.data(), channels.size() }, snapshot.phonemes[1], snapshot.phonemeCount[1]);
+        FaceSnapshot::Copy({ channels.data(), channels.size() }, snapshot.modifiers[1], snapshot.modifierCount[1]);
+
+        // a mood past the count of expression1 isn't one
+        snapshot.expressions[0][Expression::MoodHappy] = 0.8f;
+
+        auto values = ToPreset(snapshot, SnapshotLayer::Script);
+
+        std::uint32_t wrong = 0;
+        for (std::size_t i = 0; i < Phoneme::Total; ++i) {
+            wrong += values[i] != (i < channels.size() ? 0.5f : 0.0f);
+        }
+        for (std::size_t i = 0; i < kPresetModifiers; ++i) {
+            wrong += values[Phoneme::Total + i] != (i < channels.size() ? 0.5f : 0.0f);
+        }
+        CHECK(wrong == 0);
+
+        CHECK(values[30] == static_cast<float>(Expression::MoodNeutral));
+        CHECK(values[31] == 0.0f);
+    }
+
+    // an erased face starts over: nothing to read, then a fresh slot that takes the same snapshot again
+    MFGFIX_TEST(SnapshotEraseStartsOver)
+    {
+        SnapshotBoard board;
+        FaceSnapshot snapshot;
+        std::uint32_t version = 0;
+
+        CHECK(board.Publish(0x1230, MakeSnapshot(1)));
+        CHECK(!board.Publish(0x1230, MakeSnapshot(1)));
+
+        CHECK(board.Erase(0x1230));
+        CHECK(!board.Erase(0x1230));
+        CHECK(!board.Read(0x1230, snapshot));
+
+        CHECK(board.Publish(0x1230, MakeSnapshot(1)));
+        CHECK(board.Read(0x1230, snapshot, &version) && version == 1 && Whole(snapshot));
+
+        board.Clear();
+        CHECK(board.Size() == 0 && !board.Read(0x1230, snapshot));
+    }
+
+    // faces erased and published again while readers copy them out: every read finds nothing or a whole snapshot,
+    // a slot erased under a reader stays until that reader is done with it
+    MFGFIX_TEST(SnapshotReadsSurviveErase)
+    {
+        constexpr std::size_t kFaces = 4;
+        constexpr std::size_t kReaders = 3;
+        constexpr std::uint32_t kRounds = 20000;
+
+        SnapshotBoard board;
+        std::atomic<bool> writing{ true };
+        std::atomic<std::uint64_t> broken{ 0 };
+        std::atomic<std::uint64_t> found{ 0 };
+
+        std::vector<std::thread> threads;
+
+        threads.emplace_back([&]() {
+            for (std::uint32_t round = 1; round <= kRounds; ++round) {
+                auto face = (round % kFaces + 1) * 0x230;
+
+                board.Publish(face, MakeSnapshot(round));
+                if (round % 3 == 0) {
+                    board.Erase(face);
+                }
+            }
+            writing.store(false, std::memory_order_release);
+        });
+
+        for (std::size_t reader = 0; reader < kReaders; ++reader) {
+            threads.emplace_back([&, reader]() {
+                FaceSnapshot snapshot;
+
+                // at least one pass, on one core the writer may be done before it starts
+                for (std::size_t i = reader;; ++i) {
+                    auto more = writing.load(std::memory_order_acquire);
+
+                    if (board.Read((i % kFaces + 1) * 0x230, snapshot)) {
+                        broken += !Whole(snapshot);
+                        ++found;
+                    }
+
+                    if (!more) {
+                        break;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(broken.load() == 0);
+        CHECK(found.load() > 0);
+        CHECK(board.Size() <= kFaces);
+    }
+}
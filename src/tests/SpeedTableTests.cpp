@@ -0,0 +1,223 @@
+#include "Test.h"
+
+#include "core/Random.h"
+#include "core/SpeedTable.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    // face addresses are heap pointers, 16 byte aligned
+    std::uintptr_t FaceKey(std::size_t a_face)
+    {
+        return 0x10000 + a_face * 0x260;
+    }
+
+    // every face has one speed, so a read either finds it or the default, anything else is torn
+    float FaceSpeed(std::uintptr_t a_key)
+    {
+        return static_cast<float>(a_key % 997 + 1) * 0.01f;
+    }
+
+    MFGFIX_TEST(SpeedTableSetGetErase)
+    {
+        auto table = std::make_unique<SpeedTable>();
+
+        CHECK(table->Get(FaceKey(1), 0.5f) == 0.5f);
+        CHECK(!table->Set(0, 1, 1.0f));
+
+        CHECK(table->Set(FaceKey(1), 7, 1.5f));
+        CHECK(table->Set(FaceKey(2), 7, 2.5f));
+        CHECK(table->Set(FaceKey(3), 8, 3.5f));
+        CHECK(table->Get(FaceKey(1), 0.5f) == 1.5f);
+        CHECK(table->Size() == 3);
+
+        // speed 0 is no speed
+        CHECK(table->Set(FaceKey(3), 8, 0.0f));
+        CHECK(table->Get(FaceKey(3), 0.5f) == 0.5f);
+
+        // the address taken by another actor loses the speed, its own actor keeps it
+        CHECK(!table->EraseForeign(FaceKey(1), 7));
+        CHECK(table->EraseForeign(FaceKey(1), 9));
+        CHECK(table->Get(FaceKey(1), 0.5f) == 0.5f);
+
+        CHECK(table->Set(FaceKey(1), 7, 1.5f));
+        CHECK(table->EraseOwner(7) == 2);
+        CHECK(table->Size() == 0);
+
+        auto stats = table->GetStats();
+        CHECK(stats.hits == 1);
+        CHECK(stats.misses == 3);
+        CHECK(stats.inserts == 4);
+        CHECK(stats.evictedUnload == 2);
+        CHECK(stats.evictedReuse == 1);
+    }
+
+    // the same operations on the table and on a map give the same reads, backward shift deletion keeps every chain whole
+    MFGFIX_TEST(SpeedTableMatchesMap)
+    {
+        constexpr std::size_t kFaces = SpeedTable::kMaxEntries - 24;
+
+        auto table = std::make_unique<SpeedTable>();
+        std::unordered_map<std::uintptr_t, std::pair<std::uint32_t, float>> model;
+        Rng rng{ Rng::kDefaultSeed };
+        std::uint32_t mismatches = 0;
+
+        for (std::uint32_t i = 0; i < 200000; ++i) {
+            auto key = FaceKey(rng.Next() % kFaces);
+            auto owner = 1 + rng.Next() % 32;
+
+            switch (rng.Next() % 8) {
+            case 0:
+                table->Set(key, owner, 0.0f);
+                model.erase(key);
+                break;
+            case 1:
+                table->EraseForeign(key, owner);
+                if (auto entry = model.find(key); entry != model.end() && entry->second.first != owner) {
+                    model.erase(entry);
+                }
+                break;
+            case 2:
+                if (rng.Next() % 64 == 0) {
+                    table->EraseOwner(owner);
+                    std::erase_if(model, [&](auto& a_entry) { return a_entry.second.first == owner; });
+                }
+                break;
+            case 3:
+            case 4:
+                table->Set(key, owner, FaceSpeed(key) + static_cast<float>(owner));
+                model[key] = { owner, FaceSpeed(key) + static_cast<float>(owner) };
+                break;
+            default:
+                {
+                    auto entry = model.find(key);
+                    mismatches += table->Get(key, -1.0f) != (entry != model.end() ? entry->second.second : -1.0f);
+                }
+                break;
+            }
+        }
+
+        CHECK(mismatches == 0);
+        CHECK(table->Size() == model.size());
+    }
+
+    // a full table drops the entry read longest ago, reads count as much as writes
+    MFGFIX_TEST(SpeedTableEvictsLeastRecentlyRead)
+    {
+        constexpr auto kFull = SpeedTable::kMaxEntries;
+
+        auto table = std::make_unique<SpeedTable>();
+
+        table->Tick(1);
+        for (std::size_t face = 0; face < kFull; ++face) {
+            table->Set(FaceKey(face), 1, FaceSpeed(FaceKey(face)));
+        }
+
+        // the even faces are still on screen, the odd ones were set once and not looked at since
+        table->Tick(2);
+        for (std::size_t face = 0; face < kFull; face += 2) {
+            table->Get(FaceKey(face), 0.0f);
+        }
+
+        // an epoch going back is ignored
+        table->Tick(1);
+        table->Tick(3);
+        for (std::size_t face = kFull; face < kFull + kFull / 2; ++face) {
+            table->Set(FaceKey(face), 2, FaceSpeed(FaceKey(face)));
+        }
+
+        std::size_t kept = 0;
+        std::size_t dropped = 0;
+
+        for (std::size_t face = 0; face < kFull; ++face) {
+            auto found = table->Get(FaceKey(face), 0.0f) != 0.0f;
+            if (face % 2) {
+                dropped += !found;
+            } else {
+                kept += found;
+            }
+        }
+
+        CHECK(kept == kFull / 2);
+        CHECK(dropped == kFull / 2);
+        CHECK(table->Size() == kFull);
+        CHECK(table->GetStats().evictedLRU == kFull / 2);
+    }
+
+    // writers inserting, changing, erasing and unloading while readers look every face up, every read is whole
+    MFGFIX_TEST(SpeedTableConcurrentReadersWriters)
+    {
+        constexpr std::size_t kFaces = 600;
+        constexpr std::size_t kWriters = 2;
+        constexpr std::size_t kReaders = 4;
+        constexpr std::uint32_t kWrites = 100000;
+
+        auto table = std::make_unique<SpeedTable>();
+        std::atomic<std::size_t> writing{ kWriters };
+        std::atomic<std::uint64_t> torn{ 0 };
+        std::atomic<std::uint64_t> reads{ 0 };
+
+        std::vector<std::thread> threads;
+
+        // each writer owns every other face, as the UI task owns the speeds of the actors it sets
+        for (std::size_t writer = 0; writer < kWriters; ++writer) {
+            threads.emplace_back([&, writer]() {
+                Rng rng{ Rng::kDefaultSeed, writer };
+                auto owner = static_cast<std::uint32_t>(writer + 1);
+
+                for (std::uint32_t i = 0; i < kWrites; ++i) {
+                    auto face = (rng.Next() % (kFaces / kWriters)) * kWriters + writer;
+                    auto key = FaceKey(face);
+
+                    if (i % 5000 == 4999) {
+                        table->EraseOwner(owner);
+                    } else {
+                        table->Set(key, owner, rng.Next() % 3 ? FaceSpeed(key) : 0.0f);
+                    }
+                }
+
+                writing.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        for (std::size_t reader = 0; reader < kReaders; ++reader) {
+            threads.emplace_back([&, reader]() {
+                std::uint64_t threadTorn = 0;
+                std::uint64_t threadReads = 0;
+                std::uint32_t epoch = 0;
+
+                // at least one pass, on one core the writers may be done before a reader starts
+                do {
+                    table->Tick(++epoch);
+
+                    for (std::size_t face = reader; face < kFaces; ++face) {
+                        auto key = FaceKey(face);
+                        auto speed = table->Get(key, -1.0f);
+                        threadTorn += speed != -1.0f && speed != FaceSpeed(key);
+                        ++threadReads;
+                    }
+                } while (writing.load(std::memory_order_acquire));
+
+                torn += threadTorn;
+                reads += threadReads;
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto stats = table->GetStats();
+
+        CHECK(torn.load() == 0);
+        CHECK(stats.hits + stats.misses == reads.load());
+        CHECK(stats.size <= kFaces);
+    }
+}
@@ -0,0 +1,158 @@
+#include "Test.h"
+
+#include "core/Stats.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    // bucket i holds [2^(i-1), 2^i), the last one everything above
+    MFGFIX_TEST(HistogramBuckets)
+    {
+        CHECK(Histogram::Bucket(0) == 0);
+        CHECK(Histogram::Bucket(1) == 1);
+        CHECK(Histogram::Bucket(2) == 2 && Histogram::Bucket(3) == 2);
+        CHECK(Histogram::Bucket(4) == 3 && Histogram::Bucket(7) == 3);
+        CHECK(Histogram::Bucket(1024) == 11);
+        CHECK(Histogram::Bucket(~0ull) == Histogram::kBuckets - 1);
+    }
+
+    // count, sum and max are exact, percentiles fall in the bucket of the sample they stand for and never above max
+    MFGFIX_TEST(HistogramPercentiles)
+    {
+        Histogram histogram;
+
+        CHECK(histogram.Read().Percentile(0.5) == 0.0);
+        CHECK(histogram.Read().Mean() == 0.0);
+
+        for (std::uint64_t ticks = 1; ticks <= 1000; ++ticks) {
+            histogram.Add(ticks);
+        }
+
+        auto snapshot = histogram.Read();
+        CHECK(snapshot.count == 1000);
+        CHECK(snapshot.sum == 500500);
+        CHECK(snapshot.max == 1000);
+        CHECK(snapshot.Mean() == 500.5);
+
+        // the 500th sample is 500, in [256, 512); the 990th is 990, in [512, 1024) but capped at max
+        auto p50 = snapshot.Percentile(0.5);
+        auto p99 = snapshot.Percentile(0.99);
+        CHECK(p50 >= 256.0 && p50 < 512.0);
+        CHECK(p99 >= 512.0 && p99 <= 1000.0);
+        CHECK(snapshot.Percentile(1.0) == 1000.0);
+        CHECK(snapshot.Percentile(0.0) <= 2.0);  // the top of the first sample's bucket
+        CHECK(p50 <= p99);
+
+        // merging a copy doubles the counts and leaves the shape
+        auto merged = snapshot;
+        merged.Merge(snapshot);
+        CHECK(merged.count == 2000 && merged.sum == 1001000 && merged.max == 1000);
+        CHECK(merged.Percentile(0.5) == p50);
+
+        histogram.Reset();
+        CHECK(histogram.Read().count == 0 && histogram.Read().max == 0);
+    }
+
+    // every thread's samples land in one report, counters and natives from any thread add up
+    MFGFIX_TEST(StatsAggregatesThreads)
+    {
+        constexpr std::size_t kThreads = 4;
+        constexpr std::uint64_t kSamples = 10000;
+
+        Stats stats;
+
+        auto often = stats.RegisterNative("SetPhoneme");
+        auto rarely = stats.RegisterNative("GetExpression");
+        CHECK(stats.RegisterNative("SetPhoneme") == often);
+        CHECK(often != rarely);
+
+        std::vector<std::thread> threads;
+        for (std::size_t thread = 0; thread < kThreads; ++thread) {
+            threads.emplace_back([&, thread]() {
+                for (std::uint64_t i = 0; i < kSamples; ++i) {
+                    stats.Add(Probe::KeyframesUpdate, 100 + thread);
+                    stats.Add(i % 4 ? Probe::RegularUpdate : Probe::SmoothUpdate, 50);
+                    stats.Count(Counter::LockContended);
+                    stats.CountNative(i % 10 ? often : rarely);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto report = stats.Collect();
+
+        CHECK(report.threads == kThreads);
+        CHECK(report[Probe::KeyframesUpdate].count == kThreads * kSamples);
+        CHECK(report[Probe::KeyframesUpdate].sum == (100 + 101 + 102 + 103) * kSamples);
+        CHECK(report[Probe::KeyframesUpdate].max == 103);
+        CHECK(report[Probe::RegularUpdate].count == kThreads * kSamples * 3 / 4);
+        CHECK(report[Probe::SmoothUpdate].count == kThreads * kSamples / 4);
+        CHECK(report[Probe::LockWait].count == 0);
+        CHECK(report.counters[static_cast<std::size_t>(Counter::LockContended)] == kThreads * kSamples);
+
+        // most calls first
+        CHECK(report.natives.size() == 2);
+        CHECK(report.natives[0].first == "SetPhoneme" && report.natives[0].second == kThreads * kSamples * 9 / 10);
+        CHECK(report.natives[1].first == "GetExpression" && report.natives[1].second == kThreads * kSamples / 10);
+
+        auto text = Stats::Format(report);
+        CHECK(text.find("KeyframesUpdate") != std::string::npos);
+        CHECK(text.find("LockContended") != std::string::npos);
+        CHECK(text.find("SetPhoneme") != std::string::npos);
+        CHECK(text.find("smooth 25.0%") != std::string::npos);
+
+        // a reset keeps the threads and the native names, and nothing else
+        stats.Reset();
+        report = stats.Collect();
+        CHECK(report.threads == kThreads);
+        CHECK(report[Probe::KeyframesUpdate].count == 0);
+        CHECK(report.counters[static_cast<std::size_t>(Counter::LockContended)] == 0);
+        CHECK(report.natives.empty());
+        CHECK(stats.RegisterNative("GetExpression") == rarely);
+    }
+
+    // once every slot is taken natives go uncounted instead of sharing a slot
+    MFGFIX_TEST(StatsNativeSlotsRunOut)
+    {
+        Stats stats;
+
+        for (std::size_t i = 0; i < Stats::kMaxNatives; ++i) {
+            CHECK(stats.RegisterNative("native" + std::to_string(i)) == i);
+        }
+
+        auto extra = stats.RegisterNative("oneTooMany");
+        CHECK(extra == Stats::kNoNative);
+
+        stats.CountNative(extra);
+        stats.CountNative(0);
+
+        auto report = stats.Collect();
+        CHECK(report.natives.size() == 1 && report.natives[0].first == "native0");
+    }
+
+    // a probe timed on a thread that never touched the stats before registers it
+    MFGFIX_TEST(ScopedTimerAddsOnce)
+    {
+        Stats stats;
+
+        std::thread([&]() {
+            ScopedTimer timer(&stats, Probe::ReleaseDialogue);
+            timer.Stop();
+            timer.Stop();
+
+            ScopedTimer none(nullptr, Probe::ReleaseDialogue);
+        }).join();
+
+        auto report = stats.Collect();
+        CHECK(report.threads == 1);
+        CHECK(report[Probe::ReleaseDialogue].count == 1);
+    }
+}
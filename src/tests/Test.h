@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdio>
+#include <span>
+#include <vector>
+
+// mfgfix-tests: every MFGFIX_TEST registers itself, the runner calls them all and exits non-zero if a CHECK failed
+// a failed CHECK is reported and the test goes on, so one run shows every broken expectation
+
+namespace MfgFix::Tests
+{
+    struct Case
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    std::vector<Case>& Cases();
+
+    struct Registrar
+    {
+        Registrar(const char* a_name, void (*a_run)()) { Cases().push_back({ a_name, a_run }); }
+    };
+
+    void Fail(const char* a_file, int a_line, const char* a_expression);
+
+    // for CHECK_SAME, two spans are the same if every float has the same bits
+    bool SameBits(std::span<const float> a_lhs, std::span<const float> a_rhs);
+}
+
+#define MFGFIX_TEST(a_name)                                                       \
+    static void a_name();                                                         \
+    static const ::MfgFix::Tests::Registrar a_name##Registrar{ #a_name, a_name }; \
+    static void a_name()
+
+#define CHECK(a_expression) ((a_expression) ? void() : ::MfgFix::Tests::Fail(__FILE__, __LINE__, #a_expression))
+
+#define CHECK_SAME(a_lhs, a_rhs) CHECK(::MfgFix::Tests::SameBits(a_lhs, a_rhs))
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/FaceUpdate.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace MfgFix::Tests
+{
+    // the face concept of core/FaceUpdate.h over plain arrays, engine layer widths, no engine layer 1 steps but a transition on request
+    class TestFace
+    {
+    public:
+        using Layer = Core::Layer;
+
+        static constexpr std::size_t kLayers = static_cast<std::size_t>(Layer::Total);
+        static constexpr std::size_t kMaxChannels = 32;
+
+        static constexpr std::array<std::uint32_t, kLayers> kCounts{
+            Core::Expression::Total, Core::Expression::Total, Core::Expression::Total,
+            Core::Modifier::Total, Core::Modifier::Total, Core::Modifier::Total,
+            Core::Phoneme::Total, Core::Phoneme::Total, Core::Phoneme::Total,
+            8, 8, 8
+        };
+
+        std::span<float> Values(Layer a_layer)
+        {
+            auto i = static_cast<std::size_t>(a_layer);
+            return { _values[i].data(), kCounts[i] };
+        }
+
+        bool IsZero(Layer a_layer)
+        {
+            auto values = Values(a_layer);
+            return std::all_of(values.begin(), values.end(), [](float a_value) { return a_value == 0.0f; });
+        }
+
+        void Reset(Layer a_layer)
+        {
+            auto values = Values(a_layer);
+            std::fill(values.begin(), values.end(), 0.0f);
+        }
+
+        void Copy(Layer a_src, Layer a_dst)
+        {
+            auto src = Values(a_src);
+            std::copy(src.begin(), src.end(), Values(a_dst).begin());
+        }
+
+        // the transition SetTransition asked for, like the engine moving layer 1 toward a new mood
+        bool TransitionUpdate(float)
+        {
+            if (!_transition) {
+                return false;
+            }
+
+            Values(Layer::Expression1)[_transition->first] = _transition->second;
+            _transition.reset();
+
+            return true;
+        }
+
+        void DialogueModifiersUpdate(float) {}
+        void DialoguePhonemesUpdate(float) {}
+
+        auto EyesTimersUpdate(const Core::FaceUpdateContext& a_context) { return Core::EyesTimersUpdate(_eyes, a_context, _hold); }
+
+        Core::EyesState GetEyesState() const { return _eyes; }
+        void SetEyesState(const Core::EyesState& a_eyes) { _eyes = a_eyes; }
+
+        float& BlinkValue() { return _blinkValue; }
+        bool Hold() const { return _hold; }
+        bool Dialogue() const { return _dialogue; }
+
+        void SetHold(bool a_hold) { _hold = a_hold; }
+        void SetDialogue(bool a_dialogue) { _dialogue = a_dialogue; }
+        void SetTransition(std::uint32_t a_id, float a_value) { _transition.emplace(a_id, a_value); }
+
+        // bitwise, NaNs included
+        bool operator==(const TestFace& a_other) const
+        {
+            return std::memcmp(&_values, &a_other._values, sizeof(_values)) == 0 &&
+                   std::memcmp(&_eyes, &a_other._eyes, sizeof(Core::EyesState)) == 0 &&
+                   std::memcmp(&_blinkValue, &a_other._blinkValue, sizeof(float)) == 0 &&
+                   _hold == a_other._hold && _dialogue == a_other._dialogue;
+        }
+
+    private:
+        std::array<std::array<float, kMaxChannels>, kLayers> _values{};
+        Core::EyesState _eyes;
+        float _blinkValue{ 0.0f };
+        bool _hold{ false };
+        bool _dialogue{ false };
+        std::optional<std::pair<std::uint32_t, float>> _transition;  // for the next TransitionUpdate
+    };
+}
@@ -0,0 +1,185 @@
+#include "Test.h"
+
+#include "core/Timeline.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace MfgFix::Core;
+
+namespace
+{
+    std::size_t Occurrences(const std::string& a_text, const std::string& a_pattern)
+    {
+        std::size_t count = 0;
+        for (auto at = a_text.find(a_pattern); at != std::string::npos; at = a_text.find(a_pattern, at + 1)) {
+            ++count;
+        }
+        return count;
+    }
+
+    // the ring keeps the newest Capacity() events in the order they ended, a clear drops the rest
+    MFGFIX_TEST(TimelineKeepsNewest)
+    {
+        Timeline timeline(5);
+        CHECK(timeline.Capacity() == 8);
+
+        for (std::uint64_t i = 0; i < 20; ++i) {
+            timeline.Add(static_cast<Span>(i % static_cast<std::uint32_t>(Span::Total)), i, 100 + i, 110 + i);
+        }
+
+        auto capture = timeline.Collect();
+        CHECK(capture.recorded == 20);
+        CHECK(capture.torn == 0);
+        CHECK(capture.events.size() == 8);
+
+        std::uint32_t wrong = 0;
+        for (std::size_t i = 0; i < capture.events.size(); ++i) {
+            auto& event = capture.events[i];
+            auto id = 12 + i;
+            wrong += event.id != id || event.begin != 100 + id || event.duration != 10 ||
+                     event.span != static_cast<Span>(id % static_cast<std::uint32_t>(Span::Total)) || event.thread != ThreadIndex();
+        }
+        CHECK(wrong == 0);
+
+        timeline.Clear();
+        CHECK(timeline.Collect().events.empty() && timeline.Collect().recorded == 0);
+
+        timeline.Add(Span::Custom, 1, 0, 1);
+        timeline.Add(Span::Custom, 2, 0, 1);
+        capture = timeline.Collect();
+        CHECK(capture.events.size() == 2 && capture.recorded == 2 && capture.events[1].id == 2);
+    }
+
+    // writers on several threads lose nothing while the ring has room, each thread's events stay in order under its own index;
+    // a collect running while they lap a small ring only ever returns whole events
+    MFGFIX_TEST(TimelineConcurrentWriters)
+    {
+        constexpr std::uint64_t kWriters = 4;
+        constexpr std::uint64_t kEvents = 20000;
+
+        {
+            Timeline timeline(kWriters * kEvents);
+
+            std::vector<std::thread> threads;
+            for (std::uint64_t writer = 0; writer < kWriters; ++writer) {
+                threads.emplace_back([&, writer]() {
+                    for (std::uint64_t i = 0; i < kEvents; ++i) {
+                        timeline.Add(Span::Expressions, writer << 32 | i, i, i + writer);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            auto capture = timeline.Collect();
+            CHECK(capture.events.size() == kWriters * kEvents);
+            CHECK(capture.torn == 0);
+
+            std::vector<std::uint64_t> next(kWriters, 0);
+            std::vector<std::uint32_t> threadOf(kWriters, ~0u);
+            std::uint32_t wrong = 0;
+
+            for (auto& event : capture.events) {
+                auto writer = event.id >> 32;
+                auto i = event.id & 0xFFFFFFFF;
+
+                if (writer >= kWriters) {
+                    ++wrong;
+                    continue;
+                }
+                if (threadOf[writer] == ~0u) {
+                    threadOf[writer] = event.thread;
+                }
+
+                wrong += i != next[writer]++ || event.thread != threadOf[writer] || event.begin != i || event.duration != writer;
+            }
+
+            CHECK(wrong == 0);
+        }
+
+        {
+            Timeline timeline(64);
+            std::atomic<std::size_t> writing{ kWriters };
+            std::atomic<std::uint64_t> broken{ 0 };
+            std::atomic<std::uint64_t> collected{ 0 };
+
+            std::vector<std::thread> threads;
+            for (std::uint64_t writer = 0; writer < kWriters; ++writer) {
+                threads.emplace_back([&, writer]() {
+                    for (std::uint64_t i = 0; i < kEvents; ++i) {
+                        auto id = writer << 32 | i;
+                        timeline.Add(static_cast<Span>(writer), id, id * 3, id * 3 + (id & 0xFF));
+                    }
+                    writing.fetch_sub(1, std::memory_order_release);
+                });
+            }
+
+            // at least one collect, on one core the writers may be done before it starts
+            threads.emplace_back([&]() {
+                do {
+                    auto capture = timeline.Collect();
+                    for (auto& event : capture.events) {
+                        broken += event.begin != event.id * 3 || event.duration != (event.id & 0xFF) || event.span != static_cast<Span>(event.id >> 32);
+                    }
+                    collected += capture.events.size();
+                } while (writing.load(std::memory_order_acquire));
+            });
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            CHECK(broken.load() == 0);
+            CHECK(collected.load() > 0);
+            CHECK(timeline.Collect().recorded == kWriters * kEvents);
+        }
+    }
+
+    // one metadata event and one complete event per span, times in microseconds from the oldest span
+    MFGFIX_TEST(TimelineChromeTrace)
+    {
+        Timeline::Capture capture;
+        capture.ticksPerSecond = 1e6;
+        capture.recorded = 5;
+        capture.torn = 2;
+        capture.events = {
+            { 1500, 250, 0xABC, 3, Span::Expressions },
+            { 1000, 1000, 0xABC, 3, Span::RegularUpdate },
+            { 2000, 40, 0x14, 7, Span::SetPhonemeModifierTask }
+        };
+
+        auto json = FormatChromeTrace(capture);
+
+        CHECK(json.starts_with("{\"displayTimeUnit\":\"ms\""));
+        CHECK(json.ends_with("]}\n"));
+        CHECK(json.find("\"recorded\":5,\"torn\":2") != std::string::npos);
+        CHECK(Occurrences(json, "\"ph\":\"M\"") == 1);
+        CHECK(Occurrences(json, "\"ph\":\"X\"") == 3);
+        CHECK(Occurrences(json, "{") == Occurrences(json, "}"));
+        CHECK(Occurrences(json, "[") == Occurrences(json, "]"));
+
+        CHECK(json.find("{\"name\":\"Expressions\",\"cat\":\"face\",\"ph\":\"X\",\"pid\":1,\"tid\":3,\"ts\":500.000,\"dur\":250.000,\"args\":{\"id\":\"0xabc\"}}") != std::string::npos);
+        CHECK(json.find("\"name\":\"RegularUpdate\",\"cat\":\"face\",\"ph\":\"X\",\"pid\":1,\"tid\":3,\"ts\":0.000,\"dur\":1000.000") != std::string::npos);
+        CHECK(json.find("\"name\":\"SetPhonemeModifierSmooth\",\"cat\":\"papyrus\",\"ph\":\"X\",\"pid\":1,\"tid\":7,\"ts\":1000.000,\"dur\":40.000") != std::string::npos);
+
+        // nothing recorded still makes a valid trace
+        auto empty = FormatChromeTrace({});
+        CHECK(Occurrences(empty, "\"ph\"") == 1 && empty.ends_with("]}\n"));
+    }
+
+    // every span has a name and a category a viewer can filter by
+    MFGFIX_TEST(TimelineSpanNames)
+    {
+        std::uint32_t unnamed = 0;
+        for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(Span::Total); ++i) {
+            std::string category = Category(static_cast<Span>(i));
+            unnamed += std::string(ToString(static_cast<Span>(i))) == "?" ||
+                       (category != "face" && category != "dialogue" && category != "papyrus");
+        }
+        CHECK(unnamed == 0);
+    }
+}
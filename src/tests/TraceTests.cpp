@@ -0,0 +1,246 @@
+#include "Test.h"
+#include "TestFace.h"
+
+#include "core/FaceUpdate.h"
+#include "core/Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace MfgFix::Core;
+using MfgFix::Tests::TestFace;
+
+namespace
+{
+    constexpr std::size_t kFaces = 6;
+    constexpr std::uint32_t kFrames = 600;
+
+    std::filesystem::path TracePath(const char* a_name)
+    {
+        return std::filesystem::temp_directory_path() / a_name;
+    }
+
+    TraceParams MakeParams(float a_blinkDelayMin)
+    {
+        std::array<EyesOffsetParams, Expression::Total> eyesOffset;
+        for (std::uint32_t i = 0; i < Expression::Total; ++i) {
+            auto exponent = i % 3 == 0 ? 2.0f : i % 3 == 1 ? 0.5f : 1.5f;
+            eyesOffset[i] = { -0.1f, 0.1f, -0.05f, 0.05f, 0.5f, 4.0f, exponent, i == Expression::MoodFear ? 0.5f : 0.0f, PowerCurve(exponent) };
+        }
+
+        return MakeTraceParams({ 0.04f, 0.14f, a_blinkDelayMin, 8.0f }, MakeTrackParams(30.0f, 15.0f, 3.0f, 1.0f), PhonemeThreshold(50.0f), eyesOffset);
+    }
+
+    // what the hook records around one update, the face made up as scripts and the engine would leave it
+    struct Capture
+    {
+        std::vector<std::uint64_t> faces;
+        std::vector<TraceRecord> records;
+    };
+
+    Capture Record(const std::filesystem::path& a_path, const TraceParams& a_params)
+    {
+        Capture capture;
+        TraceWriter writer;
+        CHECK(writer.Open(a_path));
+
+        auto eyesOffset = EyesOffsets(a_params);
+        std::array<TestFace, kFaces> faces;
+        Rng rng{ Rng::kDefaultSeed };
+        Rng script{ Rng::kDefaultSeed, 1 };
+
+        for (std::uint32_t frame = 0; frame < kFrames; ++frame) {
+            for (std::size_t i = 0; i < kFaces; ++i) {
+                auto& face = faces[i];
+
+                // a script sets an expression now and then, the engine moves phonemes while a face talks
+                if (script.Next() % 40 == 0) {
+                    face.Reset(Layer::Expression2);
+                    face.Values(Layer::Expression2)[script.Next() % Expression::Total] = script.Uniform();
+                }
+                face.SetDialogue(i % 3 == 0 && frame % 200 < 120);
+                face.SetHold(i == kFaces - 1 && frame > kFrames / 2);
+                if (face.Dialogue()) {
+                    face.Values(Layer::Phoneme1)[script.Next() % Phoneme::Total] = script.Uniform();
+                }
+
+                FaceUpdateContext context;
+                context.timeDelta = 1.0f / (30.0f + static_cast<float>(script.Next() % 60));
+                context.speed = i % 2 ? 0.0f : 0.25f + 0.25f * static_cast<float>(i % 3);
+                context.animationStep = context.speed > 0.0f ? context.timeDelta / context.speed : 0.0f;
+                context.blink = a_params.blink;
+                context.track = a_params.track;
+                context.track.deltaMax *= context.timeDelta;
+                context.phonemeThreshold = a_params.phonemeThreshold;
+                context.eyesOffset = eyesOffset;
+                context.rng = &rng;
+
+                TraceRecord record{};
+                record.timeDelta = context.timeDelta;
+                record.speed = context.speed;
+                record.flags = (face.Hold() ? TraceRecord::kHold : 0u) | (face.Dialogue() ? TraceRecord::kDialogue : 0u);
+                record.rng = rng.GetState();
+                record.eyesIn = face.GetEyesState();
+                record.blinkValueIn = face.BlinkValue();
+                for (std::size_t layer = 0; layer < TraceRecord::kLayers; ++layer) {
+                    auto values = face.Values(static_cast<Layer>(layer));
+                    record.counts[layer] = static_cast<std::uint32_t>(values.size());
+                    std::copy(values.begin(), values.end(), record.in[layer].begin());
+                }
+
+                if (context.speed > 0.0f) {
+                    SmoothUpdate(face, context);
+                } else {
+                    RegularUpdate(face, context);
+                }
+
+                for (std::size_t layer = 0; layer < TraceRecord::kLayers; ++layer) {
+                    auto values = face.Values(static_cast<Layer>(layer));
+                    std::copy(values.begin(), values.end(), record.out[layer].begin());
+                }
+                record.eyesOut = face.GetEyesState();
+                record.blinkValueOut = face.BlinkValue();
+
+                auto id = 0x1000 + i * 0x260;
+                writer.Write(a_params, id, record);
+                capture.faces.push_back(id);
+                capture.records.push_back(record);
+            }
+        }
+
+        writer.Close();
+
+        return capture;
+    }
+
+    // what the replayer reports as a divergence: any value further than its default epsilon, or NaN
+    bool Diverges(const TraceRecord& a_record, const ReplayFace& a_replay)
+    {
+        auto differs = [](float a_expected, float a_actual) {
+            return !(std::fabs(a_expected - a_actual) <= 1e-5f);
+        };
+
+        for (std::size_t layer = 0; layer < TraceRecord::kLayers; ++layer) {
+            for (std::uint32_t i = 0; i < a_record.counts[layer]; ++i) {
+                if (differs(a_record.out[layer][i], a_replay.Result()[layer][i])) {
+                    return true;
+                }
+            }
+        }
+
+        auto& expected = a_record.eyesOut;
+        auto& actual = a_replay.Eyes();
+
+        return expected.blinkStage != actual.blinkStage || differs(expected.blinkTimer, actual.blinkTimer) ||
+               differs(expected.offsetTimer, actual.offsetTimer) || differs(expected.headingOffset, actual.headingOffset) ||
+               differs(expected.pitchOffset, actual.pitchOffset) || differs(expected.heading, actual.heading) ||
+               differs(expected.pitch, actual.pitch) || differs(a_record.blinkValueOut, a_replay.Blink());
+    }
+
+    // replays a trace, counting the records that diverge; a_params replaces the recorded settings when given
+    std::uint64_t Replay(const std::filesystem::path& a_path, std::uint64_t& a_records, const TraceParams* a_params = nullptr)
+    {
+        TraceReader reader;
+        CHECK(reader.Open(a_path));
+
+        TraceReplayer replayer;
+        std::uint64_t diverged = 0;
+        a_records = 0;
+
+        for (auto chunk = reader.Next(); chunk != TraceChunk::None; chunk = reader.Next()) {
+            if (chunk == TraceChunk::Params) {
+                replayer.SetParams(a_params ? *a_params : reader.Params());
+                continue;
+            }
+
+            ReplayFace face(reader.Record());
+            replayer.Replay(reader.Face(), face, reader.Record());
+
+            diverged += Diverges(reader.Record(), face);
+            ++a_records;
+        }
+
+        CHECK(!reader.Failed());
+
+        return diverged;
+    }
+
+    // the delta encoded records come back bit for bit, in the order they were written, faces interleaved
+    MFGFIX_TEST(TraceRoundTrip)
+    {
+        auto path = TracePath("mfgfix-tests-roundtrip.trace");
+        auto capture = Record(path, MakeParams(0.5f));
+
+        TraceReader reader;
+        CHECK(reader.Open(path));
+
+        std::size_t index = 0;
+        std::size_t params = 0;
+        std::uint32_t mismatched = 0;
+
+        for (auto chunk = reader.Next(); chunk != TraceChunk::None; chunk = reader.Next()) {
+            if (chunk == TraceChunk::Params) {
+                ++params;
+                continue;
+            }
+
+            mismatched += index >= capture.records.size() || reader.Face() != capture.faces[index] ||
+                          std::memcmp(&reader.Record(), &capture.records[index], sizeof(TraceRecord)) != 0;
+            ++index;
+        }
+
+        CHECK(!reader.Failed());
+        CHECK(params == 1);
+        CHECK(index == capture.records.size());
+        CHECK(mismatched == 0);
+
+        // unchanged words aren't written, a trace is much smaller than its records
+        CHECK(reader.Size() < capture.records.size() * sizeof(TraceRecord) / 4);
+
+        std::filesystem::remove(path);
+    }
+
+    // what the update did live, the replay does again; an update that behaves differently is caught
+    MFGFIX_TEST(TraceReplayMatchesLiveUpdate)
+    {
+        auto path = TracePath("mfgfix-tests-replay.trace");
+        auto params = MakeParams(0.5f);
+        auto capture = Record(path, params);
+
+        std::uint64_t records = 0;
+        CHECK(Replay(path, records) == 0);
+        CHECK(records == capture.records.size());
+
+        // blinks drawn from another range stand in for a changed update, every record that drew a blink delay shows it
+        std::uint64_t drawn = 0;
+        for (auto& record : capture.records) {
+            drawn += record.eyesIn.blinkStage == BlinkStage::BlinkUp && record.eyesOut.blinkStage == BlinkStage::BlinkDelay;
+        }
+
+        auto changed = MakeParams(1.0f);
+        CHECK(drawn > 0);
+        CHECK(Replay(path, records, &changed) >= drawn);
+
+        // so does a recorded result that isn't what the update produced
+        {
+            TraceWriter writer;
+            CHECK(writer.Open(path));
+
+            for (std::size_t i = 0; i < capture.records.size(); ++i) {
+                auto record = capture.records[i];
+                if (i == capture.records.size() / 2) {
+                    record.out[static_cast<std::size_t>(Layer::Modifier3)][Modifier::BlinkLeft] += 0.01f;
+                }
+                writer.Write(params, capture.faces[i], record);
+            }
+        }
+
+        CHECK(Replay(path, records) == 1);
+
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,67 @@
+// mfgfix-tests: unit tests of the engine independent core
+//   mfgfix-tests [filter]    runs every test whose name contains filter, all of them without one
+
+#include "Test.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace MfgFix::Tests
+{
+    namespace
+    {
+        std::uint32_t failures = 0;
+    }
+
+    std::vector<Case>& Cases()
+    {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    void Fail(const char* a_file, int a_line, const char* a_expression)
+    {
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", a_file, a_line, a_expression);
+        ++failures;
+    }
+
+    bool SameBits(std::span<const float> a_lhs, std::span<const float> a_rhs)
+    {
+        return a_lhs.size() == a_rhs.size() && std::memcmp(a_lhs.data(), a_rhs.data(), a_lhs.size_bytes()) == 0;
+    }
+
+    namespace
+    {
+        int Run(std::string_view a_filter)
+        {
+            std::uint32_t run = 0;
+            std::uint32_t failed = 0;
+
+            for (auto& test : Cases()) {
+                if (!std::string_view{ test.name }.contains(a_filter)) {
+                    continue;
+                }
+
+                auto before = failures;
+                test.run();
+                ++run;
+
+                if (failures != before) {
+                    std::fprintf(stderr, "FAILED %s\n", test.name);
+                    ++failed;
+                }
+            }
+
+            std::printf("%u tests, %u failed, %u checks failed\n", run, failed, failures);
+
+            return failed || !run ? 1 : 0;
+        }
+    }
+}
+
+int main(int a_argc, char** a_argv)
+{
+    return MfgFix::Tests::Run(a_argc > 1 ? a_argv[1] : "");
+}
@@ -12,7 +12,9 @@ set_license("Apache-2.0")
 set_warnings("allextra", "error")
 
 -- Includes
-includes("lib/CommonLibSSE-NG/xmake.lua")
+if is_plat("windows") then
+    includes("lib/CommonLibSSE-NG/xmake.lua")
+end
 includes("xmake/dotenv")
 includes("xmake/papyrus")
 add_moduledirs("xmake/modules")
@@ -81,9 +83,12 @@ option_end()
 
 -- Dependencies & Includes
 -- https://github.com/xmake-io/xmake-repo/tree/dev
-add_requires("simpleini", "directxtk")
+add_requires("simpleini")
 
-includes("lib/commonlibsse-ng")
+if is_plat("windows") then
+    add_requires("directxtk")
+    includes("lib/commonlibsse-ng")
+end
 
 -- policies
 set_policy("package.requires_lock", true)
@@ -101,10 +106,11 @@ elseif is_mode("release") then
     set_symbols("debug")
 end
 
-set_allowedplats("windows")
-set_allowedarchs("x64")
+-- linux only builds the engine independent core, its unit tests, the trace replayer and the benchmark
+set_allowedplats("windows", "linux")
+set_allowedarchs("windows|x64", "linux|x86_64")
 set_defaultplat("windows")
-set_defaultarchs("x64")
+set_defaultarchs("windows|x64", "linux|x86_64")
 
 set_config("skse_xbyak", true)
 set_config("skyrim_se", true)
@@ -128,7 +134,7 @@ rule("common")
         import("core.base.task")
         local auto_install = config.get("auto_install")
         local install_path = config.get("install_path")
-        if auto_install and install_path and target:name() ~= "commonlibsse-ng" then
+        if auto_install and install_path and target:name() ~= "commonlibsse-ng" and target:name() ~= "mfgfix-core" and target:name() ~= "mfgfix-replay" and target:name() ~= "mfgfix-bench" and target:name() ~= "mfgfix-tests" then
             task.run("install", {target = target:name()})
         end
     end)
@@ -144,115 +150,159 @@ rule("common")
 rule_end()
 add_rules("common")
 
--- Target
-target(PROJECT_NAME)
-    set_enabled(get_config("build_dll"))
-
-    -- Dependencies
-    add_packages("simpleini", "directxtk")
-    add_deps("detours")
-    add_includedirs("lib/detours/src")
-
-    -- CommonLibSSE
-    add_deps("commonlibsse-ng")
-    add_rules("commonlibsse-ng.plugin", {
-        name = PROJECT_NAME,
-        author = "KrisV-777, crajjjj",
-        description = "Extended implementation of Mfg Fix with new functions and animated expression transitions."
-    })
-
-    -- Source files
-    set_pcxxheader("src/PCH.h")
-    add_files("src/**.cpp")
-    add_headerfiles("src/**.h")
-    add_includedirs("src")
-
-    -- flags
-    add_cxxflags(
-        "cl::/cgthreads4",
-        "cl::/diagnostics:caret",
-        "cl::/external:W0",
-        "cl::/fp:contract",
-        "cl::/fp:except-",
-        "cl::/guard:cf-",
-        "cl::/Zc:enumTypes",
-        "cl::/Zc:preprocessor",
-        "cl::/Zc:templateScope",
-        "cl::/utf-8"
-    )
-    -- flags (cl: warnings -> errors)
-    add_cxxflags("cl::/we4715") -- `function` : not all control paths return a value
-    -- flags (cl: disable warnings)
-    add_cxxflags(
-        "cl::/wd4068", -- unknown pragma 'clang'
-        "cl::/wd4201", -- nonstandard extension used : nameless struct/union
-        "cl::/wd4265" -- 'type': class has virtual functions, but its non-trivial destructor is not virtual; instances of this class may not be destructed correctly
-    )
-
-    -- Conditional flags
-    if is_mode("debug") then
-        add_cxxflags("cl::/bigobj")
-    elseif is_mode("release") then
-        add_cxxflags("cl::/Zc:inline", "cl::/JMC-", "cl::/Ob3")
-    end
-
-    on_load(function(target)
-        local clib = target:rule("commonlibsse-ng.plugin")
-        if clib then
-            -- disable unwanted events
-            clib:set("install", nil)
-            clib:set("package", nil)
-            clib:set("build_after", nil)
-        end
-    end)
+-- Targets
+target("mfgfix-core")
+    set_kind("static")
 
-    -- Post Build
-    after_build(function (target)
-        os.vcp(target:targetfile(), "dist/SKSE/Plugins")
-        os.vcp(target:symbolfile(), "dist/SKSE/Plugins")
-    end)
+    -- engine independent blending math, no CommonLib dependency
+    add_files("src/core/**.cpp")
+    add_headerfiles("src/core/**.h")
+    add_includedirs("src", { public = true })
 target_end()
 
-target("detours")
-    set_kind("static")
-    set_languages("c++17")
-    add_headerfiles("lib/detours/src/*.h", { prefixdir = "detours" })
-    add_includedirs("lib/detours/src")
-    add_files("lib/detours/src/*.cpp")
-    remove_files("lib/detours/src/uimports.cpp") -- This file is included and not compiled on its own
-target_end()
+target("mfgfix-replay")
+    set_kind("binary")
 
-target("papyrus")
-    set_enabled(get_config("build_papyrus"))
-    set_kind("object")
-    set_targetdir("dist/Scripts")
-    set_basename("PapyrusExtender")
+    -- offline replay of `mfg trace` captures, see src/replay/main.cpp
+    add_deps("mfgfix-core")
+    add_files("src/replay/**.cpp")
+target_end()
 
-    --avoid rebuild on mode change
-    set_policy("build.intermediate_directory", false)
-    add_rules("papyrus")
+target("mfgfix-tests")
+    set_kind("binary")
+
+    -- unit tests of the core, `xmake run mfgfix-tests [filter]` exits non-zero if a check failed
+    -- the settings table and snapshot don't need CommonLib, they are tested with it
+    add_deps("mfgfix-core")
+    add_files("src/tests/**.cpp", "src/mfgfix/SettingsTable.cpp")
+    add_defines("MFGFIX_DIST_INI=\"$(projectdir)/dist/SKSE/Plugins/mfgfix.ini\"")
+    add_tests("default")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+target_end()
 
-    add_files("dist/Source/Scripts/*.psc")
-    add_includedirs("dist/Source/Scripts")
-    add_includedirs("$(papyrus_gamesource)/Source/Scripts")
+target("mfgfix-bench")
+    set_kind("binary")
 
-    on_load(function(target)
-        import("core.project.config")
+    -- idle fast path, level of detail, frame budget and the command queue under a synthetic crowd, see src/bench/main.cpp
+    add_deps("mfgfix-core")
+    add_files("src/bench/**.cpp")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+target_end()
 
-        if not config.get("papyrus_include") then
-            cprint("${color.warning}papyrus_include is not defined")
+if is_plat("windows") then
+    target(PROJECT_NAME)
+        set_enabled(get_config("build_dll"))
+
+        -- Dependencies
+        add_packages("simpleini", "directxtk")
+        add_deps("detours", "mfgfix-core")
+        add_includedirs("lib/detours/src")
+
+        -- CommonLibSSE
+        add_deps("commonlibsse-ng")
+        add_rules("commonlibsse-ng.plugin", {
+            name = PROJECT_NAME,
+            author = "KrisV-777, crajjjj",
+            description = "Extended implementation of Mfg Fix with new functions and animated expression transitions."
+        })
+
+        -- Source files
+        set_pcxxheader("src/PCH.h")
+        add_files("src/*.cpp", "src/mfgfix/**.cpp")
+        add_headerfiles("src/*.h", "src/mfgfix/**.h")
+        add_includedirs("src")
+
+        -- flags
+        add_cxxflags(
+            "cl::/cgthreads4",
+            "cl::/diagnostics:caret",
+            "cl::/external:W0",
+            "cl::/fp:contract",
+            "cl::/fp:except-",
+            "cl::/guard:cf-",
+            "cl::/Zc:enumTypes",
+            "cl::/Zc:preprocessor",
+            "cl::/Zc:templateScope",
+            "cl::/utf-8"
+        )
+        -- flags (cl: warnings -> errors)
+        add_cxxflags("cl::/we4715") -- `function` : not all control paths return a value
+        -- flags (cl: disable warnings)
+        add_cxxflags(
+            "cl::/wd4068", -- unknown pragma 'clang'
+            "cl::/wd4201", -- nonstandard extension used : nameless struct/union
+            "cl::/wd4265" -- 'type': class has virtual functions, but its non-trivial destructor is not virtual; instances of this class may not be destructed correctly
+        )
+
+        -- Conditional flags
+        if is_mode("debug") then
+            add_cxxflags("cl::/bigobj")
+        elseif is_mode("release") then
+            add_cxxflags("cl::/Zc:inline", "cl::/JMC-", "cl::/Ob3")
         end
-        if not config.get("papyrus_gamesource") then
-            cprint("${color.warning}papyrus_gamesource is not defined")
-        end
-    end)
 
-    before_build(function(target)
-        import("core.project.config")
-        assert(config.get("papyrus_include"), "papyrus_include is not defined")
-        assert(config.get("papyrus_gamesource"), "papyrus_gamesource is not defined")
-    end)
-target_end()
+        on_load(function(target)
+            local clib = target:rule("commonlibsse-ng.plugin")
+            if clib then
+                -- disable unwanted events
+                clib:set("install", nil)
+                clib:set("package", nil)
+                clib:set("build_after", nil)
+            end
+        end)
+
+        -- Post Build
+        after_build(function (target)
+            os.vcp(target:targetfile(), "dist/SKSE/Plugins")
+            os.vcp(target:symbolfile(), "dist/SKSE/Plugins")
+        end)
+    target_end()
+
+    target("detours")
+        set_kind("static")
+        set_languages("c++17")
+        add_headerfiles("lib/detours/src/*.h", { prefixdir = "detours" })
+        add_includedirs("lib/detours/src")
+        add_files("lib/detours/src/*.cpp")
+        remove_files("lib/detours/src/uimports.cpp") -- This file is included and not compiled on its own
+    target_end()
+
+    target("papyrus")
+        set_enabled(get_config("build_papyrus"))
+        set_kind("object")
+        set_targetdir("dist/Scripts")
+        set_basename("PapyrusExtender")
+
+        --avoid rebuild on mode change
+        set_policy("build.intermediate_directory", false)
+        add_rules("papyrus")
+
+        add_files("dist/Source/Scripts/*.psc")
+        add_includedirs("dist/Source/Scripts")
+        add_includedirs("$(papyrus_gamesource)/Source/Scripts")
+
+        on_load(function(target)
+            import("core.project.config")
+
+            if not config.get("papyrus_include") then
+                cprint("${color.warning}papyrus_include is not defined")
+            end
+            if not config.get("papyrus_gamesource") then
+                cprint("${color.warning}papyrus_gamesource is not defined")
+            end
+        end)
+
+        before_build(function(target)
+            import("core.project.config")
+            assert(config.get("papyrus_include"), "papyrus_include is not defined")
+            assert(config.get("papyrus_gamesource"), "papyrus_gamesource is not defined")
+        end)
+    target_end()
+end
 
 includes("@builtin/xpack")
 